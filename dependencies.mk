@@ -30,7 +30,8 @@ TEST_DEPENDENCIES = \
 
 #------------------------------------------------------------------------------
 # Linux dependencies
-LINUX_DEPENDENCIES =
+LINUX_DEPENDENCIES = \
+  LIBPTHREAD
 
 LINUX_TEST_DEPENDENCIES =
 
@@ -41,7 +42,8 @@ endif
 
 #------------------------------------------------------------------------------
 # BSD dependencies
-BSD_DEPENDENCIES =
+BSD_DEPENDENCIES = \
+  LIBPTHREAD
 
 BSD_TEST_DEPENDENCIES =
 
@@ -25,6 +25,7 @@
 #include <lsp-plug.in/r3d/wgl/version.h>
 
 #include <lsp-plug.in/r3d/base/backend.h>
+#include <lsp-plug.in/r3d/wgl/types.h>
 
 #include <gl/gl.h>
 #include <windows.h>
@@ -35,21 +36,186 @@ namespace lsp
     {
         namespace wgl
         {
-            typedef struct vertex_t
+            struct cmd_queue_t;
+            struct trace_writer_t;
+            struct gl_ext_t;
+            struct geometry_cache_t;
+            struct frame_t;
+            struct expand_batch_t;
+            struct lod_cache_t;
+            struct occlusion_cache_t;
+            struct arena_t;
+
+            /**
+             * Geometry cache flags
+             */
+            enum cache_flags_t
+            {
+                CACHE_GEOMETRY      = 1 << 0,       // Cache buffer data in the video memory between frames
+                CACHE_OPTIMIZE      = 1 << 1,       // Reorder triangles and vertices of cached geometry for the vertex cache
+                CACHE_SORT          = 1 << 2,       // Sort triangles of cached blended buffers back-to-front
+            };
+
+            /**
+             * Maximum object identifier for picking, identifiers are encoded into 24-bit RGB color
+             */
+            constexpr uint32_t OBJECT_ID_MAX        = 0xffffff;
+
+            /**
+             * Geometry cache statistics
+             */
+            typedef struct cache_stats_t
+            {
+                size_t              nEntries;       // Number of cached buffers
+                size_t              nVertices;      // Overall number of cached vertices
+                size_t              nIndices;       // Overall number of cached indices
+                size_t              nBytes;         // Overall amount of memory used by cached data
+                size_t              nHits;          // Number of draws that used cached data
+                size_t              nMisses;        // Number of draws that caused the cache entry to be built
+                float               fAcmrBefore;    // Average cache miss ratio of cached triangles before optimization
+                float               fAcmrAfter;     // Average cache miss ratio of cached triangles after optimization
+                size_t              nSorts;         // Number of depth sortings of blended triangles
+                size_t              nSortHits;      // Number of draws that reused the previous depth order
+                size_t              nUpdates;       // Number of partial updates of cached geometry
+                size_t              nUpdatedBytes;  // Amount of vertex data uploaded by partial updates
+                size_t              nClusters;      // Overall number of clusters of cached geometry
+                size_t              nClusterTests;  // Number of clusters tested for visibility
+                size_t              nClusterCulls;  // Number of clusters culled by frustum or backface tests
+            } cache_stats_t;
+
+            /**
+             * Frame reuse statistics
+             */
+            typedef struct frame_stats_t
+            {
+                size_t              nFrames;        // Number of frames finished with frame reuse enabled
+                size_t              nDrawn;         // Number of frames drawn by OpenGL
+                size_t              nSkipped;       // Number of frames skipped because they were identical to the previous one
+            } frame_stats_t;
+
+            /**
+             * Occlusion culling statistics
+             */
+            typedef struct occlusion_stats_t
             {
-                dot4_t          v;      // Vertex
-                vec4_t          n;      // Normal
-                color_t         c;      // Color
-            } vertex_t;
+                size_t              nEntries;       // Number of tracked buffers
+                size_t              nTested;        // Number of draws tested for visibility
+                size_t              nCulled;        // Number of draws skipped as occluded
+                size_t              nQueries;       // Number of issued occlusion queries
+            } occlusion_stats_t;
+
+            /**
+             * View inside the render target for drawing of multiple views
+             */
+            typedef struct view_t
+            {
+                ssize_t             left, top;      // Top-left corner of the view inside the render target
+                ssize_t             width, height;  // Size of the view
+                r3d::mat4_t         projection;     // Projection matrix of the view
+                r3d::mat4_t         view;           // View matrix of the view
+            } view_t;
+
+            /**
+             * Output image of the tiled offscreen rendering
+             */
+            typedef struct tiled_output_t
+            {
+                void               *data;           // Pixels of the image, rows are stored top-down
+                size_t              stride;         // Distance between rows in bytes
+                ssize_t             width, height;  // Size of the image
+                r3d::pixel_format_t format;         // Pixel format
+            } tiled_output_t;
 
             typedef struct backend_t: public r3d::base_backend_t
             {
-                WCHAR              *pWndClass;      // Window class
+                bool                bWndClass;      // Flag: backend holds the reference to the shared window class
                 HWND                hWindow;        // Window instance
                 HDC                 hDC;            // Device context instance
                 HGLRC               hGL;            // OpenGL context instance
+                uint32_t            nContextId;     // Process-wide unique identifier of the OpenGL context
+                bool                bStickyContext; // Flag: keep the context current for the thread after finish()
                 bool                bDrawing;       // Flag: backend is in drawing mode
-                vertex_t           *vxBuffer;       // Temporary vertex buffer
+                arena_t            *pArena;         // Arena of temporary data, reset at the end of each frame
+
+                // Matrix state
+                r3d::mat4_t         matViewWorld;   // Product of view and world matrices
+                bool                bViewWorld;     // Flag: matViewWorld is up to date
+                r3d::mat4_t         matGLProjection;// Projection matrix loaded into the context
+                r3d::mat4_t         matGLModelView; // Model-view matrix loaded into the context
+                uint32_t            nGLMatrices;    // Flags of matrices that are valid in the context
+
+                // Threaded rendering mode
+                cmd_queue_t        *pQueue;         // Command queue, non-NULL in threaded mode
+                HANDLE              hThread;        // Render thread that owns the context
+                HANDLE              hConsumer;      // Event to wake up the render thread
+                HANDLE              hProducer;      // Event to wake up the caller thread
+                uint32_t            nConsumerWait;  // Render thread waits for commands
+                uint32_t            nProducerWait;  // Caller thread waits for free space in the queue
+                uint32_t            nSubmitted;     // Number of submitted synchronous commands
+                uint32_t            nCompleted;     // Number of completed synchronous commands
+                status_t            nAsyncError;    // Last error of asynchronous command
+
+                trace_writer_t     *pTrace;         // Trace writer, non-NULL when tracing
+
+                gl_ext_t           *pExt;           // OpenGL extensions
+                geometry_cache_t   *pCache;         // Geometry cache
+
+                // Frame reuse
+                frame_t            *pFrame;         // Recorded frame, non-NULL when frame reuse is enabled
+                uint8_t            *vPixels;        // Pixels read from the last drawn frame
+                size_t              nPixelsCap;     // Capacity of the pixel buffer
+                uint64_t            nPixelsHash;    // Hash of the frame the pixels belong to
+                r3d::pixel_format_t enPixelsFormat; // Format of the pixels
+                bool                bPixels;        // Flag: pixels are valid
+                bool                bDeferred;      // Flag: calls of the current frame are recorded, not issued
+                bool                bReused;        // Flag: pixels of the previous frame were returned for current frame
+                bool                bFrameReuse;    // Flag: frame reuse is enabled
+                uint32_t            nDataVersion;   // Version of the buffer data, changed by invalidate()
+                frame_stats_t       sFrameStats;    // Frame reuse statistics
+
+                // Multiple views
+                view_t             *vViews;         // Views inside the render target
+                size_t              nViews;         // Number of views, 0 if disabled
+                uint8_t            *vAtlas;         // Pixels of the whole render target for splitting into views
+                size_t              nAtlasCap;      // Capacity of the atlas buffer
+
+                // Picking
+                bool                bPicking;       // Flag: draw object identifiers instead of colors
+                uint32_t            nObjectId;      // Object identifier for following draws
+
+                // Expansion and decimation of lines and points
+                expand_batch_t     *pExpand;        // Batch of expanded primitives, non-NULL when expansion is enabled
+                lod_cache_t        *pLod;           // Levels of detail, non-NULL when decimation is enabled
+                ssize_t             nGLWidth;       // Width of the viewport in the context
+                ssize_t             nGLHeight;      // Height of the viewport in the context
+
+                // Occlusion culling
+                occlusion_cache_t  *pOcclusion;     // Occlusion queries of heavy buffers
+
+                // Tiled offscreen rendering
+                bool                bTiled;         // Flag: frames are drawn by tiles into the output image
+                tiled_output_t      sTiled;         // Output image
+
+                // Retained command lists
+                GLuint             *vLists;         // Display lists owned by the backend
+                size_t              nLists;         // Number of display lists
+                size_t              nListsCap;      // Capacity of the display list array
+                GLuint              nListCompile;   // Display list being recorded, 0 if none
+
+                // Reduced resolution rendering
+                float               fRenderScale;   // Scale of the render target relative to the viewport
+                uint8_t            *vScaled;        // Pixels of the scaled frame before upscaling
+                size_t              nScaledCap;     // Capacity of the scaled pixel buffer
+
+                // Post-process anti-aliasing
+                bool                bFxaa;          // Flag: FXAA pass is applied to the frame before readback
+                bool                bFxaaDone;      // Flag: FXAA pass has been applied to the current contents of the frame
+                bool                bFxaaCPU;       // Flag: shader pass is not available, read pixels are filtered by the CPU
+                GLuint              nFxaaProgram;   // Shader program of the FXAA pass, 0 if not created
+                GLint               nFxaaTexel;     // Location of the texel size uniform
+                GLuint              nFxaaTexture;   // Texture with the copy of the frame, 0 if not created
+                ssize_t             nFxaaWidth;     // Width of the texture
+                ssize_t             nFxaaHeight;    // Height of the texture
 
                 void                construct();
                 explicit            backend_t();
@@ -67,6 +233,440 @@ namespace lsp
                 static status_t     read_pixels(r3d::backend_t *handle, void *buf, r3d::pixel_format_t format);
                 static status_t     finish(r3d::backend_t *handle);
 
+                /**
+                 * Enable or disable threaded rendering mode. In threaded mode the backend
+                 * owns the render thread that holds the OpenGL context. All drawing calls
+                 * are converted into commands and passed to the render thread, the buffer
+                 * data is copied into the command queue. Only read_pixels() and sync()
+                 * wait for the render thread to complete previously submitted commands.
+                 * The mode can be changed only after initialization and outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param threaded threaded mode flag
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_threaded(r3d::backend_t *handle, bool threaded);
+
+                /**
+                 * Check that backend is in threaded rendering mode
+                 * @param handle backend handle
+                 * @return true if backend is in threaded rendering mode
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static bool         threaded(r3d::backend_t *handle);
+
+                /**
+                 * Enable or disable the sticky context. Independent backends can render in parallel,
+                 * one backend per thread: each backend owns its context and the process-wide state is
+                 * synchronized. The backend tracks the context that is current for the calling thread
+                 * and skips redundant wglMakeCurrent() calls. By default the context is released in
+                 * finish(), so the backend can be used by different threads in different frames. The
+                 * sticky context stays current for the drawing thread after finish(), and the next
+                 * frame drawn by the same thread does not switch the context at all. The sticky backend
+                 * should be used and destroyed only by the same thread, and other code should not make
+                 * other contexts current for this thread. Disabling the sticky context releases it.
+                 * Has no effect in threaded mode where the context is always held by the render thread.
+                 * The mode can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param sticky sticky context flag
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_sticky_context(r3d::backend_t *handle, bool sticky);
+
+                /**
+                 * Start capturing the trace of backend calls into the file. The trace
+                 * contains all calls that change the state of the backend or draw the
+                 * frame. Buffer data is deduplicated by the contents and stored only once.
+                 * The trace can be replayed by replay_trace() through any backend.
+                 * The tracing can be started only after initialization and outside the drawing.
+                 * Command lists are not traced: calls recorded into a list between begin_list()
+                 * and end_list() and replays of lists by draw_list() are skipped.
+                 *
+                 * @param handle backend handle
+                 * @param path path to the trace file in UTF-8 encoding
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     start_trace(r3d::backend_t *handle, const char *path);
+
+                /**
+                 * Stop capturing the trace and close the trace file
+                 * @param handle backend handle
+                 * @return status of operation, STATUS_CLOSED if tracing was not started
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     stop_trace(r3d::backend_t *handle);
+
+                /**
+                 * Set geometry cache flags. When caching is enabled, the buffer data is uploaded
+                 * into the video memory on the first draw and reused by the following draws of
+                 * the buffer with the same data and index pointers, stride, count and primitive type.
+                 * Separate normal and color indices are welded into the single index buffer.
+                 * The caller should call invalidate() when the contents of the cached data change.
+                 * The flags can be changed only after initialization and outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param flags combination of cache_flags_t, 0 disables and drops the cache
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_cache_flags(r3d::backend_t *handle, size_t flags);
+
+                /**
+                 * Invalidate cached geometry, the geometry will be rebuilt on the next draw.
+                 * Invalidation also marks the following frame as changed for the frame reuse.
+                 * @param handle backend handle
+                 * @param data pointer to the data or index array of the buffer, NULL to invalidate all entries
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     invalidate(r3d::backend_t *handle, const void *data);
+
+                /**
+                 * Get geometry cache statistics
+                 * @param handle backend handle
+                 * @param stats pointer to store statistics
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     get_cache_stats(r3d::backend_t *handle, cache_stats_t *stats);
+
+                /**
+                 * Enable or disable frame reuse. When enabled, the calls between start() and
+                 * read_pixels() are recorded and the hash of the frame inputs is computed:
+                 * background, viewport size, matrices, lights, buffer parameters and data pointers.
+                 * If the hash matches the hash of the last drawn frame, read_pixels() returns the
+                 * previously read pixels and no OpenGL work is issued for the frame. Buffer data
+                 * is not hashed, so the caller should call invalidate() when the data changes and
+                 * keep the data valid until read_pixels() or finish(). The mode can be changed
+                 * only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param enable frame reuse flag
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_frame_reuse(r3d::backend_t *handle, bool enable);
+
+                /**
+                 * Get frame reuse statistics
+                 * @param handle backend handle
+                 * @param stats pointer to store statistics
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     get_frame_stats(r3d::backend_t *handle, frame_stats_t *stats);
+
+                /**
+                 * Set views inside the render target. When views are set, the calls between start()
+                 * and read_pixels() are recorded and drawn once for each view with the viewport and
+                 * scissor rectangle of the view. The projection and view matrices of the view replace
+                 * the projection and view matrices of the backend, the world matrix of each draw is kept.
+                 * Views can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param views array of views
+                 * @param count number of views, 0 disables drawing of multiple views
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_views(r3d::backend_t *handle, const view_t *views, size_t count);
+
+                /**
+                 * Read pixels of all views with single readback of the render target
+                 * @param handle backend handle
+                 * @param bufs array of buffers, one per view, each should be of view width x height pixels
+                 * @param format pixel format
+                 * @return status of operation, STATUS_OVERFLOW if some view does not fit the render target
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     read_views(r3d::backend_t *handle, void **bufs, r3d::pixel_format_t format);
+
+                /**
+                 * Set the scale of the render target. The frame is drawn with the viewport reduced
+                 * by the scale factor, read_pixels() upscales the frame to the viewport size with
+                 * bilinear filtering. Reduced scale is useful for interactive changes of the scene,
+                 * 1.0 restores full resolution. The scale can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param scale scale factor in range (0, 1]
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_render_scale(r3d::backend_t *handle, float scale);
+
+                /**
+                 * Enable or disable picking mode. In picking mode each draw outputs the object
+                 * identifier set by set_object_id() encoded into the color, lighting and blending
+                 * are disabled and the background has zero identifier. Identifiers and depth
+                 * can be read with read_ids(). The mode can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param picking picking mode flag
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_picking(r3d::backend_t *handle, bool picking);
+
+                /**
+                 * Set the object identifier for following draws, reset to zero by start()
+                 * @param handle backend handle
+                 * @param id object identifier, not greater than OBJECT_ID_MAX
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_object_id(r3d::backend_t *handle, uint32_t id);
+
+                /**
+                 * Read object identifiers and depth values of the rectangle. Object identifiers
+                 * are valid only in picking mode, depth values are window depth values in range
+                 * [0, 1] where 1 is the depth of the background.
+                 *
+                 * @param handle backend handle
+                 * @param left left coordinate of the rectangle
+                 * @param top top coordinate of the rectangle
+                 * @param width width of the rectangle
+                 * @param height height of the rectangle
+                 * @param ids buffer of width x height elements to store object identifiers, may be NULL
+                 * @param depth buffer of width x height elements to store depth values, may be NULL
+                 * @return status of operation, STATUS_OVERFLOW if the rectangle does not fit the viewport
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     read_ids(r3d::backend_t *handle, ssize_t left, ssize_t top, ssize_t width, ssize_t height,
+                                        uint32_t *ids, float *depth);
+
+                /**
+                 * Enable or disable expansion of lines and points. When enabled, unlit lines, wireframe
+                 * triangles and points are transformed on the CPU and expanded into screen-aligned quads
+                 * of the buffer width in pixels instead of using glLineWidth() and glPointSize().
+                 * Quads of consecutive buffers with the same blending are accumulated and drawn by
+                 * a single call, the batch is drawn before any other primitive and before reading
+                 * the frame. The mode can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param expand expansion flag
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_expand_primitives(r3d::backend_t *handle, bool expand);
+
+                /**
+                 * Enable or disable decimation of large point and line buffers. On the first draw
+                 * of the buffer, levels of detail are built on the uniform grids from 2 to 1024 cells
+                 * along the largest side of the bounding box: one representative point per occupied
+                 * cell or one representative line per pair of cells. Each draw uses the coarsest level
+                 * with the projected cell size not larger than a pixel. The caller should call
+                 * invalidate() when the data changes. The mode can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param min_count minimum number of primitives in the buffer to decimate, 0 disables decimation
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_decimation(r3d::backend_t *handle, size_t min_count);
+
+                /**
+                 * Enable or disable occlusion culling of heavy buffers. Before drawing the buffer
+                 * with the number of primitives not less than the threshold, the bounding box of the
+                 * buffer is rendered with disabled color and depth writes inside the occlusion query.
+                 * The result of the query is used in the next frame, so the buffer hidden behind
+                 * previously drawn geometry is skipped with a single frame of latency and the query
+                 * never stalls the pipeline. Culling works only when the context supports occlusion
+                 * queries and multiple views are not set. The caller should draw large occluders first
+                 * and call invalidate() when the data changes. The mode can be changed only outside
+                 * the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param min_count minimum number of primitives in the buffer to test, 0 disables culling
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_occlusion_culling(r3d::backend_t *handle, size_t min_count);
+
+                /**
+                 * Get occlusion culling statistics
+                 * @param handle backend handle
+                 * @param stats pointer to store statistics
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     get_occlusion_stats(r3d::backend_t *handle, occlusion_stats_t *stats);
+
+                /**
+                 * Get statistics of the arena that holds temporary data of the frame:
+                 * converted vertex arrays, sorting buffers and scratch data of the geometry
+                 * cache and decimation. The arena is grown to the high-water mark, so the
+                 * frames that do not exceed it perform no heap allocations.
+                 *
+                 * @param handle backend handle
+                 * @param stats pointer to store statistics
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     get_arena_stats(r3d::backend_t *handle, arena_stats_t *stats);
+
+                /**
+                 * Shrink the arena of temporary data to the amount of memory used by the last frame,
+                 * can be called only outside the drawing
+                 *
+                 * @param handle backend handle
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     trim_arena(r3d::backend_t *handle);
+
+                /**
+                 * Enable or disable tiled offscreen rendering of images larger than the render
+                 * target. The frame is recorded and drawn in finish() once per tile of the output
+                 * image with the sub-frustum of the projection matrix, tiles have the size of the
+                 * render target. When pixel buffer objects are supported, readback of each tile
+                 * overlaps drawing of the next one. Tiles are written directly into the output
+                 * image which can be a memory-mapped file, so the memory used by the backend is
+                 * bounded by the tile size. read_pixels() is not available in the tiled mode.
+                 * The mode is not compatible with threaded rendering and multiple views and can
+                 * be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param output output image, NULL to disable tiled rendering
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_tiled_output(r3d::backend_t *handle, const tiled_output_t *output);
+
+                /**
+                 * Start recording of the retained command list. All following set_lights() and
+                 * draw_primitives() calls are validated and compiled into the OpenGL display list
+                 * with current matrices, flags and lights instead of drawing. The buffer data is
+                 * copied into the list, so the buffers can be changed after recording. Occlusion
+                 * culling and decimation are not applied to recorded draws. Lists can be recorded
+                 * only during the drawing in the non-threaded mode without frame reuse and
+                 * multiple views.
+                 *
+                 * @param handle backend handle
+                 * @return status of operation, STATUS_BAD_STATE in threaded mode, with frame
+                 *         reuse enabled, outside the drawing or if the list is already recorded
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     begin_list(r3d::backend_t *handle);
+
+                /**
+                 * Finish recording of the retained command list
+                 *
+                 * @param handle backend handle
+                 * @param id pointer to store identifier of the list
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     end_list(r3d::backend_t *handle, size_t *id);
+
+                /**
+                 * Replay the retained command list with a single call. The lights of the list
+                 * stay active for the following draws. The list can be replayed only during the
+                 * drawing, replaying the list while recording another list nests it. The list
+                 * can not be replayed in threaded mode or with frame reuse enabled.
+                 *
+                 * @param handle backend handle
+                 * @param id identifier of the list
+                 * @return status of operation, STATUS_BAD_STATE in threaded mode, with frame
+                 *         reuse enabled or outside the drawing, STATUS_NOT_FOUND if there is no
+                 *         such list
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     draw_list(r3d::backend_t *handle, size_t id);
+
+                /**
+                 * Destroy the retained command list, all lists are destroyed with the backend.
+                 * In threaded mode the list is deleted by the render thread.
+                 *
+                 * @param handle backend handle
+                 * @param id identifier of the list
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     destroy_list(r3d::backend_t *handle, size_t id);
+
+                /**
+                 * Read pixels of the frame in the extended output format. The frame is read from
+                 * OpenGL once and then flipped, swizzled, premultiplied and packed into the caller's
+                 * buffer in a single pass, rows are stored top-down with the specified stride.
+                 * Not available in the tiled mode.
+                 *
+                 * @param handle backend handle
+                 * @param buf destination buffer
+                 * @param stride distance between rows of the destination buffer in bytes
+                 * @param format output format
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     read_pixels_ex(r3d::backend_t *handle, void *buf, size_t stride, read_format_t format);
+
+                /**
+                 * Mark the range of elements of the vertex, normal or color data as modified.
+                 * Unlike invalidate(), cached geometry is not rebuilt: only cached vertices that
+                 * refer the range are gathered and uploaded into the existing buffer object on
+                 * the next draw. Passing the index array marks the geometry as stale.
+                 *
+                 * @param handle backend handle
+                 * @param data pointer to the data array of the buffer
+                 * @param first first modified element of the array
+                 * @param count number of modified elements
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     update_range(r3d::backend_t *handle, const void *data, size_t first, size_t count);
+
+                /**
+                 * Draw primitives of the ring buffer starting with the specified primitive. The
+                 * primitives from first to the end of the buffer are drawn first with the current
+                 * transform, then the wrapped primitives from the start of the buffer are drawn with
+                 * the additional model transform. Scrolling data is updated in place with
+                 * update_range() instead of being shifted in memory. Cached geometry of the ring
+                 * keeps the original order of primitives, blended triangles are not sorted.
+                 *
+                 * @param handle backend handle
+                 * @param buffer buffer to draw
+                 * @param first first primitive of the ring
+                 * @param wrap model transform applied to the wrapped primitives, NULL for identity
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     draw_ring(r3d::backend_t *handle, const r3d::buffer_t *buffer, size_t first, const r3d::mat4_t *wrap);
+
+                /**
+                 * Enable or disable cluster culling of large cached triangle buffers. The triangles
+                 * of the cached geometry are reordered spatially and split into clusters of about
+                 * 128 triangles with bounding spheres and normal cones. Each draw culls clusters
+                 * against the view frustum and, unless culling of faces is disabled for the buffer,
+                 * clusters that face away from the viewer, and draws only ranges of visible clusters.
+                 * Requires the geometry cache. Blended buffers that are sorted back-to-front and
+                 * draws recorded into command lists are not culled.
+                 *
+                 * @param handle backend handle
+                 * @param min_count minimum number of triangles of the clustered buffer, 0 to disable
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_cluster_culling(r3d::backend_t *handle, size_t min_count);
+
+                /**
+                 * Enable or disable fast approximate anti-aliasing of the frame. The filter is applied
+                 * by read_pixels(), read_pixels_ex() and read_views() before the readback: on the GPU
+                 * with the fragment shader when GLSL is supported, otherwise the read pixels are filtered
+                 * on the CPU. Edges are smoothed at the cost of a single pass over the frame instead of
+                 * rendering at a higher resolution. Frames with reduced render scale are filtered before
+                 * upscaling. Picking frames, read_ids() and tiled output are not filtered. The mode can
+                 * be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param enable enable anti-aliasing
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_fxaa(r3d::backend_t *handle, bool enable);
+
             } backend_t;
 
         } /* namespace wgl */
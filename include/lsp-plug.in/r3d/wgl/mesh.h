@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_R3D_WGL_MESH_H_
+#define LSP_PLUG_IN_R3D_WGL_MESH_H_
+
+#include <lsp-plug.in/r3d/wgl/version.h>
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+#include <lsp-plug.in/r3d/wgl/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            enum mesh_flags_t
+            {
+                MESH_NORMALS        = 1 << 0,       // Vertices contain normals
+                MESH_COLORS         = 1 << 1,       // Vertices contain colors
+                MESH_INDEXED        = 1 << 2        // Vertices are welded and referenced by indices
+            };
+
+            /**
+             * Mesh mapped into the memory. Vertex and index data point directly
+             * into the mapped file and stay valid until the mesh is unmapped.
+             */
+            typedef struct mesh_t
+            {
+                const vertex_t         *vertices;       // Interleaved vertices
+                const uint32_t         *indices;        // Indices of vertices, NULL if the mesh is not indexed
+                size_t                  nvertices;      // Number of vertices
+                size_t                  count;          // Number of primitives
+                r3d::primitive_type_t   type;           // Type of primitives
+                size_t                  flags;          // Combination of mesh_flags_t
+                r3d::dot4_t             min;            // Minimum corner of the bounding box
+                r3d::dot4_t             max;            // Maximum corner of the bounding box
+                void                   *mapping;        // Mapping of the file
+            } mesh_t;
+
+            /**
+             * Convert the buffer into the mesh file. Vertex attributes are gathered into
+             * the interleaved vertex_t layout, normals and colors are stored only if they
+             * are present in the buffer.
+             *
+             * @param path path to the mesh file in UTF-8 encoding
+             * @param buffer buffer to store
+             * @param flags MESH_INDEXED to weld vertices and store indices, 0 to store vertices
+             *   of primitives as is
+             * @return status of operation
+             */
+            LSP_R3D_WGL_LIB_PUBLIC
+            status_t write_mesh(const char *path, const r3d::buffer_t *buffer, size_t flags);
+
+            /**
+             * Map the mesh file into the memory. The file is validated but not parsed,
+             * so loading time does not depend on the size of the mesh.
+             *
+             * @param mesh mesh to initialize
+             * @param path path to the mesh file in UTF-8 encoding
+             * @return status of operation
+             */
+            LSP_R3D_WGL_LIB_PUBLIC
+            status_t map_mesh(mesh_t *mesh, const char *path);
+
+            /**
+             * Unmap the mesh file, all buffers that refer the mesh data become invalid
+             * @param mesh mesh to unmap
+             */
+            LSP_R3D_WGL_LIB_PUBLIC
+            void unmap_mesh(mesh_t *mesh);
+
+            /**
+             * Initialize the buffer that refers the mapped mesh data without copying.
+             * The buffer is set up with identity model matrix and no flags, the caller
+             * may adjust them before drawing. Interleaved buffers are uploaded to the
+             * geometry cache directly, without welding and gathering of vertices.
+             *
+             * @param buffer buffer to initialize
+             * @param mesh mapped mesh
+             */
+            LSP_R3D_WGL_LIB_PUBLIC
+            void mesh_buffer(r3d::buffer_t *buffer, const mesh_t *mesh);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_R3D_WGL_MESH_H_ */
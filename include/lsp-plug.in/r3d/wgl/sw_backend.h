@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_R3D_WGL_SW_BACKEND_H_
+#define LSP_PLUG_IN_R3D_WGL_SW_BACKEND_H_
+
+#include <lsp-plug.in/r3d/wgl/version.h>
+
+#include <lsp-plug.in/r3d/base/backend.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            namespace sw
+            {
+                struct raster_t;
+                struct cvertex_t;
+            } /* namespace sw */
+
+            constexpr size_t SW_MAX_LIGHTS      = 8;
+
+            /**
+             * Portable software rasterizer backend, used as a fallback when
+             * OpenGL context can not be created. Supports offscreen rendering only.
+             */
+            typedef struct sw_backend_t: public r3d::base_backend_t
+            {
+                sw::raster_t       *pRaster;        // Rasterizer
+                sw::cvertex_t      *vVertices;      // Temporary buffer of transformed vertices
+                size_t              nVertices;      // Capacity of the vertex buffer
+                r3d::light_t        vLights[SW_MAX_LIGHTS]; // Enabled lights
+                size_t              nLights;        // Number of enabled lights
+                bool                bDrawing;       // Flag: backend is in drawing mode
+                bool                bFxaa;          // Flag: FXAA filter is applied to read pixels
+                uint8_t            *vPixels;        // Temporary buffer of pixels before filtering
+                size_t              nPixelsCap;     // Capacity of the pixel buffer
+
+                void                construct();
+                explicit            sw_backend_t();
+
+                static void         destroy(r3d::backend_t *handle);
+                static status_t     init_window(r3d::backend_t *handle, void **out_window);
+                static status_t     init_offscreen(r3d::backend_t *handle);
+
+                static status_t     locate(r3d::backend_t *handle, ssize_t left, ssize_t top, ssize_t width, ssize_t height);
+                static status_t     start(r3d::backend_t *handle);
+                static status_t     set_lights(r3d::backend_t *handle, const r3d::light_t *lights, size_t count);
+                static status_t     draw_primitives(r3d::backend_t *handle, const r3d::buffer_t *buffer);
+                static status_t     sync(r3d::backend_t *handle);
+                static status_t     read_pixels(r3d::backend_t *handle, void *buf, r3d::pixel_format_t format);
+                static status_t     finish(r3d::backend_t *handle);
+
+                /**
+                 * Enable or disable fast approximate anti-aliasing of pixels returned by
+                 * read_pixels(). The filter is the same as the one of the OpenGL backend.
+                 * The mode can be changed only outside the drawing.
+                 *
+                 * @param handle backend handle
+                 * @param enable enable anti-aliasing
+                 * @return status of operation
+                 */
+                LSP_R3D_WGL_LIB_PUBLIC
+                static status_t     set_fxaa(r3d::backend_t *handle, bool enable);
+
+            } sw_backend_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_R3D_WGL_SW_BACKEND_H_ */
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_R3D_WGL_TRACE_H_
+#define LSP_PLUG_IN_R3D_WGL_TRACE_H_
+
+#include <lsp-plug.in/r3d/wgl/version.h>
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/backend.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Statistics of the trace replay
+             */
+            typedef struct trace_stats_t
+            {
+                size_t              nCalls;         // Overall number of replayed calls
+                size_t              nFrames;        // Number of replayed frames
+                size_t              nDraws;         // Number of draw_primitives() and draw_ring() calls
+                size_t              nErrors;        // Number of calls that returned error
+                uint64_t            nTotalTime;     // Overall replay time, nanoseconds
+                uint64_t            nFrameMin;      // Minimum frame time (start() .. finish()), nanoseconds
+                uint64_t            nFrameMax;      // Maximum frame time (start() .. finish()), nanoseconds
+            } trace_stats_t;
+
+            /**
+             * Replay the trace captured by backend_t::start_trace() through the backend.
+             * The trace file is memory-mapped, buffer data is passed to the backend directly
+             * from the mapped memory. The backend should be already initialized. Draws of
+             * ring buffers are replayed through backend_t::draw_ring() by the OpenGL backend,
+             * other backends draw the ring as two ranges of primitives.
+             *
+             * @param backend backend to replay the trace
+             * @param path path to the trace file in UTF-8 encoding
+             * @param stats pointer to store replay statistics, may be NULL
+             * @return status of operation
+             */
+            LSP_R3D_WGL_LIB_PUBLIC
+            status_t replay_trace(r3d::backend_t *backend, const char *path, trace_stats_t *stats);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_R3D_WGL_TRACE_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_R3D_WGL_TYPES_H_
+#define LSP_PLUG_IN_R3D_WGL_TYPES_H_
+
+#include <lsp-plug.in/r3d/wgl/version.h>
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Statistics of the frame arena of temporary data
+             */
+            typedef struct arena_stats_t
+            {
+                size_t              nCapacity;      // Capacity of the arena block
+                size_t              nHighWater;     // Maximum amount of memory used by a frame since the last trim
+                size_t              nFrameBytes;    // Maximum amount of memory used by the last frame
+                size_t              nFrameAllocs;   // Number of allocations performed by the last frame
+                size_t              nFrames;        // Number of finished frames
+                size_t              nHeapAllocs;    // Overall number of heap allocations performed by the arena
+            } arena_stats_t;
+
+            /**
+             * Output formats of the extended pixel readback
+             */
+            enum read_format_t
+            {
+                READ_RGBA,                          // 8-bit RGBA
+                READ_BGRA,                          // 8-bit BGRA
+                READ_RGB,                           // 8-bit RGB
+                READ_BGR,                           // 8-bit BGR
+                READ_RGBA_PREMUL,                   // 8-bit RGBA with premultiplied alpha
+                READ_BGRA_PREMUL,                   // 8-bit BGRA with premultiplied alpha, native format of Win32 layered windows
+                READ_RGB565                         // 16-bit packed RGB 5:6:5
+            };
+
+            typedef struct vertex_t
+            {
+                dot4_t          v;      // Vertex
+                vec4_t          n;      // Normal
+                color_t         c;      // Color
+            } vertex_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_R3D_WGL_TYPES_H_ */
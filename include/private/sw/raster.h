@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_SW_RASTER_H_
+#define PRIVATE_SW_RASTER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+#include <private/sw/workers.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            namespace sw
+            {
+                constexpr size_t TILE_SHIFT         = 6;
+                constexpr size_t TILE_SIZE          = 1 << TILE_SHIFT;  // Size of the tile in pixels
+
+                enum raster_flags_t
+                {
+                    RF_BLEND        = 1 << 0,       // Enable blending
+                    RF_STD_BLEND    = 1 << 1,       // Standard blending (src*alpha + dst*(1-alpha))
+                    RF_CULL         = 1 << 2,       // Cull back faces
+                };
+
+                /**
+                 * Vertex in the clip space
+                 */
+                typedef struct cvertex_t
+                {
+                    r3d::dot4_t     p;              // Clip-space coordinates
+                    r3d::color_t    c;              // Vertex color
+                } cvertex_t;
+
+                /**
+                 * Vertex in the screen space
+                 */
+                typedef struct svertex_t
+                {
+                    float           x, y;           // Coordinates in pixels, Y axis looks down
+                    float           z;              // Depth in range [0..1]
+                    float           iw;             // 1/w value for perspective-correct interpolation
+                    r3d::color_t    c;              // Vertex color
+                } svertex_t;
+
+                /**
+                 * Triangle prepared for rasterization
+                 */
+                typedef struct triangle_t
+                {
+                    float           e[3][3];        // Edge functions a*x + b*y + c, inside when all are non-negative
+                    float           z[3];           // Depth plane
+                    float           iw[3];          // 1/w plane
+                    float           c[4][3];        // Planes of color components divided by w
+                    int32_t         left, top;      // Top-left corner of the bounding box, inclusive
+                    int32_t         right, bottom;  // Bottom-right corner of the bounding box, exclusive
+                    uint32_t        flags;          // Rasterization flags
+                } triangle_t;
+
+                /**
+                 * Bin of triangles that overlap the tile
+                 */
+                typedef struct bin_t
+                {
+                    uint32_t       *vItems;         // Indices of triangles in order of submission
+                    size_t          nItems;         // Number of items
+                    size_t          nCapacity;      // Capacity
+                } bin_t;
+
+                /**
+                 * Tiled rasterizer. Triangles are set up and distributed between tiles
+                 * when submitted, tiles are rasterized in parallel on flush.
+                 */
+                typedef struct raster_t
+                {
+                    uint32_t       *vColor;         // Color buffer, RGBA 8 bit per component, top row first
+                    float          *vDepth;         // Depth buffer
+                    size_t          nWidth;         // Width of the frame
+                    size_t          nHeight;        // Height of the frame
+                    size_t          nTilesX;        // Number of tiles horizontally
+                    size_t          nTilesY;        // Number of tiles vertically
+                    bin_t          *vBins;          // Bins of tiles
+                    triangle_t     *vTriangles;     // Triangles pending for rasterization
+                    size_t          nTriangles;     // Number of pending triangles
+                    size_t          nTriCapacity;   // Capacity of triangle array
+                    workers_t       sWorkers;       // Worker threads
+                    bool            bWorkers;       // Workers have been started
+
+                    void            construct();
+                    void            destroy();
+
+                    /**
+                     * Resize the frame
+                     * @param width width of the frame
+                     * @param height height of the frame
+                     * @return status of operation
+                     */
+                    status_t        resize(size_t width, size_t height);
+
+                    /**
+                     * Drop all pending primitives and clear the frame
+                     * @param color background color
+                     */
+                    void            clear(const r3d::color_t *color);
+
+                    /**
+                     * Submit triangle
+                     * @param v0 first vertex
+                     * @param v1 second vertex
+                     * @param v2 third vertex
+                     * @param flags rasterization flags
+                     * @return status of operation
+                     */
+                    status_t        add_triangle(const svertex_t *v0, const svertex_t *v1, const svertex_t *v2, uint32_t flags);
+
+                    /**
+                     * Submit line as a screen-space quad
+                     * @param v0 first vertex
+                     * @param v1 second vertex
+                     * @param width width of the line in pixels
+                     * @param flags rasterization flags
+                     * @return status of operation
+                     */
+                    status_t        add_line(const svertex_t *v0, const svertex_t *v1, float width, uint32_t flags);
+
+                    /**
+                     * Submit point as a screen-space square
+                     * @param v point
+                     * @param size size of the point in pixels
+                     * @param flags rasterization flags
+                     * @return status of operation
+                     */
+                    status_t        add_point(const svertex_t *v, float size, uint32_t flags);
+
+                    /**
+                     * Rasterize all pending primitives
+                     */
+                    void            flush();
+
+                    /**
+                     * Drop all pending primitives
+                     */
+                    void            reset();
+
+                    /**
+                     * Read the frame contents
+                     * @param buf destination buffer
+                     * @param format pixel format
+                     * @return status of operation
+                     */
+                    status_t        read(void *buf, r3d::pixel_format_t format);
+                } raster_t;
+
+            } /* namespace sw */
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_SW_RASTER_H_ */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_SW_WORKERS_H_
+#define PRIVATE_SW_WORKERS_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            namespace sw
+            {
+            #ifdef PLATFORM_WINDOWS
+                typedef SRWLOCK             mutex_t;
+                typedef CONDITION_VARIABLE  cond_t;
+                typedef HANDLE              thread_t;
+            #else
+                typedef pthread_mutex_t     mutex_t;
+                typedef pthread_cond_t      cond_t;
+                typedef pthread_t           thread_t;
+            #endif /* PLATFORM_WINDOWS */
+
+                /**
+                 * Task executed by workers
+                 * @param arg task argument
+                 * @param index index of the item to process
+                 */
+                typedef void (* task_t)(void *arg, size_t index);
+
+                /**
+                 * Simple pool of worker threads that executes the parallel loop
+                 * over the set of independent items. The calling thread also
+                 * participates in processing.
+                 */
+                typedef struct workers_t
+                {
+                    thread_t           *vThreads;       // Worker threads
+                    size_t              nThreads;       // Number of worker threads
+                    mutex_t             sMutex;         // Mutex
+                    cond_t              sStart;         // Start condition
+                    cond_t              sDone;          // Completion condition
+                    task_t              pTask;          // Current task
+                    void               *pArg;           // Argument of the current task
+                    uint32_t            nItems;         // Number of items to process
+                    uint32_t            nNext;          // Next item to process
+                    uint32_t            nPending;       // Number of threads still processing items
+                    uint32_t            nGeneration;    // Generation of the task
+                    bool                bExit;          // Exit flag
+
+                    void                construct();
+                    void                destroy();
+
+                    /**
+                     * Start worker threads
+                     * @param threads number of additional worker threads, 0 means
+                     *   the number of processors minus one
+                     * @return status of operation
+                     */
+                    status_t            init(size_t threads);
+
+                    /**
+                     * Execute the task for each item and wait for completion
+                     * @param task task to execute
+                     * @param arg task argument
+                     * @param items number of items
+                     */
+                    void                run(task_t task, void *arg, size_t items);
+
+                    /**
+                     * Get the number of processors available in the system
+                     * @return number of processors
+                     */
+                    static size_t       processors();
+                } workers_t;
+
+            } /* namespace sw */
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_SW_WORKERS_H_ */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_ARENA_H_
+#define PRIVATE_WGL_ARENA_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/wgl/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t ARENA_ALIGN            = 0x10;     // Default alignment of allocations
+            constexpr size_t ARENA_GRANULE          = 0x10000;  // Granularity of the arena capacity
+            constexpr size_t ARENA_MIN_CHUNK        = 0x10000;  // Minimum size of the overflow chunk
+
+            /**
+             * Overflow chunk, allocated when the allocation does not fit into the arena block
+             */
+            typedef struct arena_chunk_t
+            {
+                arena_chunk_t      *pNext;          // Previously allocated chunk
+                size_t              nBase;          // Amount of arena memory used before the chunk
+                size_t              nUsed;          // Number of used bytes of the chunk
+                size_t              nCapacity;      // Capacity of the chunk
+            } arena_chunk_t;
+
+            /**
+             * Position of the arena to roll back temporary allocations
+             */
+            typedef size_t          arena_mark_t;
+
+            /**
+             * Linear allocator of temporary data. All memory is released at once by reset()
+             * at the end of the frame or by release() to the previously taken mark. When the
+             * allocation does not fit into the arena block, the overflow chunk is allocated
+             * from the heap and the block is grown to the high-water mark on reset(), so the
+             * steady-state frames do not access the heap at all.
+             */
+            typedef struct arena_t
+            {
+                uint8_t            *vData;          // Arena block
+                size_t              nUsed;          // Number of used bytes of the block
+                size_t              nCapacity;      // Capacity of the block
+                arena_chunk_t      *pOverflow;      // List of overflow chunks, most recent first
+                size_t              nTotal;         // Overall amount of used memory
+                size_t              nPeak;          // Maximum amount of used memory during the current frame
+                size_t              nHighWater;     // Maximum amount of used memory since the last trim
+                size_t              nAllocs;        // Number of allocations during the current frame
+                arena_stats_t       sStats;         // Statistics
+
+                void                construct();
+                void                destroy();
+
+                /**
+                 * Allocate memory
+                 * @param size size of memory to allocate
+                 * @param align alignment, power of 2
+                 * @return pointer to memory or NULL on error
+                 */
+                void               *alloc(size_t size, size_t align = ARENA_ALIGN);
+
+                template <class T>
+                inline T           *alloc(size_t count)
+                {
+                    return static_cast<T *>(alloc(count * sizeof(T), (alignof(T) > ARENA_ALIGN) ? alignof(T) : ARENA_ALIGN));
+                }
+
+                /**
+                 * Get the current position of the arena
+                 * @return current position
+                 */
+                inline arena_mark_t mark() const    { return nTotal; }
+
+                /**
+                 * Release all allocations performed after taking the mark
+                 * @param mark position of the arena
+                 */
+                void                release(arena_mark_t mark);
+
+                /**
+                 * Release all allocations at the end of the frame and grow the arena
+                 * block to the high-water mark if it has overflowed
+                 */
+                void                reset();
+
+                /**
+                 * Shrink the arena block to the amount of memory used by the last frame,
+                 * should be called outside of the frame
+                 */
+                void                trim();
+
+                void                get_stats(arena_stats_t *stats);
+            } arena_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_ARENA_H_ */
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_CACHE_H_
+#define PRIVATE_WGL_CACHE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/wgl/backend.h>
+#include <private/wgl/arena.h>
+#include <private/wgl/cluster.h>
+#include <private/wgl/ext.h>
+#include <private/wgl/weld.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t CACHE_BINS             = 0x100;    // Number of hash bins, power of 2
+            constexpr size_t CACHE_MAX_AGE          = 0x100;    // Number of frames the unused entry is kept
+            constexpr float CACHE_SORT_EPSILON      = 1e-4f;    // Relative change of the depth row that requires sorting
+            constexpr size_t CACHE_UPDATE_GAP       = 0x10;     // Maximum number of unchanged vertices merged into the uploaded run
+
+            /**
+             * Range of modified elements of the source array
+             */
+            typedef struct dirty_t
+            {
+                size_t              first;          // First modified element
+                size_t              last;           // Element after the last modified one, the range is empty if first >= last
+            } dirty_t;
+
+            /**
+             * Cached geometry of the buffer
+             */
+            typedef struct geometry_t
+            {
+                geometry_t         *pNext;          // Next entry in the hash bin
+
+                // Key
+                const void         *pVData;         // Vertex data
+                const void         *pNData;         // Normal data
+                const void         *pCData;         // Color data
+                const uint32_t     *pVIndex;        // Vertex indices
+                const uint32_t     *pNIndex;        // Normal indices
+                const uint32_t     *pCIndex;        // Color indices
+                size_t              nVStride;       // Vertex stride
+                size_t              nNStride;       // Normal stride
+                size_t              nCStride;       // Color stride
+                size_t              nCount;         // Number of vertices referenced by primitives
+                uint32_t            nType;          // Primitive type
+                uint32_t            nHash;          // Hash of the key
+                uint32_t            nVersion;       // Version stamp, entry is stale if differs from cache version
+                size_t              nLastFrame;     // Last frame the entry has been used
+
+                // Contents
+                GLuint              nVBO;           // Vertex buffer object, 0 if not supported
+                GLuint              nIBO;           // Index buffer object, 0 if not supported
+                vertex_t           *vVertices;      // Vertex data, NULL if stored in VBO
+                uint32_t           *vIndices;       // Index data
+                remap_t            *vRemap;         // Source of each vertex
+                size_t              nVertices;      // Number of unique vertices
+                size_t              nBytes;         // Amount of memory used
+                float               fAcmrBefore;    // Average cache miss ratio before optimization
+                float               fAcmrAfter;     // Average cache miss ratio after optimization
+
+                // Depth sorting
+                float              *vCentroids;     // Centroids of triangles in model space: X, Y and Z arrays
+                uint32_t           *vSorted;        // Indices of triangles sorted back-to-front
+                float               vSortRow[4];    // Depth row of the model-view matrix used for sorting
+                bool                bSorted;        // Index buffer object contains sorted indices
+
+                // Partial updates
+                dirty_t             vDirty[3];      // Modified ranges of vertex, normal and color data
+                bool                bDirty;         // The entry has modified ranges
+                bool                bOrdered;       // Primitives are stored in the original order
+
+                // Cluster culling
+                cluster_set_t      *pClusters;      // Clusters of triangles, NULL if not clustered
+            } geometry_t;
+
+            /**
+             * Cache of geometry stored in the video memory. Should be accessed only
+             * by the thread that owns the OpenGL context.
+             */
+            typedef struct geometry_cache_t
+            {
+                geometry_t         *vBins[CACHE_BINS];  // Hash bins
+                size_t              nFlags;         // Cache flags
+                uint32_t            nVersion;       // Current version stamp
+                size_t              nFrame;         // Frame counter
+                size_t              nEntries;       // Number of entries
+                size_t              nHits;          // Number of cache hits
+                size_t              nMisses;        // Number of cache misses
+                size_t              nSorts;         // Number of depth sortings
+                size_t              nSortHits;      // Number of reused depth orders
+                size_t              nUpdates;       // Number of partial updates
+                size_t              nUpdatedBytes;  // Amount of vertex data uploaded by partial updates
+                size_t              nClusterMin;    // Minimum number of triangles of clustered geometry, 0 if disabled
+                size_t              nClusterTests;  // Number of tested clusters
+                size_t              nClusterCulls;  // Number of culled clusters
+
+                void                construct();
+
+                /**
+                 * Drop all entries, should be called with the current OpenGL context
+                 * @param ext OpenGL extensions
+                 */
+                void                destroy(const gl_ext_t *ext);
+
+                /**
+                 * Find the cache entry for the buffer or build it
+                 * @param ext OpenGL extensions
+                 * @param key buffer supplied by the caller, used as key
+                 * @param data buffer that contains actual data, may differ from key in threaded mode
+                 * @param count number of vertices referenced by primitives
+                 * @param ordered primitives should be kept in the original order
+                 * @param arena arena for temporary data
+                 * @return cache entry or NULL on error
+                 */
+                geometry_t         *get(const gl_ext_t *ext, const r3d::buffer_t *key, const r3d::buffer_t *data, size_t count,
+                                        bool ordered, arena_t *arena);
+
+                /**
+                 * Prepare indices of the entry for drawing: sort triangles back-to-front
+                 * for blended drawing or restore the original order. The previous order
+                 * is reused if the depth row of the model-view matrix did not change.
+                 *
+                 * @param ext OpenGL extensions
+                 * @param g cache entry
+                 * @param data buffer that contains actual data
+                 * @param mv model-view matrix, NULL to restore the original order
+                 * @param arena arena for temporary data
+                 * @return pointer to the client-side index data
+                 */
+                const uint32_t     *prepare_indices(const gl_ext_t *ext, geometry_t *g, const r3d::buffer_t *data, const r3d::mat4_t *mv,
+                                        arena_t *arena);
+
+                /**
+                 * Mark entries that refer the data as stale
+                 * @param data pointer to the data or index array, NULL for all entries
+                 */
+                void                invalidate(const void *data);
+
+                /**
+                 * Mark the range of elements of the vertex, normal or color data as modified.
+                 * Only vertices that refer the range are uploaded on the next use of the entry.
+                 * Entries that use the data as indices are marked as stale.
+                 *
+                 * @param data pointer to the data array
+                 * @param first first modified element
+                 * @param count number of modified elements
+                 */
+                void                update(const void *data, size_t first, size_t count);
+
+                /**
+                 * Start new frame and release entries that were not used for a long time
+                 * @param ext OpenGL extensions
+                 */
+                void                next_frame(const gl_ext_t *ext);
+
+                /**
+                 * Get cache statistics
+                 * @param stats pointer to store statistics
+                 */
+                void                get_stats(cache_stats_t *stats);
+            } geometry_cache_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_CACHE_H_ */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_CLUSTER_H_
+#define PRIVATE_WGL_CLUSTER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+#include <private/wgl/arena.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t CLUSTER_TRIANGLES      = 128;      // Number of triangles in the cluster
+            constexpr float CLUSTER_NO_CONE         = 2.0f;     // Cutoff of the normal cone that never culls
+
+            /**
+             * Range of indices of visible clusters
+             */
+            typedef struct cluster_range_t
+            {
+                uint32_t            first;          // First index
+                uint32_t            count;          // Number of indices
+            } cluster_range_t;
+
+            /**
+             * View parameters of the cluster culling in model space
+             */
+            typedef struct cluster_view_t
+            {
+                float               vPlanes[6][4];  // Normalized frustum planes, the inner side is positive
+                float               vEye[4];        // Eye position (w = 1) or negated view direction (w = 0)
+                bool                bCones;         // Flag: perform backface culling with normal cones
+            } cluster_view_t;
+
+            /**
+             * Clusters of triangles: consecutive runs of CLUSTER_TRIANGLES triangles of the
+             * index buffer with bounding spheres and normal cones stored as separate arrays,
+             * so four clusters are tested at once with SIMD instructions.
+             */
+            typedef struct cluster_set_t
+            {
+                float              *vCX, *vCY, *vCZ;    // Centers of bounding spheres
+                float              *vRadius;            // Radii of bounding spheres
+                float              *vAX, *vAY, *vAZ;    // Axes of normal cones
+                float              *vCutoff;            // Sines of half-angles of normal cones, CLUSTER_NO_CONE if not applicable
+                size_t              nClusters;          // Number of clusters
+                size_t              nCount;             // Number of indices
+                uint8_t            *pData;              // Allocated data
+
+                void                construct();
+                void                destroy();
+
+                /**
+                 * Split triangles into clusters and compute bounds of each cluster
+                 * @param vertices vertex positions
+                 * @param stride stride between vertex positions in bytes, 0 for tightly packed
+                 * @param indices triangle indices
+                 * @param count number of indices, multiple of 3
+                 * @return status of operation
+                 */
+                status_t            build(const r3d::dot4_t *vertices, size_t stride, const uint32_t *indices, size_t count);
+
+                /**
+                 * Cull clusters against the view and build the list of index ranges of visible
+                 * clusters, adjacent visible clusters are merged into one range
+                 * @param ranges array to store ranges, should hold at least (nClusters + 1) / 2 elements
+                 * @param view view parameters
+                 * @param visible pointer to store number of visible clusters, may be NULL
+                 * @return number of ranges
+                 */
+                size_t              cull(cluster_range_t *ranges, const cluster_view_t *view, size_t *visible) const;
+            } cluster_set_t;
+
+            /**
+             * Reorder triangles along the Morton curve of their centroids, so consecutive
+             * runs of triangles form spatially compact clusters
+             * @param indices triangle indices to reorder
+             * @param count number of indices, multiple of 3
+             * @param vertices vertex positions
+             * @param stride stride between vertex positions in bytes, 0 for tightly packed
+             * @param arena arena for temporary data
+             * @return status of operation
+             */
+            status_t    cluster_sort(uint32_t *indices, size_t count, const r3d::dot4_t *vertices, size_t stride, arena_t *arena);
+
+            /**
+             * Compute view parameters of the cluster culling in model space
+             * @param view view parameters to compute
+             * @param projection projection matrix
+             * @param modelview model-view matrix
+             * @param cones perform backface culling of counter-clockwise triangles with normal cones
+             */
+            void        cluster_view(cluster_view_t *view, const r3d::mat4_t *projection, const r3d::mat4_t *modelview, bool cones);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_CLUSTER_H_ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_DECIMATE_H_
+#define PRIVATE_WGL_DECIMATE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+#include <private/wgl/arena.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t LOD_BINS               = 0x40;     // Number of hash bins, power of 2
+            constexpr size_t LOD_MAX_AGE            = 0x100;    // Number of frames the unused entry is kept
+            constexpr size_t LOD_MAX_LEVELS         = 10;       // Maximum number of levels, the finest grid is 1024 cells per axis
+            constexpr float LOD_CELL_PIXELS         = 1.0f;     // Maximum projected size of the cell in pixels
+
+            /**
+             * Level of detail: primitives that represent cells of the uniform grid
+             */
+            typedef struct lod_level_t
+            {
+                float               fCellSize;      // Size of the cell in model space
+                size_t              nCount;         // Number of primitives
+                uint32_t           *vVIndex;        // Vertex indices
+                uint32_t           *vNIndex;        // Normal indices, NULL if not required
+                uint32_t           *vCIndex;        // Color indices, NULL if not required
+            } lod_level_t;
+
+            /**
+             * Levels of detail of the point or line buffer, ordered from the coarsest one
+             */
+            typedef struct lod_t
+            {
+                lod_t              *pNext;          // Next entry in the hash bin
+
+                // Key
+                const void         *pVData;         // Vertex data
+                const uint32_t     *pVIndex;        // Vertex indices
+                const uint32_t     *pNIndex;        // Normal indices
+                const uint32_t     *pCIndex;        // Color indices
+                size_t              nVStride;       // Vertex stride
+                size_t              nCount;         // Number of primitives
+                uint32_t            nType;          // Primitive type
+                size_t              nLastFrame;     // Last frame the entry has been used
+
+                // Contents
+                r3d::dot4_t         sCenter;        // Center of the bounding box
+                float               fExtent;        // Maximum size of the bounding box
+                lod_level_t         vLevels[LOD_MAX_LEVELS];
+                size_t              nLevels;        // Number of levels
+            } lod_t;
+
+            /**
+             * Cache of levels of detail for decimation of large point and line buffers.
+             * Each level keeps one representative point per occupied grid cell or one
+             * representative line per pair of cells. Should be accessed only by the
+             * thread that draws the buffers.
+             */
+            typedef struct lod_cache_t
+            {
+                lod_t              *vBins[LOD_BINS];    // Hash bins
+                size_t              nMinCount;      // Minimum number of primitives in the decimated buffer
+                size_t              nFrame;         // Frame counter
+                size_t              nEntries;       // Number of entries
+
+                void                construct();
+                void                destroy();
+
+                /**
+                 * Select the level of detail of the buffer for drawing, build levels on the first use
+                 * @param dst buffer to store the decimated buffer
+                 * @param key buffer supplied by the caller, used as key
+                 * @param data buffer that contains actual data, may differ from key in threaded mode
+                 * @param mvp product of projection, view, world and model matrices
+                 * @param width width of the viewport in pixels
+                 * @param height height of the viewport in pixels
+                 * @param arena arena for temporary data
+                 * @return true if the decimated buffer should be drawn instead of the original one
+                 */
+                bool                decimate(r3d::buffer_t *dst, const r3d::buffer_t *key, const r3d::buffer_t *data,
+                                        const r3d::mat4_t *mvp, ssize_t width, ssize_t height, arena_t *arena);
+
+                /**
+                 * Drop levels of buffers that refer the data
+                 * @param data pointer to the vertex data or index array, NULL to drop all entries
+                 */
+                void                invalidate(const void *data);
+
+                /**
+                 * Advance the frame counter and drop entries unused for a long time
+                 */
+                void                next_frame();
+            } lod_cache_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_DECIMATE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_EXPAND_H_
+#define PRIVATE_WGL_EXPAND_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Vertex of the expanded geometry, the position is in clip coordinates
+             */
+            typedef struct expand_vertex_t
+            {
+                r3d::dot4_t         v;              // Position in clip coordinates
+                r3d::color_t        c;              // Color
+            } expand_vertex_t;
+
+            /**
+             * Batch of lines and points expanded into screen-aligned quads. Quads of buffers
+             * with different widths are accumulated in the single triangle array which is
+             * drawn by one call with identity matrices.
+             */
+            typedef struct expand_batch_t
+            {
+                expand_vertex_t    *vVertices;      // Vertices of triangles
+                size_t              nVertices;      // Number of vertices
+                size_t              nCapacity;      // Capacity of the vertex array
+                r3d::dot4_t        *vPoints;        // Temporary array of transformed points
+                size_t              nPoints;        // Capacity of the point array
+                size_t              nFlags;         // Blending flags of the batched buffers
+
+                void                construct();
+                void                destroy();
+
+                inline void         clear()         { nVertices = 0; }
+
+                /**
+                 * Expand lines, wireframe triangles or points of the buffer and add them to the batch
+                 * @param buffer buffer to expand
+                 * @param mvp product of projection and model-view matrices
+                 * @param width width of the viewport in pixels
+                 * @param height height of the viewport in pixels
+                 * @return status of operation
+                 */
+                status_t            add(const r3d::buffer_t *buffer, const r3d::mat4_t *mvp, ssize_t width, ssize_t height);
+            } expand_batch_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_EXPAND_H_ */
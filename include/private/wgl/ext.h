@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_EXT_H_
+#define PRIVATE_WGL_EXT_H_
+
+#include <lsp-plug.in/common/types.h>
+
+#include <windows.h>
+#include <gl/gl.h>
+#include <gl/glext.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Table of OpenGL functions that are not exported by opengl32.dll
+             * and should be obtained by wglGetProcAddress() for the current context
+             */
+            typedef struct gl_ext_t
+            {
+                bool                            bLoaded;        // Extensions have been loaded
+                bool                            bVBO;           // Vertex buffer objects are supported
+                bool                            bOcclusion;     // Occlusion queries are supported
+                bool                            bPBO;           // Pixel buffer objects are supported
+                bool                            bShaders;       // GLSL shader programs are supported
+
+                // Vertex buffer objects
+                PFNGLGENBUFFERSPROC             glGenBuffers;
+                PFNGLDELETEBUFFERSPROC          glDeleteBuffers;
+                PFNGLBINDBUFFERPROC             glBindBuffer;
+                PFNGLBUFFERDATAPROC             glBufferData;
+                PFNGLBUFFERSUBDATAPROC          glBufferSubData;
+
+                // Pixel buffer objects, use functions of vertex buffer objects
+                PFNGLMAPBUFFERPROC              glMapBuffer;
+                PFNGLUNMAPBUFFERPROC            glUnmapBuffer;
+
+                // Occlusion queries
+                PFNGLGENQUERIESPROC             glGenQueries;
+                PFNGLDELETEQUERIESPROC          glDeleteQueries;
+                PFNGLBEGINQUERYPROC             glBeginQuery;
+                PFNGLENDQUERYPROC               glEndQuery;
+                PFNGLGETQUERYOBJECTUIVPROC      glGetQueryObjectuiv;
+
+                // Shader programs
+                PFNGLCREATESHADERPROC           glCreateShader;
+                PFNGLDELETESHADERPROC           glDeleteShader;
+                PFNGLSHADERSOURCEPROC           glShaderSource;
+                PFNGLCOMPILESHADERPROC          glCompileShader;
+                PFNGLGETSHADERIVPROC            glGetShaderiv;
+                PFNGLCREATEPROGRAMPROC          glCreateProgram;
+                PFNGLDELETEPROGRAMPROC          glDeleteProgram;
+                PFNGLATTACHSHADERPROC           glAttachShader;
+                PFNGLLINKPROGRAMPROC            glLinkProgram;
+                PFNGLGETPROGRAMIVPROC           glGetProgramiv;
+                PFNGLUSEPROGRAMPROC             glUseProgram;
+                PFNGLGETUNIFORMLOCATIONPROC     glGetUniformLocation;
+                PFNGLUNIFORM1IPROC              glUniform1i;
+                PFNGLUNIFORM2FPROC              glUniform2f;
+
+                void                            construct();
+
+                /**
+                 * Load extensions, should be called with the current OpenGL context
+                 */
+                void                            init();
+            } gl_ext_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_EXT_H_ */
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_FRAME_H_
+#define PRIVATE_WGL_FRAME_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t FRAME_ALIGN            = 16;
+
+            enum frame_record_type_t
+            {
+                FRAME_LIGHTS,
+                FRAME_DRAW
+            };
+
+            /**
+             * Rotation of the order of primitives for drawing of the ring buffer
+             */
+            typedef struct ring_t
+            {
+                size_t              first;          // First primitive of the ring, 0 if not rotated
+                r3d::mat4_t         wrap;           // Model transform of the wrapped primitives
+            } ring_t;
+
+            typedef struct frame_record_t
+            {
+                uint32_t            type;           // Type of record
+                uint32_t            size;           // Size of record including header and padding
+            } frame_record_t;
+
+            typedef struct frame_lights_t
+            {
+                frame_record_t      hdr;
+                size_t              count;          // Number of lights
+                // Followed by lights, the record may move on reallocation so no pointers are stored
+            } frame_lights_t;
+
+            typedef struct frame_draw_t
+            {
+                frame_record_t      hdr;
+                r3d::mat4_t         projection;     // Projection matrix
+                r3d::mat4_t         view_world;     // Product of view and world matrices
+                r3d::mat4_t         world;          // World matrix, used for drawing of multiple views
+                r3d::buffer_t       buffer;         // Buffer that refers the caller's data
+                ring_t              ring;           // Rotation of the ring buffer
+            } frame_draw_t;
+
+            /**
+             * Recorded frame. Stores the calls issued between start() and the first
+             * read_pixels() or finish() and computes the rolling hash of the frame
+             * inputs. Buffer data is not copied, it is identified by the pointers
+             * and the data version which is changed by the caller on invalidation.
+             */
+            typedef struct frame_t
+            {
+                uint8_t            *vData;          // Recorded calls
+                size_t              nSize;          // Size of recorded data
+                size_t              nCapacity;      // Capacity of the data buffer
+                uint64_t            nHash;          // Hash of the frame inputs
+
+                void                construct();
+                void                destroy();
+
+                /**
+                 * Drop recorded calls and start hashing of the new frame
+                 * @param bg background color
+                 * @param width width of the viewport
+                 * @param height height of the viewport
+                 * @param version version of the buffer data
+                 */
+                void                clear(const r3d::color_t *bg, ssize_t width, ssize_t height, uint32_t version);
+
+                /**
+                 * Add the data without padding bytes to the hash of the frame inputs
+                 * @param data data to add
+                 * @param size size of data in bytes, the tail shorter than 4 bytes is zero-padded
+                 */
+                void                add_hash(const void *data, size_t size);
+
+                status_t            add_lights(const r3d::light_t *lights, size_t count);
+                status_t            add_draw(const r3d::buffer_t *buffer, const r3d::mat4_t *projection,
+                                        const r3d::mat4_t *view_world, const r3d::mat4_t *world, const ring_t *ring,
+                                        uint32_t object_id);
+
+                static inline const r3d::light_t *lights(const frame_lights_t *rec)
+                {
+                    size_t offset = (sizeof(frame_lights_t) + FRAME_ALIGN - 1) & ~(FRAME_ALIGN - 1);
+                    return reinterpret_cast<const r3d::light_t *>(reinterpret_cast<const uint8_t *>(rec) + offset);
+                }
+
+                inline frame_record_t  *first()
+                {
+                    return (nSize > 0) ? reinterpret_cast<frame_record_t *>(vData) : NULL;
+                }
+
+                inline frame_record_t  *next(frame_record_t *rec)
+                {
+                    uint8_t *ptr = reinterpret_cast<uint8_t *>(rec) + rec->size;
+                    return (ptr < &vData[nSize]) ? reinterpret_cast<frame_record_t *>(ptr) : NULL;
+                }
+            } frame_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_FRAME_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_FXAA_H_
+#define PRIVATE_WGL_FXAA_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <private/wgl/arena.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr float FXAA_EDGE_MIN           = 1.0f / 16.0f;     // Minimum local contrast of the edge
+            constexpr float FXAA_EDGE_THRESHOLD     = 1.0f / 8.0f;      // Minimum local contrast relative to the maximum luma
+            constexpr float FXAA_REDUCE_MIN         = 1.0f / 128.0f;    // Minimum reduction of the edge direction
+            constexpr float FXAA_REDUCE_MUL         = 1.0f / 8.0f;      // Reduction of the edge direction relative to the luma
+            constexpr float FXAA_SPAN_MAX           = 8.0f;             // Maximum length of the edge direction in pixels
+
+            /**
+             * Get the source of the fragment shader that performs the same FXAA pass
+             * on the GPU. The shader expects the frame in the texture unit 0 bound to
+             * the "frame" sampler and the size of the texel in the "texel" uniform.
+             *
+             * @return source of the fragment shader
+             */
+            const char *fxaa_shader();
+
+            /**
+             * Apply the fast approximate anti-aliasing to the 8-bit image. The luma is
+             * computed as (R + 2G + B) / 4, so the filter does not depend on the order
+             * of color channels and the orientation of rows. Pixels with low local
+             * contrast are copied as is, pixels on edges are blended along the edge.
+             * Alpha channel of 4-byte pixels is copied as is.
+             *
+             * @param dst destination image, should not overlap the source image
+             * @param dst_stride stride between rows of the destination image in bytes
+             * @param src source image
+             * @param src_stride stride between rows of the source image in bytes
+             * @param width width of the image
+             * @param height height of the image
+             * @param bpp number of bytes per pixel, 3 or 4
+             * @param arena arena for temporary data
+             * @return status of operation
+             */
+            status_t    fxaa(
+                uint8_t *dst, size_t dst_stride,
+                const uint8_t *src, size_t src_stride,
+                size_t width, size_t height, size_t bpp,
+                arena_t *arena);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_FXAA_H_ */
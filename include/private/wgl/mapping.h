@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_MAPPING_H_
+#define PRIVATE_WGL_MAPPING_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+#include <stdio.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Read-only memory mapping of the whole file
+             */
+            typedef struct mapping_t
+            {
+                const uint8_t      *pData;          // Mapped data
+                size_t              nSize;          // Size of the file
+            #ifdef PLATFORM_WINDOWS
+                HANDLE              hFile;
+                HANDLE              hMapping;
+            #else
+                int                 nFD;
+            #endif /* PLATFORM_WINDOWS */
+            } mapping_t;
+
+            /**
+             * Map the file into the memory for reading
+             * @param m mapping to initialize
+             * @param path path to the file in UTF-8 encoding
+             * @return status of operation, the mapping does not need to be released on error
+             */
+            status_t    map_file(mapping_t *m, const char *path);
+
+            /**
+             * Release the memory mapping and close the file
+             * @param m mapping to release
+             */
+            void        unmap_file(mapping_t *m);
+
+            /**
+             * Open the file using the UTF-8 encoded path
+             * @param path path to the file in UTF-8 encoding
+             * @param mode open mode as for fopen()
+             * @return file descriptor or NULL on error
+             */
+            FILE       *open_file(const char *path, const char *mode);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_MAPPING_H_ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_WGL_MATRIX_H_
+#define PRIVATE_WGL_MATRIX_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Matrices are stored in column-major order as OpenGL expects
+             */
+
+            /**
+             * Compute the product of two matrices: r = a * b
+             * @param r destination matrix, may not alias the arguments
+             * @param a left matrix
+             * @param b right matrix
+             */
+            void matrix_mul(r3d::mat4_t *r, const r3d::mat4_t *a, const r3d::mat4_t *b);
+
+            /**
+             * Set the identity matrix
+             * @param r destination matrix
+             */
+            void matrix_identity(r3d::mat4_t *r);
+
+            /**
+             * Transform the point: r = m * v
+             * @param r destination point, may not alias the argument
+             * @param m transformation matrix
+             * @param v point to transform
+             */
+            inline void matrix_apply(r3d::dot4_t *r, const r3d::mat4_t *m, const r3d::dot4_t *v)
+            {
+                const float *x  = m->m;
+                r->x    = x[0] * v->x + x[4] * v->y + x[8]  * v->z + x[12] * v->w;
+                r->y    = x[1] * v->x + x[5] * v->y + x[9]  * v->z + x[13] * v->w;
+                r->z    = x[2] * v->x + x[6] * v->y + x[10] * v->z + x[14] * v->w;
+                r->w    = x[3] * v->x + x[7] * v->y + x[11] * v->z + x[15] * v->w;
+            }
+
+            /**
+             * Transform the array of points in place: v[i] = m * v[i]
+             * @param v array of points
+             * @param m transformation matrix
+             * @param count number of points
+             */
+            void matrix_apply_array(r3d::dot4_t *v, const r3d::mat4_t *m, size_t count);
+
+            /**
+             * Transform the vector by the upper 3x3 part of the matrix: r = m * v
+             * @param r destination vector, may not alias the argument
+             * @param m transformation matrix
+             * @param v vector to transform
+             */
+            inline void matrix_apply3(r3d::vec4_t *r, const r3d::mat4_t *m, const r3d::vec4_t *v)
+            {
+                const float *x  = m->m;
+                r->dx   = x[0] * v->dx + x[4] * v->dy + x[8]  * v->dz;
+                r->dy   = x[1] * v->dx + x[5] * v->dy + x[9]  * v->dz;
+                r->dz   = x[2] * v->dx + x[6] * v->dy + x[10] * v->dz;
+                r->dw   = 0.0f;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_MATRIX_H_ */
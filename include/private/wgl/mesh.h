@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_MESH_H_
+#define PRIVATE_WGL_MESH_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /*
+             * Mesh file layout. The file starts with mesh_file_t header followed by
+             * the vertex section with interleaved vertex_t elements and optional index
+             * section with 32-bit indices. Sections are aligned to MESH_ALIGN bytes, so
+             * the data is properly aligned when the file is memory-mapped and can be
+             * passed to the backend as is. All values are stored in the native byte order
+             * of the machine that wrote the mesh.
+             */
+            constexpr uint32_t MESH_MAGIC           = 0x4d443352;   // 'R3DM'
+            constexpr uint32_t MESH_VERSION         = 1;
+            constexpr size_t MESH_ALIGN             = 64;
+
+            typedef struct mesh_file_t
+            {
+                uint32_t            magic;          // MESH_MAGIC
+                uint32_t            version;        // MESH_VERSION
+                uint32_t            type;           // Primitive type
+                uint32_t            flags;          // Combination of mesh_flags_t
+                uint64_t            count;          // Number of primitives
+                uint64_t            vertices;       // Number of vertices
+                uint64_t            indices;        // Number of indices, 0 if not indexed
+                uint64_t            vertex_offset;  // Offset of the vertex section
+                uint64_t            index_offset;   // Offset of the index section, 0 if not indexed
+                float               min[4];         // Minimum corner of the bounding box
+                float               max[4];         // Maximum corner of the bounding box
+            } mesh_file_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_MESH_H_ */
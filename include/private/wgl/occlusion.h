@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_OCCLUSION_H_
+#define PRIVATE_WGL_OCCLUSION_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/wgl/backend.h>
+#include <private/wgl/ext.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t OCCLUSION_BINS         = 0x40;     // Number of hash bins, power of 2
+            constexpr size_t OCCLUSION_MAX_AGE      = 0x100;    // Number of frames the unused entry is kept
+
+            /**
+             * Occlusion state of the buffer drawn with the specific model matrix
+             */
+            typedef struct occluder_t
+            {
+                occluder_t         *pNext;          // Next entry in the hash bin
+
+                // Key
+                const void         *pVData;         // Vertex data
+                const uint32_t     *pVIndex;        // Vertex indices
+                size_t              nVStride;       // Vertex stride
+                size_t              nCount;         // Number of primitives
+                uint32_t            nType;          // Primitive type
+                r3d::mat4_t         sModel;         // Model matrix
+                size_t              nLastFrame;     // Last frame the entry has been used
+
+                // State
+                float               vMin[3];        // Minimum corner of the bounding box in model space
+                float               vMax[3];        // Maximum corner of the bounding box in model space
+                bool                bBounds;        // Flag: bounding box is valid
+                GLuint              nQuery;         // Query object, 0 if not allocated
+                bool                bPending;       // Flag: query has been issued and the result was not read yet
+                bool                bVisible;       // Flag: result of the last completed query
+            } occluder_t;
+
+            /**
+             * Cache of occlusion queries against bounding boxes of heavy buffers. The result
+             * of the query issued in one frame is used in the following frame, so reading the
+             * result never stalls the pipeline. Should be accessed only by the thread that
+             * owns the OpenGL context.
+             */
+            typedef struct occlusion_cache_t
+            {
+                occluder_t         *vBins[OCCLUSION_BINS];  // Hash bins
+                size_t              nMinCount;      // Minimum number of primitives of the tested buffer, 0 if disabled
+                size_t              nFrame;         // Frame counter
+                size_t              nEntries;       // Number of entries
+                size_t              nTested;        // Number of tested draws
+                size_t              nCulled;        // Number of draws skipped as invisible
+                size_t              nQueries;       // Number of issued queries
+
+                void                construct();
+
+                /**
+                 * Drop all entries, should be called with the current OpenGL context
+                 * @param ext OpenGL extensions
+                 */
+                void                destroy(const gl_ext_t *ext);
+
+                /**
+                 * Test the visibility of the buffer and issue the query for the following frame.
+                 * Should be called with projection and model-view matrices of the buffer loaded.
+                 *
+                 * @param ext OpenGL extensions
+                 * @param key buffer supplied by the caller, used as key
+                 * @param data buffer that contains actual data, may differ from key in threaded mode
+                 * @param count number of vertices referenced by primitives
+                 * @param mvp product of projection and model-view matrices
+                 * @return false if the buffer was invisible and should not be drawn
+                 */
+                bool                test(const gl_ext_t *ext, const r3d::buffer_t *key, const r3d::buffer_t *data,
+                                        size_t count, const r3d::mat4_t *mvp);
+
+                /**
+                 * Mark bounding boxes of buffers that refer the data as invalid
+                 * @param data pointer to the vertex data or index array, NULL for all entries
+                 */
+                void                invalidate(const void *data);
+
+                /**
+                 * Advance the frame counter and drop entries unused for a long time,
+                 * should be called with the current OpenGL context
+                 * @param ext OpenGL extensions
+                 */
+                void                next_frame(const gl_ext_t *ext);
+
+                void                get_stats(occlusion_stats_t *stats);
+            } occlusion_cache_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_OCCLUSION_H_ */
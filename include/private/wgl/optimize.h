@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_OPTIMIZE_H_
+#define PRIVATE_WGL_OPTIMIZE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t VCACHE_SIZE            = 32;       // Size of the modelled post-transform cache
+            constexpr size_t VCACHE_FIFO_SIZE       = 16;       // Size of the FIFO cache used for ACMR estimation
+
+            /**
+             * Compute average cache miss ratio (number of vertex transforms per triangle)
+             * for the FIFO post-transform cache of the specified size
+             *
+             * @param indices triangle list indices
+             * @param count number of indices, multiple of 3
+             * @param vertices number of vertices
+             * @param cache_size size of the cache
+             * @return average cache miss ratio, 0 for empty list
+             */
+            float       compute_acmr(const uint32_t *indices, size_t count, size_t vertices, size_t cache_size);
+
+            /**
+             * Reorder triangles to improve the post-transform vertex cache hit rate
+             * using the linear-speed algorithm by Tom Forsyth. The indices are updated
+             * in place, the winding of each triangle is preserved.
+             *
+             * @param indices triangle list indices
+             * @param count number of indices, multiple of 3
+             * @param vertices number of vertices
+             * @return status of operation
+             */
+            status_t    optimize_triangles(uint32_t *indices, size_t count, size_t vertices);
+
+            /**
+             * Renumber vertices in order of first use to improve the vertex fetch
+             * locality. The indices are updated in place.
+             *
+             * @param order array to store the original vertex index for each new vertex,
+             *   vertices that are not referenced are moved to the end
+             * @param indices triangle list indices
+             * @param count number of indices
+             * @param vertices number of vertices
+             * @return status of operation
+             */
+            status_t    optimize_vertices(uint32_t *order, uint32_t *indices, size_t count, size_t vertices);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_OPTIMIZE_H_ */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_PIXELS_H_
+#define PRIVATE_WGL_PIXELS_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/wgl/types.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Get the size of the pixel in the output format
+             * @param format output format
+             * @return size of the pixel in bytes, 0 for unsupported format
+             */
+            size_t      read_format_size(read_format_t format);
+
+            /**
+             * Convert RGBA pixels read from the OpenGL context into the output format in a
+             * single pass: vertical flip, channel swizzle, alpha premultiplication and packing
+             * are fused into one kernel per row.
+             *
+             * @param dst destination image
+             * @param dst_stride stride between rows of the destination image in bytes
+             * @param src source image with RGBA pixels
+             * @param src_stride stride between rows of the source image in bytes
+             * @param width width of the image
+             * @param height height of the image
+             * @param format output format
+             * @param flip source image is stored bottom-up
+             * @return status of operation
+             */
+            status_t    convert_pixels(
+                uint8_t *dst, size_t dst_stride,
+                const uint8_t *src, size_t src_stride,
+                size_t width, size_t height,
+                read_format_t format, bool flip);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_PIXELS_H_ */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_WGL_QUEUE_H_
+#define PRIVATE_WGL_QUEUE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t CMD_QUEUE_ALIGN        = 16;       // Alignment of each record
+            constexpr uint32_t CMD_PADDING          = 0;        // Reserved type of the padding record
+
+            /**
+             * Header of the command record stored in the queue
+             */
+            typedef struct cmd_header_t
+            {
+                uint32_t            type;           // Type of the command
+                uint32_t            size;           // Overall size of the record including header
+            } cmd_header_t;
+
+            /**
+             * Lock-free single-producer single-consumer ring of variable-size
+             * command records. The producer calls begin() to reserve the record
+             * and commit() to publish it. The consumer calls fetch() to obtain the
+             * oldest record and release() to return the space to the producer.
+             * The queue does not perform any blocking, the caller should implement
+             * waiting by itself.
+             */
+            typedef struct cmd_queue_t
+            {
+                uint8_t            *vData;          // Ring data
+                void               *pData;          // Allocated pointer
+                uint32_t            nCapacity;      // Capacity of the ring, power of 2
+                uint32_t            nHead;          // Write position, modified by producer
+                uint32_t            nTail;          // Read position, modified by consumer
+                uint32_t            nPending;       // Size of the reserved but not committed data
+
+                void                construct();
+                void                destroy();
+
+                /**
+                 * Allocate the ring
+                 * @param capacity minimum capacity of the ring in bytes
+                 * @return status of operation
+                 */
+                status_t            init(size_t capacity);
+
+                /**
+                 * Get the maximum size of the single record that can be stored in the queue
+                 * @return maximum size of the record including header
+                 */
+                inline size_t       max_record() const  { return nCapacity >> 1; }
+
+                /**
+                 * Reserve space for the record (producer side)
+                 * @param type type of the record, should not be CMD_PADDING
+                 * @param size size of the record including header
+                 * @return pointer to the reserved record or NULL if there is no space at this moment
+                 */
+                cmd_header_t       *begin(uint32_t type, size_t size);
+
+                /**
+                 * Publish the reserved record to the consumer (producer side)
+                 */
+                void                commit();
+
+                /**
+                 * Fetch the oldest record (consumer side)
+                 * @return pointer to the record or NULL if queue is empty
+                 */
+                cmd_header_t       *fetch();
+
+                /**
+                 * Release the record obtained by fetch() (consumer side)
+                 * @param hdr record to release
+                 */
+                void                release(const cmd_header_t *hdr);
+
+                /**
+                 * Check that queue is empty
+                 * @return true if queue is empty
+                 */
+                bool                empty();
+            } cmd_queue_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_QUEUE_H_ */
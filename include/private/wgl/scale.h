@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_SCALE_H_
+#define PRIVATE_WGL_SCALE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Upscale the image with bilinear filtering. Pixel centers of both images
+             * are aligned, edge pixels are clamped. The vertical pass is performed for
+             * all channels at once, so any pixel size is supported.
+             *
+             * @param dst destination image
+             * @param dw width of the destination image
+             * @param dh height of the destination image
+             * @param dst_stride stride between rows of the destination image in bytes
+             * @param src source image
+             * @param sw width of the source image
+             * @param sh height of the source image
+             * @param src_stride stride between rows of the source image in bytes
+             * @param bpp size of pixel in bytes
+             * @param flip source image is stored bottom-up
+             * @return status of operation
+             */
+            status_t    upscale_bilinear(
+                uint8_t *dst, size_t dw, size_t dh, size_t dst_stride,
+                const uint8_t *src, size_t sw, size_t sh, size_t src_stride,
+                size_t bpp, bool flip);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_SCALE_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_SORT_H_
+#define PRIVATE_WGL_SORT_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <private/wgl/arena.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Compute depth of points as the dot product with the matrix row:
+             * dst[i] = row[0]*x[i] + row[1]*y[i] + row[2]*z[i] + row[3]
+             *
+             * @param dst destination array
+             * @param x array of X coordinates
+             * @param y array of Y coordinates
+             * @param z array of Z coordinates
+             * @param row depth row of the transformation matrix
+             * @param count number of points
+             */
+            void        compute_depths(float *dst, const float *x, const float *y, const float *z, const float *row, size_t count);
+
+            /**
+             * Check that the depth row of the transformation matrix has changed enough
+             * to make the previously computed order of elements invalid
+             *
+             * @param a depth row of the current transformation matrix
+             * @param b depth row the order has been computed for
+             * @param epsilon maximum relative change of each element of the row
+             * @return true if the order of elements should be computed again
+             */
+            bool        depth_row_changed(const float *a, const float *b, float epsilon);
+
+            /**
+             * Compute the order of elements sorted by ascending keys using the LSD radix sort
+             *
+             * @param order array to store indices of elements in sorted order
+             * @param keys keys of elements
+             * @param count number of elements
+             * @param arena arena for temporary data
+             * @return status of operation
+             */
+            status_t    sort_by_keys(uint32_t *order, const float *keys, size_t count, arena_t *arena);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_SORT_H_ */
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_WGL_TRACE_H_
+#define PRIVATE_WGL_TRACE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+
+#include <stdio.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /*
+             * Trace file layout. The file starts with trace_file_t header followed
+             * by records. Each record starts with trace_record_t header and is padded
+             * to TRACE_ALIGN bytes, so the payload of the blob record is properly
+             * aligned when the file is memory-mapped. Buffer data is stored in blob
+             * records which are emitted once per unique content before the first
+             * draw record that references them. Blob identifiers start with 1,
+             * identifier 0 means absence of data. All values are stored in the
+             * native byte order of the machine that captured the trace.
+             */
+            constexpr uint32_t TRACE_MAGIC          = 0x54443352;   // 'R3DT'
+            constexpr uint32_t TRACE_VERSION        = 1;
+            constexpr size_t TRACE_ALIGN            = 16;
+
+            enum trace_record_type_t
+            {
+                TRACE_BLOB,
+                TRACE_LOCATE,
+                TRACE_START,
+                TRACE_MATRIX,
+                TRACE_LIGHTS,
+                TRACE_DRAW,
+                TRACE_SYNC,
+                TRACE_READ_PIXELS,
+                TRACE_FINISH,
+                TRACE_RING
+            };
+
+            typedef struct trace_file_t
+            {
+                uint32_t            magic;          // TRACE_MAGIC
+                uint32_t            version;        // TRACE_VERSION
+                uint32_t            reserved[2];
+            } trace_file_t;
+
+            typedef struct trace_record_t
+            {
+                uint32_t            type;           // Type of record
+                uint32_t            size;           // Size of payload without padding
+            } trace_record_t;
+
+            typedef struct trace_blob_t
+            {
+                uint32_t            id;             // Identifier of the blob
+                uint32_t            size;           // Size of the blob data
+                // Followed by data
+            } trace_blob_t;
+
+            typedef struct trace_locate_t
+            {
+                int32_t             left, top;
+                int32_t             width, height;
+            } trace_locate_t;
+
+            typedef struct trace_start_t
+            {
+                r3d::color_t        bg;             // Background color
+            } trace_start_t;
+
+            typedef struct trace_matrix_t
+            {
+                uint32_t            type;           // Matrix type
+                uint32_t            reserved[3];
+                r3d::mat4_t         m;              // Matrix
+            } trace_matrix_t;
+
+            typedef struct trace_light_t
+            {
+                uint32_t            type;
+                float               constant, linear, quadratic, cutoff;
+                r3d::dot4_t         position;
+                r3d::vec4_t         direction;
+                r3d::color_t        ambient, diffuse, specular;
+            } trace_light_t;
+
+            typedef struct trace_array_t
+            {
+                uint32_t            data;           // Blob with data
+                uint32_t            stride;         // Stride between elements
+                uint32_t            index;          // Blob with indices
+            } trace_array_t;
+
+            typedef struct trace_draw_t
+            {
+                r3d::mat4_t         model;          // Model matrix
+                uint32_t            type;           // Primitive type
+                uint32_t            flags;          // Buffer flags
+                float               width;          // Line width or point size
+                uint32_t            count;          // Number of primitives
+                trace_array_t       vertex;         // Vertex array
+                trace_array_t       normal;         // Normal array
+                trace_array_t       color;          // Color array
+                r3d::color_t        dfl;            // Default color
+            } trace_draw_t;
+
+            typedef struct trace_ring_t
+            {
+                uint32_t            first;          // First primitive of the ring
+                uint32_t            reserved[3];
+                r3d::mat4_t         wrap;           // Model transform of the wrapped primitives
+                trace_draw_t        draw;           // Buffer of the ring
+            } trace_ring_t;
+
+            typedef struct trace_read_pixels_t
+            {
+                uint32_t            format;         // Pixel format
+            } trace_read_pixels_t;
+
+            /**
+             * Entry of the blob hash table
+             */
+            typedef struct trace_hash_t
+            {
+                uint64_t            hash;           // Hash of the contents, 0 for empty slot
+                uint32_t            size;           // Size of the contents
+                uint32_t            id;             // Identifier of the blob
+            } trace_hash_t;
+
+            /**
+             * Trace writer, serializes backend calls into the trace file. Buffer payloads
+             * are deduplicated by the content hash, so static geometry that is drawn each
+             * frame is stored only once.
+             */
+            typedef struct trace_writer_t
+            {
+                FILE               *pFD;            // File descriptor
+                trace_hash_t       *vHash;          // Hash table of written blobs
+                size_t              nHashCap;       // Capacity of the hash table, power of 2
+                size_t              nBlobs;         // Number of written blobs
+                status_t            nError;         // First I/O error
+
+                void                construct();
+                void                destroy();
+
+                /**
+                 * Create the trace file and write the header
+                 * @param path path to the file in UTF-8 encoding
+                 * @return status of operation
+                 */
+                status_t            open(const char *path);
+
+                /**
+                 * Flush and close the trace file
+                 * @return status of operation, including deferred I/O errors
+                 */
+                status_t            close();
+
+                void                locate(ssize_t left, ssize_t top, ssize_t width, ssize_t height);
+                void                start(const r3d::color_t *bg);
+                void                set_matrix(r3d::matrix_type_t type, const r3d::mat4_t *m);
+                void                set_lights(const r3d::light_t *lights, size_t count);
+                void                draw_primitives(const r3d::buffer_t *buffer);
+                void                draw_ring(const r3d::buffer_t *buffer, size_t first, const r3d::mat4_t *wrap);
+                void                sync();
+                void                read_pixels(r3d::pixel_format_t format);
+                void                finish();
+            } trace_writer_t;
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_TRACE_H_ */
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_WGL_WELD_H_
+#define PRIVATE_WGL_WELD_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/r3d/iface/types.h>
+#include <lsp-plug.in/r3d/wgl/types.h>
+#include <private/wgl/arena.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Source of the cached vertex: indices of attributes in the original arrays
+             */
+            typedef struct remap_t
+            {
+                uint32_t            v;              // Vertex index
+                uint32_t            n;              // Normal index
+                uint32_t            c;              // Color index
+            } remap_t;
+
+            /**
+             * Weld vertices of the buffer: vertices that refer the same vertex, normal and
+             * color elements of the source arrays are merged into one.
+             *
+             * @param indices array to store count indices of welded vertices
+             * @param remap array to store sources of welded vertices, should hold count elements
+             * @param data source buffer
+             * @param count number of vertices referenced by primitives
+             * @param arena arena for temporary data
+             * @return number of welded vertices or negative status code on error
+             */
+            ssize_t             weld_indices(uint32_t *indices, remap_t *remap, const r3d::buffer_t *data, size_t count, arena_t *arena);
+
+            /**
+             * Gather attributes of vertices from the source arrays into the interleaved layout.
+             * Attributes missing in the source buffer are left unchanged.
+             *
+             * @param vx destination vertices
+             * @param remap sources of vertices
+             * @param count number of vertices
+             * @param data source buffer
+             */
+            void                gather_vertices(vertex_t *vx, const remap_t *remap, size_t count, const r3d::buffer_t *data);
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PRIVATE_WGL_WELD_H_ */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <private/wgl/arena.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            static constexpr size_t ARENA_CHUNK_HDR     = (sizeof(arena_chunk_t) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+            static inline size_t align_size(size_t size, size_t align)
+            {
+                return (size + align - 1) & ~(align - 1);
+            }
+
+            static inline uint8_t *chunk_data(arena_chunk_t *c)
+            {
+                return reinterpret_cast<uint8_t *>(c) + ARENA_CHUNK_HDR;
+            }
+
+            static inline size_t block_capacity(size_t size)
+            {
+                // Keep some room for alignment of allocations
+                return (size > 0) ? align_size(size + (size >> 2), ARENA_GRANULE) : 0;
+            }
+
+            static void *place(uint8_t *data, size_t *used, size_t capacity, size_t size, size_t align)
+            {
+                if (data == NULL)
+                    return NULL;
+
+                uintptr_t base      = reinterpret_cast<uintptr_t>(data);
+                size_t off          = align_size(base + *used, align) - base;
+                if ((off + size) > capacity)
+                    return NULL;
+
+                *used               = off + size;
+                return &data[off];
+            }
+
+            void arena_t::construct()
+            {
+                vData               = NULL;
+                nUsed               = 0;
+                nCapacity           = 0;
+                pOverflow           = NULL;
+                nTotal              = 0;
+                nPeak               = 0;
+                nHighWater          = 0;
+                nAllocs             = 0;
+
+                sStats.nCapacity    = 0;
+                sStats.nHighWater   = 0;
+                sStats.nFrameBytes  = 0;
+                sStats.nFrameAllocs = 0;
+                sStats.nFrames      = 0;
+                sStats.nHeapAllocs  = 0;
+            }
+
+            void arena_t::destroy()
+            {
+                release(0);
+                if (vData != NULL)
+                {
+                    free(vData);
+                    vData               = NULL;
+                }
+                nCapacity           = 0;
+            }
+
+            void *arena_t::alloc(size_t size, size_t align)
+            {
+                void *ptr;
+                ++nAllocs;
+
+                // Allocate from the arena block or from the most recent chunk
+                arena_chunk_t *c    = pOverflow;
+                if (c == NULL)
+                {
+                    if ((ptr = place(vData, &nUsed, nCapacity, size, align)) != NULL)
+                    {
+                        nTotal              = nUsed;
+                        nPeak               = lsp_max(nPeak, nTotal);
+                        return ptr;
+                    }
+                }
+                else if ((ptr = place(chunk_data(c), &c->nUsed, c->nCapacity, size, align)) != NULL)
+                {
+                    nTotal              = c->nBase + c->nUsed;
+                    nPeak               = lsp_max(nPeak, nTotal);
+                    return ptr;
+                }
+
+                // Allocate new chunk
+                size_t capacity     = lsp_max(align_size(size + align, ARENA_ALIGN), ARENA_MIN_CHUNK);
+                c                   = static_cast<arena_chunk_t *>(malloc(ARENA_CHUNK_HDR + capacity));
+                if (c == NULL)
+                    return NULL;
+                ++sStats.nHeapAllocs;
+
+                c->pNext            = pOverflow;
+                c->nBase            = nTotal;
+                c->nUsed            = 0;
+                c->nCapacity        = capacity;
+                pOverflow           = c;
+
+                ptr                 = place(chunk_data(c), &c->nUsed, c->nCapacity, size, align);
+                nTotal              = c->nBase + c->nUsed;
+                nPeak               = lsp_max(nPeak, nTotal);
+                return ptr;
+            }
+
+            void arena_t::release(arena_mark_t mark)
+            {
+                // Drop chunks allocated after the mark
+                while ((pOverflow != NULL) && (pOverflow->nBase >= mark))
+                {
+                    arena_chunk_t *c    = pOverflow;
+                    pOverflow           = c->pNext;
+                    free(c);
+                }
+
+                if (pOverflow != NULL)
+                    pOverflow->nUsed    = mark - pOverflow->nBase;
+                else
+                    nUsed               = lsp_min(nUsed, mark);
+                nTotal              = mark;
+            }
+
+            void arena_t::reset()
+            {
+                bool overflow       = pOverflow != NULL;
+                release(0);
+
+                // Update statistics
+                nHighWater          = lsp_max(nHighWater, nPeak);
+                sStats.nFrameBytes  = nPeak;
+                sStats.nFrameAllocs = nAllocs;
+                ++sStats.nFrames;
+                nPeak               = 0;
+                nAllocs             = 0;
+
+                // Grow the block to fit all allocations of the frame
+                if ((overflow) || (nCapacity < nHighWater))
+                {
+                    size_t capacity     = block_capacity(nHighWater);
+                    uint8_t *ptr        = static_cast<uint8_t *>(malloc(capacity));
+                    if (ptr != NULL)
+                    {
+                        ++sStats.nHeapAllocs;
+                        if (vData != NULL)
+                            free(vData);
+                        vData               = ptr;
+                        nCapacity           = capacity;
+                    }
+                }
+            }
+
+            void arena_t::trim()
+            {
+                release(0);
+
+                nHighWater          = sStats.nFrameBytes;
+                size_t capacity     = block_capacity(nHighWater);
+                if (capacity >= nCapacity)
+                    return;
+
+                if (vData != NULL)
+                    free(vData);
+                vData               = NULL;
+                nCapacity           = 0;
+                if (capacity <= 0)
+                    return;
+
+                if ((vData = static_cast<uint8_t *>(malloc(capacity))) != NULL)
+                {
+                    ++sStats.nHeapAllocs;
+                    nCapacity           = capacity;
+                }
+            }
+
+            void arena_t::get_stats(arena_stats_t *stats)
+            {
+                *stats              = sStats;
+                stats->nCapacity    = nCapacity;
+                stats->nHighWater   = lsp_max(nHighWater, nPeak);
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
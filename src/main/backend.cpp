@@ -20,9 +20,28 @@
  */
 
 #include <lsp-plug.in/common/types.h>
+
+#ifdef PLATFORM_WINDOWS
+
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
 #include <lsp-plug.in/r3d/wgl/backend.h>
-
+#include <private/wgl/arena.h>
+#include <private/wgl/cache.h>
+#include <private/wgl/decimate.h>
+#include <private/wgl/expand.h>
+#include <private/wgl/ext.h>
+#include <private/wgl/frame.h>
+#include <private/wgl/fxaa.h>
+#include <private/wgl/matrix.h>
+#include <private/wgl/occlusion.h>
+#include <private/wgl/pixels.h>
+#include <private/wgl/queue.h>
+#include <private/wgl/scale.h>
+#include <private/wgl/trace.h>
+
+#include <stddef.h>
 #include <stdlib.h>
 #include <shlwapi.h>
 #include <wchar.h>
@@ -48,7 +67,107 @@ namespace lsp
                 DBUF_INDEX_MASK   = DBUF_VINDEX | DBUF_NINDEX | DBUF_CINDEX
             };
 
+            enum command_type_t
+            {
+                CMD_START           = 1,
+                CMD_LIGHTS,
+                CMD_DRAW,
+                CMD_SYNC,
+                CMD_READ_PIXELS,
+                CMD_FINISH,
+                CMD_BARRIER,
+                CMD_VIEWPORT,
+                CMD_READ_IDS,
+                CMD_READ_PIXELS_EX,
+                CMD_DELETE_LIST,
+                CMD_QUIT
+            };
+
+            typedef struct cmd_start_t
+            {
+                cmd_header_t        hdr;
+                r3d::color_t        bg;             // Background color
+            } cmd_start_t;
+
+            typedef struct cmd_lights_t
+            {
+                cmd_header_t        hdr;
+                size_t              count;          // Number of lights
+                r3d::light_t       *lights;         // Lights stored in the record payload
+            } cmd_lights_t;
+
+            typedef struct cmd_draw_t
+            {
+                cmd_header_t        hdr;
+                r3d::mat4_t         projection;     // Projection matrix
+                r3d::mat4_t         view_world;     // Product of view and world matrices
+                r3d::buffer_t       buffer;         // Buffer that refers the payload or caller's data
+                r3d::buffer_t       key;            // Buffer passed by the caller, used as geometry cache key
+                ring_t              ring;           // Rotation of the ring buffer
+                status_t           *result;         // Result of synchronous drawing, NULL for asynchronous
+            } cmd_draw_t;
+
+            typedef struct cmd_sync_t
+            {
+                cmd_header_t        hdr;
+                status_t           *result;         // Result of the command
+            } cmd_sync_t;
+
+            typedef struct cmd_read_pixels_t
+            {
+                cmd_header_t        hdr;
+                void               *buf;            // Destination buffer
+                r3d::pixel_format_t format;         // Pixel format
+                status_t           *result;         // Result of the command
+            } cmd_read_pixels_t;
+
+            typedef struct cmd_read_pixels_ex_t
+            {
+                cmd_header_t        hdr;
+                void               *buf;            // Destination buffer
+                size_t              stride;         // Stride between rows of the destination buffer
+                read_format_t       format;         // Output format
+                status_t           *result;         // Result of the command
+            } cmd_read_pixels_ex_t;
+
+            typedef struct cmd_finish_t
+            {
+                cmd_header_t        hdr;
+                bool                skip;           // The frame has been skipped and should not be presented
+            } cmd_finish_t;
+
+            typedef struct cmd_list_t
+            {
+                cmd_header_t        hdr;
+                GLuint              id;             // Identifier of the list
+            } cmd_list_t;
+
+            typedef struct cmd_read_ids_t
+            {
+                cmd_header_t        hdr;
+                ssize_t             left, top;      // Top-left corner of the rectangle
+                ssize_t             width, height;  // Size of the rectangle
+                uint32_t           *ids;            // Destination buffer for object identifiers
+                float              *depth;          // Destination buffer for depth values
+                status_t           *result;         // Result of the command
+            } cmd_read_ids_t;
+
+            typedef struct cmd_viewport_t
+            {
+                cmd_header_t        hdr;
+                int32_t             left, bottom;   // Bottom-left corner of the viewport
+                int32_t             width, height;  // Size of the viewport
+                bool                scissor;        // Restrict drawing and clearing by the viewport
+            } cmd_viewport_t;
+
+            enum gl_matrix_flags_t
+            {
+                GLM_PROJECTION      = 1 << 0,
+                GLM_MODELVIEW       = 1 << 1
+            };
+
             constexpr size_t VATTR_BUFFER_SIZE      = 3072;    // Multiple of 3
+            constexpr size_t CMD_QUEUE_SIZE         = 0x400000; // Size of the command queue in threaded mode
 
         #define PFD(color_bits, r_bits, g_bits, b_bits, a_bits, depth_bits) \
             { \
@@ -100,6 +219,21 @@ namespace lsp
             };
         #undef PFD
 
+            static cmd_header_t    *enqueue(backend_t *_this, uint32_t type, size_t size);
+            static void             submit(backend_t *_this);
+            static status_t         call_render_thread(backend_t *_this, uint32_t type);
+            static void             wait_completion(backend_t *_this, uint32_t ticket);
+            static status_t         start_render_thread(backend_t *_this);
+            static void             stop_render_thread(backend_t *_this);
+            static status_t         take_async_error(backend_t *_this, status_t res);
+            static void             drop_frame(backend_t *_this);
+            static void             drop_pixels(backend_t *_this);
+
+            static inline size_t align_size(size_t size)
+            {
+                return (size + CMD_QUEUE_ALIGN - 1) & (~(CMD_QUEUE_ALIGN - 1));
+            }
+
             backend_t::backend_t()
             {
                 construct();
@@ -120,14 +254,152 @@ namespace lsp
                 return DefWindowProcW(hwnd, uMsg, wParam, lParam);
             }
 
+            //-----------------------------------------------------------------
+            // Process-wide state shared by backends rendering in different threads
+            static SRWLOCK                  sWndClassLock   = SRWLOCK_INIT;     // Lock of the window class registration
+            static size_t                   nWndClassRefs   = 0;                // Number of backends that use the window class
+            static WCHAR                    sWndClassName[64];                  // Name of the window class
+            static uint32_t                 nContextIds     = 0;                // Generator of context identifiers
+            static thread_local uint32_t    nThreadContext  = 0;                // Context that is current for the thread, 0 if none
+
+            static status_t acquire_window_class()
+            {
+                status_t res        = STATUS_OK;
+
+                ::AcquireSRWLockExclusive(&sWndClassLock);
+                if (nWndClassRefs <= 0)
+                {
+                    // The name is unique for each copy of the library loaded into the process
+                    swprintf_s(sWndClassName, sizeof(sWndClassName) / sizeof(WCHAR), L"lsp-wgl-%p", sWndClassName);
+
+                    WNDCLASSW wc;
+                    ZeroMemory(&wc, sizeof(wc));
+
+                    wc.style         = CS_HREDRAW | CS_VREDRAW;
+                    wc.lpfnWndProc   = window_proc;
+                    wc.hInstance     = GetModuleHandleW(NULL);
+                    wc.lpszClassName = sWndClassName;
+
+                    if (!RegisterClassW(&wc))
+                        res             = STATUS_UNKNOWN_ERR;
+                }
+                if (res == STATUS_OK)
+                    ++nWndClassRefs;
+                ::ReleaseSRWLockExclusive(&sWndClassLock);
+
+                return res;
+            }
+
+            static void release_window_class()
+            {
+                ::AcquireSRWLockExclusive(&sWndClassLock);
+                if ((--nWndClassRefs) <= 0)
+                    UnregisterClassW(sWndClassName, GetModuleHandleW(NULL));
+                ::ReleaseSRWLockExclusive(&sWndClassLock);
+            }
+
+            static bool make_current(backend_t *_this)
+            {
+                // Context identifiers are never reused, so the stale identifier of the
+                // destroyed context never matches
+                if (nThreadContext == _this->nContextId)
+                    return true;
+                if (!::wglMakeCurrent(_this->hDC, _this->hGL))
+                    return false;
+                nThreadContext      = _this->nContextId;
+                return true;
+            }
+
+            static void release_current(backend_t *_this)
+            {
+                if (nThreadContext != _this->nContextId)
+                    return;
+                ::wglMakeCurrent(_this->hDC, NULL);
+                nThreadContext      = 0;
+            }
+
             void backend_t::construct()
             {
-                pWndClass       = NULL;
+                bWndClass       = false;
                 hWindow         = NULL;
                 hDC             = NULL;
                 hGL             = NULL;
+                nContextId      = 0;
+                bStickyContext  = false;
                 bDrawing        = false;
-                vxBuffer        = NULL;
+                pArena          = NULL;
+
+                bViewWorld      = false;
+                nGLMatrices     = 0;
+
+                pQueue          = NULL;
+                hThread         = NULL;
+                hConsumer       = NULL;
+                hProducer       = NULL;
+                nConsumerWait   = 0;
+                nProducerWait   = 0;
+                nSubmitted      = 0;
+                nCompleted      = 0;
+                nAsyncError     = STATUS_OK;
+
+                pTrace          = NULL;
+
+                pExt            = NULL;
+                pCache          = NULL;
+
+                pFrame          = NULL;
+                vPixels         = NULL;
+                nPixelsCap      = 0;
+                nPixelsHash     = 0;
+                enPixelsFormat  = r3d::PIXEL_RGBA;
+                bPixels         = false;
+                bDeferred       = false;
+                bReused         = false;
+                bFrameReuse     = false;
+                nDataVersion    = 0;
+                sFrameStats.nFrames     = 0;
+                sFrameStats.nDrawn      = 0;
+                sFrameStats.nSkipped    = 0;
+
+                vViews          = NULL;
+                nViews          = 0;
+                vAtlas          = NULL;
+                nAtlasCap       = 0;
+
+                bPicking        = false;
+                nObjectId       = 0;
+
+                pExpand         = NULL;
+                pLod            = NULL;
+                nGLWidth        = 0;
+                nGLHeight       = 0;
+
+                pOcclusion      = NULL;
+
+                bTiled          = false;
+                sTiled.data     = NULL;
+                sTiled.stride   = 0;
+                sTiled.width    = 0;
+                sTiled.height   = 0;
+                sTiled.format   = r3d::PIXEL_RGBA;
+
+                vLists          = NULL;
+                nLists          = 0;
+                nListsCap       = 0;
+                nListCompile    = 0;
+
+                fRenderScale    = 1.0f;
+                vScaled         = NULL;
+                nScaledCap      = 0;
+
+                bFxaa           = false;
+                bFxaaDone       = false;
+                bFxaaCPU        = false;
+                nFxaaProgram    = 0;
+                nFxaaTexel      = -1;
+                nFxaaTexture    = 0;
+                nFxaaWidth      = 0;
+                nFxaaHeight     = 0;
 
                 base_backend_t::construct();
 
@@ -154,21 +426,121 @@ namespace lsp
             {
                 backend_t *_this = static_cast<backend_t *>(handle);
 
-                // Destroy vertex attributes buffer
-                if (_this->vxBuffer != NULL)
+                // Stop the render thread
+                stop_render_thread(_this);
+
+                // Stop tracing
+                stop_trace(handle);
+
+                // Drop the geometry cache
+                if (_this->pCache != NULL)
+                {
+                    if ((_this->hGL != NULL) && (make_current(_this)))
+                    {
+                        _this->pCache->destroy(_this->pExt);
+                        release_current(_this);
+                    }
+                    free(_this->pCache);
+                    _this->pCache       = NULL;
+                }
+
+                // Drop the occlusion queries
+                if (_this->pOcclusion != NULL)
+                {
+                    if ((_this->hGL != NULL) && (_this->pOcclusion->nEntries > 0) && (make_current(_this)))
+                    {
+                        _this->pOcclusion->destroy(_this->pExt);
+                        release_current(_this);
+                    }
+                    free(_this->pOcclusion);
+                    _this->pOcclusion   = NULL;
+                }
+
+                // Drop the retained command lists
+                if (_this->vLists != NULL)
+                {
+                    if ((_this->hGL != NULL) && (_this->nLists > 0) && (make_current(_this)))
+                    {
+                        for (size_t i=0; i<_this->nLists; ++i)
+                            ::glDeleteLists(_this->vLists[i], 1);
+                        release_current(_this);
+                    }
+                    free(_this->vLists);
+                    _this->vLists       = NULL;
+                }
+                _this->nLists       = 0;
+                _this->nListsCap    = 0;
+
+                // Drop resources of the anti-aliasing pass
+                if ((_this->hGL != NULL) && ((_this->nFxaaProgram != 0) || (_this->nFxaaTexture != 0)) && (make_current(_this)))
+                {
+                    if (_this->nFxaaProgram != 0)
+                        _this->pExt->glDeleteProgram(_this->nFxaaProgram);
+                    if (_this->nFxaaTexture != 0)
+                        ::glDeleteTextures(1, &_this->nFxaaTexture);
+                    release_current(_this);
+                }
+                _this->nFxaaProgram = 0;
+                _this->nFxaaTexture = 0;
+                if (_this->pExt != NULL)
+                {
+                    free(_this->pExt);
+                    _this->pExt         = NULL;
+                }
+
+                // Drop the recorded frame and views
+                drop_pixels(_this);
+                drop_frame(_this);
+                if (_this->vViews != NULL)
+                {
+                    free(_this->vViews);
+                    _this->vViews       = NULL;
+                }
+                if (_this->vAtlas != NULL)
+                {
+                    free(_this->vAtlas);
+                    _this->vAtlas       = NULL;
+                }
+                _this->nViews       = 0;
+                _this->nAtlasCap    = 0;
+
+                // Destroy the batch of expanded lines and points
+                if (_this->pExpand != NULL)
+                {
+                    _this->pExpand->destroy();
+                    free(_this->pExpand);
+                    _this->pExpand      = NULL;
+                }
+
+                // Destroy levels of detail
+                if (_this->pLod != NULL)
+                {
+                    _this->pLod->destroy();
+                    free(_this->pLod);
+                    _this->pLod         = NULL;
+                }
+
+                // Destroy the buffer for scaled pixels
+                if (_this->vScaled != NULL)
                 {
-                    free(_this->vxBuffer);
-                    _this->vxBuffer     = NULL;
+                    free(_this->vScaled);
+                    _this->vScaled      = NULL;
+                }
+                _this->nScaledCap   = 0;
+
+                // Destroy the arena of temporary data
+                if (_this->pArena != NULL)
+                {
+                    _this->pArena->destroy();
+                    free(_this->pArena);
+                    _this->pArena       = NULL;
                 }
 
                 // Destroy the context and the window
                 if (_this->hDC != NULL)
                 {
                     if (_this->hGL != NULL)
-                    {
-                        if (::wglGetCurrentContext() == _this->hGL)
-                            ::wglMakeCurrent(_this->hDC, NULL);
-                    }
+                        release_current(_this);
                     _this->hDC          = NULL;
                 }
                 if (_this->hGL != NULL)
@@ -181,11 +553,10 @@ namespace lsp
                     DestroyWindow(_this->hWindow);
                     _this->hWindow      = NULL;
                 }
-                if (_this->pWndClass != NULL)
+                if (_this->bWndClass)
                 {
-                    UnregisterClassW(_this->pWndClass, GetModuleHandleW(NULL));
-                    free(_this->pWndClass);
-                    _this->pWndClass    = NULL;
+                    release_window_class();
+                    _this->bWndClass    = false;
                 }
 
                 // Call parent structure for destroy
@@ -198,31 +569,19 @@ namespace lsp
                 if (_this->hWindow != NULL)
                     return STATUS_BAD_STATE;
 
-                if (_this->pWndClass == NULL)
+                // Window class is shared by all backends and registered once
+                if (!_this->bWndClass)
                 {
-                    // Generate class name of the window
-                    WCHAR class_name[80];
-                    swprintf_s(class_name, sizeof(class_name), L"lsp-wgl-%p", _this);
-                    if ((_this->pWndClass = _wcsdup(class_name)) == NULL)
-                        return STATUS_NO_MEM;
-
-                    // Register window class name
-                    WNDCLASSW wc;
-                    ZeroMemory(&wc, sizeof(wc));
-
-                    wc.style         = CS_HREDRAW | CS_VREDRAW;
-                    wc.lpfnWndProc   = window_proc;
-                    wc.hInstance     = GetModuleHandleW(NULL);
-                    wc.lpszClassName = _this->pWndClass;
-
-                    if (!RegisterClassW(&wc))
-                        return STATUS_UNKNOWN_ERR;
+                    status_t res    = acquire_window_class();
+                    if (res != STATUS_OK)
+                        return res;
+                    _this->bWndClass    = true;
                 }
 
                 // Create window
                 _this->hWindow = CreateWindowExW(
                     0,                                  // dwExStyle
-                    _this->pWndClass,                   // lpClassName
+                    sWndClassName,                      // lpClassName
                     L"WGL Offscreen Window",            // lpWindowName
                     WS_OVERLAPPEDWINDOW,                // dwStyle
                     0,                                  // X
@@ -270,6 +629,28 @@ namespace lsp
                     lsp_error("Error creating context: code=%ld", long(GetLastError()));
                     return STATUS_UNKNOWN_ERR;
                 }
+                _this->nContextId   = atomic_add(&nContextIds, uint32_t(1)) + 1;
+
+                // Extensions are loaded on the first drawing with the current context
+                _this->pExt     = static_cast<gl_ext_t *>(malloc(sizeof(gl_ext_t)));
+                if (_this->pExt == NULL)
+                    return STATUS_NO_MEM;
+                _this->pExt->construct();
+
+                _this->pCache   = static_cast<geometry_cache_t *>(malloc(sizeof(geometry_cache_t)));
+                if (_this->pCache == NULL)
+                    return STATUS_NO_MEM;
+                _this->pCache->construct();
+
+                _this->pOcclusion   = static_cast<occlusion_cache_t *>(malloc(sizeof(occlusion_cache_t)));
+                if (_this->pOcclusion == NULL)
+                    return STATUS_NO_MEM;
+                _this->pOcclusion->construct();
+
+                _this->pArena       = static_cast<arena_t *>(malloc(sizeof(arena_t)));
+                if (_this->pArena == NULL)
+                    return STATUS_NO_MEM;
+                _this->pArena->construct();
 
 //                ShowWindow(_this->hWindow, SW_SHOWNORMAL);
 
@@ -289,8 +670,14 @@ namespace lsp
                 backend_t *_this = static_cast<backend_t *>(handle);
                 if ((_this->hGL == NULL) || (_this->bDrawing))
                     return STATUS_BAD_STATE;
+                if (_this->pTrace != NULL)
+                    _this->pTrace->locate(left, top, width, height);
 
-                ::glViewport(0, 0, width, height);
+                // The render thread should not access the window while it is being moved
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+                else
+                    ::glViewport(0, 0, width, height);
 
                 if ((_this->viewLeft == left) &&
                     (_this->viewTop == top) &&
@@ -318,16 +705,63 @@ namespace lsp
                 return STATUS_OK;
             }
 
-            status_t backend_t::start(r3d::backend_t *handle)
+            static void render_size(const backend_t *_this, ssize_t *width, ssize_t *height)
             {
-                backend_t *_this = static_cast<backend_t *>(handle);
-                if ((_this->hGL == NULL) || (_this->bDrawing))
-                    return STATUS_BAD_STATE;
+                // The frame is drawn into the bottom-left part of the render target when scaled
+                if (_this->fRenderScale >= 1.0f)
+                {
+                    *width      = _this->viewWidth;
+                    *height     = _this->viewHeight;
+                    return;
+                }
+
+                *width      = lsp_max(ssize_t(_this->viewWidth * _this->fRenderScale + 0.5f), ssize_t(1));
+                *height     = lsp_max(ssize_t(_this->viewHeight * _this->fRenderScale + 0.5f), ssize_t(1));
+            }
+
+            static const r3d::color_t *background(const backend_t *_this)
+            {
+                // Background of the picking frame encodes the zero object identifier
+                static const r3d::color_t pick_bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+                return (_this->bPicking) ? &pick_bg : &_this->colBackground;
+            }
 
+            static void gl_start(backend_t *_this, const r3d::color_t *bg)
+            {
                 // Set active context
-                ::wglMakeCurrent(_this->hDC, _this->hGL);
-                ::glViewport(0, 0, _this->viewWidth, _this->viewHeight);
+                make_current(_this);
+                _this->pExt->init();
+
+                // Release unused cached geometry
+                geometry_cache_t *cache = _this->pCache;
+                if (cache->nFlags & CACHE_GEOMETRY)
+                    cache->next_frame(_this->pExt);
+                else if (cache->nEntries > 0)
+                    cache->destroy(_this->pExt);
+                if (_this->pLod != NULL)
+                    _this->pLod->next_frame();
+
+                // Release unused occlusion queries
+                occlusion_cache_t *occ  = _this->pOcclusion;
+                if (occ->nMinCount > 0)
+                    occ->next_frame(_this->pExt);
+                else if (occ->nEntries > 0)
+                    occ->destroy(_this->pExt);
+
+                ssize_t width, height;
+                render_size(_this, &width, &height);
+                ::glViewport(0, 0, width, height);
+                ::glDisable(GL_SCISSOR_TEST);
+                _this->nGLWidth     = width;
+                _this->nGLHeight    = height;
+                if (_this->pExpand != NULL)
+                    _this->pExpand->clear();
                 ::glDrawBuffer(GL_BACK);
+                if (_this->bPicking)
+                    ::glDisable(GL_DITHER);
+                else
+                    ::glEnable(GL_DITHER);
+                _this->nGLMatrices  = 0;
 
                 // Enable depth test and culling
                 ::glDepthFunc(GL_LEQUAL);
@@ -347,28 +781,70 @@ namespace lsp
                 ::glEnable(GL_POLYGON_OFFSET_LINE);
 
                 // Clear buffer
-                ::glClearColor(_this->colBackground.r, _this->colBackground.g, _this->colBackground.b, _this->colBackground.a);
+                ::glClearColor(bg->r, bg->g, bg->b, bg->a);
                 ::glClearDepth(1.0);
                 ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                _this->bFxaaDone    = false;
+            }
+
+            static void exec_start(backend_t *_this, const r3d::color_t *bg)
+            {
+                if (_this->pQueue != NULL)
+                {
+                    cmd_start_t *cmd    = reinterpret_cast<cmd_start_t *>(enqueue(_this, CMD_START, sizeof(cmd_start_t)));
+                    cmd->bg             = *bg;
+                    submit(_this);
+                }
+                else
+                    gl_start(_this, bg);
+            }
+
+            status_t backend_t::start(r3d::backend_t *handle)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (_this->pTrace != NULL)
+                    _this->pTrace->start(&_this->colBackground);
+
+                // Record the frame if the output of the previous frame can be reused
+                // or the frame should be drawn for multiple views
+                if (_this->pFrame != NULL)
+                {
+                    frame_t *f          = _this->pFrame;
+                    f->clear(background(_this), _this->viewWidth, _this->viewHeight, _this->nDataVersion);
+                    f->add_hash(&_this->fRenderScale, sizeof(float));
+                    uint32_t fxaa       = _this->bFxaa;
+                    uint32_t picking    = _this->bPicking;
+                    f->add_hash(&fxaa, sizeof(fxaa));
+                    f->add_hash(&picking, sizeof(picking));
+                    if (_this->nViews > 0)
+                        f->add_hash(_this->vViews, _this->nViews * sizeof(view_t));
+                    _this->bDeferred    = true;
+                }
+                else
+                    exec_start(_this, background(_this));
 
                 // Setup drawing flag
                 _this->bDrawing     = true;
+                _this->nObjectId    = 0;
 
                 return STATUS_OK;
             }
 
             status_t backend_t::set_matrix(r3d::backend_t *handle, r3d::matrix_type_t type, const r3d::mat4_t *m)
             {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (_this->pTrace != NULL)
+                    _this->pTrace->set_matrix(type, m);
+                if (type != r3d::MATRIX_PROJECTION)
+                    _this->bViewWorld   = false;
+
                 return r3d::base_backend_t::set_matrix(handle, type, m);
             }
 
-            status_t backend_t::set_lights(r3d::backend_t *handle, const r3d::light_t *lights, size_t count)
+            static status_t gl_set_lights(const r3d::light_t *lights, size_t count)
             {
-                backend_t *_this = static_cast<backend_t *>(handle);
-
-                if ((_this->hDC == NULL) || (!_this->bDrawing))
-                    return STATUS_BAD_STATE;
-
                 // Enable all possible lights
                 size_t light_id = GL_LIGHT0;
 
@@ -438,6 +914,70 @@ namespace lsp
                 return STATUS_OK;
             }
 
+            static status_t count_lights(const r3d::light_t *lights, size_t count, size_t *n_out)
+            {
+                // Validate lights and estimate the number of lights that affect the drawing
+                size_t n_lights = 0, n_enabled = 0;
+                for ( ; (n_lights < count) && (n_enabled <= (GL_LIGHT7 - GL_LIGHT0)); ++n_lights)
+                {
+                    switch (lights[n_lights].type)
+                    {
+                        case r3d::LIGHT_NONE:
+                            break;
+                        case r3d::LIGHT_POINT:
+                        case r3d::LIGHT_DIRECTIONAL:
+                        case r3d::LIGHT_SPOT:
+                            ++n_enabled;
+                            break;
+                        default:
+                            return STATUS_INVALID_VALUE;
+                    }
+                }
+
+                *n_out          = n_lights;
+                return STATUS_OK;
+            }
+
+            static status_t exec_set_lights(backend_t *_this, const r3d::light_t *lights, size_t count)
+            {
+                if (_this->pQueue == NULL)
+                    return gl_set_lights(lights, count);
+
+                size_t n_lights = 0;
+                status_t res    = count_lights(lights, count, &n_lights);
+                if (res != STATUS_OK)
+                    return res;
+
+                // Submit the command
+                size_t hdr_size     = align_size(sizeof(cmd_lights_t));
+                cmd_lights_t *cmd   = reinterpret_cast<cmd_lights_t *>(
+                    enqueue(_this, CMD_LIGHTS, hdr_size + n_lights * sizeof(r3d::light_t)));
+                cmd->count          = n_lights;
+                cmd->lights         = reinterpret_cast<r3d::light_t *>(reinterpret_cast<uint8_t *>(cmd) + hdr_size);
+                ::memcpy(cmd->lights, lights, n_lights * sizeof(r3d::light_t));
+                submit(_this);
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::set_lights(r3d::backend_t *handle, const r3d::light_t *lights, size_t count)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+
+                if ((_this->hDC == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if ((_this->pTrace != NULL) && (_this->nListCompile == 0))
+                    _this->pTrace->set_lights(lights, count);
+                if (!_this->bDeferred)
+                    return exec_set_lights(_this, lights, count);
+
+                size_t n_lights = 0;
+                status_t res    = count_lights(lights, count, &n_lights);
+                if (res != STATUS_OK)
+                    return res;
+                return _this->pFrame->add_lights(lights, n_lights);
+            }
+
             void gl_draw_arrays_simple(GLenum mode, size_t bstate, const r3d::buffer_t *buffer, size_t count)
             {
                 // Enable vertex pointer (if present)
@@ -509,23 +1049,22 @@ namespace lsp
             {
                 backend_t *_this = static_cast<backend_t *>(handle);
 
-                // Lazy initialization: allocate temporary buffer
-                if (_this->vxBuffer == NULL)
-                {
-                    _this->vxBuffer = reinterpret_cast<vertex_t *>(malloc(VATTR_BUFFER_SIZE * sizeof(vertex_t)));
-                    if (_this->vxBuffer == NULL)
-                        return;
-                }
+                // Allocate temporary buffer
+                arena_t *arena          = _this->pArena;
+                arena_mark_t mark       = arena->mark();
+                vertex_t *vxbuf         = arena->alloc<vertex_t>(lsp_min(count, VATTR_BUFFER_SIZE));
+                if (vxbuf == NULL)
+                    return;
 
                 // Enable vertex pointer
                 ::glEnableClientState(GL_VERTEX_ARRAY);
-                ::glVertexPointer(4, GL_FLOAT, sizeof(vertex_t), &_this->vxBuffer->v);
+                ::glVertexPointer(4, GL_FLOAT, sizeof(vertex_t), &vxbuf->v);
 
                 // Enable normal pointer
                 if (bstate & DBUF_NORMAL)
                 {
                     ::glEnableClientState(GL_NORMAL_ARRAY);
-                    ::glNormalPointer(GL_FLOAT, sizeof(vertex_t), &_this->vxBuffer->n);
+                    ::glNormalPointer(GL_FLOAT, sizeof(vertex_t), &vxbuf->n);
                 }
                 else
                     ::glDisableClientState(GL_NORMAL_ARRAY);
@@ -534,7 +1073,7 @@ namespace lsp
                 if (bstate & DBUF_COLOR)
                 {
                     ::glEnableClientState(GL_COLOR_ARRAY);
-                    ::glColorPointer(4, GL_FLOAT, sizeof(vertex_t), &_this->vxBuffer->c);
+                    ::glColorPointer(4, GL_FLOAT, sizeof(vertex_t), &vxbuf->c);
                 }
                 else
                 {
@@ -560,7 +1099,7 @@ namespace lsp
                         to_do           = VATTR_BUFFER_SIZE;
 
                     // Fill the temporary buffer data
-                    vertex_t *vx    = _this->vxBuffer;
+                    vertex_t *vx    = vxbuf;
                     for (size_t i=0; i<to_do; ++i, ++vx)
                     {
                         size_t vxi      = off + i;
@@ -592,10 +1131,10 @@ namespace lsp
 
                     // Draw the buffer
                     if (buffer->type != r3d::PRIMITIVE_WIREFRAME_TRIANGLES)
-                        ::glDrawArrays(mode, 0, count);
+                        ::glDrawArrays(mode, 0, to_do);
                     else
                     {
-                        for (size_t i=0; i<count; i += 3)
+                        for (size_t i=0; i<to_do; i += 3)
                             ::glDrawArrays(mode, i, 3);
                     }
 
@@ -609,47 +1148,133 @@ namespace lsp
                 if (bstate & DBUF_NORMAL)
                     ::glDisableClientState(GL_NORMAL_ARRAY);
                 ::glDisableClientState(GL_VERTEX_ARRAY);
+
+                arena->release(mark);
             }
 
-            status_t backend_t::draw_primitives(r3d::backend_t *handle, const r3d::buffer_t *buffer)
+            static void gl_draw_clusters(backend_t *_this, GLenum mode, const r3d::buffer_t *buffer, geometry_t *g,
+                const r3d::mat4_t *projection, const r3d::mat4_t *modelview, uintptr_t ix)
             {
-                backend_t *_this = static_cast<backend_t *>(handle);
+                const cluster_set_t *cs = g->pClusters;
+                geometry_cache_t *cache = _this->pCache;
 
-                if (buffer == NULL)
-                    return STATUS_BAD_ARGUMENTS;
-                if ((_this->hDC == NULL) || (!_this->bDrawing))
-                    return STATUS_BAD_STATE;
+                // Faces are culled by OpenGL only if culling is not disabled for the buffer
+                cluster_view_t view;
+                cluster_view(&view, projection, modelview, !(buffer->flags & r3d::BUFFER_NO_CULLING));
 
-                // Is there any data to draw?
-                if (buffer->count <= 0)
-                    return STATUS_OK;
+                arena_t *arena          = _this->pArena;
+                arena_mark_t mark       = arena->mark();
+                cluster_range_t *ranges = arena->alloc<cluster_range_t>((cs->nClusters + 1) / 2);
+                if (ranges == NULL)
+                {
+                    arena->release(mark);
+                    ::glDrawElements(mode, g->nCount, GL_UNSIGNED_INT, reinterpret_cast<const void *>(ix));
+                    return;
+                }
 
-                //-------------------------------------------------------------
-                // Select the drawing mode
+                size_t visible          = 0;
+                size_t n                = cs->cull(ranges, &view, &visible);
+                cache->nClusterTests   += cs->nClusters;
+                cache->nClusterCulls   += cs->nClusters - visible;
+
+                for (size_t i=0; i<n; ++i)
+                {
+                    const cluster_range_t *r = &ranges[i];
+                    ::glDrawElements(mode, r->count, GL_UNSIGNED_INT, reinterpret_cast<const void *>(ix + r->first * sizeof(uint32_t)));
+                }
+
+                arena->release(mark);
+            }
+
+            static void gl_draw_geometry(backend_t *_this, GLenum mode, size_t bstate, const r3d::buffer_t *buffer, geometry_t *g,
+                const r3d::mat4_t *projection, const r3d::mat4_t *modelview, size_t first, size_t count)
+            {
+                const gl_ext_t *ext = _this->pExt;
+
+                // Translucent triangles should be drawn back-to-front, ranges of the ring keep the original order
+                bool sort               = (buffer->flags & r3d::BUFFER_BLENDING) && (count >= g->nCount);
+                const uint32_t *indices = _this->pCache->prepare_indices(ext, g, buffer,
+                    (sort) ? modelview : NULL, _this->pArena);
+
+                // Data is addressed relative to the bound buffer object or to the client memory
+                uintptr_t vx = 0, ix = 0;
+                if (g->nVBO != 0)
+                {
+                    ext->glBindBuffer(GL_ARRAY_BUFFER, g->nVBO);
+                    ext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g->nIBO);
+                }
+                else
+                {
+                    vx      = uintptr_t(g->vVertices);
+                    ix      = uintptr_t(indices);
+                }
+
+                // Enable vertex pointer
+                ::glEnableClientState(GL_VERTEX_ARRAY);
+                ::glVertexPointer(4, GL_FLOAT, sizeof(vertex_t), reinterpret_cast<const void *>(vx + offsetof(vertex_t, v)));
+
+                // Enable normal pointer
+                if (bstate & DBUF_NORMAL)
+                {
+                    ::glEnableClientState(GL_NORMAL_ARRAY);
+                    ::glNormalPointer(GL_FLOAT, sizeof(vertex_t), reinterpret_cast<const void *>(vx + offsetof(vertex_t, n)));
+                }
+                else
+                    ::glDisableClientState(GL_NORMAL_ARRAY);
+
+                // Enable color pointer
+                if (bstate & DBUF_COLOR)
+                {
+                    ::glEnableClientState(GL_COLOR_ARRAY);
+                    ::glColorPointer(4, GL_FLOAT, sizeof(vertex_t), reinterpret_cast<const void *>(vx + offsetof(vertex_t, c)));
+                }
+                else
+                {
+                    ::glColor4fv(&buffer->color.dfl.r);         // Set-up default color
+                    ::glDisableClientState(GL_COLOR_ARRAY);
+                }
+
+                // Draw the elements, only visible clusters of the clustered geometry are drawn
+                ix     += first * sizeof(uint32_t);
+                if ((g->pClusters != NULL) && (count >= g->nCount) && (!g->bSorted) && (_this->nListCompile == 0))
+                    gl_draw_clusters(_this, mode, buffer, g, projection, modelview, ix);
+                else if (buffer->type != r3d::PRIMITIVE_WIREFRAME_TRIANGLES)
+                    ::glDrawElements(mode, count, GL_UNSIGNED_INT, reinterpret_cast<const void *>(ix));
+                else
+                {
+                    for (size_t i=0; i<count; i += 3)
+                        ::glDrawElements(mode, 3, GL_UNSIGNED_INT, reinterpret_cast<const void *>(ix + i * sizeof(uint32_t)));
+                }
+
+                // Disable previous settings
+                if (bstate & DBUF_COLOR)
+                    ::glDisableClientState(GL_COLOR_ARRAY);
+                if (bstate & DBUF_NORMAL)
+                    ::glDisableClientState(GL_NORMAL_ARRAY);
+                ::glDisableClientState(GL_VERTEX_ARRAY);
+
+                if (g->nVBO != 0)
+                {
+                    ext->glBindBuffer(GL_ARRAY_BUFFER, 0);
+                    ext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+                }
+            }
 
+            static status_t check_buffer(const r3d::buffer_t *buffer, size_t *bstate_out, size_t *count_out)
+            {
                 // Check primitive type to draw
-                GLenum mode  = GL_TRIANGLES;
                 size_t count = buffer->count;
 
                 switch (buffer->type)
                 {
                     case r3d::PRIMITIVE_TRIANGLES:
-                        mode    = GL_TRIANGLES;
-                        count   = (count << 1) + count; // count *= 3
-                        break;
                     case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
-                        mode    = GL_LINE_LOOP;
                         count   = (count << 1) + count; // count *= 3
-                        ::glLineWidth(buffer->width);
                         break;
                     case r3d::PRIMITIVE_LINES:
-                        mode    = GL_LINES;
                         count <<= 1;                    // count *= 2
-                        ::glLineWidth(buffer->width);
                         break;
                     case r3d::PRIMITIVE_POINTS:
-                        mode    = GL_POINTS;
-                        ::glPointSize(buffer->width);
                         break;
                     default:
                         return STATUS_BAD_ARGUMENTS;
@@ -675,15 +1300,237 @@ namespace lsp
                     ((bstate & DBUF_COLOR_FLAGS) == DBUF_CINDEX))
                     return STATUS_BAD_ARGUMENTS; // Index buffers can not be definde without data buffers
 
-                //-------------------------------------------------------------
-                // Prepare drawing state
-                // Load matrices
+                *bstate_out = bstate;
+                *count_out  = count;
+
+                return STATUS_OK;
+            }
+
+            static void gl_flush_expanded(backend_t *_this)
+            {
+                expand_batch_t *batch   = _this->pExpand;
+                if ((batch == NULL) || (batch->nVertices <= 0))
+                    return;
+
+                // Expanded vertices are already in clip coordinates
                 ::glMatrixMode(GL_PROJECTION);
-                ::glLoadMatrixf(_this->matProjection.m);
+                ::glLoadIdentity();
                 ::glMatrixMode(GL_MODELVIEW);
-                ::glLoadMatrixf(_this->matView.m);
-                ::glMultMatrixf(_this->matWorld.m);
-                ::glMultMatrixf(buffer->model.m);
+                ::glLoadIdentity();
+                _this->nGLMatrices  = 0;
+
+                if (batch->nFlags & r3d::BUFFER_BLENDING)
+                {
+                    ::glEnable(GL_BLEND);
+                    if (batch->nFlags & r3d::BUFFER_STD_BLENDING)
+                        ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    else
+                        ::glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+                }
+                ::glDisable(GL_CULL_FACE);
+
+                ::glEnableClientState(GL_VERTEX_ARRAY);
+                ::glVertexPointer(4, GL_FLOAT, sizeof(expand_vertex_t), &batch->vVertices->v);
+                ::glEnableClientState(GL_COLOR_ARRAY);
+                ::glColorPointer(4, GL_FLOAT, sizeof(expand_vertex_t), &batch->vVertices->c);
+
+                ::glDrawArrays(GL_TRIANGLES, 0, batch->nVertices);
+
+                ::glDisableClientState(GL_COLOR_ARRAY);
+                ::glDisableClientState(GL_VERTEX_ARRAY);
+
+                ::glEnable(GL_CULL_FACE);
+                if (batch->nFlags & r3d::BUFFER_BLENDING)
+                    ::glDisable(GL_BLEND);
+
+                batch->clear();
+            }
+
+            static bool gl_expand_primitives(
+                backend_t *_this, const r3d::buffer_t *buffer,
+                const r3d::mat4_t *projection, const r3d::mat4_t *view_world)
+            {
+                // Only unlit lines and points are expanded
+                expand_batch_t *batch   = _this->pExpand;
+                if ((batch == NULL) ||
+                    (buffer->type == r3d::PRIMITIVE_TRIANGLES) ||
+                    (buffer->flags & r3d::BUFFER_LIGHTING))
+                    return false;
+
+                // Buffers with different blending can not share the batch
+                size_t flags        = buffer->flags & (r3d::BUFFER_BLENDING | r3d::BUFFER_STD_BLENDING);
+                if ((batch->nVertices > 0) && (batch->nFlags != flags))
+                    gl_flush_expanded(_this);
+                batch->nFlags       = flags;
+
+                r3d::mat4_t mv, mvp;
+                matrix_mul(&mv, view_world, &buffer->model);
+                matrix_mul(&mvp, projection, &mv);
+
+                return batch->add(buffer, &mvp, _this->nGLWidth, _this->nGLHeight) == STATUS_OK;
+            }
+
+            static void gl_load_modelview(backend_t *_this, const r3d::mat4_t *modelview)
+            {
+                if ((!(_this->nGLMatrices & GLM_MODELVIEW)) ||
+                    (::memcmp(&_this->matGLModelView, modelview, sizeof(r3d::mat4_t)) != 0))
+                {
+                    ::glMatrixMode(GL_MODELVIEW);
+                    ::glLoadMatrixf(modelview->m);
+                    _this->matGLModelView   = *modelview;
+                    _this->nGLMatrices     |= GLM_MODELVIEW;
+                }
+            }
+
+            static void ring_range(r3d::buffer_t *dst, const r3d::buffer_t *src, size_t bstate, size_t total, size_t first, size_t count)
+            {
+                // Select the range of vertices by shifting index pointers, or data pointers if there are no indices
+                *dst                = *src;
+                if (bstate & DBUF_VINDEX)
+                    dst->vertex.index   = &src->vertex.index[first];
+                else
+                {
+                    const uint8_t *v    = reinterpret_cast<const uint8_t *>(src->vertex.data);
+                    size_t vstride      = (src->vertex.stride == 0) ? sizeof(r3d::dot4_t) : src->vertex.stride;
+                    dst->vertex.data    = reinterpret_cast<const r3d::dot4_t *>(&v[first * vstride]);
+                }
+
+                // Normals and colors without indices follow the vertex index on the simple path
+                // and the element position on the indexed path, in both cases they are shifted
+                // if the vertex data is shifted or the indexed path is taken
+                if ((!(bstate & DBUF_VINDEX)) || (bstate & (DBUF_NINDEX | DBUF_CINDEX)))
+                {
+                    if ((bstate & DBUF_NORMAL_FLAGS) == DBUF_NORMAL)
+                    {
+                        const uint8_t *n    = reinterpret_cast<const uint8_t *>(src->normal.data);
+                        size_t nstride      = (src->normal.stride == 0) ? sizeof(r3d::vec4_t) : src->normal.stride;
+                        dst->normal.data    = reinterpret_cast<const r3d::vec4_t *>(&n[first * nstride]);
+                    }
+                    if ((bstate & DBUF_COLOR_FLAGS) == DBUF_COLOR)
+                    {
+                        const uint8_t *c    = reinterpret_cast<const uint8_t *>(src->color.data);
+                        size_t cstride      = (src->color.stride == 0) ? sizeof(r3d::color_t) : src->color.stride;
+                        dst->color.data     = reinterpret_cast<const r3d::color_t *>(&c[first * cstride]);
+                    }
+                }
+                if (bstate & DBUF_NINDEX)
+                    dst->normal.index   = &src->normal.index[first];
+                if (bstate & DBUF_CINDEX)
+                    dst->color.index    = &src->color.index[first];
+                dst->count          = count / (total / src->count);
+            }
+
+            static void gl_draw_range(backend_t *_this, GLenum mode, size_t bstate, const r3d::buffer_t *buffer, size_t total,
+                geometry_t *g, const r3d::mat4_t *projection, const r3d::mat4_t *modelview, size_t first, size_t count)
+            {
+                if (g != NULL)
+                {
+                    gl_draw_geometry(_this, mode, bstate, buffer, g, projection, modelview, first, count);
+                    return;
+                }
+
+                r3d::buffer_t range;
+                if (count < total)
+                {
+                    ring_range(&range, buffer, bstate, total, first, count);
+                    buffer              = &range;
+                }
+
+                if (!(bstate & (DBUF_NINDEX | DBUF_CINDEX)))
+                    gl_draw_arrays_simple(mode, bstate, buffer, count);
+                else
+                    gl_draw_arrays_indexed(_this, mode, bstate, buffer, count);
+            }
+
+            static void gl_draw_primitives(
+                backend_t *_this, const r3d::buffer_t *buffer, const r3d::buffer_t *key, size_t bstate, size_t count,
+                const r3d::mat4_t *projection, const r3d::mat4_t *view_world, const ring_t *ring)
+            {
+                _this->bFxaaDone    = false;
+
+                // The ring is drawn as two ranges of vertices
+                size_t ring_first   = 0;
+                if ((ring != NULL) && (ring->first > 0) && (ring->first < buffer->count))
+                    ring_first          = ring->first * (count / buffer->count);
+
+                // Draw the level of detail of large point and line buffers
+                r3d::buffer_t lod, lod_key;
+                if ((_this->pLod != NULL) && (_this->nListCompile == 0) && (ring_first == 0))
+                {
+                    r3d::mat4_t mv, mvp;
+                    matrix_mul(&mv, view_world, &buffer->model);
+                    matrix_mul(&mvp, projection, &mv);
+                    if ((_this->pLod->decimate(&lod, key, buffer, &mvp, _this->nGLWidth, _this->nGLHeight, _this->pArena)) &&
+                        (check_buffer(&lod, &bstate, &count) == STATUS_OK))
+                    {
+                        // The key keeps the caller's data pointers and refers indices of the level
+                        lod_key                 = *key;
+                        lod_key.count           = lod.count;
+                        lod_key.vertex.index    = lod.vertex.index;
+                        lod_key.normal.index    = lod.normal.index;
+                        lod_key.color.index     = lod.color.index;
+                        buffer                  = &lod;
+                        key                     = &lod_key;
+                    }
+                }
+
+                // Lines and points are batched when expanded, other primitives are drawn after the batch
+                if ((ring_first == 0) && (gl_expand_primitives(_this, buffer, projection, view_world)))
+                    return;
+                gl_flush_expanded(_this);
+
+                //-------------------------------------------------------------
+                // Select the drawing mode
+                GLenum mode  = GL_TRIANGLES;
+
+                switch (buffer->type)
+                {
+                    case r3d::PRIMITIVE_TRIANGLES:
+                        mode    = GL_TRIANGLES;
+                        break;
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        mode    = GL_LINE_LOOP;
+                        ::glLineWidth(buffer->width);
+                        break;
+                    case r3d::PRIMITIVE_LINES:
+                        mode    = GL_LINES;
+                        ::glLineWidth(buffer->width);
+                        break;
+                    case r3d::PRIMITIVE_POINTS:
+                        mode    = GL_POINTS;
+                        ::glPointSize(buffer->width);
+                        break;
+                    default:
+                        return;
+                }
+
+                //-------------------------------------------------------------
+                // Prepare drawing state
+                // Load matrices, skip matrices that did not change since the previous draw
+                r3d::mat4_t modelview;
+                matrix_mul(&modelview, view_world, &buffer->model);
+
+                if ((!(_this->nGLMatrices & GLM_PROJECTION)) ||
+                    (::memcmp(&_this->matGLProjection, projection, sizeof(r3d::mat4_t)) != 0))
+                {
+                    ::glMatrixMode(GL_PROJECTION);
+                    ::glLoadMatrixf(projection->m);
+                    _this->matGLProjection  = *projection;
+                    _this->nGLMatrices     |= GLM_PROJECTION;
+                }
+                gl_load_modelview(_this, &modelview);
+
+                // Skip the heavy buffer hidden in the previous frame
+                occlusion_cache_t *occ  = _this->pOcclusion;
+                if ((occ->nMinCount > 0) && (buffer->count >= occ->nMinCount) &&
+                    (_this->pExt->bOcclusion) && (_this->nViews == 0) && (!_this->bTiled) && (_this->nListCompile == 0) &&
+                    (ring_first == 0))
+                {
+                    r3d::mat4_t mvp;
+                    matrix_mul(&mvp, projection, &modelview);
+                    if (!occ->test(_this->pExt, key, buffer, count, &mvp))
+                        return;
+                }
 
                 // enable blending
                 if (buffer->flags & r3d::BUFFER_BLENDING)
@@ -701,10 +1548,21 @@ namespace lsp
 
                 //-------------------------------------------------------------
                 // Draw the buffer data
-                if (!(bstate & (DBUF_NINDEX | DBUF_CINDEX)))
-                    gl_draw_arrays_simple(mode, bstate, buffer, count);
+                geometry_t *g = NULL;
+                if (_this->pCache->nFlags & CACHE_GEOMETRY)
+                    g = _this->pCache->get(_this->pExt, key, buffer, count, ring_first > 0, _this->pArena);
+
+                if (ring_first == 0)
+                    gl_draw_range(_this, mode, bstate, buffer, count, g, projection, &modelview, 0, count);
                 else
-                    gl_draw_arrays_indexed(handle, mode, bstate, buffer, count);
+                {
+                    // Draw the tail of the ring, then the wrapped head with the additional transform
+                    r3d::mat4_t wrapped;
+                    gl_draw_range(_this, mode, bstate, buffer, count, g, projection, &modelview, ring_first, count - ring_first);
+                    matrix_mul(&wrapped, &modelview, &ring->wrap);
+                    gl_load_modelview(_this, &wrapped);
+                    gl_draw_range(_this, mode, bstate, buffer, count, g, projection, &wrapped, 0, ring_first);
+                }
 
                 //-------------------------------------------------------------
                 // Reset the drawing state
@@ -714,81 +1572,2054 @@ namespace lsp
                     ::glDisable(GL_LIGHTING);
                 if (buffer->flags & r3d::BUFFER_NO_CULLING)
                     ::glEnable(GL_CULL_FACE);
+            }
+
+            static const r3d::mat4_t *view_world(backend_t *_this)
+            {
+                // The product is computed once after the view or world matrix change
+                if (!_this->bViewWorld)
+                {
+                    matrix_mul(&_this->matViewWorld, &_this->matView, &_this->matWorld);
+                    _this->bViewWorld   = true;
+                }
+                return &_this->matViewWorld;
+            }
+
+            static size_t index_extent(const uint32_t *index, size_t count)
+            {
+                uint32_t max = 0;
+                for (size_t i=0; i<count; ++i)
+                    max = lsp_max(max, index[i]);
+                return size_t(max) + 1;
+            }
+
+            template <class T>
+                static const T *copy_array(uint8_t * &dst, const T *src, size_t stride, size_t count)
+                {
+                    T *res = reinterpret_cast<T *>(dst);
+                    if ((stride == 0) || (stride == sizeof(T)))
+                        ::memcpy(res, src, count * sizeof(T));
+                    else
+                    {
+                        const uint8_t *ptr = reinterpret_cast<const uint8_t *>(src);
+                        for (size_t i=0; i<count; ++i, ptr += stride)
+                            res[i]  = *(reinterpret_cast<const T *>(ptr));
+                    }
+
+                    dst    += align_size(count * sizeof(T));
+                    return res;
+                }
 
+            static status_t submit_draw_primitives(
+                backend_t *_this, const r3d::buffer_t *buffer, size_t bstate, size_t count,
+                const r3d::mat4_t *projection, const r3d::mat4_t *view_world, const ring_t *ring)
+            {
+                // Estimate the amount of data referenced by the buffer
+                // Unindexed normals and colors are read per element on the indexed draw path and per vertex otherwise
+                size_t vext     = (bstate & DBUF_VINDEX) ? index_extent(buffer->vertex.index, count) : count;
+                size_t uext     = (bstate & (DBUF_NINDEX | DBUF_CINDEX)) ? count : vext;
+                size_t next     = (bstate & DBUF_NORMAL) ?
+                                  ((bstate & DBUF_NINDEX) ? index_extent(buffer->normal.index, count) : uext) : 0;
+                size_t cext     = (bstate & DBUF_COLOR) ?
+                                  ((bstate & DBUF_CINDEX) ? index_extent(buffer->color.index, count) : uext) : 0;
+                size_t isize    = align_size(count * sizeof(uint32_t));
+                size_t hdr_size = align_size(sizeof(cmd_draw_t));
+                size_t size     =
+                    hdr_size +
+                    align_size(vext * sizeof(r3d::dot4_t)) +
+                    align_size(next * sizeof(r3d::vec4_t)) +
+                    align_size(cext * sizeof(r3d::color_t));
+                if (bstate & DBUF_VINDEX)
+                    size           += isize;
+                if (bstate & DBUF_NINDEX)
+                    size           += isize;
+                if (bstate & DBUF_CINDEX)
+                    size           += isize;
+
+                // Too large data is not copied, the render thread refers the caller's data
+                // and the caller waits until the drawing is complete
+                bool copy       = size <= _this->pQueue->max_record();
+                cmd_draw_t *cmd = reinterpret_cast<cmd_draw_t *>(enqueue(_this, CMD_DRAW, (copy) ? size : sizeof(cmd_draw_t)));
+                cmd->projection = *projection;
+                cmd->view_world = *view_world;
+                cmd->buffer     = *buffer;
+                cmd->key        = *buffer;
+                cmd->ring.first = 0;
+                if (ring != NULL)
+                    cmd->ring       = *ring;
+                cmd->result     = NULL;
+
+                if (!copy)
+                {
+                    status_t res    = STATUS_OK;
+                    cmd->result     = &res;
+                    uint32_t ticket = ++_this->nSubmitted;
+                    submit(_this);
+                    wait_completion(_this, ticket);
+                    return res;
+                }
+
+                // Copy buffer data to the record
+                r3d::buffer_t *dst  = &cmd->buffer;
+                uint8_t *ptr        = reinterpret_cast<uint8_t *>(cmd) + hdr_size;
+
+                dst->vertex.data    = copy_array(ptr, buffer->vertex.data, buffer->vertex.stride, vext);
+                dst->vertex.stride  = 0;
+                if (bstate & DBUF_VINDEX)
+                    dst->vertex.index   = copy_array<uint32_t>(ptr, buffer->vertex.index, 0, count);
+                if (bstate & DBUF_NORMAL)
+                {
+                    dst->normal.data    = copy_array(ptr, buffer->normal.data, buffer->normal.stride, next);
+                    dst->normal.stride  = 0;
+                    if (bstate & DBUF_NINDEX)
+                        dst->normal.index   = copy_array<uint32_t>(ptr, buffer->normal.index, 0, count);
+                }
+                if (bstate & DBUF_COLOR)
+                {
+                    dst->color.data     = copy_array(ptr, buffer->color.data, buffer->color.stride, cext);
+                    dst->color.stride   = 0;
+                    if (bstate & DBUF_CINDEX)
+                        dst->color.index    = copy_array<uint32_t>(ptr, buffer->color.index, 0, count);
+                }
+
+                submit(_this);
                 return STATUS_OK;
             }
 
-            status_t backend_t::sync(r3d::backend_t *handle)
+            static status_t exec_draw_primitives(
+                backend_t *_this, const r3d::buffer_t *buffer, size_t bstate, size_t count,
+                const r3d::mat4_t *projection, const r3d::mat4_t *view_world, const ring_t *ring)
+            {
+                if (_this->pQueue != NULL)
+                    return submit_draw_primitives(_this, buffer, bstate, count, projection, view_world, ring);
+
+                gl_draw_primitives(_this, buffer, buffer, bstate, count, projection, view_world, ring);
+                return STATUS_OK;
+            }
+
+            static void gl_viewport(backend_t *_this, GLint left, GLint bottom, GLsizei width, GLsizei height, bool scissor)
+            {
+                // Expanded primitives depend on the size of the viewport
+                gl_flush_expanded(_this);
+                ::glViewport(left, bottom, width, height);
+                _this->nGLWidth     = width;
+                _this->nGLHeight    = height;
+                if (scissor)
+                {
+                    ::glScissor(left, bottom, width, height);
+                    ::glEnable(GL_SCISSOR_TEST);
+                }
+                else
+                    ::glDisable(GL_SCISSOR_TEST);
+            }
+
+            static void exec_viewport(backend_t *_this, ssize_t left, ssize_t bottom, ssize_t width, ssize_t height, bool scissor)
+            {
+                if (_this->pQueue == NULL)
+                {
+                    gl_viewport(_this, left, bottom, width, height, scissor);
+                    return;
+                }
+
+                cmd_viewport_t *cmd = reinterpret_cast<cmd_viewport_t *>(enqueue(_this, CMD_VIEWPORT, sizeof(cmd_viewport_t)));
+                cmd->left           = int32_t(left);
+                cmd->bottom         = int32_t(bottom);
+                cmd->width          = int32_t(width);
+                cmd->height         = int32_t(height);
+                cmd->scissor        = scissor;
+                submit(_this);
+            }
+
+            static status_t exec_records(backend_t *_this, const view_t *view, const r3d::mat4_t *crop)
+            {
+                frame_t *f          = _this->pFrame;
+                r3d::mat4_t vw, proj;
+
+                for (frame_record_t *rec = f->first(); rec != NULL; rec = f->next(rec))
+                {
+                    status_t res;
+                    switch (rec->type)
+                    {
+                        case FRAME_LIGHTS:
+                        {
+                            const frame_lights_t *cmd = reinterpret_cast<const frame_lights_t *>(rec);
+                            res     = exec_set_lights(_this, frame_t::lights(cmd), cmd->count);
+                            break;
+                        }
+                        case FRAME_DRAW:
+                        {
+                            const frame_draw_t *cmd = reinterpret_cast<const frame_draw_t *>(rec);
+                            size_t bstate = 0, count = 0;
+                            res     = check_buffer(&cmd->buffer, &bstate, &count);
+                            if (res != STATUS_OK)
+                                break;
+
+                            // Views replace the projection and view matrices of the draw
+                            if (view != NULL)
+                            {
+                                matrix_mul(&vw, &view->view, &cmd->world);
+                                res     = exec_draw_primitives(_this, &cmd->buffer, bstate, count, &view->projection, &vw, &cmd->ring);
+                            }
+                            else if (crop != NULL)
+                            {
+                                // Tiles select the part of the projection
+                                matrix_mul(&proj, crop, &cmd->projection);
+                                res     = exec_draw_primitives(_this, &cmd->buffer, bstate, count, &proj, &cmd->view_world, &cmd->ring);
+                            }
+                            else
+                                res     = exec_draw_primitives(_this, &cmd->buffer, bstate, count, &cmd->projection, &cmd->view_world, &cmd->ring);
+                            break;
+                        }
+                        default:
+                            res     = STATUS_CORRUPTED;
+                            break;
+                    }
+                    if (res != STATUS_OK)
+                        return res;
+                }
+
+                return STATUS_OK;
+            }
+
+            static status_t exec_frame(backend_t *_this)
+            {
+                // Issue all recorded calls of the deferred frame
+                _this->bDeferred    = false;
+                exec_start(_this, background(_this));
+                if (_this->bFrameReuse)
+                    ++_this->sFrameStats.nDrawn;
+
+                if (_this->nViews <= 0)
+                    return exec_records(_this, NULL, NULL);
+
+                // Draw the recorded calls once per view, views are defined with top-left origin
+                // and are scaled together with the render target
+                ssize_t width, height;
+                render_size(_this, &width, &height);
+
+                status_t res        = STATUS_OK;
+                for (size_t i=0; i<_this->nViews; ++i)
+                {
+                    const view_t *v     = &_this->vViews[i];
+                    ssize_t x0          = (v->left * width) / _this->viewWidth;
+                    ssize_t x1          = lsp_max(((v->left + v->width) * width) / _this->viewWidth, x0 + 1);
+                    ssize_t y0          = (v->top * height) / _this->viewHeight;
+                    ssize_t y1          = lsp_max(((v->top + v->height) * height) / _this->viewHeight, y0 + 1);
+
+                    exec_viewport(_this, x0, height - y1, x1 - x0, y1 - y0, true);
+                    if ((res = exec_records(_this, v, NULL)) != STATUS_OK)
+                        break;
+                }
+                exec_viewport(_this, 0, 0, width, height, false);
+
+                return res;
+            }
+
+            static status_t draw_buffer(backend_t *_this, const r3d::buffer_t *buffer, const ring_t *ring)
+            {
+                // Draw the object identifier instead of the color in picking mode
+                r3d::buffer_t pick;
+                if (_this->bPicking)
+                {
+                    uint32_t id         = _this->nObjectId;
+                    pick                = *buffer;
+                    pick.flags         &= ~size_t(r3d::BUFFER_BLENDING | r3d::BUFFER_STD_BLENDING | r3d::BUFFER_LIGHTING);
+                    pick.normal.data    = NULL;
+                    pick.normal.stride  = 0;
+                    pick.normal.index   = NULL;
+                    pick.color.data     = NULL;
+                    pick.color.stride   = 0;
+                    pick.color.index    = NULL;
+                    pick.color.dfl.r    = ((id >> 16) & 0xff) / 255.0f;
+                    pick.color.dfl.g    = ((id >> 8) & 0xff) / 255.0f;
+                    pick.color.dfl.b    = (id & 0xff) / 255.0f;
+                    pick.color.dfl.a    = 1.0f;
+                    buffer              = &pick;
+                }
+
+                size_t bstate = 0, count = 0;
+                status_t res = check_buffer(buffer, &bstate, &count);
+                if (res != STATUS_OK)
+                    return res;
+
+                if (_this->bDeferred)
+                    return _this->pFrame->add_draw(buffer, &_this->matProjection, view_world(_this), &_this->matWorld, ring, _this->nObjectId);
+
+                return exec_draw_primitives(_this, buffer, bstate, count, &_this->matProjection, view_world(_this), ring);
+            }
+
+            status_t backend_t::draw_primitives(r3d::backend_t *handle, const r3d::buffer_t *buffer)
             {
                 backend_t *_this = static_cast<backend_t *>(handle);
 
-                if ((_this->hGL == NULL) || (!_this->bDrawing))
+                if (buffer == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->hDC == NULL) || (!_this->bDrawing))
                     return STATUS_BAD_STATE;
+                if ((_this->pTrace != NULL) && (_this->nListCompile == 0))
+                    _this->pTrace->draw_primitives(buffer);
+
+                // Is there any data to draw?
+                if (buffer->count <= 0)
+                    return STATUS_OK;
+
+                return draw_buffer(_this, buffer, NULL);
+            }
 
+            static void gl_sync(backend_t *_this)
+            {
+                gl_flush_expanded(_this);
                 ::glFinish();
                 ::glFlush();
-
-                return STATUS_OK;
             }
 
-            status_t backend_t::read_pixels(r3d::backend_t *handle, void *buf, r3d::pixel_format_t format)
+            status_t backend_t::sync(r3d::backend_t *handle)
             {
                 backend_t *_this = static_cast<backend_t *>(handle);
 
-                if ((_this->hDC == NULL) || (!_this->bDrawing))
+                if ((_this->hGL == NULL) || (!_this->bDrawing))
                     return STATUS_BAD_STATE;
+                if (_this->pTrace != NULL)
+                    _this->pTrace->sync();
+
+                // Nothing has been issued to the context yet
+                if (_this->bDeferred)
+                    return STATUS_OK;
+
+                if (_this->pQueue != NULL)
+                    return take_async_error(_this, call_render_thread(_this, CMD_SYNC));
+
+                gl_sync(_this);
+
+                return STATUS_OK;
+            }
 
-                size_t fmt;
-                size_t row_size;
+            static bool gl_pixel_format(r3d::pixel_format_t format, GLenum *fmt, size_t *bpp)
+            {
                 switch (format)
                 {
                     case r3d::PIXEL_RGBA:
-                        fmt         = GL_RGBA;
-                        row_size    = _this->viewWidth * 4;
+                        *fmt        = GL_RGBA;
+                        *bpp        = 4;
                         break;
                     case r3d::PIXEL_BGRA:
-                        fmt         = GL_BGRA;
-                        row_size    = _this->viewWidth * 4;
+                        *fmt        = GL_BGRA;
+                        *bpp        = 4;
                         break;
                     case r3d::PIXEL_RGB:
-                        fmt         = GL_RGB;
-                        row_size    = _this->viewWidth * 3;
+                        *fmt        = GL_RGB;
+                        *bpp        = 3;
                         break;
                     case r3d::PIXEL_BGR:
-                        fmt         = GL_BGR;
-                        row_size    = _this->viewWidth * 3;
+                        *fmt        = GL_BGR;
+                        *bpp        = 3;
                         break;
                     default:
-                        return STATUS_BAD_ARGUMENTS;
+                        return false;
                 }
+                return true;
+            }
 
-                ::glReadBuffer(GL_BACK);
-                ::glReadPixels(0, 0, _this->viewWidth, _this->viewHeight, fmt, GL_UNSIGNED_BYTE, buf);
-                base_backend_t::swap_rows(buf, _this->viewHeight, row_size);
+            static GLuint gl_compile_fxaa(const gl_ext_t *ext)
+            {
+                const char *src     = fxaa_shader();
+                GLint ok            = GL_FALSE;
+                GLuint shader       = ext->glCreateShader(GL_FRAGMENT_SHADER);
+                if (shader == 0)
+                    return 0;
+                ext->glShaderSource(shader, 1, &src, NULL);
+                ext->glCompileShader(shader);
+                ext->glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+                if (ok != GL_TRUE)
+                {
+                    ext->glDeleteShader(shader);
+                    return 0;
+                }
 
-                return STATUS_OK;
+                // The shader is deleted with the program it is attached to
+                GLuint program      = ext->glCreateProgram();
+                if (program != 0)
+                {
+                    ext->glAttachShader(program, shader);
+                    ext->glLinkProgram(program);
+                    ext->glGetProgramiv(program, GL_LINK_STATUS, &ok);
+                    if (ok != GL_TRUE)
+                    {
+                        ext->glDeleteProgram(program);
+                        program             = 0;
+                    }
+                }
+                ext->glDeleteShader(shader);
+
+                return program;
             }
 
-            status_t backend_t::finish(r3d::backend_t *handle)
+            static bool gl_init_fxaa(backend_t *_this, ssize_t width, ssize_t height)
             {
-                backend_t *_this = static_cast<backend_t *>(handle);
-                if ((_this->hGL == NULL) || (!_this->bDrawing))
-                    return STATUS_BAD_STATE;
+                const gl_ext_t *ext     = _this->pExt;
+                if ((!ext->bShaders) || (_this->bFxaaCPU))
+                    return false;
 
-                ::glFinish();
-                ::glFlush();
-                SwapBuffers(_this->hDC);
+                if (_this->nFxaaProgram == 0)
+                {
+                    GLuint program          = gl_compile_fxaa(ext);
+                    if (program == 0)
+                    {
+                        lsp_warn("Failed to build FXAA shader, pixels will be filtered by CPU");
+                        _this->bFxaaCPU         = true;
+                        return false;
+                    }
 
-                // Set active context
-                if (::wglGetCurrentContext() == _this->hGL)
-                    ::wglMakeCurrent(_this->hDC, NULL);
+                    ext->glUseProgram(program);
+                    ext->glUniform1i(ext->glGetUniformLocation(program, "frame"), 0);
+                    ext->glUseProgram(0);
+                    _this->nFxaaProgram     = program;
+                    _this->nFxaaTexel       = ext->glGetUniformLocation(program, "texel");
+                }
 
-                // Reset drawing flag
-                _this->bDrawing     = false;
+                // The texture holds the copy of the frame and is resized with the render target
+                if (_this->nFxaaTexture == 0)
+                {
+                    ::glGenTextures(1, &_this->nFxaaTexture);
+                    _this->nFxaaWidth       = 0;
+                    _this->nFxaaHeight      = 0;
+                }
+                ::glBindTexture(GL_TEXTURE_2D, _this->nFxaaTexture);
+                if ((_this->nFxaaWidth != width) || (_this->nFxaaHeight != height))
+                {
+                    ::glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+                    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    _this->nFxaaWidth       = width;
+                    _this->nFxaaHeight      = height;
+                }
 
-                return STATUS_OK;
+                return true;
             }
+
+            /**
+             * Apply the anti-aliasing pass to the back buffer if it is enabled
+             * @return true if the read pixels should be filtered by the CPU
+             */
+            static bool gl_apply_fxaa(backend_t *_this, ssize_t width, ssize_t height)
+            {
+                if ((!_this->bFxaa) || (_this->bPicking))
+                    return false;
+                if (_this->bFxaaDone)
+                    return false;
+                if (!gl_init_fxaa(_this, width, height))
+                    return true;
+
+                // Copy the frame into the texture and draw it back through the filter
+                const gl_ext_t *ext     = _this->pExt;
+                ::glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+                ::glPushAttrib(GL_ENABLE_BIT | GL_VIEWPORT_BIT);
+                ::glViewport(0, 0, width, height);
+                ::glDisable(GL_SCISSOR_TEST);
+                ::glDisable(GL_DEPTH_TEST);
+                ::glDisable(GL_CULL_FACE);
+                ::glDisable(GL_BLEND);
+                ::glDisable(GL_DITHER);
+
+                ::glMatrixMode(GL_PROJECTION);
+                ::glLoadIdentity();
+                ::glMatrixMode(GL_MODELVIEW);
+                ::glLoadIdentity();
+                _this->nGLMatrices  = 0;
+
+                ext->glUseProgram(_this->nFxaaProgram);
+                ext->glUniform2f(_this->nFxaaTexel, 1.0f / width, 1.0f / height);
+                ::glBegin(GL_QUADS);
+                    ::glTexCoord2f(0.0f, 0.0f);
+                    ::glVertex2f(-1.0f, -1.0f);
+                    ::glTexCoord2f(1.0f, 0.0f);
+                    ::glVertex2f(1.0f, -1.0f);
+                    ::glTexCoord2f(1.0f, 1.0f);
+                    ::glVertex2f(1.0f, 1.0f);
+                    ::glTexCoord2f(0.0f, 1.0f);
+                    ::glVertex2f(-1.0f, 1.0f);
+                ::glEnd();
+                ext->glUseProgram(0);
+
+                ::glBindTexture(GL_TEXTURE_2D, 0);
+                ::glPopAttrib();
+
+                _this->bFxaaDone    = true;
+                return false;
+            }
+
+            static status_t gl_read_pixels(backend_t *_this, void *buf, r3d::pixel_format_t format)
+            {
+                gl_flush_expanded(_this);
+
+                GLenum fmt;
+                size_t bpp;
+                if (!gl_pixel_format(format, &fmt, &bpp))
+                    return STATUS_BAD_ARGUMENTS;
+
+                ssize_t width, height;
+                render_size(_this, &width, &height);
+                bool filter         = gl_apply_fxaa(_this, width, height);
+
+                ::glReadBuffer(GL_BACK);
+
+                arena_t *arena      = _this->pArena;
+                arena_mark_t mark   = arena->mark();
+                if ((width == _this->viewWidth) && (height == _this->viewHeight))
+                {
+                    // Pixels are read into the temporary buffer and filtered into the caller's buffer
+                    size_t row_size     = width * bpp;
+                    uint8_t *src        = static_cast<uint8_t *>(buf);
+                    if ((filter) && ((src = arena->alloc<uint8_t>(row_size * height)) == NULL))
+                        return STATUS_NO_MEM;
+
+                    // Rows of 3-byte formats are not padded to 4 bytes in the caller's buffer
+                    ::glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                    ::glReadPixels(0, 0, _this->viewWidth, _this->viewHeight, fmt, GL_UNSIGNED_BYTE, src);
+                    ::glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+                    status_t res        = STATUS_OK;
+                    if (filter)
+                        res                 = fxaa(static_cast<uint8_t *>(buf), row_size, src, row_size, width, height, bpp, arena);
+                    arena->release(mark);
+                    if (res == STATUS_OK)
+                        base_backend_t::swap_rows(buf, _this->viewHeight, row_size);
+                    return res;
+                }
+
+                // Read the scaled frame and upscale it to the size of the viewport
+                size_t row_size     = width * bpp;
+                size_t size         = row_size * height;
+                if (size > _this->nScaledCap)
+                {
+                    uint8_t *ptr        = static_cast<uint8_t *>(realloc(_this->vScaled, size));
+                    if (ptr == NULL)
+                        return STATUS_NO_MEM;
+                    _this->vScaled      = ptr;
+                    _this->nScaledCap   = size;
+                }
+
+                ::glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                ::glReadPixels(0, 0, width, height, fmt, GL_UNSIGNED_BYTE, _this->vScaled);
+                ::glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+                // Filter the frame before upscaling
+                const uint8_t *src  = _this->vScaled;
+                if (filter)
+                {
+                    uint8_t *dst        = arena->alloc<uint8_t>(size);
+                    if (dst == NULL)
+                        return STATUS_NO_MEM;
+                    status_t res        = fxaa(dst, row_size, src, row_size, width, height, bpp, arena);
+                    if (res != STATUS_OK)
+                    {
+                        arena->release(mark);
+                        return res;
+                    }
+                    src                 = dst;
+                }
+
+                status_t res        = upscale_bilinear(
+                    static_cast<uint8_t *>(buf), _this->viewWidth, _this->viewHeight, _this->viewWidth * bpp,
+                    src, width, height, row_size,
+                    bpp, true);
+                arena->release(mark);
+
+                return res;
+            }
+
+            static status_t exec_read_pixels(backend_t *_this, void *buf, r3d::pixel_format_t format);
+
+            static size_t pixel_size(r3d::pixel_format_t format)
+            {
+                switch (format)
+                {
+                    case r3d::PIXEL_RGBA:
+                    case r3d::PIXEL_BGRA:
+                        return 4;
+                    case r3d::PIXEL_RGB:
+                    case r3d::PIXEL_BGR:
+                        return 3;
+                    default:
+                        break;
+                }
+                return 0;
+            }
+
+            static status_t read_deferred_pixels(backend_t *_this, void *buf, r3d::pixel_format_t format)
+            {
+                size_t bpp          = pixel_size(format);
+                if (bpp == 0)
+                    return STATUS_BAD_ARGUMENTS;
+                size_t size         = _this->viewWidth * _this->viewHeight * bpp;
+
+                // Return pixels of the previous frame if all inputs are the same
+                uint64_t hash       = _this->pFrame->nHash;
+                if ((_this->bFrameReuse) &&
+                    (_this->bPixels) &&
+                    (_this->nPixelsHash == hash) &&
+                    (_this->enPixelsFormat == format))
+                {
+                    ::memcpy(buf, _this->vPixels, size);
+                    _this->bReused      = true;
+                    return STATUS_OK;
+                }
+
+                // Draw the frame and keep the copy of the pixels
+                status_t res        = exec_frame(_this);
+                if (res == STATUS_OK)
+                    res                 = exec_read_pixels(_this, buf, format);
+                if ((res != STATUS_OK) || (!_this->bFrameReuse))
+                    return res;
+
+                if (size > _this->nPixelsCap)
+                {
+                    uint8_t *ptr        = static_cast<uint8_t *>(realloc(_this->vPixels, size));
+                    if (ptr == NULL)
+                    {
+                        _this->bPixels      = false;
+                        return STATUS_OK;
+                    }
+                    _this->vPixels      = ptr;
+                    _this->nPixelsCap   = size;
+                }
+                ::memcpy(_this->vPixels, buf, size);
+                _this->nPixelsHash  = hash;
+                _this->enPixelsFormat = format;
+                _this->bPixels      = true;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::read_pixels(r3d::backend_t *handle, void *buf, r3d::pixel_format_t format)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+
+                if ((_this->hDC == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (_this->bTiled)
+                    return STATUS_BAD_STATE;
+                if (_this->pTrace != NULL)
+                    _this->pTrace->read_pixels(format);
+                if (_this->bDeferred)
+                    return read_deferred_pixels(_this, buf, format);
+
+                return exec_read_pixels(_this, buf, format);
+            }
+
+            static status_t exec_read_pixels(backend_t *_this, void *buf, r3d::pixel_format_t format)
+            {
+                if (_this->pQueue == NULL)
+                    return gl_read_pixels(_this, buf, format);
+
+                // Pass the command to the render thread and wait for the result
+                status_t res            = STATUS_OK;
+                cmd_read_pixels_t *cmd  = reinterpret_cast<cmd_read_pixels_t *>(
+                    enqueue(_this, CMD_READ_PIXELS, sizeof(cmd_read_pixels_t)));
+                cmd->buf                = buf;
+                cmd->format             = format;
+                cmd->result             = &res;
+                uint32_t ticket         = ++_this->nSubmitted;
+                submit(_this);
+                wait_completion(_this, ticket);
+
+                return take_async_error(_this, res);
+            }
+
+            static status_t gl_read_pixels_ex(backend_t *_this, void *buf, size_t stride, read_format_t format)
+            {
+                gl_flush_expanded(_this);
+
+                // Read the frame once in the native format into the temporary buffer
+                ssize_t width, height;
+                render_size(_this, &width, &height);
+                bool filter         = gl_apply_fxaa(_this, width, height);
+
+                arena_t *arena      = _this->pArena;
+                arena_mark_t mark   = arena->mark();
+                size_t row_size     = width * 4;
+                uint8_t *src        = arena->alloc<uint8_t>(row_size * height);
+                if (src == NULL)
+                    return STATUS_NO_MEM;
+
+                ::glReadBuffer(GL_BACK);
+                ::glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, src);
+
+                // Filter the frame before upscaling
+                status_t res        = STATUS_OK;
+                if (filter)
+                {
+                    uint8_t *dst        = arena->alloc<uint8_t>(row_size * height);
+                    if (dst != NULL)
+                    {
+                        res                 = fxaa(dst, row_size, src, row_size, width, height, 4, arena);
+                        src                 = dst;
+                    }
+                    else
+                        res                 = STATUS_NO_MEM;
+                }
+
+                // Upscale the frame to the size of the viewport, keeping rows bottom-up
+                if ((res == STATUS_OK) && ((width != _this->viewWidth) || (height != _this->viewHeight)))
+                {
+                    size_t view_row     = _this->viewWidth * 4;
+                    uint8_t *view       = arena->alloc<uint8_t>(view_row * _this->viewHeight);
+                    if (view != NULL)
+                    {
+                        res                 = upscale_bilinear(
+                            view, _this->viewWidth, _this->viewHeight, view_row,
+                            src, width, height, row_size,
+                            4, false);
+                        src                 = view;
+                        row_size            = view_row;
+                    }
+                    else
+                        res                 = STATUS_NO_MEM;
+                }
+
+                // Flip, swizzle and pack pixels into the caller's buffer in a single pass
+                if (res == STATUS_OK)
+                    res                 = convert_pixels(
+                        static_cast<uint8_t *>(buf), stride,
+                        src, row_size,
+                        _this->viewWidth, _this->viewHeight,
+                        format, true);
+
+                arena->release(mark);
+                return res;
+            }
+
+            static status_t gl_read_ids(backend_t *_this, ssize_t left, ssize_t top, ssize_t width, ssize_t height, uint32_t *ids, float *depth)
+            {
+                gl_flush_expanded(_this);
+
+                // Map the rectangle to the render target which can be scaled, rows of the target are stored bottom-up
+                ssize_t rw, rh;
+                render_size(_this, &rw, &rh);
+                ssize_t vw          = _this->viewWidth;
+                ssize_t vh          = _this->viewHeight;
+
+                ssize_t x0          = (left * rw) / vw;
+                ssize_t x1          = ((left + width - 1) * rw) / vw;
+                ssize_t y0          = rh - 1 - ((top + height - 1) * rh) / vh;
+                ssize_t y1          = rh - 1 - (top * rh) / vh;
+                ssize_t sw          = x1 - x0 + 1;
+                ssize_t sh          = y1 - y0 + 1;
+
+                size_t count        = sw * sh;
+                size_t size         = count * (sizeof(uint32_t) + sizeof(float));
+                if (size > _this->nScaledCap)
+                {
+                    uint8_t *ptr        = static_cast<uint8_t *>(realloc(_this->vScaled, size));
+                    if (ptr == NULL)
+                        return STATUS_NO_MEM;
+                    _this->vScaled      = ptr;
+                    _this->nScaledCap   = size;
+                }
+                uint8_t *rgba       = _this->vScaled;
+                float *z            = reinterpret_cast<float *>(&_this->vScaled[count * sizeof(uint32_t)]);
+
+                ::glReadBuffer(GL_BACK);
+                if (ids != NULL)
+                    ::glReadPixels(x0, y0, sw, sh, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+                if (depth != NULL)
+                    ::glReadPixels(x0, y0, sw, sh, GL_DEPTH_COMPONENT, GL_FLOAT, z);
+
+                // Decode identifiers and depth, output rows are stored top-down
+                for (ssize_t y=0; y<height; ++y)
+                {
+                    ssize_t sy          = rh - 1 - ((top + y) * rh) / vh - y0;
+                    for (ssize_t x=0; x<width; ++x)
+                    {
+                        size_t off          = sy * sw + ((left + x) * rw) / vw - x0;
+                        if (ids != NULL)
+                        {
+                            const uint8_t *p    = &rgba[off * 4];
+                            *(ids++)            = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | uint32_t(p[2]);
+                        }
+                        if (depth != NULL)
+                            *(depth++)          = z[off];
+                    }
+                }
+
+                return STATUS_OK;
+            }
+
+            static void gl_finish(backend_t *_this, bool release, bool skip)
+            {
+                // The skipped frame has not been drawn, the previous output stays actual
+                if (!skip)
+                {
+                    gl_flush_expanded(_this);
+                    ::glFinish();
+                    ::glFlush();
+                    SwapBuffers(_this->hDC);
+                }
+
+                // Temporary data of the frame is not needed anymore
+                _this->pArena->reset();
+
+                // Release the context unless it should stay current for the thread
+                if ((release) && (!_this->bStickyContext))
+                    release_current(_this);
+            }
+
+            static void copy_tile(const tiled_output_t *out, ssize_t left, ssize_t top, ssize_t width, ssize_t height,
+                const uint8_t *src, size_t bpp)
+            {
+                // Rows of the tile are read bottom-up
+                size_t row_size     = width * bpp;
+                uint8_t *dst        = static_cast<uint8_t *>(out->data) + (top + height - 1) * out->stride + left * bpp;
+                for (ssize_t i=0; i<height; ++i, src += row_size, dst -= out->stride)
+                    ::memcpy(dst, src, row_size);
+            }
+
+            static status_t exec_tiles(backend_t *_this)
+            {
+                const tiled_output_t *out   = &_this->sTiled;
+                const gl_ext_t *ext         = _this->pExt;
+                GLenum fmt;
+                size_t bpp;
+                if (!gl_pixel_format(out->format, &fmt, &bpp))
+                    return STATUS_BAD_ARGUMENTS;
+
+                _this->bDeferred    = false;
+                exec_start(_this, background(_this));
+
+                // Each tile occupies the whole render target, the part of the last
+                // tile in the row or column that is outside the image is not read
+                ssize_t tw, th;
+                render_size(_this, &tw, &th);
+                if ((tw <= 0) || (th <= 0))
+                    return STATUS_BAD_STATE;
+                size_t cols         = (out->width + tw - 1) / tw;
+                size_t tiles        = cols * ((out->height + th - 1) / th);
+                size_t tile_size    = tw * th * bpp;
+
+                // Double-buffered pixel buffers let readback of the tile overlap drawing of the next one,
+                // otherwise tiles are read synchronously into the temporary buffer
+                GLuint pbo[2]       = { 0, 0 };
+                arena_t *arena      = _this->pArena;
+                arena_mark_t mark   = arena->mark();
+                uint8_t *scratch    = NULL;
+                if (ext->bPBO)
+                {
+                    ext->glGenBuffers(2, pbo);
+                    for (size_t i=0; i<2; ++i)
+                    {
+                        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+                        ext->glBufferData(GL_PIXEL_PACK_BUFFER, tile_size, NULL, GL_STREAM_READ);
+                    }
+                    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                }
+                else if ((scratch = arena->alloc<uint8_t>(tile_size)) == NULL)
+                    return STATUS_NO_MEM;
+
+                ::glReadBuffer(GL_BACK);
+                ::glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+                status_t res        = STATUS_OK;
+                ssize_t prev[4]     = { 0, 0, 0, 0 };
+                r3d::mat4_t crop;
+                matrix_identity(&crop);
+
+                for (size_t i=0; i<tiles; ++i)
+                {
+                    ssize_t left        = (i % cols) * tw;
+                    ssize_t top         = (i / cols) * th;
+                    ssize_t width       = lsp_min(tw, out->width - left);
+                    ssize_t height      = lsp_min(th, out->height - top);
+
+                    // Map the tile area of the image into the clip space of the render target
+                    float sx            = float(out->width) / float(tw);
+                    float sy            = float(out->height) / float(th);
+                    float cx            = float(2 * left + tw) / float(out->width) - 1.0f;
+                    float cy            = 1.0f - float(2 * top + th) / float(out->height);
+                    crop.m[0]           = sx;
+                    crop.m[5]           = sy;
+                    crop.m[12]          = -sx * cx;
+                    crop.m[13]          = -sy * cy;
+
+                    if (i > 0)
+                        ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                    if ((res = exec_records(_this, NULL, &crop)) != STATUS_OK)
+                        break;
+                    gl_flush_expanded(_this);
+
+                    if (pbo[0] == 0)
+                    {
+                        ::glReadPixels(0, th - height, width, height, fmt, GL_UNSIGNED_BYTE, scratch);
+                        copy_tile(out, left, top, width, height, scratch, bpp);
+                        continue;
+                    }
+
+                    // Start the readback of the tile and copy the previous one
+                    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i & 1]);
+                    ::glReadPixels(0, th - height, width, height, fmt, GL_UNSIGNED_BYTE, NULL);
+                    if (i > 0)
+                    {
+                        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[(i - 1) & 1]);
+                        const uint8_t *src  = static_cast<const uint8_t *>(ext->glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+                        if (src == NULL)
+                        {
+                            res                 = STATUS_UNKNOWN_ERR;
+                            break;
+                        }
+                        copy_tile(out, prev[0], prev[1], prev[2], prev[3], src, bpp);
+                        ext->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                    }
+
+                    prev[0]             = left;
+                    prev[1]             = top;
+                    prev[2]             = width;
+                    prev[3]             = height;
+                }
+
+                if (pbo[0] != 0)
+                {
+                    // Copy the last tile
+                    if ((res == STATUS_OK) && (tiles > 0))
+                    {
+                        ext->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[(tiles - 1) & 1]);
+                        const uint8_t *src  = static_cast<const uint8_t *>(ext->glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+                        if (src != NULL)
+                        {
+                            copy_tile(out, prev[0], prev[1], prev[2], prev[3], src, bpp);
+                            ext->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                        }
+                        else
+                            res                 = STATUS_UNKNOWN_ERR;
+                    }
+                    ext->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                    ext->glDeleteBuffers(2, pbo);
+                }
+
+                ::glPixelStorei(GL_PACK_ALIGNMENT, 4);
+                arena->release(mark);
+
+                return res;
+            }
+
+            status_t backend_t::finish(r3d::backend_t *handle)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (_this->pTrace != NULL)
+                    _this->pTrace->finish();
+
+                // The deferred frame is skipped if it has not changed since the last drawn frame
+                status_t res        = STATUS_OK;
+                bool skip           = false;
+                if (_this->bDeferred)
+                {
+                    _this->bDeferred    = false;
+                    if (_this->bFrameReuse)
+                        ++_this->sFrameStats.nFrames;
+
+                    // The tiled output is always drawn since the caller may change the image
+                    if ((_this->bReused) ||
+                        ((_this->bFrameReuse) && (!_this->bTiled) && (_this->bPixels) && (_this->nPixelsHash == _this->pFrame->nHash)))
+                    {
+                        ++_this->sFrameStats.nSkipped;
+                        skip                = true;
+                    }
+                    else
+                        res                 = (_this->bTiled) ? exec_tiles(_this) : exec_frame(_this);
+                }
+                else if (_this->bFrameReuse)
+                    ++_this->sFrameStats.nFrames;
+
+                // Drop the command list that has not been finished
+                if (_this->nListCompile != 0)
+                {
+                    lsp_warn("Command list %d has not been finished before the end of the frame", int(_this->nListCompile));
+                    ::glEndList();
+                    ::glDeleteLists(_this->nListCompile, 1);
+                    _this->nListCompile = 0;
+                    _this->nGLMatrices  = 0;
+                }
+
+                if (_this->pQueue != NULL)
+                {
+                    cmd_finish_t *cmd   = reinterpret_cast<cmd_finish_t *>(enqueue(_this, CMD_FINISH, sizeof(cmd_finish_t)));
+                    cmd->skip           = skip;
+                    submit(_this);
+                }
+                else
+                    gl_finish(_this, true, skip);
+
+                // Reset drawing flag
+                _this->bDrawing     = false;
+                _this->bReused      = false;
+
+                return res;
+            }
+
+            //-----------------------------------------------------------------
+            // Threaded rendering mode
+            static cmd_header_t *enqueue(backend_t *_this, uint32_t type, size_t size)
+            {
+                cmd_queue_t *q      = _this->pQueue;
+                cmd_header_t *hdr   = q->begin(type, size);
+
+                while (hdr == NULL)
+                {
+                    // Wait until the render thread releases some space
+                    atomic_store(&_this->nProducerWait, uint32_t(1));
+                    if ((hdr = q->begin(type, size)) == NULL)
+                        ::WaitForSingleObject(_this->hProducer, INFINITE);
+                    atomic_store(&_this->nProducerWait, uint32_t(0));
+                }
+
+                return hdr;
+            }
+
+            static void submit(backend_t *_this)
+            {
+                _this->pQueue->commit();
+                if (atomic_load(&_this->nConsumerWait))
+                    ::SetEvent(_this->hConsumer);
+            }
+
+            static void wait_completion(backend_t *_this, uint32_t ticket)
+            {
+                while (int32_t(atomic_load(&_this->nCompleted) - ticket) < 0)
+                    ::WaitForSingleObject(_this->hProducer, INFINITE);
+            }
+
+            static void complete(backend_t *_this, status_t *result, status_t code)
+            {
+                *result     = code;
+                atomic_add(&_this->nCompleted, uint32_t(1));
+                ::SetEvent(_this->hProducer);
+            }
+
+            static status_t call_render_thread(backend_t *_this, uint32_t type)
+            {
+                status_t res        = STATUS_OK;
+                cmd_sync_t *cmd     = reinterpret_cast<cmd_sync_t *>(enqueue(_this, type, sizeof(cmd_sync_t)));
+                cmd->result         = &res;
+                uint32_t ticket     = ++_this->nSubmitted;
+                submit(_this);
+                wait_completion(_this, ticket);
+
+                return res;
+            }
+
+            static status_t take_async_error(backend_t *_this, status_t res)
+            {
+                // Called after synchronization, the render thread does not modify the value
+                if (res == STATUS_OK)
+                    res                 = _this->nAsyncError;
+                _this->nAsyncError  = STATUS_OK;
+                return res;
+            }
+
+            static bool execute_command(backend_t *_this, cmd_header_t *hdr)
+            {
+                switch (hdr->type)
+                {
+                    case CMD_START:
+                    {
+                        cmd_start_t *cmd        = reinterpret_cast<cmd_start_t *>(hdr);
+                        gl_start(_this, &cmd->bg);
+                        break;
+                    }
+                    case CMD_LIGHTS:
+                    {
+                        cmd_lights_t *cmd       = reinterpret_cast<cmd_lights_t *>(hdr);
+                        status_t res            = gl_set_lights(cmd->lights, cmd->count);
+                        if (res != STATUS_OK)
+                            _this->nAsyncError      = res;
+                        break;
+                    }
+                    case CMD_DRAW:
+                    {
+                        cmd_draw_t *cmd         = reinterpret_cast<cmd_draw_t *>(hdr);
+                        size_t bstate = 0, count = 0;
+                        status_t res            = check_buffer(&cmd->buffer, &bstate, &count);
+                        if (res == STATUS_OK)
+                            gl_draw_primitives(_this, &cmd->buffer, &cmd->key, bstate, count, &cmd->projection, &cmd->view_world, &cmd->ring);
+
+                        if (cmd->result != NULL)
+                            complete(_this, cmd->result, res);
+                        else if (res != STATUS_OK)
+                            _this->nAsyncError      = res;
+                        break;
+                    }
+                    case CMD_SYNC:
+                    {
+                        gl_sync(_this);
+                        complete(_this, reinterpret_cast<cmd_sync_t *>(hdr)->result, STATUS_OK);
+                        break;
+                    }
+                    case CMD_READ_PIXELS:
+                    {
+                        cmd_read_pixels_t *cmd  = reinterpret_cast<cmd_read_pixels_t *>(hdr);
+                        complete(_this, cmd->result, gl_read_pixels(_this, cmd->buf, cmd->format));
+                        break;
+                    }
+                    case CMD_READ_PIXELS_EX:
+                    {
+                        cmd_read_pixels_ex_t *cmd   = reinterpret_cast<cmd_read_pixels_ex_t *>(hdr);
+                        complete(_this, cmd->result, gl_read_pixels_ex(_this, cmd->buf, cmd->stride, cmd->format));
+                        break;
+                    }
+                    case CMD_FINISH:
+                    {
+                        cmd_finish_t *cmd       = reinterpret_cast<cmd_finish_t *>(hdr);
+                        gl_finish(_this, false, cmd->skip);
+                        break;
+                    }
+                    case CMD_READ_IDS:
+                    {
+                        cmd_read_ids_t *cmd     = reinterpret_cast<cmd_read_ids_t *>(hdr);
+                        complete(_this, cmd->result,
+                            gl_read_ids(_this, cmd->left, cmd->top, cmd->width, cmd->height, cmd->ids, cmd->depth));
+                        break;
+                    }
+                    case CMD_VIEWPORT:
+                    {
+                        cmd_viewport_t *cmd     = reinterpret_cast<cmd_viewport_t *>(hdr);
+                        gl_viewport(_this, cmd->left, cmd->bottom, cmd->width, cmd->height, cmd->scissor);
+                        break;
+                    }
+                    case CMD_BARRIER:
+                        complete(_this, reinterpret_cast<cmd_sync_t *>(hdr)->result, STATUS_OK);
+                        break;
+                    case CMD_DELETE_LIST:
+                        ::glDeleteLists(reinterpret_cast<cmd_list_t *>(hdr)->id, 1);
+                        break;
+                    case CMD_QUIT:
+                        release_current(_this);
+                        complete(_this, reinterpret_cast<cmd_sync_t *>(hdr)->result, STATUS_OK);
+                        return false;
+                    default:
+                        break;
+                }
+
+                return true;
+            }
+
+            static DWORD WINAPI render_thread(LPVOID arg)
+            {
+                backend_t *_this    = static_cast<backend_t *>(arg);
+                cmd_queue_t *q      = _this->pQueue;
+
+                for (bool active = true; active; )
+                {
+                    cmd_header_t *hdr   = q->fetch();
+                    if (hdr == NULL)
+                    {
+                        // Wait for new commands
+                        atomic_store(&_this->nConsumerWait, uint32_t(1));
+                        if (q->empty())
+                            ::WaitForSingleObject(_this->hConsumer, INFINITE);
+                        atomic_store(&_this->nConsumerWait, uint32_t(0));
+                        continue;
+                    }
+
+                    // Execute the command and release the record
+                    active              = execute_command(_this, hdr);
+                    q->release(hdr);
+                    if (atomic_load(&_this->nProducerWait))
+                        ::SetEvent(_this->hProducer);
+                }
+
+                return 0;
+            }
+
+            static status_t start_render_thread(backend_t *_this)
+            {
+                cmd_queue_t *q      = static_cast<cmd_queue_t *>(malloc(sizeof(cmd_queue_t)));
+                if (q == NULL)
+                    return STATUS_NO_MEM;
+                q->construct();
+
+                status_t res        = q->init(CMD_QUEUE_SIZE);
+                if (res != STATUS_OK)
+                {
+                    free(q);
+                    return res;
+                }
+
+                _this->pQueue       = q;
+                _this->nConsumerWait= 0;
+                _this->nProducerWait= 0;
+                _this->nSubmitted   = 0;
+                _this->nCompleted   = 0;
+                _this->nAsyncError  = STATUS_OK;
+                _this->hConsumer    = ::CreateEventW(NULL, FALSE, FALSE, NULL);
+                _this->hProducer    = ::CreateEventW(NULL, FALSE, FALSE, NULL);
+
+                if ((_this->hConsumer != NULL) && (_this->hProducer != NULL))
+                    _this->hThread      = ::CreateThread(NULL, 0, render_thread, _this, 0, NULL);
+                if (_this->hThread != NULL)
+                    return STATUS_OK;
+
+                // Rollback the changes
+                lsp_error("Error creating render thread: code=%ld", long(GetLastError()));
+                stop_render_thread(_this);
+
+                return STATUS_UNKNOWN_ERR;
+            }
+
+            static void stop_render_thread(backend_t *_this)
+            {
+                if (_this->hThread != NULL)
+                {
+                    call_render_thread(_this, CMD_QUIT);
+                    ::WaitForSingleObject(_this->hThread, INFINITE);
+                    ::CloseHandle(_this->hThread);
+                    _this->hThread      = NULL;
+                }
+                if (_this->hConsumer != NULL)
+                {
+                    ::CloseHandle(_this->hConsumer);
+                    _this->hConsumer    = NULL;
+                }
+                if (_this->hProducer != NULL)
+                {
+                    ::CloseHandle(_this->hProducer);
+                    _this->hProducer    = NULL;
+                }
+                if (_this->pQueue != NULL)
+                {
+                    _this->pQueue->destroy();
+                    free(_this->pQueue);
+                    _this->pQueue       = NULL;
+                }
+            }
+
+            status_t backend_t::set_threaded(r3d::backend_t *handle, bool threaded)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (threaded == (_this->pQueue != NULL))
+                    return STATUS_OK;
+                if ((threaded) && (_this->bTiled))
+                    return STATUS_BAD_STATE;
+
+                if (!threaded)
+                {
+                    stop_render_thread(_this);
+                    return STATUS_OK;
+                }
+
+                // The context should not be current for the caller's thread
+                release_current(_this);
+
+                return start_render_thread(_this);
+            }
+
+            bool backend_t::threaded(r3d::backend_t *handle)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                return _this->pQueue != NULL;
+            }
+
+            status_t backend_t::set_sticky_context(r3d::backend_t *handle, bool sticky)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                _this->bStickyContext   = sticky;
+
+                // The render thread holds the context in threaded mode
+                if ((!sticky) && (_this->pQueue == NULL))
+                    release_current(_this);
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Trace capture
+            status_t backend_t::start_trace(r3d::backend_t *handle, const char *path)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (path == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (_this->pTrace != NULL)
+                    return STATUS_OPENED;
+
+                trace_writer_t *w   = static_cast<trace_writer_t *>(malloc(sizeof(trace_writer_t)));
+                if (w == NULL)
+                    return STATUS_NO_MEM;
+                w->construct();
+
+                status_t res        = w->open(path);
+                if (res != STATUS_OK)
+                {
+                    w->destroy();
+                    free(w);
+                    return res;
+                }
+
+                // Record the current state to make the trace self-contained
+                w->locate(_this->viewLeft, _this->viewTop, _this->viewWidth, _this->viewHeight);
+                w->set_matrix(r3d::MATRIX_PROJECTION, &_this->matProjection);
+                w->set_matrix(r3d::MATRIX_VIEW, &_this->matView);
+                w->set_matrix(r3d::MATRIX_WORLD, &_this->matWorld);
+
+                _this->pTrace       = w;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::stop_trace(r3d::backend_t *handle)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                trace_writer_t *w   = _this->pTrace;
+                if (w == NULL)
+                    return STATUS_CLOSED;
+
+                _this->pTrace       = NULL;
+                status_t res        = w->close();
+                w->destroy();
+                free(w);
+
+                return res;
+            }
+
+            //-----------------------------------------------------------------
+            // Geometry cache
+            status_t backend_t::set_cache_flags(r3d::backend_t *handle, size_t flags)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                // The render thread should not access the cache while it is being changed
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                // Rebuild all entries if optimization settings change,
+                // the disabled cache is dropped at the start of the next frame
+                geometry_cache_t *cache = _this->pCache;
+                if ((cache->nFlags ^ flags) & CACHE_OPTIMIZE)
+                    cache->invalidate(NULL);
+                cache->nFlags       = flags;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::invalidate(r3d::backend_t *handle, const void *data)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (_this->hGL == NULL)
+                    return STATUS_BAD_STATE;
+
+                // Previously submitted draws should complete before invalidation
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->pCache->invalidate(data);
+                if (_this->pLod != NULL)
+                    _this->pLod->invalidate(data);
+                _this->pOcclusion->invalidate(data);
+                ++_this->nDataVersion;
+                return STATUS_OK;
+            }
+
+            status_t backend_t::get_cache_stats(r3d::backend_t *handle, cache_stats_t *stats)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (stats == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if (_this->hGL == NULL)
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->pCache->get_stats(stats);
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Frame reuse and multiple views
+            static status_t create_frame(backend_t *_this)
+            {
+                if (_this->pFrame != NULL)
+                    return STATUS_OK;
+
+                frame_t *f          = static_cast<frame_t *>(malloc(sizeof(frame_t)));
+                if (f == NULL)
+                    return STATUS_NO_MEM;
+                f->construct();
+                _this->pFrame       = f;
+
+                return STATUS_OK;
+            }
+
+            static void drop_frame(backend_t *_this)
+            {
+                if (_this->pFrame != NULL)
+                {
+                    _this->pFrame->destroy();
+                    free(_this->pFrame);
+                    _this->pFrame       = NULL;
+                }
+                _this->bDeferred    = false;
+            }
+
+            static void drop_pixels(backend_t *_this)
+            {
+                if (_this->vPixels != NULL)
+                {
+                    free(_this->vPixels);
+                    _this->vPixels      = NULL;
+                }
+                _this->nPixelsCap   = 0;
+                _this->bPixels      = false;
+            }
+
+            status_t backend_t::set_frame_reuse(r3d::backend_t *handle, bool enable)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (_this->bDrawing)
+                    return STATUS_BAD_STATE;
+                if (enable == _this->bFrameReuse)
+                    return STATUS_OK;
+
+                // The render thread should not access the frame while it is being changed
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                if (enable)
+                {
+                    status_t res        = create_frame(_this);
+                    if (res != STATUS_OK)
+                        return res;
+                }
+                else
+                {
+                    drop_pixels(_this);
+                    if ((_this->nViews <= 0) && (!_this->bTiled))
+                        drop_frame(_this);
+                }
+                _this->bFrameReuse  = enable;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::get_frame_stats(r3d::backend_t *handle, frame_stats_t *stats)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (stats == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+
+                *stats          = _this->sFrameStats;
+                return STATUS_OK;
+            }
+
+
+            status_t backend_t::set_views(r3d::backend_t *handle, const view_t *views, size_t count)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((count > 0) && (views == NULL))
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->bDrawing) || ((_this->bTiled) && (count > 0)))
+                    return STATUS_BAD_STATE;
+                for (size_t i=0; i<count; ++i)
+                {
+                    if ((views[i].width <= 0) || (views[i].height <= 0))
+                        return STATUS_INVALID_VALUE;
+                }
+
+                // The render thread should not access the views while they are being changed
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                if (count <= 0)
+                {
+                    if (_this->vViews != NULL)
+                    {
+                        free(_this->vViews);
+                        _this->vViews       = NULL;
+                    }
+                    _this->nViews       = 0;
+                    if (!_this->bFrameReuse)
+                        drop_frame(_this);
+                    return STATUS_OK;
+                }
+
+                status_t res        = create_frame(_this);
+                if (res != STATUS_OK)
+                    return res;
+
+                view_t *v           = static_cast<view_t *>(realloc(_this->vViews, count * sizeof(view_t)));
+                if (v == NULL)
+                    return STATUS_NO_MEM;
+                ::memcpy(v, views, count * sizeof(view_t));
+                _this->vViews       = v;
+                _this->nViews       = count;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::read_views(r3d::backend_t *handle, void **bufs, r3d::pixel_format_t format)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (bufs == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->hDC == NULL) || (!_this->bDrawing) || (_this->nViews <= 0))
+                    return STATUS_BAD_STATE;
+
+                size_t bpp          = pixel_size(format);
+                if (bpp == 0)
+                    return STATUS_BAD_ARGUMENTS;
+
+                // All views should fit the render target
+                for (size_t i=0; i<_this->nViews; ++i)
+                {
+                    const view_t *v     = &_this->vViews[i];
+                    if ((v->left < 0) || (v->top < 0) ||
+                        ((v->left + v->width) > _this->viewWidth) ||
+                        ((v->top + v->height) > _this->viewHeight))
+                        return STATUS_OVERFLOW;
+                }
+
+                // Read the whole render target at once
+                size_t stride       = _this->viewWidth * bpp;
+                size_t size         = stride * _this->viewHeight;
+                if (size > _this->nAtlasCap)
+                {
+                    uint8_t *ptr        = static_cast<uint8_t *>(realloc(_this->vAtlas, size));
+                    if (ptr == NULL)
+                        return STATUS_NO_MEM;
+                    _this->vAtlas       = ptr;
+                    _this->nAtlasCap    = size;
+                }
+
+                status_t res        = read_pixels(handle, _this->vAtlas, format);
+                if (res != STATUS_OK)
+                    return res;
+
+                // Split the render target into per-view buffers
+                for (size_t i=0; i<_this->nViews; ++i)
+                {
+                    const view_t *v     = &_this->vViews[i];
+                    size_t row_size     = v->width * bpp;
+                    const uint8_t *src  = &_this->vAtlas[v->top * stride + v->left * bpp];
+                    uint8_t *dst        = static_cast<uint8_t *>(bufs[i]);
+                    for (ssize_t y=0; y<v->height; ++y, src += stride, dst += row_size)
+                        ::memcpy(dst, src, row_size);
+                }
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Render scale
+            status_t backend_t::set_render_scale(r3d::backend_t *handle, float scale)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (!((scale > 0.0f) && (scale <= 1.0f)))
+                    return STATUS_INVALID_VALUE;
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                // The render thread should not access the scale while it is being changed
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->fRenderScale = scale;
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Picking
+            status_t backend_t::set_picking(r3d::backend_t *handle, bool picking)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->bPicking     = picking;
+                return STATUS_OK;
+            }
+
+            status_t backend_t::set_object_id(r3d::backend_t *handle, uint32_t id)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (id > OBJECT_ID_MAX)
+                    return STATUS_INVALID_VALUE;
+                if (!_this->bDrawing)
+                    return STATUS_BAD_STATE;
+
+                _this->nObjectId    = id;
+                return STATUS_OK;
+            }
+
+            status_t backend_t::read_ids(r3d::backend_t *handle, ssize_t left, ssize_t top, ssize_t width, ssize_t height, uint32_t *ids, float *depth)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((ids == NULL) && (depth == NULL))
+                    return STATUS_BAD_ARGUMENTS;
+                if ((width <= 0) || (height <= 0))
+                    return STATUS_INVALID_VALUE;
+                if ((_this->hDC == NULL) || (!_this->bDrawing) || (_this->bTiled))
+                    return STATUS_BAD_STATE;
+                if ((left < 0) || (top < 0) ||
+                    ((left + width) > _this->viewWidth) ||
+                    ((top + height) > _this->viewHeight))
+                    return STATUS_OVERFLOW;
+
+                // The deferred frame should be drawn, identifiers and depth are not kept by frame reuse
+                status_t res        = STATUS_OK;
+                if (_this->bDeferred)
+                {
+                    if ((res = exec_frame(_this)) != STATUS_OK)
+                        return res;
+                }
+
+                if (_this->pQueue == NULL)
+                    return gl_read_ids(_this, left, top, width, height, ids, depth);
+
+                cmd_read_ids_t *cmd     = reinterpret_cast<cmd_read_ids_t *>(
+                    enqueue(_this, CMD_READ_IDS, sizeof(cmd_read_ids_t)));
+                cmd->left               = left;
+                cmd->top                = top;
+                cmd->width              = width;
+                cmd->height             = height;
+                cmd->ids                = ids;
+                cmd->depth              = depth;
+                cmd->result             = &res;
+                uint32_t ticket         = ++_this->nSubmitted;
+                submit(_this);
+                wait_completion(_this, ticket);
+
+                return take_async_error(_this, res);
+            }
+
+            //-----------------------------------------------------------------
+            // Expansion of lines and points
+            status_t backend_t::set_expand_primitives(r3d::backend_t *handle, bool expand)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (expand == (_this->pExpand != NULL))
+                    return STATUS_OK;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                if (expand)
+                {
+                    expand_batch_t *batch   = static_cast<expand_batch_t *>(malloc(sizeof(expand_batch_t)));
+                    if (batch == NULL)
+                        return STATUS_NO_MEM;
+                    batch->construct();
+                    _this->pExpand          = batch;
+                }
+                else
+                {
+                    _this->pExpand->destroy();
+                    free(_this->pExpand);
+                    _this->pExpand          = NULL;
+                }
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Decimation
+            status_t backend_t::set_decimation(r3d::backend_t *handle, size_t min_count)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                if (min_count <= 0)
+                {
+                    if (_this->pLod != NULL)
+                    {
+                        _this->pLod->destroy();
+                        free(_this->pLod);
+                        _this->pLod         = NULL;
+                    }
+                    return STATUS_OK;
+                }
+
+                if (_this->pLod == NULL)
+                {
+                    lod_cache_t *lod    = static_cast<lod_cache_t *>(malloc(sizeof(lod_cache_t)));
+                    if (lod == NULL)
+                        return STATUS_NO_MEM;
+                    lod->construct();
+                    _this->pLod         = lod;
+                }
+                _this->pLod->nMinCount  = min_count;
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Occlusion culling
+            status_t backend_t::set_occlusion_culling(r3d::backend_t *handle, size_t min_count)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                // The disabled cache is dropped at the start of the next frame
+                _this->pOcclusion->nMinCount    = min_count;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::get_occlusion_stats(r3d::backend_t *handle, occlusion_stats_t *stats)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (stats == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if (_this->hGL == NULL)
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->pOcclusion->get_stats(stats);
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Frame arena
+            status_t backend_t::get_arena_stats(r3d::backend_t *handle, arena_stats_t *stats)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (stats == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if (_this->hGL == NULL)
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->pArena->get_stats(stats);
+                return STATUS_OK;
+            }
+
+            status_t backend_t::trim_arena(r3d::backend_t *handle)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->pArena->trim();
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Retained command lists
+            static ssize_t find_list(backend_t *_this, size_t id)
+            {
+                for (size_t i=0; i<_this->nLists; ++i)
+                {
+                    if (_this->vLists[i] == id)
+                        return i;
+                }
+                return -1;
+            }
+
+            status_t backend_t::begin_list(r3d::backend_t *handle)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (!_this->bDrawing) || (_this->nListCompile != 0))
+                    return STATUS_BAD_STATE;
+                if ((_this->pQueue != NULL) || (_this->bDeferred))
+                    return STATUS_BAD_STATE;
+
+                // Reserve the place for the list to not fail after recording
+                if (_this->nLists >= _this->nListsCap)
+                {
+                    size_t cap          = (_this->nListsCap > 0) ? _this->nListsCap << 1 : 0x10;
+                    GLuint *lists       = static_cast<GLuint *>(realloc(_this->vLists, cap * sizeof(GLuint)));
+                    if (lists == NULL)
+                        return STATUS_NO_MEM;
+                    _this->vLists       = lists;
+                    _this->nListsCap    = cap;
+                }
+
+                // Previously batched primitives should not get into the list
+                gl_flush_expanded(_this);
+
+                GLuint id           = ::glGenLists(1);
+                if (id == 0)
+                    return STATUS_UNKNOWN_ERR;
+                ::glNewList(id, GL_COMPILE);
+
+                // Matrices should be loaded by the list itself
+                _this->nListCompile = id;
+                _this->nGLMatrices  = 0;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::end_list(r3d::backend_t *handle, size_t *id)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (id == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->hGL == NULL) || (!_this->bDrawing) || (_this->nListCompile == 0))
+                    return STATUS_BAD_STATE;
+
+                gl_flush_expanded(_this);
+                ::glEndList();
+
+                // Matrices loaded by the list are not loaded into the context
+                _this->vLists[_this->nLists++]  = _this->nListCompile;
+                *id                 = _this->nListCompile;
+                _this->nListCompile = 0;
+                _this->nGLMatrices  = 0;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::draw_list(r3d::backend_t *handle, size_t id)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if ((_this->pQueue != NULL) || (_this->bDeferred))
+                    return STATUS_BAD_STATE;
+                if (find_list(_this, id) < 0)
+                    return STATUS_NOT_FOUND;
+
+                gl_flush_expanded(_this);
+                ::glCallList(GLuint(id));
+                _this->bFxaaDone    = false;
+                _this->nGLMatrices  = 0;
+
+                return STATUS_OK;
+            }
+
+            status_t backend_t::destroy_list(r3d::backend_t *handle, size_t id)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (_this->hGL == NULL)
+                    return STATUS_BAD_STATE;
+
+                ssize_t index       = find_list(_this, id);
+                if (index < 0)
+                    return STATUS_NOT_FOUND;
+
+                // The render thread holds the context in threaded mode,
+                // the context is not current outside the drawing otherwise
+                if (_this->pQueue != NULL)
+                {
+                    cmd_list_t *cmd     = reinterpret_cast<cmd_list_t *>(enqueue(_this, CMD_DELETE_LIST, sizeof(cmd_list_t)));
+                    cmd->id             = GLuint(id);
+                    submit(_this);
+                }
+                else if (_this->bDrawing)
+                    ::glDeleteLists(GLuint(id), 1);
+                else if (make_current(_this))
+                {
+                    ::glDeleteLists(GLuint(id), 1);
+                    if (!_this->bStickyContext)
+                        release_current(_this);
+                }
+                else
+                    return STATUS_UNKNOWN_ERR;
+
+                _this->vLists[index]    = _this->vLists[--_this->nLists];
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Tiled offscreen rendering
+            status_t backend_t::set_tiled_output(r3d::backend_t *handle, const tiled_output_t *output)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (output == NULL)
+                {
+                    if ((_this->bTiled) && (!_this->bFrameReuse) && (_this->nViews <= 0))
+                        drop_frame(_this);
+                    _this->bTiled       = false;
+                    return STATUS_OK;
+                }
+
+                size_t bpp          = pixel_size(output->format);
+                if ((output->data == NULL) || (bpp == 0))
+                    return STATUS_BAD_ARGUMENTS;
+                if ((output->width <= 0) || (output->height <= 0) || (output->stride < output->width * bpp))
+                    return STATUS_INVALID_VALUE;
+                if ((_this->pQueue != NULL) || (_this->nViews > 0))
+                    return STATUS_BAD_STATE;
+
+                // Draws are recorded and replayed once per tile
+                status_t res        = create_frame(_this);
+                if (res != STATUS_OK)
+                    return res;
+
+                _this->sTiled       = *output;
+                _this->bTiled       = true;
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Extended pixel readback
+            static status_t exec_read_pixels_ex(backend_t *_this, void *buf, size_t stride, read_format_t format)
+            {
+                if (_this->pQueue == NULL)
+                    return gl_read_pixels_ex(_this, buf, stride, format);
+
+                // Pass the command to the render thread and wait for the result
+                status_t res                = STATUS_OK;
+                cmd_read_pixels_ex_t *cmd   = reinterpret_cast<cmd_read_pixels_ex_t *>(
+                    enqueue(_this, CMD_READ_PIXELS_EX, sizeof(cmd_read_pixels_ex_t)));
+                cmd->buf                    = buf;
+                cmd->stride                 = stride;
+                cmd->format                 = format;
+                cmd->result                 = &res;
+                uint32_t ticket             = ++_this->nSubmitted;
+                submit(_this);
+                wait_completion(_this, ticket);
+
+                return take_async_error(_this, res);
+            }
+
+            status_t backend_t::read_pixels_ex(r3d::backend_t *handle, void *buf, size_t stride, read_format_t format)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+
+                if ((_this->hDC == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (_this->bTiled)
+                    return STATUS_BAD_STATE;
+
+                size_t bpp          = read_format_size(format);
+                if ((buf == NULL) || (bpp == 0) || (stride < _this->viewWidth * bpp))
+                    return STATUS_BAD_ARGUMENTS;
+
+                // Issue the deferred frame, pixels of extended formats are not kept for frame reuse
+                if (_this->bDeferred)
+                {
+                    status_t res        = exec_frame(_this);
+                    if (res != STATUS_OK)
+                        return res;
+                }
+
+                return exec_read_pixels_ex(_this, buf, stride, format);
+            }
+
+            //-----------------------------------------------------------------
+            // Partial updates and ring buffers
+            status_t backend_t::update_range(r3d::backend_t *handle, const void *data, size_t first, size_t count)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if (data == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if (_this->hGL == NULL)
+                    return STATUS_BAD_STATE;
+                if (count <= 0)
+                    return STATUS_OK;
+
+                // Previously submitted draws should complete before the entries are marked,
+                // modified vertices are uploaded by the render thread on the next draw
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->pCache->update(data, first, count);
+                if (_this->pLod != NULL)
+                    _this->pLod->invalidate(data);
+                _this->pOcclusion->invalidate(data);
+                ++_this->nDataVersion;
+                return STATUS_OK;
+            }
+
+            status_t backend_t::draw_ring(r3d::backend_t *handle, const r3d::buffer_t *buffer, size_t first, const r3d::mat4_t *wrap)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+
+                if (buffer == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->hDC == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if (buffer->count <= 0)
+                    return STATUS_OK;
+                if (first >= buffer->count)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->pTrace != NULL) && (_this->nListCompile == 0))
+                    _this->pTrace->draw_ring(buffer, first, wrap);
+
+                ring_t ring;
+                ring.first          = first;
+                if (wrap != NULL)
+                    ring.wrap           = *wrap;
+                else
+                    matrix_identity(&ring.wrap);
+
+                return draw_buffer(_this, buffer, &ring);
+            }
+
+            //-----------------------------------------------------------------
+            // Cluster culling
+            status_t backend_t::set_cluster_culling(r3d::backend_t *handle, size_t min_count)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                // Cached geometry is rebuilt with or without clusters
+                geometry_cache_t *cache = _this->pCache;
+                if (cache->nClusterMin != min_count)
+                {
+                    cache->nClusterMin      = min_count;
+                    cache->invalidate(NULL);
+                }
+
+                return STATUS_OK;
+            }
+
+            //-----------------------------------------------------------------
+            // Post-process anti-aliasing
+            status_t backend_t::set_fxaa(r3d::backend_t *handle, bool enable)
+            {
+                backend_t *_this = static_cast<backend_t *>(handle);
+                if ((_this->hGL == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                if (_this->pQueue != NULL)
+                    call_render_thread(_this, CMD_BARRIER);
+
+                _this->bFxaa        = enable;
+                return STATUS_OK;
+            }
+
         } /* namespace wgl */
     } /* namespace r3d */
 } /* namespace lsp */
 
+#endif /* PLATFORM_WINDOWS */
@@ -0,0 +1,864 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+
+#ifdef PLATFORM_WINDOWS
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/cache.h>
+#include <private/wgl/optimize.h>
+#include <private/wgl/sort.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            static inline uint32_t hash_ptr(uint32_t h, const void *ptr)
+            {
+                uint64_t v  = uint64_t(uintptr_t(ptr));
+                h           = (h ^ uint32_t(v)) * 0x01000193;
+                h           = (h ^ uint32_t(v >> 32)) * 0x01000193;
+                return h;
+            }
+
+            static inline uint32_t hash_key(const r3d::buffer_t *key, size_t count)
+            {
+                uint32_t h  = 0x811c9dc5;
+                h           = hash_ptr(h, key->vertex.data);
+                h           = hash_ptr(h, key->vertex.index);
+                h           = hash_ptr(h, key->normal.data);
+                h           = hash_ptr(h, key->normal.index);
+                h           = hash_ptr(h, key->color.data);
+                h           = hash_ptr(h, key->color.index);
+                h           = (h ^ uint32_t(count)) * 0x01000193;
+                h           = (h ^ uint32_t(key->type)) * 0x01000193;
+                return h;
+            }
+
+            static inline bool key_equals(const geometry_t *g, const r3d::buffer_t *key, size_t count, uint32_t hash)
+            {
+                return (g->nHash == hash) &&
+                    (g->nCount == count) &&
+                    (g->nType == uint32_t(key->type)) &&
+                    (g->pVData == key->vertex.data) &&
+                    (g->pNData == key->normal.data) &&
+                    (g->pCData == key->color.data) &&
+                    (g->pVIndex == key->vertex.index) &&
+                    (g->pNIndex == key->normal.index) &&
+                    (g->pCIndex == key->color.index) &&
+                    (g->nVStride == key->vertex.stride) &&
+                    (g->nNStride == key->normal.stride) &&
+                    (g->nCStride == key->color.stride);
+            }
+
+            static void release_contents(const gl_ext_t *ext, geometry_t *g)
+            {
+                if ((g->nVBO != 0) || (g->nIBO != 0))
+                {
+                    GLuint buffers[2] = { g->nVBO, g->nIBO };
+                    ext->glDeleteBuffers(2, buffers);
+                    g->nVBO         = 0;
+                    g->nIBO         = 0;
+                }
+                if (g->vVertices != NULL)
+                {
+                    free(g->vVertices);
+                    g->vVertices    = NULL;
+                }
+                if (g->vIndices != NULL)
+                {
+                    free(g->vIndices);
+                    g->vIndices     = NULL;
+                }
+                if (g->vRemap != NULL)
+                {
+                    free(g->vRemap);
+                    g->vRemap       = NULL;
+                }
+                if (g->vCentroids != NULL)
+                {
+                    free(g->vCentroids);
+                    g->vCentroids   = NULL;
+                }
+                if (g->vSorted != NULL)
+                {
+                    free(g->vSorted);
+                    g->vSorted      = NULL;
+                }
+                if (g->pClusters != NULL)
+                {
+                    g->pClusters->destroy();
+                    free(g->pClusters);
+                    g->pClusters    = NULL;
+                }
+                g->bSorted      = false;
+                g->nVertices    = 0;
+                g->nBytes       = 0;
+
+                for (size_t i=0; i<3; ++i)
+                {
+                    g->vDirty[i].first  = 0;
+                    g->vDirty[i].last   = 0;
+                }
+                g->bDirty       = false;
+                g->bOrdered     = false;
+            }
+
+            static status_t optimize_geometry(geometry_t *g, arena_t *arena)
+            {
+                arena_mark_t mark       = arena->mark();
+                uint32_t *order         = arena->alloc<uint32_t>(g->nVertices);
+                remap_t *remap          = arena->alloc<remap_t>(g->nVertices);
+                if ((order == NULL) || (remap == NULL))
+                {
+                    arena->release(mark);
+                    return STATUS_NO_MEM;
+                }
+
+                status_t res            = optimize_triangles(g->vIndices, g->nCount, g->nVertices);
+                if (res == STATUS_OK)
+                    res                     = optimize_vertices(order, g->vIndices, g->nCount, g->nVertices);
+                if (res == STATUS_OK)
+                {
+                    for (size_t i=0; i<g->nVertices; ++i)
+                        remap[i]                = g->vRemap[order[i]];
+                    ::memcpy(g->vRemap, remap, g->nVertices * sizeof(remap_t));
+                }
+
+                arena->release(mark);
+                return res;
+            }
+
+            static status_t build_clusters(geometry_t *g, const vertex_t *vertices, bool sort, arena_t *arena)
+            {
+                if (g->pClusters == NULL)
+                {
+                    g->pClusters            = static_cast<cluster_set_t *>(malloc(sizeof(cluster_set_t)));
+                    if (g->pClusters == NULL)
+                        return STATUS_NO_MEM;
+                    g->pClusters->construct();
+                }
+                else
+                    g->nBytes              -= g->pClusters->nClusters * sizeof(float) * 8;
+
+                // Spatially compact runs of triangles produce tight bounds of clusters
+                status_t res            = STATUS_OK;
+                if (sort)
+                    res                     = cluster_sort(g->vIndices, g->nCount, &vertices->v, sizeof(vertex_t), arena);
+                if (res == STATUS_OK)
+                    res                     = g->pClusters->build(&vertices->v, sizeof(vertex_t), g->vIndices, g->nCount);
+                if (res != STATUS_OK)
+                {
+                    g->pClusters->destroy();
+                    free(g->pClusters);
+                    g->pClusters            = NULL;
+                    return res;
+                }
+
+                g->nBytes              += g->pClusters->nClusters * sizeof(float) * 8;
+                return STATUS_OK;
+            }
+
+            /**
+             * Check that attributes of the buffer are stored in the vertex_t layout and share
+             * the vertex index, so the vertex array can be uploaded without gathering.
+             */
+            static bool interleaved(const r3d::buffer_t *data)
+            {
+                const uint8_t *vbuf     = reinterpret_cast<const uint8_t *>(data->vertex.data);
+                if (data->vertex.stride != sizeof(vertex_t))
+                    return false;
+                if ((data->normal.data != NULL) &&
+                    ((data->normal.stride != sizeof(vertex_t)) || (data->normal.index != NULL) ||
+                     (reinterpret_cast<const uint8_t *>(data->normal.data) != &vbuf[offsetof(vertex_t, n)])))
+                    return false;
+                if ((data->color.data != NULL) &&
+                    ((data->color.stride != sizeof(vertex_t)) || (data->color.index != NULL) ||
+                     (reinterpret_cast<const uint8_t *>(data->color.data) != &vbuf[offsetof(vertex_t, c)])))
+                    return false;
+                return true;
+            }
+
+            /**
+             * Copy indices of the interleaved buffer, each source vertex maps to itself
+             * @return number of referenced vertices
+             */
+            static size_t direct_indices(uint32_t *indices, const r3d::buffer_t *data, size_t count)
+            {
+                const uint32_t *vindex  = data->vertex.index;
+                if (vindex == NULL)
+                {
+                    for (size_t i=0; i<count; ++i)
+                        indices[i]              = uint32_t(i);
+                    return count;
+                }
+
+                uint32_t max            = 0;
+                for (size_t i=0; i<count; ++i)
+                {
+                    indices[i]              = vindex[i];
+                    max                     = lsp_max(max, vindex[i]);
+                }
+                return size_t(max) + 1;
+            }
+
+            static status_t build_contents(const gl_ext_t *ext, size_t flags, size_t cluster_min, geometry_t *g, const r3d::buffer_t *data,
+                bool ordered, arena_t *arena)
+            {
+                size_t count            = g->nCount;
+
+                // Weld indices, interleaved data is referenced as is
+                bool direct             = interleaved(data);
+                g->vIndices             = static_cast<uint32_t *>(malloc(count * sizeof(uint32_t)));
+                g->vRemap               = static_cast<remap_t *>(malloc(count * sizeof(remap_t)));
+                if ((g->vIndices == NULL) || (g->vRemap == NULL))
+                    return STATUS_NO_MEM;
+
+                ssize_t vertices;
+                if (direct)
+                {
+                    vertices                = direct_indices(g->vIndices, data, count);
+                    if (size_t(vertices) > count)
+                    {
+                        free(g->vRemap);
+                        g->vRemap               = static_cast<remap_t *>(malloc(vertices * sizeof(remap_t)));
+                        if (g->vRemap == NULL)
+                            return STATUS_NO_MEM;
+                    }
+
+                    bool normal             = data->normal.data != NULL;
+                    bool color              = data->color.data != NULL;
+                    for (ssize_t i=0; i<vertices; ++i)
+                    {
+                        remap_t *r              = &g->vRemap[i];
+                        r->v                    = uint32_t(i);
+                        r->n                    = (normal) ? uint32_t(i) : 0;
+                        r->c                    = (color) ? uint32_t(i) : 0;
+                    }
+                }
+                else
+                {
+                    vertices                = weld_indices(g->vIndices, g->vRemap, data, count, arena);
+                    if (vertices < 0)
+                        return status_t(-vertices);
+                }
+                g->nVertices            = vertices;
+
+                remap_t *remap          = static_cast<remap_t *>(realloc(g->vRemap, vertices * sizeof(remap_t)));
+                if (remap != NULL)
+                    g->vRemap               = remap;
+
+                // Optimize the order of triangles, clustered geometry is ordered spatially instead
+                bool triangles          = (g->nType == r3d::PRIMITIVE_TRIANGLES) || (g->nType == r3d::PRIMITIVE_WIREFRAME_TRIANGLES);
+                bool clusters           = (g->nType == r3d::PRIMITIVE_TRIANGLES) && (cluster_min > 0) &&
+                                          (count / 3 >= cluster_min) && (!ordered);
+                g->bOrdered             = true;
+                if (triangles)
+                {
+                    g->fAcmrBefore          = compute_acmr(g->vIndices, count, vertices, VCACHE_FIFO_SIZE);
+                    if ((flags & CACHE_OPTIMIZE) && (count >= 6) && (!ordered) && (!clusters))
+                    {
+                        g->bOrdered             = false;
+                        status_t res            = (direct) ?
+                            optimize_triangles(g->vIndices, count, vertices) :
+                            optimize_geometry(g, arena);
+                        if (res != STATUS_OK)
+                            return res;
+                        g->fAcmrAfter           = compute_acmr(g->vIndices, count, vertices, VCACHE_FIFO_SIZE);
+                    }
+                    else
+                        g->fAcmrAfter           = g->fAcmrBefore;
+                }
+
+                // Gather vertex data, interleaved data is uploaded to the video memory directly
+                const vertex_t *vx      = reinterpret_cast<const vertex_t *>(data->vertex.data);
+                if ((!direct) || (!ext->bVBO))
+                {
+                    g->vVertices            = static_cast<vertex_t *>(malloc(vertices * sizeof(vertex_t)));
+                    if (g->vVertices == NULL)
+                        return STATUS_NO_MEM;
+                    gather_vertices(g->vVertices, g->vRemap, vertices, data);
+                    vx                      = g->vVertices;
+                }
+
+                // Split large triangle buffers into clusters
+                if (clusters)
+                {
+                    status_t res            = build_clusters(g, vx, true, arena);
+                    if (res != STATUS_OK)
+                        return res;
+                    g->bOrdered             = false;
+                    g->fAcmrAfter           = compute_acmr(g->vIndices, count, vertices, VCACHE_FIFO_SIZE);
+                }
+
+                g->nBytes              += vertices * (sizeof(vertex_t) + sizeof(remap_t)) + count * sizeof(uint32_t);
+
+                // Upload data to the video memory
+                if (ext->bVBO)
+                {
+                    GLuint buffers[2]       = { 0, 0 };
+                    ext->glGenBuffers(2, buffers);
+                    g->nVBO                 = buffers[0];
+                    g->nIBO                 = buffers[1];
+
+                    ext->glBindBuffer(GL_ARRAY_BUFFER, g->nVBO);
+                    ext->glBufferData(GL_ARRAY_BUFFER, vertices * sizeof(vertex_t), vx, GL_STATIC_DRAW);
+                    ext->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+                    ext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g->nIBO);
+                    ext->glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), g->vIndices, GL_STATIC_DRAW);
+                    ext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+                    // Vertex data is not needed anymore
+                    free(g->vVertices);
+                    g->vVertices            = NULL;
+                }
+
+                return STATUS_OK;
+            }
+
+            static inline bool range_contains(const dirty_t *d, size_t index)
+            {
+                return (index >= d->first) && (index < d->last);
+            }
+
+            static inline bool vertex_dirty(const geometry_t *g, const remap_t *r)
+            {
+                return
+                    (range_contains(&g->vDirty[0], r->v)) ||
+                    (range_contains(&g->vDirty[1], r->n)) ||
+                    (range_contains(&g->vDirty[2], r->c));
+            }
+
+            static void drop_sorting(geometry_t *g)
+            {
+                // Centroids and the depth order are computed again on the next sorting
+                if (g->vCentroids != NULL)
+                {
+                    free(g->vCentroids);
+                    g->vCentroids   = NULL;
+                    g->nBytes      -= g->nCount * sizeof(float);
+                }
+                if (g->vSorted != NULL)
+                {
+                    free(g->vSorted);
+                    g->vSorted      = NULL;
+                    g->nBytes      -= g->nCount * sizeof(uint32_t);
+                }
+            }
+
+            static status_t update_clusters(geometry_t *g, const r3d::buffer_t *data, arena_t *arena)
+            {
+                // Bounds of clusters are computed again for the current order of triangles
+                if (g->vVertices != NULL)
+                    return build_clusters(g, g->vVertices, false, arena);
+
+                arena_mark_t mark       = arena->mark();
+                vertex_t *vx            = arena->alloc<vertex_t>(g->nVertices);
+                if (vx == NULL)
+                    return STATUS_NO_MEM;
+                gather_vertices(vx, g->vRemap, g->nVertices, data);
+                status_t res            = build_clusters(g, vx, false, arena);
+                arena->release(mark);
+
+                return res;
+            }
+
+            /**
+             * Gather and upload vertices that refer modified ranges of the source data.
+             * Runs of modified vertices separated by short gaps are uploaded by single call.
+             */
+            static status_t update_contents(const gl_ext_t *ext, geometry_t *g, const r3d::buffer_t *data, arena_t *arena, size_t *bytes)
+            {
+                status_t res            = STATUS_OK;
+                size_t uploaded         = 0;
+                size_t vertices         = g->nVertices;
+                arena_mark_t mark       = arena->mark();
+
+                if (g->nVBO != 0)
+                    ext->glBindBuffer(GL_ARRAY_BUFFER, g->nVBO);
+
+                for (size_t i=0; i<vertices; )
+                {
+                    if (!vertex_dirty(g, &g->vRemap[i]))
+                    {
+                        ++i;
+                        continue;
+                    }
+
+                    // Extend the run until the gap of unchanged vertices becomes too long
+                    size_t first            = i++;
+                    size_t last             = i;
+                    for ( ; i < vertices; ++i)
+                    {
+                        if (vertex_dirty(g, &g->vRemap[i]))
+                            last                    = i + 1;
+                        else if ((i - last) >= CACHE_UPDATE_GAP)
+                            break;
+                    }
+
+                    size_t n                = last - first;
+                    if (g->nVBO != 0)
+                    {
+                        vertex_t *vx            = arena->alloc<vertex_t>(n);
+                        if (vx == NULL)
+                        {
+                            res                     = STATUS_NO_MEM;
+                            break;
+                        }
+                        gather_vertices(vx, &g->vRemap[first], n, data);
+                        ext->glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(vertex_t), n * sizeof(vertex_t), vx);
+                        arena->release(mark);
+                    }
+                    else
+                        gather_vertices(&g->vVertices[first], &g->vRemap[first], n, data);
+
+                    uploaded               += n * sizeof(vertex_t);
+                }
+
+                if (g->nVBO != 0)
+                    ext->glBindBuffer(GL_ARRAY_BUFFER, 0);
+                arena->release(mark);
+                if (res != STATUS_OK)
+                    return res;
+
+                if (g->vDirty[0].first < g->vDirty[0].last)
+                {
+                    drop_sorting(g);
+                    if ((g->pClusters != NULL) && ((res = update_clusters(g, data, arena)) != STATUS_OK))
+                        return res;
+                }
+                for (size_t i=0; i<3; ++i)
+                {
+                    g->vDirty[i].first      = 0;
+                    g->vDirty[i].last       = 0;
+                }
+                g->bDirty               = false;
+                *bytes                  = uploaded;
+
+                return STATUS_OK;
+            }
+
+            void geometry_cache_t::construct()
+            {
+                for (size_t i=0; i<CACHE_BINS; ++i)
+                    vBins[i]        = NULL;
+                nFlags          = 0;
+                nVersion        = 1;
+                nFrame          = 0;
+                nEntries        = 0;
+                nHits           = 0;
+                nMisses         = 0;
+                nSorts          = 0;
+                nSortHits       = 0;
+                nUpdates        = 0;
+                nUpdatedBytes   = 0;
+                nClusterMin     = 0;
+                nClusterTests   = 0;
+                nClusterCulls   = 0;
+            }
+
+            void geometry_cache_t::destroy(const gl_ext_t *ext)
+            {
+                for (size_t i=0; i<CACHE_BINS; ++i)
+                {
+                    for (geometry_t *g = vBins[i]; g != NULL; )
+                    {
+                        geometry_t *next    = g->pNext;
+                        release_contents(ext, g);
+                        free(g);
+                        g                   = next;
+                    }
+                    vBins[i]        = NULL;
+                }
+                nEntries        = 0;
+            }
+
+            geometry_t *geometry_cache_t::get(const gl_ext_t *ext, const r3d::buffer_t *key, const r3d::buffer_t *data, size_t count,
+                bool ordered, arena_t *arena)
+            {
+                uint32_t hash       = hash_key(key, count);
+                geometry_t **bin    = &vBins[hash & (CACHE_BINS - 1)];
+
+                // Lookup for the entry
+                geometry_t *g       = *bin;
+                for ( ; g != NULL; g = g->pNext)
+                {
+                    if (key_equals(g, key, count, hash))
+                        break;
+                }
+
+                if (g != NULL)
+                {
+                    g->nLastFrame       = nFrame;
+                    if ((g->nVersion == nVersion) && ((!ordered) || (g->bOrdered)))
+                    {
+                        if (!g->bDirty)
+                        {
+                            ++nHits;
+                            return g;
+                        }
+
+                        // Upload only modified vertices
+                        size_t bytes        = 0;
+                        if (update_contents(ext, g, data, arena, &bytes) == STATUS_OK)
+                        {
+                            ++nHits;
+                            ++nUpdates;
+                            nUpdatedBytes      += bytes;
+                            return g;
+                        }
+                    }
+
+                    // The entry is stale or its primitives are reordered, rebuild it
+                    release_contents(ext, g);
+                }
+                else
+                {
+                    g                   = static_cast<geometry_t *>(malloc(sizeof(geometry_t)));
+                    if (g == NULL)
+                        return NULL;
+
+                    g->pVData           = key->vertex.data;
+                    g->pNData           = key->normal.data;
+                    g->pCData           = key->color.data;
+                    g->pVIndex          = key->vertex.index;
+                    g->pNIndex          = key->normal.index;
+                    g->pCIndex          = key->color.index;
+                    g->nVStride         = key->vertex.stride;
+                    g->nNStride         = key->normal.stride;
+                    g->nCStride         = key->color.stride;
+                    g->nCount           = count;
+                    g->nType            = key->type;
+                    g->nHash            = hash;
+                    g->nLastFrame       = nFrame;
+
+                    g->nVBO             = 0;
+                    g->nIBO             = 0;
+                    g->vVertices        = NULL;
+                    g->vIndices         = NULL;
+                    g->vRemap           = NULL;
+                    g->nVertices        = 0;
+                    g->nBytes           = 0;
+                    g->vCentroids       = NULL;
+                    g->vSorted          = NULL;
+                    g->bSorted          = false;
+                    for (size_t i=0; i<3; ++i)
+                    {
+                        g->vDirty[i].first  = 0;
+                        g->vDirty[i].last   = 0;
+                    }
+                    g->bDirty           = false;
+                    g->bOrdered         = false;
+                    g->pClusters        = NULL;
+
+                    g->pNext            = *bin;
+                    *bin                = g;
+                    ++nEntries;
+                }
+
+                ++nMisses;
+                g->nVersion         = nVersion;
+                g->fAcmrBefore      = 0.0f;
+                g->fAcmrAfter       = 0.0f;
+
+                status_t res        = build_contents(ext, nFlags, nClusterMin, g, data, ordered, arena);
+                if (res != STATUS_OK)
+                {
+                    lsp_warn("Failed to build cached geometry, code=%d", int(res));
+                    release_contents(ext, g);
+                    g->nVersion         = 0;
+                    return NULL;
+                }
+
+                lsp_trace("Cached geometry: vertices=%d, indices=%d, ACMR before=%.3f, after=%.3f",
+                    int(g->nVertices), int(g->nCount), g->fAcmrBefore, g->fAcmrAfter);
+
+                return g;
+            }
+
+            static status_t compute_centroids(geometry_t *g, const r3d::buffer_t *data)
+            {
+                size_t triangles        = g->nCount / 3;
+                float *c                = static_cast<float *>(malloc(triangles * 3 * sizeof(float)));
+                if (c == NULL)
+                    return STATUS_NO_MEM;
+
+                float *cx               = c;
+                float *cy               = &c[triangles];
+                float *cz               = &c[triangles * 2];
+                const uint8_t  *vbuf    = reinterpret_cast<const uint8_t *>(data->vertex.data);
+                size_t vstride          = (data->vertex.stride == 0) ? sizeof(r3d::dot4_t)  : data->vertex.stride;
+                const uint32_t *idx     = g->vIndices;
+                constexpr float k       = 1.0f / 3.0f;
+
+                for (size_t i=0; i<triangles; ++i, idx += 3)
+                {
+                    const r3d::dot4_t *p0   = reinterpret_cast<const r3d::dot4_t *>(&vbuf[g->vRemap[idx[0]].v * vstride]);
+                    const r3d::dot4_t *p1   = reinterpret_cast<const r3d::dot4_t *>(&vbuf[g->vRemap[idx[1]].v * vstride]);
+                    const r3d::dot4_t *p2   = reinterpret_cast<const r3d::dot4_t *>(&vbuf[g->vRemap[idx[2]].v * vstride]);
+                    cx[i]                   = (p0->x + p1->x + p2->x) * k;
+                    cy[i]                   = (p0->y + p1->y + p2->y) * k;
+                    cz[i]                   = (p0->z + p1->z + p2->z) * k;
+                }
+
+                g->vCentroids           = c;
+                return STATUS_OK;
+            }
+
+            static status_t sort_triangles(geometry_t *g, const float *row, arena_t *arena)
+            {
+                size_t triangles        = g->nCount / 3;
+                arena_mark_t mark       = arena->mark();
+                float *depth            = arena->alloc<float>(triangles);
+                uint32_t *order         = arena->alloc<uint32_t>(triangles);
+                if ((depth == NULL) || (order == NULL))
+                {
+                    arena->release(mark);
+                    return STATUS_NO_MEM;
+                }
+
+                // The far triangles have lower eye-space Z and go first
+                const float *c          = g->vCentroids;
+                compute_depths(depth, c, &c[triangles], &c[triangles * 2], row, triangles);
+                status_t res            = sort_by_keys(order, depth, triangles, arena);
+                if (res == STATUS_OK)
+                {
+                    uint32_t *dst           = g->vSorted;
+                    for (size_t i=0; i<triangles; ++i, dst += 3)
+                    {
+                        const uint32_t *src     = &g->vIndices[order[i] * 3];
+                        dst[0]                  = src[0];
+                        dst[1]                  = src[1];
+                        dst[2]                  = src[2];
+                    }
+                }
+
+                arena->release(mark);
+                return res;
+            }
+
+            static void upload_indices(const gl_ext_t *ext, geometry_t *g, const uint32_t *indices)
+            {
+                ext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g->nIBO);
+                ext->glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, g->nCount * sizeof(uint32_t), indices);
+                ext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            }
+
+            const uint32_t *geometry_cache_t::prepare_indices(const gl_ext_t *ext, geometry_t *g, const r3d::buffer_t *data, const r3d::mat4_t *mv,
+                arena_t *arena)
+            {
+                // Restore the original order if required
+                if ((mv == NULL) || (!(nFlags & CACHE_SORT)) || (g->nType != r3d::PRIMITIVE_TRIANGLES))
+                {
+                    if ((g->bSorted) && (g->nIBO != 0))
+                        upload_indices(ext, g, g->vIndices);
+                    g->bSorted      = false;
+                    return g->vIndices;
+                }
+
+                // Check that previous order can be reused
+                float row[4]    = { mv->m[2], mv->m[6], mv->m[10], mv->m[14] };
+                if ((g->vSorted != NULL) && (!depth_row_changed(row, g->vSortRow, CACHE_SORT_EPSILON)))
+                    ++nSortHits;
+                else
+                {
+                    // Allocate data
+                    if (g->vCentroids == NULL)
+                    {
+                        if (compute_centroids(g, data) != STATUS_OK)
+                            return g->vIndices;
+                        g->nBytes      += g->nCount * sizeof(float);
+                    }
+                    if (g->vSorted == NULL)
+                    {
+                        g->vSorted      = static_cast<uint32_t *>(malloc(g->nCount * sizeof(uint32_t)));
+                        if (g->vSorted == NULL)
+                            return g->vIndices;
+                        g->nBytes      += g->nCount * sizeof(uint32_t);
+                    }
+
+                    // Sort triangles
+                    if (sort_triangles(g, row, arena) != STATUS_OK)
+                    {
+                        free(g->vSorted);
+                        g->vSorted      = NULL;
+                        g->nBytes      -= g->nCount * sizeof(uint32_t);
+                        return g->vIndices;
+                    }
+                    for (size_t i=0; i<4; ++i)
+                        g->vSortRow[i]  = row[i];
+                    g->bSorted      = false;
+                    ++nSorts;
+                }
+
+                if ((!g->bSorted) && (g->nIBO != 0))
+                    upload_indices(ext, g, g->vSorted);
+                g->bSorted      = true;
+
+                return g->vSorted;
+            }
+
+            void geometry_cache_t::invalidate(const void *data)
+            {
+                if (data == NULL)
+                {
+                    if ((++nVersion) == 0)
+                        nVersion        = 1;
+                    return;
+                }
+
+                for (size_t i=0; i<CACHE_BINS; ++i)
+                {
+                    for (geometry_t *g = vBins[i]; g != NULL; g = g->pNext)
+                    {
+                        if ((g->pVData == data) ||
+                            (g->pNData == data) ||
+                            (g->pCData == data) ||
+                            (g->pVIndex == data) ||
+                            (g->pNIndex == data) ||
+                            (g->pCIndex == data))
+                            g->nVersion     = 0;
+                    }
+                }
+            }
+
+            static inline void mark_dirty(geometry_t *g, size_t attr, size_t first, size_t last)
+            {
+                dirty_t *d          = &g->vDirty[attr];
+                if (d->first < d->last)
+                {
+                    d->first            = lsp_min(d->first, first);
+                    d->last             = lsp_max(d->last, last);
+                }
+                else
+                {
+                    d->first            = first;
+                    d->last             = last;
+                }
+                g->bDirty           = true;
+            }
+
+            void geometry_cache_t::update(const void *data, size_t first, size_t count)
+            {
+                size_t last         = first + count;
+
+                for (size_t i=0; i<CACHE_BINS; ++i)
+                {
+                    for (geometry_t *g = vBins[i]; g != NULL; g = g->pNext)
+                    {
+                        // Changed indices alter the topology, the entry should be rebuilt
+                        if ((g->pVIndex == data) ||
+                            (g->pNIndex == data) ||
+                            (g->pCIndex == data))
+                        {
+                            g->nVersion     = 0;
+                            continue;
+                        }
+
+                        if (g->pVData == data)
+                            mark_dirty(g, 0, first, last);
+                        if (g->pNData == data)
+                            mark_dirty(g, 1, first, last);
+                        if (g->pCData == data)
+                            mark_dirty(g, 2, first, last);
+                    }
+                }
+            }
+
+            void geometry_cache_t::next_frame(const gl_ext_t *ext)
+            {
+                ++nFrame;
+
+                for (size_t i=0; i<CACHE_BINS; ++i)
+                {
+                    for (geometry_t **pg = &vBins[i]; *pg != NULL; )
+                    {
+                        geometry_t *g       = *pg;
+                        if ((nFrame - g->nLastFrame) <= CACHE_MAX_AGE)
+                        {
+                            pg                  = &g->pNext;
+                            continue;
+                        }
+
+                        *pg                 = g->pNext;
+                        release_contents(ext, g);
+                        free(g);
+                        --nEntries;
+                    }
+                }
+            }
+
+            void geometry_cache_t::get_stats(cache_stats_t *stats)
+            {
+                float before = 0.0f, after = 0.0f;
+                size_t triangles = 0;
+
+                stats->nEntries     = nEntries;
+                stats->nVertices    = 0;
+                stats->nIndices     = 0;
+                stats->nBytes       = 0;
+                stats->nHits        = nHits;
+                stats->nMisses      = nMisses;
+                stats->nSorts       = nSorts;
+                stats->nSortHits    = nSortHits;
+                stats->nUpdates     = nUpdates;
+                stats->nUpdatedBytes = nUpdatedBytes;
+                stats->nClusters    = 0;
+                stats->nClusterTests = nClusterTests;
+                stats->nClusterCulls = nClusterCulls;
+
+                for (size_t i=0; i<CACHE_BINS; ++i)
+                {
+                    for (geometry_t *g = vBins[i]; g != NULL; g = g->pNext)
+                    {
+                        stats->nVertices   += g->nVertices;
+                        stats->nIndices    += g->nCount;
+                        stats->nBytes      += g->nBytes;
+                        if (g->pClusters != NULL)
+                            stats->nClusters   += g->pClusters->nClusters;
+
+                        if (g->fAcmrBefore > 0.0f)
+                        {
+                            size_t n            = g->nCount / 3;
+                            before             += g->fAcmrBefore * n;
+                            after              += g->fAcmrAfter * n;
+                            triangles          += n;
+                        }
+                    }
+                }
+
+                stats->fAcmrBefore  = (triangles > 0) ? before / triangles : 0.0f;
+                stats->fAcmrAfter   = (triangles > 0) ? after / triangles : 0.0f;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PLATFORM_WINDOWS */
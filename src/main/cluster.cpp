@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/cluster.h>
+#include <private/wgl/sort.h>
+
+#include <float.h>
+#include <stdlib.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            static inline const r3d::dot4_t *vertex_at(const uint8_t *vertices, size_t stride, uint32_t index)
+            {
+                return reinterpret_cast<const r3d::dot4_t *>(&vertices[index * stride]);
+            }
+
+            void cluster_set_t::construct()
+            {
+                vCX         = NULL;
+                vCY         = NULL;
+                vCZ         = NULL;
+                vRadius     = NULL;
+                vAX         = NULL;
+                vAY         = NULL;
+                vAZ         = NULL;
+                vCutoff     = NULL;
+                nClusters   = 0;
+                nCount      = 0;
+                pData       = NULL;
+            }
+
+            void cluster_set_t::destroy()
+            {
+                if (pData != NULL)
+                    free(pData);
+                construct();
+            }
+
+            status_t cluster_set_t::build(const r3d::dot4_t *vertices, size_t stride, const uint32_t *indices, size_t count)
+            {
+                size_t triangles    = count / 3;
+                size_t clusters     = (triangles + CLUSTER_TRIANGLES - 1) / CLUSTER_TRIANGLES;
+                uint8_t *data       = static_cast<uint8_t *>(malloc(clusters * sizeof(float) * 8));
+                if (data == NULL)
+                    return STATUS_NO_MEM;
+
+                destroy();
+                pData               = data;
+                float *ptr          = reinterpret_cast<float *>(data);
+                vCX                 = ptr;
+                vCY                 = &ptr[clusters];
+                vCZ                 = &ptr[clusters * 2];
+                vRadius             = &ptr[clusters * 3];
+                vAX                 = &ptr[clusters * 4];
+                vAY                 = &ptr[clusters * 5];
+                vAZ                 = &ptr[clusters * 6];
+                vCutoff             = &ptr[clusters * 7];
+                nClusters           = clusters;
+                nCount              = triangles * 3;
+
+                const uint8_t *vbuf = reinterpret_cast<const uint8_t *>(vertices);
+                if (stride == 0)
+                    stride              = sizeof(r3d::dot4_t);
+
+                for (size_t k=0; k<clusters; ++k)
+                {
+                    const uint32_t *idx = &indices[k * CLUSTER_TRIANGLES * 3];
+                    size_t n            = lsp_min(triangles - k * CLUSTER_TRIANGLES, CLUSTER_TRIANGLES) * 3;
+
+                    // Bounding sphere around the center of the bounding box
+                    float min[3], max[3];
+                    const r3d::dot4_t *p = vertex_at(vbuf, stride, idx[0]);
+                    min[0] = max[0]     = p->x;
+                    min[1] = max[1]     = p->y;
+                    min[2] = max[2]     = p->z;
+                    for (size_t i=1; i<n; ++i)
+                    {
+                        p                   = vertex_at(vbuf, stride, idx[i]);
+                        min[0]              = lsp_min(min[0], p->x);
+                        min[1]              = lsp_min(min[1], p->y);
+                        min[2]              = lsp_min(min[2], p->z);
+                        max[0]              = lsp_max(max[0], p->x);
+                        max[1]              = lsp_max(max[1], p->y);
+                        max[2]              = lsp_max(max[2], p->z);
+                    }
+
+                    float cx            = (min[0] + max[0]) * 0.5f;
+                    float cy            = (min[1] + max[1]) * 0.5f;
+                    float cz            = (min[2] + max[2]) * 0.5f;
+                    float r2            = 0.0f;
+                    for (size_t i=0; i<n; ++i)
+                    {
+                        p                   = vertex_at(vbuf, stride, idx[i]);
+                        float dx            = p->x - cx;
+                        float dy            = p->y - cy;
+                        float dz            = p->z - cz;
+                        r2                  = lsp_max(r2, dx*dx + dy*dy + dz*dz);
+                    }
+
+                    vCX[k]              = cx;
+                    vCY[k]              = cy;
+                    vCZ[k]              = cz;
+                    vRadius[k]          = sqrtf(r2);
+
+                    // Normal cone: the axis is the average normal, the cutoff is the sine of the half-angle
+                    float ax = 0.0f, ay = 0.0f, az = 0.0f;
+                    for (size_t i=0; i<n; i += 3)
+                    {
+                        const r3d::dot4_t *p0   = vertex_at(vbuf, stride, idx[i]);
+                        const r3d::dot4_t *p1   = vertex_at(vbuf, stride, idx[i+1]);
+                        const r3d::dot4_t *p2   = vertex_at(vbuf, stride, idx[i+2]);
+                        float ux = p1->x - p0->x, uy = p1->y - p0->y, uz = p1->z - p0->z;
+                        float vx = p2->x - p0->x, vy = p2->y - p0->y, vz = p2->z - p0->z;
+                        float nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+                        float len = sqrtf(nx*nx + ny*ny + nz*nz);
+                        if (len <= 0.0f)
+                            continue;
+                        len         = 1.0f / len;
+                        ax         += nx * len;
+                        ay         += ny * len;
+                        az         += nz * len;
+                    }
+
+                    float cutoff        = CLUSTER_NO_CONE;
+                    float alen          = sqrtf(ax*ax + ay*ay + az*az);
+                    if (alen > 0.0f)
+                    {
+                        alen                = 1.0f / alen;
+                        ax                 *= alen;
+                        ay                 *= alen;
+                        az                 *= alen;
+
+                        float mindp         = 1.0f;
+                        for (size_t i=0; i<n; i += 3)
+                        {
+                            const r3d::dot4_t *p0   = vertex_at(vbuf, stride, idx[i]);
+                            const r3d::dot4_t *p1   = vertex_at(vbuf, stride, idx[i+1]);
+                            const r3d::dot4_t *p2   = vertex_at(vbuf, stride, idx[i+2]);
+                            float ux = p1->x - p0->x, uy = p1->y - p0->y, uz = p1->z - p0->z;
+                            float vx = p2->x - p0->x, vy = p2->y - p0->y, vz = p2->z - p0->z;
+                            float nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+                            float len = sqrtf(nx*nx + ny*ny + nz*nz);
+                            if (len > 0.0f)
+                                mindp       = lsp_min(mindp, (nx*ax + ny*ay + nz*az) / len);
+                        }
+
+                        // Cones wider than the hemisphere can not be backfacing as a whole
+                        if (mindp > 0.0f)
+                            cutoff          = sqrtf(lsp_max(1.0f - mindp * mindp, 0.0f));
+                    }
+
+                    vAX[k]              = ax;
+                    vAY[k]              = ay;
+                    vAZ[k]              = az;
+                    vCutoff[k]          = cutoff;
+                }
+
+                return STATUS_OK;
+            }
+
+            static inline bool cluster_culled(const cluster_set_t *s, const cluster_view_t *view, size_t i)
+            {
+                float cx        = s->vCX[i];
+                float cy        = s->vCY[i];
+                float cz        = s->vCZ[i];
+                float r         = s->vRadius[i];
+
+                for (size_t j=0; j<6; ++j)
+                {
+                    const float *p  = view->vPlanes[j];
+                    if ((p[0]*cx + p[1]*cy + p[2]*cz + p[3]) < -r)
+                        return true;
+                }
+
+                if (!view->bCones)
+                    return false;
+
+                // All triangles face away if the view vector lies inside the cone around the axis
+                const float *e  = view->vEye;
+                float dx        = cx * e[3] - e[0];
+                float dy        = cy * e[3] - e[1];
+                float dz        = cz * e[3] - e[2];
+                float len       = sqrtf(dx*dx + dy*dy + dz*dz);
+                float dp        = dx * s->vAX[i] + dy * s->vAY[i] + dz * s->vAZ[i];
+                return dp >= s->vCutoff[i] * len + r * e[3];
+            }
+
+            static inline size_t add_cluster(cluster_range_t *ranges, size_t n, ssize_t *last, size_t k, size_t count)
+            {
+                uint32_t first  = uint32_t(k * CLUSTER_TRIANGLES * 3);
+                uint32_t size   = uint32_t(lsp_min(count - first, CLUSTER_TRIANGLES * 3));
+
+                // Merge with the previous cluster if it is visible too
+                if ((n > 0) && (*last == ssize_t(k) - 1))
+                    ranges[n-1].count  += size;
+                else
+                {
+                    ranges[n].first     = first;
+                    ranges[n].count     = size;
+                    ++n;
+                }
+                *last           = k;
+                return n;
+            }
+
+            size_t cluster_set_t::cull(cluster_range_t *ranges, const cluster_view_t *view, size_t *visible) const
+            {
+                size_t n        = 0;
+                size_t shown    = 0;
+                ssize_t last    = -2;
+                size_t i        = 0;
+
+            #ifdef __SSE2__
+                const __m128 zero   = _mm_setzero_ps();
+                const __m128 ew     = _mm_set1_ps(view->vEye[3]);
+                const __m128 ex     = _mm_set1_ps(view->vEye[0]);
+                const __m128 ey     = _mm_set1_ps(view->vEye[1]);
+                const __m128 ez     = _mm_set1_ps(view->vEye[2]);
+
+                for ( ; i + 4 <= nClusters; i += 4)
+                {
+                    __m128 cx           = _mm_loadu_ps(&vCX[i]);
+                    __m128 cy           = _mm_loadu_ps(&vCY[i]);
+                    __m128 cz           = _mm_loadu_ps(&vCZ[i]);
+                    __m128 r            = _mm_loadu_ps(&vRadius[i]);
+                    __m128 nr           = _mm_sub_ps(zero, r);
+
+                    // Frustum test of bounding spheres
+                    __m128 out          = _mm_setzero_ps();
+                    for (size_t j=0; j<6; ++j)
+                    {
+                        const float *p      = view->vPlanes[j];
+                        __m128 d            = _mm_add_ps(
+                            _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(p[0])), _mm_mul_ps(cy, _mm_set1_ps(p[1]))),
+                            _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(p[2])), _mm_set1_ps(p[3])));
+                        out                 = _mm_or_ps(out, _mm_cmplt_ps(d, nr));
+                    }
+
+                    // Backface test of normal cones
+                    if (view->bCones)
+                    {
+                        __m128 dx           = _mm_sub_ps(_mm_mul_ps(cx, ew), ex);
+                        __m128 dy           = _mm_sub_ps(_mm_mul_ps(cy, ew), ey);
+                        __m128 dz           = _mm_sub_ps(_mm_mul_ps(cz, ew), ez);
+                        __m128 len          = _mm_sqrt_ps(_mm_add_ps(
+                            _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+                        __m128 dp           = _mm_add_ps(
+                            _mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&vAX[i])), _mm_mul_ps(dy, _mm_loadu_ps(&vAY[i]))),
+                            _mm_mul_ps(dz, _mm_loadu_ps(&vAZ[i])));
+                        __m128 lim          = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&vCutoff[i]), len), _mm_mul_ps(r, ew));
+                        out                 = _mm_or_ps(out, _mm_cmpge_ps(dp, lim));
+                    }
+
+                    int mask            = _mm_movemask_ps(out);
+                    if (mask == 0xf)
+                        continue;
+                    for (size_t j=0; j<4; ++j)
+                    {
+                        if (mask & (1 << j))
+                            continue;
+                        n                   = add_cluster(ranges, n, &last, i + j, nCount);
+                        ++shown;
+                    }
+                }
+            #endif /* __SSE2__ */
+
+                for ( ; i < nClusters; ++i)
+                {
+                    if (cluster_culled(this, view, i))
+                        continue;
+                    n                   = add_cluster(ranges, n, &last, i, nCount);
+                    ++shown;
+                }
+
+                if (visible != NULL)
+                    *visible            = shown;
+                return n;
+            }
+
+            static inline uint32_t morton_spread(uint32_t x)
+            {
+                // Insert two zero bits between bits of the 8-bit value
+                x       = (x | (x << 8)) & 0x0f00f;
+                x       = (x | (x << 4)) & 0xc30c3;
+                x       = (x | (x << 2)) & 0x249249;
+                return x;
+            }
+
+            static inline uint32_t morton_cell(float v, float min, float scale)
+            {
+                float c = (v - min) * scale;
+                return (c > 0.0f) ? lsp_min(uint32_t(c), uint32_t(0xff)) : 0;
+            }
+
+            status_t cluster_sort(uint32_t *indices, size_t count, const r3d::dot4_t *vertices, size_t stride, arena_t *arena)
+            {
+                size_t triangles    = count / 3;
+                if (triangles <= CLUSTER_TRIANGLES)
+                    return STATUS_OK;
+
+                arena_mark_t mark   = arena->mark();
+                float *cx           = arena->alloc<float>(triangles * 4);
+                uint32_t *order     = arena->alloc<uint32_t>(triangles);
+                uint32_t *sorted    = arena->alloc<uint32_t>(triangles * 3);
+                if ((cx == NULL) || (order == NULL) || (sorted == NULL))
+                {
+                    arena->release(mark);
+                    return STATUS_NO_MEM;
+                }
+                float *cy           = &cx[triangles];
+                float *cz           = &cx[triangles * 2];
+                float *keys         = &cx[triangles * 3];
+
+                // Compute centroids and their bounds
+                const uint8_t *vbuf = reinterpret_cast<const uint8_t *>(vertices);
+                if (stride == 0)
+                    stride              = sizeof(r3d::dot4_t);
+                constexpr float k   = 1.0f / 3.0f;
+                float min[3]        = { FLT_MAX, FLT_MAX, FLT_MAX };
+                float max[3]        = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+                for (size_t i=0; i<triangles; ++i)
+                {
+                    const uint32_t *idx     = &indices[i * 3];
+                    const r3d::dot4_t *p0   = vertex_at(vbuf, stride, idx[0]);
+                    const r3d::dot4_t *p1   = vertex_at(vbuf, stride, idx[1]);
+                    const r3d::dot4_t *p2   = vertex_at(vbuf, stride, idx[2]);
+                    cx[i]                   = (p0->x + p1->x + p2->x) * k;
+                    cy[i]                   = (p0->y + p1->y + p2->y) * k;
+                    cz[i]                   = (p0->z + p1->z + p2->z) * k;
+                    min[0]                  = lsp_min(min[0], cx[i]);
+                    min[1]                  = lsp_min(min[1], cy[i]);
+                    min[2]                  = lsp_min(min[2], cz[i]);
+                    max[0]                  = lsp_max(max[0], cx[i]);
+                    max[1]                  = lsp_max(max[1], cy[i]);
+                    max[2]                  = lsp_max(max[2], cz[i]);
+                }
+
+                // 24-bit Morton codes are represented exactly by float keys
+                float size          = lsp_max(max[0] - min[0], lsp_max(max[1] - min[1], max[2] - min[2]));
+                float scale         = (size > 0.0f) ? 256.0f / size : 0.0f;
+                for (size_t i=0; i<triangles; ++i)
+                {
+                    uint32_t code           =
+                        morton_spread(morton_cell(cx[i], min[0], scale)) |
+                        (morton_spread(morton_cell(cy[i], min[1], scale)) << 1) |
+                        (morton_spread(morton_cell(cz[i], min[2], scale)) << 2);
+                    keys[i]                 = float(code);
+                }
+
+                status_t res        = sort_by_keys(order, keys, triangles, arena);
+                if (res == STATUS_OK)
+                {
+                    uint32_t *dst           = sorted;
+                    for (size_t i=0; i<triangles; ++i, dst += 3)
+                    {
+                        const uint32_t *src     = &indices[order[i] * 3];
+                        dst[0]                  = src[0];
+                        dst[1]                  = src[1];
+                        dst[2]                  = src[2];
+                    }
+                    ::memcpy(indices, sorted, triangles * 3 * sizeof(uint32_t));
+                }
+
+                arena->release(mark);
+                return res;
+            }
+
+            void cluster_view(cluster_view_t *view, const r3d::mat4_t *projection, const r3d::mat4_t *modelview, bool cones)
+            {
+                // Frustum planes are the combinations of rows of the model-view-projection matrix
+                r3d::mat4_t mvp;
+                const float *a  = projection->m;
+                const float *b  = modelview->m;
+                for (size_t c=0; c<4; ++c)
+                    for (size_t r=0; r<4; ++r)
+                        mvp.m[c*4 + r]  = a[r] * b[c*4] + a[4 + r] * b[c*4 + 1] + a[8 + r] * b[c*4 + 2] + a[12 + r] * b[c*4 + 3];
+
+                const float *m  = mvp.m;
+                for (size_t i=0; i<6; ++i)
+                {
+                    size_t row      = i >> 1;
+                    float sign      = (i & 1) ? -1.0f : 1.0f;
+                    float *p        = view->vPlanes[i];
+                    for (size_t c=0; c<4; ++c)
+                        p[c]            = m[c*4 + 3] + sign * m[c*4 + row];
+
+                    float len       = sqrtf(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+                    if (len > 0.0f)
+                    {
+                        len             = 1.0f / len;
+                        p[0]           *= len;
+                        p[1]           *= len;
+                        p[2]           *= len;
+                        p[3]           *= len;
+                    }
+                    else
+                    {
+                        p[0]            = 0.0f;
+                        p[1]            = 0.0f;
+                        p[2]            = 0.0f;
+                        p[3]            = 1.0f;
+                    }
+                }
+
+                // Inverse of the upper 3x3 part of the model-view matrix
+                float i00 = b[5]*b[10] - b[9]*b[6],  i01 = b[8]*b[6] - b[4]*b[10], i02 = b[4]*b[9] - b[8]*b[5];
+                float i10 = b[9]*b[2] - b[1]*b[10],  i11 = b[0]*b[10] - b[8]*b[2], i12 = b[8]*b[1] - b[0]*b[9];
+                float i20 = b[1]*b[6] - b[5]*b[2],   i21 = b[4]*b[2] - b[0]*b[6],  i22 = b[0]*b[5] - b[4]*b[1];
+                float det = b[0]*i00 + b[4]*i10 + b[8]*i20;
+
+                // Mirroring transforms flip the winding of triangles
+                view->bCones    = (cones) && (det > 0.0f);
+                if (!view->bCones)
+                {
+                    view->vEye[0]   = 0.0f;
+                    view->vEye[1]   = 0.0f;
+                    view->vEye[2]   = 0.0f;
+                    view->vEye[3]   = 0.0f;
+                    return;
+                }
+                det             = 1.0f / det;
+
+                if (projection->m[11] != 0.0f)
+                {
+                    // Perspective projection: eye position is the inverse transform of the origin
+                    float tx = b[12], ty = b[13], tz = b[14];
+                    view->vEye[0]   = -(i00*tx + i01*ty + i02*tz) * det;
+                    view->vEye[1]   = -(i10*tx + i11*ty + i12*tz) * det;
+                    view->vEye[2]   = -(i20*tx + i21*ty + i22*tz) * det;
+                    view->vEye[3]   = 1.0f;
+                }
+                else
+                {
+                    // Orthographic projection: negated direction of the view along -Z
+                    float dx        = -i02 * det;
+                    float dy        = -i12 * det;
+                    float dz        = -i22 * det;
+                    float len       = sqrtf(dx*dx + dy*dy + dz*dz);
+                    len             = (len > 0.0f) ? 1.0f / len : 0.0f;
+                    view->vEye[0]   = -dx * len;
+                    view->vEye[1]   = -dy * len;
+                    view->vEye[2]   = -dz * len;
+                    view->vEye[3]   = 0.0f;
+                }
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
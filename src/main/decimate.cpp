@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/decimate.h>
+#include <private/wgl/matrix.h>
+
+#include <float.h>
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t LOD_GRID_BITS          = LOD_MAX_LEVELS;
+            constexpr uint32_t LOD_GRID_MASK        = (1 << LOD_GRID_BITS) - 1;
+
+            static inline size_t lod_hash(const r3d::buffer_t *key)
+            {
+                uintptr_t h = reinterpret_cast<uintptr_t>(key->vertex.data) ^
+                              (reinterpret_cast<uintptr_t>(key->vertex.index) >> 4) ^
+                              key->count;
+                h          ^= h >> 7;
+                h          ^= h >> 13;
+                return h & (LOD_BINS - 1);
+            }
+
+            static inline bool lod_match(const lod_t *lod, const r3d::buffer_t *key)
+            {
+                return (lod->pVData == key->vertex.data) &&
+                       (lod->pVIndex == key->vertex.index) &&
+                       (lod->pNIndex == ((key->normal.data != NULL) ? key->normal.index : NULL)) &&
+                       (lod->pCIndex == ((key->color.data != NULL) ? key->color.index : NULL)) &&
+                       (lod->nVStride == key->vertex.stride) &&
+                       (lod->nCount == key->count) &&
+                       (lod->nType == uint32_t(key->type));
+            }
+
+            static void free_lod(lod_t *lod)
+            {
+                for (size_t i=0; i<lod->nLevels; ++i)
+                    free(lod->vLevels[i].vVIndex);
+                free(lod);
+            }
+
+            void lod_cache_t::construct()
+            {
+                for (size_t i=0; i<LOD_BINS; ++i)
+                    vBins[i]        = NULL;
+                nMinCount       = 0;
+                nFrame          = 0;
+                nEntries        = 0;
+            }
+
+            void lod_cache_t::destroy()
+            {
+                invalidate(NULL);
+            }
+
+            void lod_cache_t::invalidate(const void *data)
+            {
+                for (size_t i=0; i<LOD_BINS; ++i)
+                {
+                    for (lod_t **pl = &vBins[i]; *pl != NULL; )
+                    {
+                        lod_t *lod          = *pl;
+                        if ((data != NULL) &&
+                            (lod->pVData != data) &&
+                            (lod->pVIndex != data) &&
+                            (lod->pNIndex != data) &&
+                            (lod->pCIndex != data))
+                        {
+                            pl                  = &lod->pNext;
+                            continue;
+                        }
+
+                        *pl                 = lod->pNext;
+                        free_lod(lod);
+                        --nEntries;
+                    }
+                }
+            }
+
+            void lod_cache_t::next_frame()
+            {
+                ++nFrame;
+
+                for (size_t i=0; i<LOD_BINS; ++i)
+                {
+                    for (lod_t **pl = &vBins[i]; *pl != NULL; )
+                    {
+                        lod_t *lod          = *pl;
+                        if ((nFrame - lod->nLastFrame) <= LOD_MAX_AGE)
+                        {
+                            pl                  = &lod->pNext;
+                            continue;
+                        }
+
+                        *pl                 = lod->pNext;
+                        free_lod(lod);
+                        --nEntries;
+                    }
+                }
+            }
+
+            static inline uint64_t cell_key(const uint32_t *codes, size_t prim, size_t epp, size_t shift)
+            {
+                // Cell code contains 10-bit coordinates along each axis
+                const uint32_t *c   = &codes[prim * epp];
+                uint32_t m          = (LOD_GRID_MASK >> shift) * 0x100401;  // Mask for all three coordinates
+                uint32_t a          = (c[0] >> shift) & m;
+                if (epp < 2)
+                    return a;
+
+                // The pair of cells does not depend on the direction of the line
+                uint32_t b          = (c[1] >> shift) & m;
+                return (a < b) ? (uint64_t(a) | (uint64_t(b) << 32)) : (uint64_t(b) | (uint64_t(a) << 32));
+            }
+
+            static bool store_level(lod_level_t *level, const r3d::buffer_t *data, const uint32_t *prims, size_t count, size_t epp)
+            {
+                // With normal or color indices, unindexed normals and colors are per element
+                // and need own indices since primitives of the level are selected
+                bool nindex     = (data->normal.index != NULL) || (data->color.index != NULL);
+                bool cindex     = nindex;
+                size_t n        = count * epp;
+                size_t arrays   = 1 + ((nindex) ? 1 : 0) + ((cindex) ? 1 : 0);
+
+                uint32_t *ptr   = static_cast<uint32_t *>(malloc(n * arrays * sizeof(uint32_t)));
+                if (ptr == NULL)
+                    return false;
+
+                level->nCount   = count;
+                level->vVIndex  = ptr;
+                ptr            += n;
+                level->vNIndex  = NULL;
+                level->vCIndex  = NULL;
+                if (nindex)
+                {
+                    level->vNIndex  = ptr;
+                    ptr            += n;
+                }
+                if (cindex)
+                    level->vCIndex  = ptr;
+
+                const uint32_t *vindex  = data->vertex.index;
+                for (size_t i=0, k=0; i<count; ++i)
+                {
+                    for (size_t j=0; j<epp; ++j, ++k)
+                    {
+                        size_t e                = prims[i] * epp + j;
+                        level->vVIndex[k]       = (vindex != NULL) ? vindex[e] : uint32_t(e);
+                        if (nindex)
+                            level->vNIndex[k]       = (data->normal.index != NULL) ? data->normal.index[e] : uint32_t(e);
+                        if (cindex)
+                            level->vCIndex[k]       = (data->color.index != NULL) ? data->color.index[e] : uint32_t(e);
+                    }
+                }
+
+                return true;
+            }
+
+            static bool build_lod(lod_t *lod, const r3d::buffer_t *data, arena_t *arena)
+            {
+                size_t count        = data->count;
+                size_t epp          = (data->type == r3d::PRIMITIVE_LINES) ? 2 : 1;
+                size_t elements     = count * epp;
+                const uint8_t *vdata    = reinterpret_cast<const uint8_t *>(data->vertex.data);
+                const uint32_t *vindex  = data->vertex.index;
+                size_t vstride      = (data->vertex.stride == 0) ? sizeof(r3d::dot4_t) : data->vertex.stride;
+
+                // Compute the bounding box
+                float min[3]        = { FLT_MAX, FLT_MAX, FLT_MAX };
+                float max[3]        = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+                for (size_t i=0; i<elements; ++i)
+                {
+                    const r3d::dot4_t *p    = reinterpret_cast<const r3d::dot4_t *>(vdata + ((vindex != NULL) ? vindex[i] : i) * vstride);
+                    min[0]  = lsp_min(min[0], p->x);
+                    min[1]  = lsp_min(min[1], p->y);
+                    min[2]  = lsp_min(min[2], p->z);
+                    max[0]  = lsp_max(max[0], p->x);
+                    max[1]  = lsp_max(max[1], p->y);
+                    max[2]  = lsp_max(max[2], p->z);
+                }
+
+                float extent        = lsp_max(max[0] - min[0], lsp_max(max[1] - min[1], max[2] - min[2]));
+                if (!(extent > 0.0f))
+                    extent              = 1.0f;
+                lod->sCenter.x      = (min[0] + max[0]) * 0.5f;
+                lod->sCenter.y      = (min[1] + max[1]) * 0.5f;
+                lod->sCenter.z      = (min[2] + max[2]) * 0.5f;
+                lod->sCenter.w      = 1.0f;
+                lod->fExtent        = extent;
+                lod->nLevels        = 0;
+
+                // Allocate cell codes, two lists of primitives and the hash set
+                size_t cap          = 1;
+                while (cap < (count << 1))
+                    cap               <<= 1;
+                arena_mark_t mark   = arena->mark();
+                uint64_t *set       = arena->alloc<uint64_t>(cap);
+                uint32_t *codes     = arena->alloc<uint32_t>(elements);
+                uint32_t *src       = arena->alloc<uint32_t>(count);
+                uint32_t *dst       = arena->alloc<uint32_t>(count);
+                if ((set == NULL) || (codes == NULL) || (src == NULL) || (dst == NULL))
+                {
+                    arena->release(mark);
+                    return false;
+                }
+
+                // Compute codes of cells of the finest grid
+                float scale         = float(1 << LOD_GRID_BITS) / extent;
+                for (size_t i=0; i<elements; ++i)
+                {
+                    const r3d::dot4_t *p    = reinterpret_cast<const r3d::dot4_t *>(vdata + ((vindex != NULL) ? vindex[i] : i) * vstride);
+                    uint32_t cx     = lsp_min(uint32_t(lsp_max((p->x - min[0]) * scale, 0.0f)), LOD_GRID_MASK);
+                    uint32_t cy     = lsp_min(uint32_t(lsp_max((p->y - min[1]) * scale, 0.0f)), LOD_GRID_MASK);
+                    uint32_t cz     = lsp_min(uint32_t(lsp_max((p->z - min[2]) * scale, 0.0f)), LOD_GRID_MASK);
+                    codes[i]        = cx | (cy << LOD_GRID_BITS) | (cz << (LOD_GRID_BITS * 2));
+                }
+                for (size_t i=0; i<count; ++i)
+                    src[i]          = uint32_t(i);
+
+                // Build levels from the finest to the coarsest, representatives of each level are
+                // selected among representatives of the finer level
+                lod_level_t levels[LOD_MAX_LEVELS];
+                size_t n_levels     = 0;
+                size_t n_src        = count;
+                bool ok             = true;
+
+                for (size_t shift=0; shift < LOD_MAX_LEVELS; ++shift)
+                {
+                    size_t mask         = 1;
+                    while (mask < (n_src << 1))
+                        mask              <<= 1;
+                    ::memset(set, 0, mask * sizeof(uint64_t));
+                    --mask;
+
+                    size_t n_dst        = 0;
+                    for (size_t i=0; i<n_src; ++i)
+                    {
+                        uint64_t key        = cell_key(codes, src[i], epp, shift) + 1;
+                        size_t h            = size_t((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+                        while ((set[h] != 0) && (set[h] != key))
+                            h                   = (h + 1) & mask;
+                        if (set[h] != 0)
+                            continue;
+                        set[h]              = key;
+                        dst[n_dst++]        = src[i];
+                    }
+
+                    // Keep only levels that reduce the number of primitives at least twice
+                    if ((n_dst << 1) <= count)
+                    {
+                        lod_level_t *level  = &levels[n_levels];
+                        level->fCellSize    = extent / float(1 << (LOD_GRID_BITS - shift));
+                        if (!store_level(level, data, dst, n_dst, epp))
+                        {
+                            ok                  = false;
+                            break;
+                        }
+                        ++n_levels;
+                    }
+
+                    uint32_t *tmp       = src;
+                    src                 = dst;
+                    dst                 = tmp;
+                    n_src               = n_dst;
+                }
+
+                arena->release(mark);
+
+                // Store levels from the coarsest one
+                for (size_t i=0; i<n_levels; ++i)
+                    lod->vLevels[i]     = levels[n_levels - i - 1];
+                lod->nLevels        = n_levels;
+
+                return ok;
+            }
+
+            static bool pixels_per_unit(float *ppu, const lod_t *lod, const r3d::mat4_t *mvp, ssize_t width, ssize_t height)
+            {
+                // Estimate the projected size of the unit length at the center of the bounding box
+                r3d::dot4_t c, p, q;
+                matrix_apply(&c, mvp, &lod->sCenter);
+                if (c.w <= 1e-6f)
+                    return false;
+
+                float d             = lod->fExtent * 0.01f;
+                float max           = 0.0f;
+                for (size_t i=0; i<3; ++i)
+                {
+                    p               = lod->sCenter;
+                    (&p.x)[i]      += d;
+                    matrix_apply(&q, mvp, &p);
+                    if (q.w <= 1e-6f)
+                        return false;
+
+                    float dx        = (q.x / q.w - c.x / c.w) * width * 0.5f;
+                    float dy        = (q.y / q.w - c.y / c.w) * height * 0.5f;
+                    max             = lsp_max(max, dx*dx + dy*dy);
+                }
+
+                *ppu            = sqrtf(max) / d;
+                return true;
+            }
+
+            bool lod_cache_t::decimate(r3d::buffer_t *dst, const r3d::buffer_t *key, const r3d::buffer_t *data,
+                const r3d::mat4_t *mvp, ssize_t width, ssize_t height, arena_t *arena)
+            {
+                if ((nMinCount <= 0) || (key->count < nMinCount))
+                    return false;
+                if ((key->type != r3d::PRIMITIVE_POINTS) && (key->type != r3d::PRIMITIVE_LINES))
+                    return false;
+                if ((width <= 0) || (height <= 0))
+                    return false;
+
+                // Find or build the entry
+                lod_t **bin         = &vBins[lod_hash(key)];
+                lod_t *lod          = *bin;
+                for ( ; lod != NULL; lod = lod->pNext)
+                {
+                    if (lod_match(lod, key))
+                        break;
+                }
+
+                if (lod == NULL)
+                {
+                    if ((lod = static_cast<lod_t *>(malloc(sizeof(lod_t)))) == NULL)
+                        return false;
+
+                    lod->pVData         = key->vertex.data;
+                    lod->pVIndex        = key->vertex.index;
+                    lod->pNIndex        = (key->normal.data != NULL) ? key->normal.index : NULL;
+                    lod->pCIndex        = (key->color.data != NULL) ? key->color.index : NULL;
+                    lod->nVStride       = key->vertex.stride;
+                    lod->nCount         = key->count;
+                    lod->nType          = uint32_t(key->type);
+
+                    if (!build_lod(lod, data, arena))
+                    {
+                        free_lod(lod);
+                        return false;
+                    }
+
+                    lod->pNext          = *bin;
+                    *bin                = lod;
+                    ++nEntries;
+                }
+                lod->nLastFrame     = nFrame;
+
+                // Select the coarsest level with cells not larger than a pixel
+                float ppu;
+                if ((lod->nLevels <= 0) || (!pixels_per_unit(&ppu, lod, mvp, width, height)))
+                    return false;
+
+                const lod_level_t *level = NULL;
+                for (size_t i=0; i<lod->nLevels; ++i)
+                {
+                    if ((lod->vLevels[i].fCellSize * ppu) <= LOD_CELL_PIXELS)
+                    {
+                        level               = &lod->vLevels[i];
+                        break;
+                    }
+                }
+                if (level == NULL)
+                    return false;
+
+                *dst                = *data;
+                dst->count          = level->nCount;
+                dst->vertex.index   = level->vVIndex;
+                if ((level->vNIndex != NULL) && (data->normal.data != NULL))
+                    dst->normal.index   = level->vNIndex;
+                if ((level->vCIndex != NULL) && (data->color.data != NULL))
+                    dst->color.index    = level->vCIndex;
+
+                return true;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
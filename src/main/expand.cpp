@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/wgl/expand.h>
+#include <private/wgl/matrix.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t EXPAND_INITIAL_CAPACITY    = 0x400;
+            constexpr float EXPAND_MIN_W                = 1e-6f;
+
+            void expand_batch_t::construct()
+            {
+                vVertices       = NULL;
+                nVertices       = 0;
+                nCapacity       = 0;
+                vPoints         = NULL;
+                nPoints         = 0;
+                nFlags          = 0;
+            }
+
+            void expand_batch_t::destroy()
+            {
+                if (vVertices != NULL)
+                {
+                    free(vVertices);
+                    vVertices       = NULL;
+                }
+                if (vPoints != NULL)
+                {
+                    free(vPoints);
+                    vPoints         = NULL;
+                }
+                nVertices       = 0;
+                nCapacity       = 0;
+                nPoints         = 0;
+            }
+
+            template <class T>
+                static bool reserve(T * &array, size_t &capacity, size_t count)
+                {
+                    if (count <= capacity)
+                        return true;
+
+                    size_t cap      = lsp_max(capacity, EXPAND_INITIAL_CAPACITY);
+                    while (cap < count)
+                        cap           <<= 1;
+                    T *ptr          = static_cast<T *>(realloc(array, cap * sizeof(T)));
+                    if (ptr == NULL)
+                        return false;
+
+                    array           = ptr;
+                    capacity        = cap;
+                    return true;
+                }
+
+            static inline void fetch_color(r3d::color_t *c, const r3d::buffer_t *buffer, size_t i)
+            {
+                if (buffer->color.data == NULL)
+                {
+                    *c              = buffer->color.dfl;
+                    return;
+                }
+
+                // Without own index the color array is read per element if the normal array
+                // has own index too, otherwise it is indexed by the vertex index
+                bool separate   = (buffer->normal.index != NULL) || (buffer->color.index != NULL);
+                size_t ci       = (buffer->color.index != NULL) ? buffer->color.index[i] :
+                                  ((separate) || (buffer->vertex.index == NULL)) ? i : buffer->vertex.index[i];
+                size_t stride   = (buffer->color.stride == 0) ? sizeof(r3d::color_t) : buffer->color.stride;
+                *c              = *reinterpret_cast<const r3d::color_t *>(
+                    reinterpret_cast<const uint8_t *>(buffer->color.data) + ci * stride);
+            }
+
+            static inline void lerp(r3d::dot4_t *a, const r3d::dot4_t *b, float t)
+            {
+                a->x           += (b->x - a->x) * t;
+                a->y           += (b->y - a->y) * t;
+                a->z           += (b->z - a->z) * t;
+                a->w           += (b->w - a->w) * t;
+            }
+
+            static inline void lerp(r3d::color_t *a, const r3d::color_t *b, float t)
+            {
+                a->r           += (b->r - a->r) * t;
+                a->g           += (b->g - a->g) * t;
+                a->b           += (b->b - a->b) * t;
+                a->a           += (b->a - a->a) * t;
+            }
+
+            static inline expand_vertex_t *emit(expand_vertex_t *dst, const r3d::dot4_t *p, float dx, float dy, const r3d::color_t *c)
+            {
+                dst->v.x        = p->x + dx * p->w;
+                dst->v.y        = p->y + dy * p->w;
+                dst->v.z        = p->z;
+                dst->v.w        = p->w;
+                dst->c          = *c;
+                return dst + 1;
+            }
+
+            static expand_vertex_t *expand_segment(
+                expand_vertex_t *dst,
+                r3d::dot4_t a, r3d::color_t ca, r3d::dot4_t b, r3d::color_t cb,
+                float width, float height, float size)
+            {
+                // Clip the segment by the near plane: z + w >= 0
+                float da        = a.z + a.w;
+                float db        = b.z + b.w;
+                if ((da < 0.0f) && (db < 0.0f))
+                    return dst;
+                if (da < 0.0f)
+                {
+                    float t         = da / (da - db);
+                    lerp(&a, &b, t);
+                    lerp(&ca, &cb, t);
+                }
+                else if (db < 0.0f)
+                {
+                    float t         = db / (db - da);
+                    lerp(&b, &a, t);
+                    lerp(&cb, &ca, t);
+                }
+                if ((a.w < EXPAND_MIN_W) || (b.w < EXPAND_MIN_W))
+                    return dst;
+
+                // Compute the direction of the segment in pixels and the normal offset in NDC
+                float dx        = (b.x / b.w - a.x / a.w) * width * 0.5f;
+                float dy        = (b.y / b.w - a.y / a.w) * height * 0.5f;
+                float len       = sqrtf(dx*dx + dy*dy);
+                float nx        = 0.0f, ny = 1.0f;
+                if (len > EXPAND_MIN_W)
+                {
+                    nx              = -dy / len;
+                    ny              = dx / len;
+                }
+                nx             *= size / width;
+                ny             *= size / height;
+
+                dst             = emit(dst, &a, -nx, -ny, &ca);
+                dst             = emit(dst, &a,  nx,  ny, &ca);
+                dst             = emit(dst, &b,  nx,  ny, &cb);
+                dst             = emit(dst, &a, -nx, -ny, &ca);
+                dst             = emit(dst, &b,  nx,  ny, &cb);
+                dst             = emit(dst, &b, -nx, -ny, &cb);
+
+                return dst;
+            }
+
+            static expand_vertex_t *expand_point(
+                expand_vertex_t *dst, const r3d::dot4_t *p, const r3d::color_t *c,
+                float width, float height, float size)
+            {
+                if (((p->z + p->w) < 0.0f) || (p->w < EXPAND_MIN_W))
+                    return dst;
+
+                float hx        = size / width;
+                float hy        = size / height;
+
+                dst             = emit(dst, p, -hx, -hy, c);
+                dst             = emit(dst, p,  hx, -hy, c);
+                dst             = emit(dst, p,  hx,  hy, c);
+                dst             = emit(dst, p, -hx, -hy, c);
+                dst             = emit(dst, p,  hx,  hy, c);
+                dst             = emit(dst, p, -hx,  hy, c);
+
+                return dst;
+            }
+
+            status_t expand_batch_t::add(const r3d::buffer_t *buffer, const r3d::mat4_t *mvp, ssize_t width, ssize_t height)
+            {
+                size_t count, quads;
+                switch (buffer->type)
+                {
+                    case r3d::PRIMITIVE_LINES:
+                        count           = buffer->count * 2;
+                        quads           = buffer->count;
+                        break;
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        count           = buffer->count * 3;
+                        quads           = count;
+                        break;
+                    case r3d::PRIMITIVE_POINTS:
+                        count           = buffer->count;
+                        quads           = count;
+                        break;
+                    default:
+                        return STATUS_BAD_ARGUMENTS;
+                }
+                if ((count <= 0) || (width <= 0) || (height <= 0))
+                    return STATUS_OK;
+
+                if (!reserve(vPoints, nPoints, count))
+                    return STATUS_NO_MEM;
+                if (!reserve(vVertices, nCapacity, nVertices + quads * 6))
+                    return STATUS_NO_MEM;
+
+                // Fetch and transform all points into clip coordinates
+                const uint8_t *vdata    = reinterpret_cast<const uint8_t *>(buffer->vertex.data);
+                const uint32_t *vindex  = buffer->vertex.index;
+                size_t vstride          = (buffer->vertex.stride == 0) ? sizeof(r3d::dot4_t) : buffer->vertex.stride;
+                for (size_t i=0; i<count; ++i)
+                {
+                    size_t vi               = (vindex != NULL) ? vindex[i] : i;
+                    vPoints[i]              = *reinterpret_cast<const r3d::dot4_t *>(vdata + vi * vstride);
+                }
+                matrix_apply_array(vPoints, mvp, count);
+
+                // Expand primitives, the half-size in pixels maps to size/width in NDC
+                float fw                = width;
+                float fh                = height;
+                float size              = lsp_max(buffer->width, 1.0f);
+                expand_vertex_t *dst    = &vVertices[nVertices];
+                r3d::color_t c[3];
+
+                switch (buffer->type)
+                {
+                    case r3d::PRIMITIVE_LINES:
+                        for (size_t i=0; i<count; i += 2)
+                        {
+                            fetch_color(&c[0], buffer, i);
+                            fetch_color(&c[1], buffer, i + 1);
+                            dst         = expand_segment(dst, vPoints[i], c[0], vPoints[i+1], c[1], fw, fh, size);
+                        }
+                        break;
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        for (size_t i=0; i<count; i += 3)
+                        {
+                            fetch_color(&c[0], buffer, i);
+                            fetch_color(&c[1], buffer, i + 1);
+                            fetch_color(&c[2], buffer, i + 2);
+                            dst         = expand_segment(dst, vPoints[i], c[0], vPoints[i+1], c[1], fw, fh, size);
+                            dst         = expand_segment(dst, vPoints[i+1], c[1], vPoints[i+2], c[2], fw, fh, size);
+                            dst         = expand_segment(dst, vPoints[i+2], c[2], vPoints[i], c[0], fw, fh, size);
+                        }
+                        break;
+                    default:
+                        for (size_t i=0; i<count; ++i)
+                        {
+                            fetch_color(&c[0], buffer, i);
+                            dst         = expand_point(dst, &vPoints[i], &c[0], fw, fh, size);
+                        }
+                        break;
+                }
+
+                nVertices               = dst - vVertices;
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+
+#ifdef PLATFORM_WINDOWS
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/ext.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            template <class T>
+                static inline bool load_proc(T &proc, const char *name)
+                {
+                    PROC ptr    = ::wglGetProcAddress(name);
+
+                    // Some drivers return small integers instead of NULL for missing functions
+                    if ((uintptr_t(ptr) <= 3) || (uintptr_t(ptr) == uintptr_t(-1)))
+                        ptr         = NULL;
+                    proc        = reinterpret_cast<T>(reinterpret_cast<void *>(ptr));
+
+                    return proc != NULL;
+                }
+
+            /**
+             * Check the extension presence in the space-separated list of extensions
+             */
+            static bool has_extension(const char *list, const char *name)
+            {
+                if (list == NULL)
+                    return false;
+
+                size_t len  = strlen(name);
+                for (const char *p = list; (p = strstr(p, name)) != NULL; p += len)
+                {
+                    if (((p == list) || (p[-1] == ' ')) &&
+                        ((p[len] == ' ') || (p[len] == '\0')))
+                        return true;
+                }
+                return false;
+            }
+
+            static int gl_version()
+            {
+                const char *ver = reinterpret_cast<const char *>(::glGetString(GL_VERSION));
+                if ((ver == NULL) || (ver[0] < '0') || (ver[0] > '9'))
+                    return 0;
+
+                int major = 0, minor = 0;
+                for ( ; (*ver >= '0') && (*ver <= '9'); ++ver)
+                    major   = major * 10 + (*ver - '0');
+                if (*ver == '.')
+                {
+                    for (++ver; (*ver >= '0') && (*ver <= '9'); ++ver)
+                        minor   = minor * 10 + (*ver - '0');
+                }
+
+                return major * 100 + minor;
+            }
+
+            void gl_ext_t::construct()
+            {
+                bLoaded             = false;
+                bVBO                = false;
+                bOcclusion          = false;
+                bPBO                = false;
+                bShaders            = false;
+
+                glGenBuffers        = NULL;
+                glDeleteBuffers     = NULL;
+                glBindBuffer        = NULL;
+                glBufferData        = NULL;
+                glBufferSubData     = NULL;
+
+                glMapBuffer         = NULL;
+                glUnmapBuffer       = NULL;
+
+                glGenQueries        = NULL;
+                glDeleteQueries     = NULL;
+                glBeginQuery        = NULL;
+                glEndQuery          = NULL;
+                glGetQueryObjectuiv = NULL;
+
+                glCreateShader      = NULL;
+                glDeleteShader      = NULL;
+                glShaderSource      = NULL;
+                glCompileShader     = NULL;
+                glGetShaderiv       = NULL;
+                glCreateProgram     = NULL;
+                glDeleteProgram     = NULL;
+                glAttachShader      = NULL;
+                glLinkProgram       = NULL;
+                glGetProgramiv      = NULL;
+                glUseProgram        = NULL;
+                glGetUniformLocation = NULL;
+                glUniform1i         = NULL;
+                glUniform2f         = NULL;
+            }
+
+            void gl_ext_t::init()
+            {
+                if (bLoaded)
+                    return;
+                bLoaded             = true;
+
+                const char *list    = reinterpret_cast<const char *>(::glGetString(GL_EXTENSIONS));
+                int version         = gl_version();
+
+                // Vertex buffer objects
+                if (version >= 105)
+                {
+                    bVBO                =
+                        load_proc(glGenBuffers, "glGenBuffers") &&
+                        load_proc(glDeleteBuffers, "glDeleteBuffers") &&
+                        load_proc(glBindBuffer, "glBindBuffer") &&
+                        load_proc(glBufferData, "glBufferData") &&
+                        load_proc(glBufferSubData, "glBufferSubData");
+                }
+                if ((!bVBO) && (has_extension(list, "GL_ARB_vertex_buffer_object")))
+                {
+                    bVBO                =
+                        load_proc(glGenBuffers, "glGenBuffersARB") &&
+                        load_proc(glDeleteBuffers, "glDeleteBuffersARB") &&
+                        load_proc(glBindBuffer, "glBindBufferARB") &&
+                        load_proc(glBufferData, "glBufferDataARB") &&
+                        load_proc(glBufferSubData, "glBufferSubDataARB");
+                }
+
+                // Pixel buffer objects
+                if ((bVBO) && ((version >= 201) ||
+                    (has_extension(list, "GL_ARB_pixel_buffer_object")) ||
+                    (has_extension(list, "GL_EXT_pixel_buffer_object"))))
+                {
+                    bPBO                =
+                        load_proc(glMapBuffer, "glMapBuffer") &&
+                        load_proc(glUnmapBuffer, "glUnmapBuffer");
+                    if (!bPBO)
+                    {
+                        bPBO                =
+                            load_proc(glMapBuffer, "glMapBufferARB") &&
+                            load_proc(glUnmapBuffer, "glUnmapBufferARB");
+                    }
+                }
+
+                // Occlusion queries
+                if (version >= 105)
+                {
+                    bOcclusion          =
+                        load_proc(glGenQueries, "glGenQueries") &&
+                        load_proc(glDeleteQueries, "glDeleteQueries") &&
+                        load_proc(glBeginQuery, "glBeginQuery") &&
+                        load_proc(glEndQuery, "glEndQuery") &&
+                        load_proc(glGetQueryObjectuiv, "glGetQueryObjectuiv");
+                }
+                if ((!bOcclusion) && (has_extension(list, "GL_ARB_occlusion_query")))
+                {
+                    bOcclusion          =
+                        load_proc(glGenQueries, "glGenQueriesARB") &&
+                        load_proc(glDeleteQueries, "glDeleteQueriesARB") &&
+                        load_proc(glBeginQuery, "glBeginQueryARB") &&
+                        load_proc(glEndQuery, "glEndQueryARB") &&
+                        load_proc(glGetQueryObjectuiv, "glGetQueryObjectuivARB");
+                }
+
+                // Shader programs, only the core interface is used
+                if (version >= 200)
+                {
+                    bShaders            =
+                        load_proc(glCreateShader, "glCreateShader") &&
+                        load_proc(glDeleteShader, "glDeleteShader") &&
+                        load_proc(glShaderSource, "glShaderSource") &&
+                        load_proc(glCompileShader, "glCompileShader") &&
+                        load_proc(glGetShaderiv, "glGetShaderiv") &&
+                        load_proc(glCreateProgram, "glCreateProgram") &&
+                        load_proc(glDeleteProgram, "glDeleteProgram") &&
+                        load_proc(glAttachShader, "glAttachShader") &&
+                        load_proc(glLinkProgram, "glLinkProgram") &&
+                        load_proc(glGetProgramiv, "glGetProgramiv") &&
+                        load_proc(glUseProgram, "glUseProgram") &&
+                        load_proc(glGetUniformLocation, "glGetUniformLocation") &&
+                        load_proc(glUniform1i, "glUniform1i") &&
+                        load_proc(glUniform2f, "glUniform2f");
+                }
+
+                lsp_trace("OpenGL version=%d.%d, VBO=%s, PBO=%s, occlusion queries=%s, shaders=%s",
+                    version / 100, version % 100, (bVBO) ? "yes" : "no", (bPBO) ? "yes" : "no", (bOcclusion) ? "yes" : "no",
+                    (bShaders) ? "yes" : "no");
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PLATFORM_WINDOWS */
@@ -20,23 +20,43 @@
  */
 
 #include <lsp-plug.in/common/types.h>
-#include <lsp-plug.in/r3d/wgl/backend.h>
 #include <lsp-plug.in/r3d/wgl/factory.h>
+#include <lsp-plug.in/r3d/wgl/sw_backend.h>
 #include <stdlib.h>
 
+#ifdef PLATFORM_WINDOWS
+    #include <lsp-plug.in/r3d/wgl/backend.h>
+#endif /* PLATFORM_WINDOWS */
+
 namespace lsp
 {
     namespace r3d
     {
         namespace wgl
         {
+        #ifdef PLATFORM_WINDOWS
+            constexpr size_t BACKEND_WGL        = 0;
+            constexpr size_t BACKEND_SW         = 1;
+        #else
+            // Only the software rasterizer is available on other platforms
+            constexpr size_t BACKEND_SW         = 0;
+        #endif /* PLATFORM_WINDOWS */
+
             const r3d::backend_metadata_t factory_t::sMetadata[] =
             {
+            #ifdef PLATFORM_WINDOWS
                 {
                     "wgl_2x",
                     "openGL 2.0+ (Windows)",
                     "wgl_opengl_v2",
                     WND_HANDLE_WINDOWS
+                },
+            #endif /* PLATFORM_WINDOWS */
+                {
+                    "wgl_sw",
+                    "Software rasterizer",
+                    "software",
+                    WND_HANDLE_NONE
                 }
             };
 
@@ -48,13 +68,22 @@ namespace lsp
 
             r3d::backend_t *factory_t::create(r3d::factory_t *handle, size_t id)
             {
-                if (id == 0)
+            #ifdef PLATFORM_WINDOWS
+                if (id == BACKEND_WGL)
                 {
                     wgl::backend_t *res = static_cast<wgl::backend_t *>(::malloc(sizeof(wgl::backend_t)));
                     if (res != NULL)
                         res->construct();
                     return res;
                 }
+            #endif /* PLATFORM_WINDOWS */
+                if (id == BACKEND_SW)
+                {
+                    wgl::sw_backend_t *res = static_cast<wgl::sw_backend_t *>(::malloc(sizeof(wgl::sw_backend_t)));
+                    if (res != NULL)
+                        res->construct();
+                    return res;
+                }
                 return NULL;
             }
 
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/frame.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t FRAME_INITIAL_CAPACITY = 0x4000;
+
+            static inline size_t frame_align(size_t size)
+            {
+                return (size + FRAME_ALIGN - 1) & ~(FRAME_ALIGN - 1);
+            }
+
+            static inline uint64_t hash_value(uint64_t h, uint64_t v)
+            {
+                return (h ^ v) * 0x100000001b3ULL;
+            }
+
+            static inline uint64_t hash_ptr(uint64_t h, const void *ptr)
+            {
+                return hash_value(h, uint64_t(reinterpret_cast<uintptr_t>(ptr)));
+            }
+
+            static uint64_t hash_floats(uint64_t h, const float *v, size_t count)
+            {
+                // Hash bit patterns of values, the structures of floats have no padding
+                for (size_t i=0; i<count; ++i)
+                {
+                    uint32_t w;
+                    memcpy(&w, &v[i], sizeof(w));
+                    h                   = hash_value(h, w);
+                }
+                return h;
+            }
+
+            void frame_t::construct()
+            {
+                vData       = NULL;
+                nSize       = 0;
+                nCapacity   = 0;
+                nHash       = 0;
+            }
+
+            void frame_t::destroy()
+            {
+                if (vData != NULL)
+                {
+                    free(vData);
+                    vData       = NULL;
+                }
+                nSize       = 0;
+                nCapacity   = 0;
+            }
+
+            void frame_t::clear(const r3d::color_t *bg, ssize_t width, ssize_t height, uint32_t version)
+            {
+                nSize       = 0;
+
+                uint64_t h  = 0xcbf29ce484222325ULL;
+                h           = hash_floats(h, &bg->r, sizeof(r3d::color_t) / sizeof(float));
+                h           = hash_value(h, uint64_t(width));
+                h           = hash_value(h, uint64_t(height));
+                h           = hash_value(h, version);
+                nHash       = h;
+            }
+
+            void frame_t::add_hash(const void *data, size_t size)
+            {
+                const uint8_t *p    = static_cast<const uint8_t *>(data);
+                uint64_t h          = nHash;
+                for ( ; size >= sizeof(uint32_t); size -= sizeof(uint32_t), p += sizeof(uint32_t))
+                {
+                    uint32_t w;
+                    memcpy(&w, p, sizeof(w));
+                    h                   = hash_value(h, w);
+                }
+                if (size > 0)
+                {
+                    // Fold the tail bytes into the last word
+                    uint32_t w          = 0;
+                    memcpy(&w, p, size);
+                    h                   = hash_value(h, w);
+                }
+                nHash               = h;
+            }
+
+            static frame_record_t *append(frame_t *f, uint32_t type, size_t size)
+            {
+                size            = frame_align(size);
+                if ((f->nSize + size) > f->nCapacity)
+                {
+                    size_t cap      = lsp_max(f->nCapacity, FRAME_INITIAL_CAPACITY);
+                    while (cap < (f->nSize + size))
+                        cap           <<= 1;
+                    uint8_t *ptr    = static_cast<uint8_t *>(realloc(f->vData, cap));
+                    if (ptr == NULL)
+                        return NULL;
+                    f->vData        = ptr;
+                    f->nCapacity    = cap;
+                }
+
+                frame_record_t *rec = reinterpret_cast<frame_record_t *>(&f->vData[f->nSize]);
+                rec->type       = type;
+                rec->size       = uint32_t(size);
+                f->nSize       += size;
+
+                return rec;
+            }
+
+            status_t frame_t::add_lights(const r3d::light_t *lights, size_t count)
+            {
+                size_t hdr_size     = frame_align(sizeof(frame_lights_t));
+                frame_lights_t *rec = reinterpret_cast<frame_lights_t *>(
+                    append(this, FRAME_LIGHTS, hdr_size + count * sizeof(r3d::light_t)));
+                if (rec == NULL)
+                    return STATUS_NO_MEM;
+
+                rec->count          = count;
+                if (count > 0)
+                    ::memcpy(reinterpret_cast<uint8_t *>(rec) + hdr_size, lights, count * sizeof(r3d::light_t));
+
+                uint64_t h          = hash_value(nHash, FRAME_LIGHTS);
+                h                   = hash_value(h, count);
+                for (size_t i=0; i<count; ++i)
+                {
+                    const r3d::light_t *l = &lights[i];
+                    h                   = hash_value(h, l->type);
+                    h                   = hash_floats(h, &l->position.x, 4);
+                    h                   = hash_floats(h, &l->direction.dx, 4);
+                    h                   = hash_floats(h, &l->ambient.r, 4);
+                    h                   = hash_floats(h, &l->diffuse.r, 4);
+                    h                   = hash_floats(h, &l->specular.r, 4);
+                    h                   = hash_floats(h, &l->constant, 1);
+                    h                   = hash_floats(h, &l->linear, 1);
+                    h                   = hash_floats(h, &l->quadratic, 1);
+                    h                   = hash_floats(h, &l->cutoff, 1);
+                }
+                nHash               = h;
+
+                return STATUS_OK;
+            }
+
+            status_t frame_t::add_draw(const r3d::buffer_t *buffer, const r3d::mat4_t *projection,
+                const r3d::mat4_t *view_world, const r3d::mat4_t *world, const ring_t *ring,
+                uint32_t object_id)
+            {
+                frame_draw_t *rec   = reinterpret_cast<frame_draw_t *>(
+                    append(this, FRAME_DRAW, sizeof(frame_draw_t)));
+                if (rec == NULL)
+                    return STATUS_NO_MEM;
+
+                rec->projection     = *projection;
+                rec->view_world     = *view_world;
+                rec->world          = *world;
+                rec->buffer         = *buffer;
+                rec->ring.first     = 0;
+                if (ring != NULL)
+                    rec->ring           = *ring;
+
+                // Buffer data is identified by pointers, the contents are covered by the data version
+                uint64_t h          = hash_value(nHash, FRAME_DRAW);
+                h                   = hash_floats(h, projection->m, 16);
+                h                   = hash_floats(h, view_world->m, 16);
+                h                   = hash_floats(h, world->m, 16);
+                h                   = hash_floats(h, buffer->model.m, 16);
+                h                   = hash_value(h, buffer->type);
+                h                   = hash_value(h, buffer->flags);
+                h                   = hash_value(h, object_id);
+                h                   = hash_floats(h, &buffer->width, 1);
+                h                   = hash_value(h, buffer->count);
+                h                   = hash_ptr(h, buffer->vertex.data);
+                h                   = hash_value(h, buffer->vertex.stride);
+                h                   = hash_ptr(h, buffer->vertex.index);
+                h                   = hash_ptr(h, buffer->normal.data);
+                h                   = hash_value(h, buffer->normal.stride);
+                h                   = hash_ptr(h, buffer->normal.index);
+                h                   = hash_ptr(h, buffer->color.data);
+                h                   = hash_value(h, buffer->color.stride);
+                h                   = hash_ptr(h, buffer->color.index);
+                h                   = hash_floats(h, &buffer->color.dfl.r, 4);
+                h                   = hash_value(h, rec->ring.first);
+                if (rec->ring.first > 0)
+                    h                   = hash_floats(h, rec->ring.wrap.m, 16);
+                nHash               = h;
+
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
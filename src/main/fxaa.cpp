@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/fxaa.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr uint32_t fxaa_shift(float k)
+            {
+                return (k < 1.0f) ? fxaa_shift(k * 2.0f) + 1 : 0;
+            }
+
+            constexpr uint32_t fxaa_ceil(float k)
+            {
+                return (float(uint32_t(k)) < k) ? uint32_t(k) + 1 : uint32_t(k);
+            }
+
+            // Integer luma differences are below the FXAA_EDGE_MIN * 255 only if they are below the ceiling of it
+            constexpr uint32_t FXAA_EDGE_MIN_U8     = fxaa_ceil(FXAA_EDGE_MIN * 255.0f);    // FXAA_EDGE_MIN in 8-bit luma units
+            constexpr uint32_t FXAA_EDGE_SHIFT      = fxaa_shift(FXAA_EDGE_THRESHOLD);      // FXAA_EDGE_THRESHOLD as the shift of 8-bit luma
+
+            static_assert(FXAA_EDGE_THRESHOLD * float(1 << FXAA_EDGE_SHIFT) == 1.0f,
+                "FXAA_EDGE_THRESHOLD should be the power of two for the integer edge test");
+
+            typedef struct fxaa_image_t
+            {
+                uint8_t            *dst;
+                size_t              dst_stride;
+                const uint8_t      *src;
+                size_t              src_stride;
+                const uint8_t      *luma;
+                ssize_t             width;
+                ssize_t             height;
+                size_t              bpp;
+            } fxaa_image_t;
+
+            static const char *fxaa_source =
+                "uniform sampler2D frame;\n"
+                "uniform vec2 texel;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    const vec3 w = vec3(0.25, 0.5, 0.25);\n"
+                "    vec2 uv = gl_TexCoord[0].xy;\n"
+                "    vec4 c = texture2D(frame, uv);\n"
+                "    float lnw = dot(texture2D(frame, uv + vec2(-1.0, -1.0) * texel).rgb, w);\n"
+                "    float lne = dot(texture2D(frame, uv + vec2( 1.0, -1.0) * texel).rgb, w);\n"
+                "    float lsw = dot(texture2D(frame, uv + vec2(-1.0,  1.0) * texel).rgb, w);\n"
+                "    float lse = dot(texture2D(frame, uv + vec2( 1.0,  1.0) * texel).rgb, w);\n"
+                "    float lm = dot(c.rgb, w);\n"
+                "    float lmin = min(lm, min(min(lnw, lne), min(lsw, lse)));\n"
+                "    float lmax = max(lm, max(max(lnw, lne), max(lsw, lse)));\n"
+                "    if (lmax - lmin < max(1.0 / 16.0, lmax * (1.0 / 8.0)))\n"
+                "    {\n"
+                "        gl_FragColor = c;\n"
+                "        return;\n"
+                "    }\n"
+                "\n"
+                "    vec2 dir = vec2(-((lnw + lne) - (lsw + lse)), (lnw + lsw) - (lne + lse));\n"
+                "    float reduce = max((lnw + lne + lsw + lse) * (0.25 * (1.0 / 8.0)), 1.0 / 128.0);\n"
+                "    float rcp = 1.0 / (min(abs(dir.x), abs(dir.y)) + reduce);\n"
+                "    dir = clamp(dir * rcp, -8.0, 8.0) * texel;\n"
+                "\n"
+                "    vec3 a = 0.5 * (\n"
+                "        texture2D(frame, uv + dir * (1.0 / 3.0 - 0.5)).rgb +\n"
+                "        texture2D(frame, uv + dir * (2.0 / 3.0 - 0.5)).rgb);\n"
+                "    vec3 b = a * 0.5 + 0.25 * (\n"
+                "        texture2D(frame, uv - dir * 0.5).rgb +\n"
+                "        texture2D(frame, uv + dir * 0.5).rgb);\n"
+                "    float lb = dot(b, w);\n"
+                "    gl_FragColor = vec4(((lb < lmin) || (lb > lmax)) ? a : b, c.a);\n"
+                "}\n";
+
+            const char *fxaa_shader()
+            {
+                return fxaa_source;
+            }
+
+            static inline uint8_t pixel_luma(const uint8_t *p)
+            {
+                return uint8_t((uint32_t(p[0]) + (uint32_t(p[1]) << 1) + uint32_t(p[2])) >> 2);
+            }
+
+            static void compute_luma(uint8_t *luma, const uint8_t *src, size_t count, size_t bpp)
+            {
+                size_t i = 0;
+            #ifdef __SSE2__
+                if (bpp == 4)
+                {
+                    const __m128i mask  = _mm_set1_epi32(0xff);
+                    for ( ; i + 16 <= count; i += 16)
+                    {
+                        __m128i l[4];
+                        for (size_t j=0; j<4; ++j)
+                        {
+                            __m128i x       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[(i + j * 4) * 4]));
+                            __m128i r       = _mm_and_si128(x, mask);
+                            __m128i g       = _mm_and_si128(_mm_srli_epi32(x, 8), mask);
+                            __m128i b       = _mm_and_si128(_mm_srli_epi32(x, 16), mask);
+                            l[j]            = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(r, b), _mm_add_epi32(g, g)), 2);
+                        }
+                        __m128i lo      = _mm_packs_epi32(l[0], l[1]);
+                        __m128i hi      = _mm_packs_epi32(l[2], l[3]);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(&luma[i]), _mm_packus_epi16(lo, hi));
+                    }
+                }
+            #endif /* __SSE2__ */
+                for ( ; i < count; ++i)
+                    luma[i]         = pixel_luma(&src[i * bpp]);
+            }
+
+            static inline uint32_t luma_at(const fxaa_image_t *img, ssize_t x, ssize_t y)
+            {
+                x       = lsp_limit(x, ssize_t(0), img->width - 1);
+                y       = lsp_limit(y, ssize_t(0), img->height - 1);
+                return img->luma[y * img->width + x];
+            }
+
+            /**
+             * Sample RGB components of the source image with bilinear filtering,
+             * coordinates are in pixels with centers of pixels at half-integers
+             */
+            static void sample(float *rgb, const fxaa_image_t *img, float x, float y)
+            {
+                x          -= 0.5f;
+                y          -= 0.5f;
+                float fx    = floorf(x);
+                float fy    = floorf(y);
+                float kx    = x - fx;
+                float ky    = y - fy;
+                ssize_t x0  = lsp_limit(ssize_t(fx), ssize_t(0), img->width - 1);
+                ssize_t y0  = lsp_limit(ssize_t(fy), ssize_t(0), img->height - 1);
+                ssize_t x1  = lsp_min(x0 + 1, img->width - 1);
+                ssize_t y1  = lsp_min(y0 + 1, img->height - 1);
+                if (fx < 0.0f)
+                    x1          = x0;
+                if (fy < 0.0f)
+                    y1          = y0;
+
+                const uint8_t *r0   = &img->src[y0 * img->src_stride];
+                const uint8_t *r1   = &img->src[y1 * img->src_stride];
+                const uint8_t *p00  = &r0[x0 * img->bpp];
+                const uint8_t *p01  = &r0[x1 * img->bpp];
+                const uint8_t *p10  = &r1[x0 * img->bpp];
+                const uint8_t *p11  = &r1[x1 * img->bpp];
+
+                for (size_t i=0; i<3; ++i)
+                {
+                    float top       = p00[i] + (float(p01[i]) - float(p00[i])) * kx;
+                    float bottom    = p10[i] + (float(p11[i]) - float(p10[i])) * kx;
+                    rgb[i]          = top + (bottom - top) * ky;
+                }
+            }
+
+            static void filter_pixel(const fxaa_image_t *img, ssize_t x, ssize_t y)
+            {
+                uint8_t *dst        = &img->dst[y * img->dst_stride + x * img->bpp];
+                const uint8_t *src  = &img->src[y * img->src_stride + x * img->bpp];
+
+                uint32_t nw         = luma_at(img, x - 1, y - 1);
+                uint32_t ne         = luma_at(img, x + 1, y - 1);
+                uint32_t sw         = luma_at(img, x - 1, y + 1);
+                uint32_t se         = luma_at(img, x + 1, y + 1);
+                uint32_t m          = img->luma[y * img->width + x];
+                uint32_t lmin       = lsp_min(m, lsp_min(lsp_min(nw, ne), lsp_min(sw, se)));
+                uint32_t lmax       = lsp_max(m, lsp_max(lsp_max(nw, ne), lsp_max(sw, se)));
+
+                // Pixels with low local contrast are not on the edge
+                if (lmax - lmin < lsp_max(FXAA_EDGE_MIN_U8, lmax >> FXAA_EDGE_SHIFT))
+                {
+                    ::memcpy(dst, src, img->bpp);
+                    return;
+                }
+
+                // Estimate the direction along the edge
+                const float k       = 1.0f / 255.0f;
+                float lnw = nw * k, lne = ne * k, lsw = sw * k, lse = se * k;
+                float dx            = -((lnw + lne) - (lsw + lse));
+                float dy            = (lnw + lsw) - (lne + lse);
+                float reduce        = lsp_max((lnw + lne + lsw + lse) * (0.25f * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+                float rcp           = 1.0f / (lsp_min(fabsf(dx), fabsf(dy)) + reduce);
+                dx                  = lsp_limit(dx * rcp, -FXAA_SPAN_MAX, FXAA_SPAN_MAX);
+                dy                  = lsp_limit(dy * rcp, -FXAA_SPAN_MAX, FXAA_SPAN_MAX);
+
+                // Blend samples along the edge
+                float cx            = x + 0.5f;
+                float cy            = y + 0.5f;
+                float s0[3], s1[3], a[3], b[3];
+                sample(s0, img, cx + dx * (1.0f / 3.0f - 0.5f), cy + dy * (1.0f / 3.0f - 0.5f));
+                sample(s1, img, cx + dx * (2.0f / 3.0f - 0.5f), cy + dy * (2.0f / 3.0f - 0.5f));
+                for (size_t i=0; i<3; ++i)
+                    a[i]                = 0.5f * (s0[i] + s1[i]);
+                sample(s0, img, cx - dx * 0.5f, cy - dy * 0.5f);
+                sample(s1, img, cx + dx * 0.5f, cy + dy * 0.5f);
+                for (size_t i=0; i<3; ++i)
+                    b[i]                = a[i] * 0.5f + 0.25f * (s0[i] + s1[i]);
+
+                // Wide blend is rejected if it leaves the local luma range
+                float lb            = (b[0] + 2.0f * b[1] + b[2]) * 0.25f;
+                const float *c      = ((lb < lmin) || (lb > lmax)) ? a : b;
+                for (size_t i=0; i<3; ++i)
+                    dst[i]              = uint8_t(c[i] + 0.5f);
+                if (img->bpp > 3)
+                    dst[3]              = src[3];
+            }
+
+            static void filter_row(const fxaa_image_t *img, ssize_t y)
+            {
+                ssize_t x       = 0;
+                ssize_t width   = img->width;
+
+            #ifdef __SSE2__
+                // Test 16 inner pixels of the row at once, most of pixels are not on edges
+                if ((y > 0) && (y < img->height - 1))
+                {
+                    const uint8_t *up       = &img->luma[(y - 1) * width];
+                    const uint8_t *row      = &img->luma[y * width];
+                    const uint8_t *dn       = &img->luma[(y + 1) * width];
+                    const __m128i emin      = _mm_set1_epi8(char(FXAA_EDGE_MIN_U8));
+                    const __m128i mshift    = _mm_set1_epi8(char(0xff >> FXAA_EDGE_SHIFT));
+                    const __m128i zero      = _mm_setzero_si128();
+
+                    filter_pixel(img, 0, y);
+                    for (x = 1; x + 17 <= width; x += 16)
+                    {
+                        __m128i nw      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&up[x - 1]));
+                        __m128i ne      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&up[x + 1]));
+                        __m128i sw      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&dn[x - 1]));
+                        __m128i se      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&dn[x + 1]));
+                        __m128i m       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&row[x]));
+                        __m128i lmin    = _mm_min_epu8(m, _mm_min_epu8(_mm_min_epu8(nw, ne), _mm_min_epu8(sw, se)));
+                        __m128i lmax    = _mm_max_epu8(m, _mm_max_epu8(_mm_max_epu8(nw, ne), _mm_max_epu8(sw, se)));
+                        __m128i range   = _mm_subs_epu8(lmax, lmin);
+                        __m128i t       = _mm_max_epu8(emin, _mm_and_si128(_mm_srli_epi16(lmax, FXAA_EDGE_SHIFT), mshift));
+                        int edges       = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(t, range), zero));
+
+                        uint8_t *dst        = &img->dst[y * img->dst_stride + x * img->bpp];
+                        const uint8_t *src  = &img->src[y * img->src_stride + x * img->bpp];
+                        if (edges == 0)
+                        {
+                            ::memcpy(dst, src, 16 * img->bpp);
+                            continue;
+                        }
+
+                        for (size_t i=0; i<16; ++i, edges >>= 1)
+                        {
+                            if (edges & 1)
+                                filter_pixel(img, x + i, y);
+                            else
+                                ::memcpy(&dst[i * img->bpp], &src[i * img->bpp], img->bpp);
+                        }
+                    }
+                }
+            #endif /* __SSE2__ */
+
+                for ( ; x < width; ++x)
+                    filter_pixel(img, x, y);
+            }
+
+            status_t fxaa(
+                uint8_t *dst, size_t dst_stride,
+                const uint8_t *src, size_t src_stride,
+                size_t width, size_t height, size_t bpp,
+                arena_t *arena)
+            {
+                if ((bpp != 3) && (bpp != 4))
+                    return STATUS_BAD_ARGUMENTS;
+                if ((width == 0) || (height == 0))
+                    return STATUS_OK;
+
+                arena_mark_t mark   = arena->mark();
+                uint8_t *luma       = arena->alloc<uint8_t>(width * height);
+                if (luma == NULL)
+                    return STATUS_NO_MEM;
+
+                for (size_t y=0; y<height; ++y)
+                    compute_luma(&luma[y * width], &src[y * src_stride], width, bpp);
+
+                fxaa_image_t img;
+                img.dst         = dst;
+                img.dst_stride  = dst_stride;
+                img.src         = src;
+                img.src_stride  = src_stride;
+                img.luma        = luma;
+                img.width       = width;
+                img.height      = height;
+                img.bpp         = bpp;
+
+                for (size_t y=0; y<height; ++y)
+                    filter_row(&img, y);
+
+                arena->release(mark);
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
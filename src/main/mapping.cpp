@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <private/wgl/mapping.h>
+
+#include <stdlib.h>
+
+#ifndef PLATFORM_WINDOWS
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            void unmap_file(mapping_t *m)
+            {
+            #ifdef PLATFORM_WINDOWS
+                if (m->pData != NULL)
+                    ::UnmapViewOfFile(m->pData);
+                if (m->hMapping != NULL)
+                    ::CloseHandle(m->hMapping);
+                if (m->hFile != INVALID_HANDLE_VALUE)
+                    ::CloseHandle(m->hFile);
+            #else
+                if (m->pData != NULL)
+                    ::munmap(const_cast<uint8_t *>(m->pData), m->nSize);
+                if (m->nFD >= 0)
+                    ::close(m->nFD);
+            #endif /* PLATFORM_WINDOWS */
+            }
+
+            status_t map_file(mapping_t *m, const char *path)
+            {
+                m->pData        = NULL;
+                m->nSize        = 0;
+
+            #ifdef PLATFORM_WINDOWS
+                m->hFile        = INVALID_HANDLE_VALUE;
+                m->hMapping     = NULL;
+
+                int len         = ::MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+                if (len <= 0)
+                    return STATUS_BAD_ARGUMENTS;
+                WCHAR *wpath    = static_cast<WCHAR *>(malloc(len * sizeof(WCHAR)));
+                if (wpath == NULL)
+                    return STATUS_NO_MEM;
+                ::MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, len);
+
+                m->hFile        = ::CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+                free(wpath);
+                if (m->hFile == INVALID_HANDLE_VALUE)
+                    return STATUS_NOT_FOUND;
+
+                LARGE_INTEGER size;
+                if (!::GetFileSizeEx(m->hFile, &size))
+                {
+                    unmap_file(m);
+                    return STATUS_IO_ERROR;
+                }
+                if (size.QuadPart <= 0)
+                {
+                    unmap_file(m);
+                    return STATUS_BAD_FORMAT;
+                }
+
+                m->hMapping     = ::CreateFileMappingW(m->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (m->hMapping == NULL)
+                {
+                    unmap_file(m);
+                    return STATUS_IO_ERROR;
+                }
+                m->pData        = static_cast<const uint8_t *>(::MapViewOfFile(m->hMapping, FILE_MAP_READ, 0, 0, 0));
+                if (m->pData == NULL)
+                {
+                    unmap_file(m);
+                    return STATUS_IO_ERROR;
+                }
+                m->nSize        = size_t(size.QuadPart);
+            #else
+                m->nFD          = ::open(path, O_RDONLY);
+                if (m->nFD < 0)
+                    return STATUS_NOT_FOUND;
+
+                struct stat st;
+                if (::fstat(m->nFD, &st) != 0)
+                {
+                    unmap_file(m);
+                    return STATUS_IO_ERROR;
+                }
+                if (st.st_size <= 0)
+                {
+                    unmap_file(m);
+                    return STATUS_BAD_FORMAT;
+                }
+
+                void *ptr       = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, m->nFD, 0);
+                if (ptr == MAP_FAILED)
+                {
+                    unmap_file(m);
+                    return STATUS_IO_ERROR;
+                }
+                m->pData        = static_cast<const uint8_t *>(ptr);
+                m->nSize        = st.st_size;
+            #endif /* PLATFORM_WINDOWS */
+
+                return STATUS_OK;
+            }
+
+            FILE *open_file(const char *path, const char *mode)
+            {
+            #ifdef PLATFORM_WINDOWS
+                int len         = ::MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+                if (len <= 0)
+                    return NULL;
+                WCHAR *wpath    = static_cast<WCHAR *>(malloc(len * sizeof(WCHAR)));
+                if (wpath == NULL)
+                    return NULL;
+                ::MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, len);
+
+                WCHAR wmode[8];
+                size_t n        = 0;
+                for ( ; (mode[n] != '\0') && (n < 7); ++n)
+                    wmode[n]        = WCHAR(mode[n]);
+                wmode[n]        = 0;
+
+                FILE *fd        = ::_wfopen(wpath, wmode);
+                free(wpath);
+                return fd;
+            #else
+                return ::fopen(path, mode);
+            #endif /* PLATFORM_WINDOWS */
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/wgl/matrix.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            void matrix_mul(r3d::mat4_t *r, const r3d::mat4_t *a, const r3d::mat4_t *b)
+            {
+            #ifdef __SSE2__
+                // Each column of the result is a linear combination of columns of a
+                __m128 c0       = _mm_loadu_ps(&a->m[0]);
+                __m128 c1       = _mm_loadu_ps(&a->m[4]);
+                __m128 c2       = _mm_loadu_ps(&a->m[8]);
+                __m128 c3       = _mm_loadu_ps(&a->m[12]);
+
+                for (size_t c=0; c<16; c += 4)
+                {
+                    const float *y  = &b->m[c];
+                    __m128 z        = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(y[0])), _mm_mul_ps(c1, _mm_set1_ps(y[1]))),
+                        _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(y[2])), _mm_mul_ps(c3, _mm_set1_ps(y[3]))));
+                    _mm_storeu_ps(&r->m[c], z);
+                }
+            #else
+                const float *x  = a->m;
+                const float *y  = b->m;
+                float *z        = r->m;
+
+                for (size_t c=0; c<16; c += 4)
+                {
+                    for (size_t i=0; i<4; ++i)
+                        z[c + i]    = x[i] * y[c] + x[i + 4] * y[c + 1] + x[i + 8] * y[c + 2] + x[i + 12] * y[c + 3];
+                }
+            #endif /* __SSE2__ */
+            }
+
+            void matrix_apply_array(r3d::dot4_t *v, const r3d::mat4_t *m, size_t count)
+            {
+            #ifdef __SSE2__
+                __m128 c0       = _mm_loadu_ps(&m->m[0]);
+                __m128 c1       = _mm_loadu_ps(&m->m[4]);
+                __m128 c2       = _mm_loadu_ps(&m->m[8]);
+                __m128 c3       = _mm_loadu_ps(&m->m[12]);
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    float *y        = &v[i].x;
+                    __m128 z        = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(y[0])), _mm_mul_ps(c1, _mm_set1_ps(y[1]))),
+                        _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(y[2])), _mm_mul_ps(c3, _mm_set1_ps(y[3]))));
+                    _mm_storeu_ps(y, z);
+                }
+            #else
+                r3d::dot4_t t;
+                for (size_t i=0; i<count; ++i)
+                {
+                    matrix_apply(&t, m, &v[i]);
+                    v[i]            = t;
+                }
+            #endif /* __SSE2__ */
+            }
+
+            void matrix_identity(r3d::mat4_t *r)
+            {
+                float *z        = r->m;
+                for (size_t i=0; i<16; ++i)
+                    z[i]            = 0.0f;
+                z[0]            = 1.0f;
+                z[5]            = 1.0f;
+                z[10]           = 1.0f;
+                z[15]           = 1.0f;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
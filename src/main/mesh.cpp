@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/r3d/wgl/mesh.h>
+#include <private/wgl/arena.h>
+#include <private/wgl/mapping.h>
+#include <private/wgl/matrix.h>
+#include <private/wgl/mesh.h>
+#include <private/wgl/weld.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            static inline size_t mesh_align(size_t size)
+            {
+                return (size + MESH_ALIGN - 1) & ~(MESH_ALIGN - 1);
+            }
+
+            static size_t primitive_vertices(size_t type)
+            {
+                switch (type)
+                {
+                    case r3d::PRIMITIVE_TRIANGLES:
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        return 3;
+                    case r3d::PRIMITIVE_LINES:
+                        return 2;
+                    case r3d::PRIMITIVE_POINTS:
+                        return 1;
+                    default:
+                        break;
+                }
+                return 0;
+            }
+
+            static bool write_padded(FILE *fd, const void *data, size_t size)
+            {
+                static const uint8_t padding[MESH_ALIGN] = { 0 };
+
+                if ((size > 0) && (fwrite(data, size, 1, fd) != 1))
+                    return false;
+                size_t pad          = mesh_align(size) - size;
+                return (pad <= 0) || (fwrite(padding, pad, 1, fd) == 1);
+            }
+
+            static status_t write_mesh_file(const char *path, const mesh_file_t *hdr, const vertex_t *vx, const uint32_t *indices)
+            {
+                FILE *fd            = open_file(path, "wb");
+                if (fd == NULL)
+                    return STATUS_IO_ERROR;
+
+                bool ok             = write_padded(fd, hdr, sizeof(mesh_file_t));
+                if (ok)
+                    ok                  = write_padded(fd, vx, hdr->vertices * sizeof(vertex_t));
+                if ((ok) && (indices != NULL))
+                    ok                  = write_padded(fd, indices, hdr->indices * sizeof(uint32_t));
+                if (fclose(fd) != 0)
+                    ok                  = false;
+
+                return (ok) ? STATUS_OK : STATUS_IO_ERROR;
+            }
+
+            status_t write_mesh(const char *path, const r3d::buffer_t *buffer, size_t flags)
+            {
+                if ((path == NULL) || (buffer == NULL) || (buffer->vertex.data == NULL))
+                    return STATUS_BAD_ARGUMENTS;
+
+                size_t count        = buffer->count * primitive_vertices(buffer->type);
+                if (count <= 0)
+                    return STATUS_BAD_ARGUMENTS;
+                if (count > 0xffffffff)
+                    return STATUS_OVERFLOW;
+
+                // Compute sources of vertices
+                arena_t arena;
+                arena.construct();
+                uint32_t *indices   = static_cast<uint32_t *>(malloc(count * sizeof(uint32_t)));
+                remap_t *remap      = static_cast<remap_t *>(malloc(count * sizeof(remap_t)));
+                vertex_t *vx        = NULL;
+                status_t res        = STATUS_NO_MEM;
+                ssize_t vertices    = count;
+
+                if ((indices != NULL) && (remap != NULL))
+                {
+                    if (flags & MESH_INDEXED)
+                        vertices            = weld_indices(indices, remap, buffer, count, &arena);
+                    else
+                    {
+                        const uint32_t *vindex  = buffer->vertex.index;
+                        const uint32_t *nindex  = buffer->normal.index;
+                        const uint32_t *cindex  = buffer->color.index;
+                        bool separate           = (nindex != NULL) || (cindex != NULL);
+                        for (size_t i=0; i<count; ++i)
+                        {
+                            remap_t *r              = &remap[i];
+                            r->v                    = (vindex != NULL) ? vindex[i] : uint32_t(i);
+                            uint32_t u              = (separate) ? uint32_t(i) : r->v;
+                            r->n                    = (nindex != NULL) ? nindex[i] : u;
+                            r->c                    = (cindex != NULL) ? cindex[i] : u;
+                        }
+                    }
+
+                    // Gather vertices
+                    if (vertices < 0)
+                        res                 = status_t(-vertices);
+                    else if ((vx = static_cast<vertex_t *>(malloc(vertices * sizeof(vertex_t)))) != NULL)
+                    {
+                        memset(vx, 0, vertices * sizeof(vertex_t));
+                        gather_vertices(vx, remap, vertices, buffer);
+                        res                 = STATUS_OK;
+                    }
+                }
+
+                free(remap);
+                arena.destroy();
+
+                if (res == STATUS_OK)
+                {
+                    // Fill header
+                    mesh_file_t hdr;
+                    memset(&hdr, 0, sizeof(hdr));
+                    hdr.magic           = MESH_MAGIC;
+                    hdr.version         = MESH_VERSION;
+                    hdr.type            = buffer->type;
+                    hdr.count           = buffer->count;
+                    hdr.vertices        = vertices;
+                    hdr.vertex_offset   = mesh_align(sizeof(mesh_file_t));
+                    if (buffer->normal.data != NULL)
+                        hdr.flags          |= MESH_NORMALS;
+                    if (buffer->color.data != NULL)
+                        hdr.flags          |= MESH_COLORS;
+                    if (flags & MESH_INDEXED)
+                    {
+                        hdr.flags          |= MESH_INDEXED;
+                        hdr.indices         = count;
+                        hdr.index_offset    = hdr.vertex_offset + mesh_align(vertices * sizeof(vertex_t));
+                    }
+
+                    // Compute bounding box
+                    for (size_t j=0; j<4; ++j)
+                    {
+                        hdr.min[j]          = (&vx[0].v.x)[j];
+                        hdr.max[j]          = hdr.min[j];
+                    }
+                    for (ssize_t i=1; i<vertices; ++i)
+                    {
+                        const float *v      = &vx[i].v.x;
+                        for (size_t j=0; j<4; ++j)
+                        {
+                            hdr.min[j]          = lsp_min(hdr.min[j], v[j]);
+                            hdr.max[j]          = lsp_max(hdr.max[j], v[j]);
+                        }
+                    }
+
+                    res                 = write_mesh_file(path, &hdr, vx, (flags & MESH_INDEXED) ? indices : NULL);
+                }
+
+                free(vx);
+                free(indices);
+
+                return res;
+            }
+
+            static status_t validate_mesh(const mesh_file_t *hdr, size_t size)
+            {
+                size_t vpp          = primitive_vertices(hdr->type);
+                if ((vpp <= 0) || (hdr->count <= 0) || (hdr->vertices <= 0) || (hdr->count > 0xffffffff / vpp))
+                    return STATUS_CORRUPTED;
+
+                // Check sections
+                if ((hdr->vertex_offset % MESH_ALIGN) || (hdr->vertex_offset < sizeof(mesh_file_t)) ||
+                    (hdr->vertex_offset > size) ||
+                    (hdr->vertices > (size - hdr->vertex_offset) / sizeof(vertex_t)))
+                    return STATUS_CORRUPTED;
+
+                if (hdr->flags & MESH_INDEXED)
+                {
+                    if ((hdr->indices != hdr->count * vpp) ||
+                        (hdr->index_offset % MESH_ALIGN) || (hdr->index_offset > size) ||
+                        (hdr->index_offset < hdr->vertex_offset + hdr->vertices * sizeof(vertex_t)) ||
+                        (hdr->indices > (size - hdr->index_offset) / sizeof(uint32_t)))
+                        return STATUS_CORRUPTED;
+                }
+                else if (hdr->vertices != hdr->count * vpp)
+                    return STATUS_CORRUPTED;
+
+                return STATUS_OK;
+            }
+
+            status_t map_mesh(mesh_t *mesh, const char *path)
+            {
+                if ((mesh == NULL) || (path == NULL))
+                    return STATUS_BAD_ARGUMENTS;
+
+                mapping_t *m        = static_cast<mapping_t *>(malloc(sizeof(mapping_t)));
+                if (m == NULL)
+                    return STATUS_NO_MEM;
+                status_t res        = map_file(m, path);
+                if (res != STATUS_OK)
+                {
+                    free(m);
+                    return res;
+                }
+
+                // Validate header
+                const mesh_file_t *hdr  = reinterpret_cast<const mesh_file_t *>(m->pData);
+                if ((m->nSize < sizeof(mesh_file_t)) || (hdr->magic != MESH_MAGIC))
+                    res                 = STATUS_BAD_FORMAT;
+                else if (hdr->version != MESH_VERSION)
+                    res                 = STATUS_UNSUPPORTED_FORMAT;
+                else
+                    res                 = validate_mesh(hdr, m->nSize);
+
+                // Validate indices, invalid index would cause reading outside of the mapping while drawing
+                const vertex_t *vx      = NULL;
+                const uint32_t *indices = NULL;
+                if (res == STATUS_OK)
+                {
+                    vx                      = reinterpret_cast<const vertex_t *>(&m->pData[hdr->vertex_offset]);
+                    if (hdr->flags & MESH_INDEXED)
+                    {
+                        indices                 = reinterpret_cast<const uint32_t *>(&m->pData[hdr->index_offset]);
+                        uint32_t max            = 0;
+                        for (size_t i=0, n=hdr->indices; i<n; ++i)
+                            max                     = lsp_max(max, indices[i]);
+                        if (max >= hdr->vertices)
+                            res                     = STATUS_CORRUPTED;
+                    }
+                }
+
+                if (res != STATUS_OK)
+                {
+                    unmap_file(m);
+                    free(m);
+                    return res;
+                }
+
+                mesh->vertices      = vx;
+                mesh->indices       = indices;
+                mesh->nvertices     = hdr->vertices;
+                mesh->count         = hdr->count;
+                mesh->type          = r3d::primitive_type_t(hdr->type);
+                mesh->flags         = hdr->flags & (MESH_NORMALS | MESH_COLORS | MESH_INDEXED);
+                mesh->min.x         = hdr->min[0];
+                mesh->min.y         = hdr->min[1];
+                mesh->min.z         = hdr->min[2];
+                mesh->min.w         = hdr->min[3];
+                mesh->max.x         = hdr->max[0];
+                mesh->max.y         = hdr->max[1];
+                mesh->max.z         = hdr->max[2];
+                mesh->max.w         = hdr->max[3];
+                mesh->mapping       = m;
+
+                return STATUS_OK;
+            }
+
+            void unmap_mesh(mesh_t *mesh)
+            {
+                if ((mesh == NULL) || (mesh->mapping == NULL))
+                    return;
+
+                mapping_t *m        = static_cast<mapping_t *>(mesh->mapping);
+                unmap_file(m);
+                free(m);
+
+                mesh->vertices      = NULL;
+                mesh->indices       = NULL;
+                mesh->nvertices     = 0;
+                mesh->count         = 0;
+                mesh->mapping       = NULL;
+            }
+
+            void mesh_buffer(r3d::buffer_t *buffer, const mesh_t *mesh)
+            {
+                const vertex_t *vx      = mesh->vertices;
+
+                matrix_identity(&buffer->model);
+                buffer->type            = mesh->type;
+                buffer->flags           = 0;
+                buffer->width           = 1.0f;
+                buffer->count           = mesh->count;
+
+                buffer->vertex.data     = &vx->v;
+                buffer->vertex.stride   = sizeof(vertex_t);
+                buffer->vertex.index    = mesh->indices;
+
+                buffer->normal.data     = (mesh->flags & MESH_NORMALS) ? &vx->n : NULL;
+                buffer->normal.stride   = sizeof(vertex_t);
+                buffer->normal.index    = NULL;
+
+                buffer->color.data      = (mesh->flags & MESH_COLORS) ? &vx->c : NULL;
+                buffer->color.stride    = sizeof(vertex_t);
+                buffer->color.index     = NULL;
+                buffer->color.dfl.r     = 1.0f;
+                buffer->color.dfl.g     = 1.0f;
+                buffer->color.dfl.b     = 1.0f;
+                buffer->color.dfl.a     = 1.0f;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+
+#ifdef PLATFORM_WINDOWS
+
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/matrix.h>
+#include <private/wgl/occlusion.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            static inline size_t occluder_hash(const r3d::buffer_t *key)
+            {
+                uintptr_t h = reinterpret_cast<uintptr_t>(key->vertex.data) ^
+                              (reinterpret_cast<uintptr_t>(key->vertex.index) >> 4) ^
+                              key->count;
+                // Translation distinguishes instances of the same buffer
+                const float *m  = &key->model.m[12];
+                for (size_t i=0; i<3; ++i)
+                {
+                    uint32_t w;
+                    ::memcpy(&w, &m[i], sizeof(w));
+                    h           = (h ^ w) * 0x01000193;
+                }
+                h          ^= h >> 7;
+                h          ^= h >> 13;
+                return h & (OCCLUSION_BINS - 1);
+            }
+
+            static inline bool occluder_match(const occluder_t *o, const r3d::buffer_t *key)
+            {
+                return (o->pVData == key->vertex.data) &&
+                       (o->pVIndex == key->vertex.index) &&
+                       (o->nVStride == key->vertex.stride) &&
+                       (o->nCount == key->count) &&
+                       (o->nType == uint32_t(key->type)) &&
+                       (::memcmp(&o->sModel, &key->model, sizeof(r3d::mat4_t)) == 0);
+            }
+
+            static void free_occluder(const gl_ext_t *ext, occluder_t *o)
+            {
+                if (o->nQuery != 0)
+                    ext->glDeleteQueries(1, &o->nQuery);
+                free(o);
+            }
+
+            void occlusion_cache_t::construct()
+            {
+                for (size_t i=0; i<OCCLUSION_BINS; ++i)
+                    vBins[i]        = NULL;
+                nMinCount       = 0;
+                nFrame          = 0;
+                nEntries        = 0;
+                nTested         = 0;
+                nCulled         = 0;
+                nQueries        = 0;
+            }
+
+            void occlusion_cache_t::destroy(const gl_ext_t *ext)
+            {
+                for (size_t i=0; i<OCCLUSION_BINS; ++i)
+                {
+                    for (occluder_t *o = vBins[i]; o != NULL; )
+                    {
+                        occluder_t *next    = o->pNext;
+                        free_occluder(ext, o);
+                        o                   = next;
+                    }
+                    vBins[i]        = NULL;
+                }
+                nEntries        = 0;
+            }
+
+            void occlusion_cache_t::invalidate(const void *data)
+            {
+                for (size_t i=0; i<OCCLUSION_BINS; ++i)
+                {
+                    for (occluder_t *o = vBins[i]; o != NULL; o = o->pNext)
+                    {
+                        if ((data == NULL) || (o->pVData == data) || (o->pVIndex == data))
+                        {
+                            o->bBounds          = false;
+                            o->bVisible         = true;
+                        }
+                    }
+                }
+            }
+
+            void occlusion_cache_t::next_frame(const gl_ext_t *ext)
+            {
+                ++nFrame;
+
+                for (size_t i=0; i<OCCLUSION_BINS; ++i)
+                {
+                    for (occluder_t **po = &vBins[i]; *po != NULL; )
+                    {
+                        occluder_t *o       = *po;
+                        if ((nFrame - o->nLastFrame) <= OCCLUSION_MAX_AGE)
+                        {
+                            po                  = &o->pNext;
+                            continue;
+                        }
+
+                        *po                 = o->pNext;
+                        free_occluder(ext, o);
+                        --nEntries;
+                    }
+                }
+            }
+
+            static void compute_bounds(occluder_t *o, const r3d::buffer_t *data, size_t count)
+            {
+                const uint8_t *vdata    = reinterpret_cast<const uint8_t *>(data->vertex.data);
+                const uint32_t *vindex  = data->vertex.index;
+                size_t vstride          = (data->vertex.stride == 0) ? sizeof(r3d::dot4_t) : data->vertex.stride;
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    const r3d::dot4_t *p    = reinterpret_cast<const r3d::dot4_t *>(vdata + ((vindex != NULL) ? vindex[i] : i) * vstride);
+                    if (i == 0)
+                    {
+                        o->vMin[0] = o->vMax[0] = p->x;
+                        o->vMin[1] = o->vMax[1] = p->y;
+                        o->vMin[2] = o->vMax[2] = p->z;
+                        continue;
+                    }
+                    o->vMin[0]  = lsp_min(o->vMin[0], p->x);
+                    o->vMin[1]  = lsp_min(o->vMin[1], p->y);
+                    o->vMin[2]  = lsp_min(o->vMin[2], p->z);
+                    o->vMax[0]  = lsp_max(o->vMax[0], p->x);
+                    o->vMax[1]  = lsp_max(o->vMax[1], p->y);
+                    o->vMax[2]  = lsp_max(o->vMax[2], p->z);
+                }
+
+                o->bBounds      = true;
+            }
+
+            static bool crosses_near_plane(const occluder_t *o, const r3d::mat4_t *mvp)
+            {
+                // The box that intersects the near plane is clipped and can not be tested reliably
+                r3d::dot4_t p, r;
+                p.w             = 1.0f;
+                for (size_t i=0; i<8; ++i)
+                {
+                    p.x             = (i & 1) ? o->vMax[0] : o->vMin[0];
+                    p.y             = (i & 2) ? o->vMax[1] : o->vMin[1];
+                    p.z             = (i & 4) ? o->vMax[2] : o->vMin[2];
+                    matrix_apply(&r, mvp, &p);
+                    if ((r.z + r.w) <= 0.0f)
+                        return true;
+                }
+                return false;
+            }
+
+            static void draw_bounds(const occluder_t *o)
+            {
+                const float *a  = o->vMin;
+                const float *b  = o->vMax;
+
+                ::glBegin(GL_QUADS);
+                    // -Z, +Z
+                    ::glVertex3f(a[0], a[1], a[2]); ::glVertex3f(b[0], a[1], a[2]); ::glVertex3f(b[0], b[1], a[2]); ::glVertex3f(a[0], b[1], a[2]);
+                    ::glVertex3f(a[0], a[1], b[2]); ::glVertex3f(b[0], a[1], b[2]); ::glVertex3f(b[0], b[1], b[2]); ::glVertex3f(a[0], b[1], b[2]);
+                    // -Y, +Y
+                    ::glVertex3f(a[0], a[1], a[2]); ::glVertex3f(b[0], a[1], a[2]); ::glVertex3f(b[0], a[1], b[2]); ::glVertex3f(a[0], a[1], b[2]);
+                    ::glVertex3f(a[0], b[1], a[2]); ::glVertex3f(b[0], b[1], a[2]); ::glVertex3f(b[0], b[1], b[2]); ::glVertex3f(a[0], b[1], b[2]);
+                    // -X, +X
+                    ::glVertex3f(a[0], a[1], a[2]); ::glVertex3f(a[0], b[1], a[2]); ::glVertex3f(a[0], b[1], b[2]); ::glVertex3f(a[0], a[1], b[2]);
+                    ::glVertex3f(b[0], a[1], a[2]); ::glVertex3f(b[0], b[1], a[2]); ::glVertex3f(b[0], b[1], b[2]); ::glVertex3f(b[0], a[1], b[2]);
+                ::glEnd();
+            }
+
+            bool occlusion_cache_t::test(const gl_ext_t *ext, const r3d::buffer_t *key, const r3d::buffer_t *data,
+                size_t count, const r3d::mat4_t *mvp)
+            {
+                // Find or create the entry
+                occluder_t **bin    = &vBins[occluder_hash(key)];
+                occluder_t *o       = *bin;
+                for ( ; o != NULL; o = o->pNext)
+                {
+                    if (occluder_match(o, key))
+                        break;
+                }
+                if (o == NULL)
+                {
+                    if ((o = static_cast<occluder_t *>(malloc(sizeof(occluder_t)))) == NULL)
+                        return true;
+
+                    o->pVData           = key->vertex.data;
+                    o->pVIndex          = key->vertex.index;
+                    o->nVStride         = key->vertex.stride;
+                    o->nCount           = key->count;
+                    o->nType            = uint32_t(key->type);
+                    o->sModel           = key->model;
+                    o->bBounds          = false;
+                    o->nQuery           = 0;
+                    o->bPending         = false;
+                    o->bVisible         = true;
+
+                    o->pNext            = *bin;
+                    *bin                = o;
+                    ++nEntries;
+                }
+                o->nLastFrame       = nFrame;
+                if (!o->bBounds)
+                    compute_bounds(o, data, count);
+
+                // Collect the result of the query issued earlier without waiting for it
+                if (o->bPending)
+                {
+                    GLuint available    = 0;
+                    ext->glGetQueryObjectuiv(o->nQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+                    if (available)
+                    {
+                        GLuint samples      = 0;
+                        ext->glGetQueryObjectuiv(o->nQuery, GL_QUERY_RESULT, &samples);
+                        o->bVisible         = samples > 0;
+                        o->bPending         = false;
+                    }
+                }
+
+                bool visible        = o->bVisible;
+                ++nTested;
+                if (!visible)
+                    ++nCulled;
+
+                // Issue the query against the bounding box for the following frame
+                if (o->bPending)
+                    return visible;
+                if (crosses_near_plane(o, mvp))
+                {
+                    o->bVisible         = true;
+                    return visible;
+                }
+                if (o->nQuery == 0)
+                {
+                    ext->glGenQueries(1, &o->nQuery);
+                    if (o->nQuery == 0)
+                    {
+                        o->bVisible         = true;
+                        return visible;
+                    }
+                }
+
+                ::glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                ::glDepthMask(GL_FALSE);
+                ::glDisable(GL_CULL_FACE);
+
+                ext->glBeginQuery(GL_SAMPLES_PASSED, o->nQuery);
+                draw_bounds(o);
+                ext->glEndQuery(GL_SAMPLES_PASSED);
+
+                ::glEnable(GL_CULL_FACE);
+                ::glDepthMask(GL_TRUE);
+                ::glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+                o->bPending         = true;
+                ++nQueries;
+
+                return visible;
+            }
+
+            void occlusion_cache_t::get_stats(occlusion_stats_t *stats)
+            {
+                stats->nEntries     = nEntries;
+                stats->nTested      = nTested;
+                stats->nCulled      = nCulled;
+                stats->nQueries     = nQueries;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
+
+#endif /* PLATFORM_WINDOWS */
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/optimize.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr float FS_CACHE_DECAY_POWER    = 1.5f;
+            constexpr float FS_LAST_TRI_SCORE       = 0.75f;
+            constexpr float FS_VALENCE_BOOST_SCALE  = 2.0f;
+            constexpr float FS_VALENCE_BOOST_POWER  = 0.5f;
+            constexpr size_t FS_VALENCE_TABLE       = 32;
+
+            typedef struct fs_vertex_t
+            {
+                uint32_t        offset;         // Offset of the triangle list in adjacency array
+                uint32_t        active;         // Number of triangles that are not emitted yet
+                int32_t         cache;          // Position in the cache, negative if not in cache
+                float           score;          // Current score
+            } fs_vertex_t;
+
+            typedef struct fs_tables_t
+            {
+                float           vCache[VCACHE_SIZE];        // Score by cache position
+                float           vValence[FS_VALENCE_TABLE]; // Score by number of remaining triangles
+            } fs_tables_t;
+
+            static void init_tables(fs_tables_t *t)
+            {
+                for (size_t i=0; i<VCACHE_SIZE; ++i)
+                {
+                    if (i < 3)
+                        t->vCache[i]    = FS_LAST_TRI_SCORE;
+                    else
+                        t->vCache[i]    = powf(1.0f - float(i - 3) / float(VCACHE_SIZE - 3), FS_CACHE_DECAY_POWER);
+                }
+
+                t->vValence[0]  = 0.0f;
+                for (size_t i=1; i<FS_VALENCE_TABLE; ++i)
+                    t->vValence[i]  = FS_VALENCE_BOOST_SCALE * powf(float(i), -FS_VALENCE_BOOST_POWER);
+            }
+
+            static inline float vertex_score(const fs_tables_t *t, const fs_vertex_t *v)
+            {
+                if (v->active == 0)
+                    return -1.0f;
+
+                float score = (v->cache >= 0) ? t->vCache[v->cache] : 0.0f;
+                score      += (v->active < FS_VALENCE_TABLE) ?
+                              t->vValence[v->active] :
+                              FS_VALENCE_BOOST_SCALE * powf(float(v->active), -FS_VALENCE_BOOST_POWER);
+
+                return score;
+            }
+
+            float compute_acmr(const uint32_t *indices, size_t count, size_t vertices, size_t cache_size)
+            {
+                size_t triangles    = count / 3;
+                if ((triangles <= 0) || (vertices <= 0))
+                    return 0.0f;
+
+                // FIFO cache is modelled by the timestamp of vertex insertion
+                size_t *stamp       = static_cast<size_t *>(malloc(vertices * sizeof(size_t)));
+                if (stamp == NULL)
+                    return 0.0f;
+
+                for (size_t i=0; i<vertices; ++i)
+                    stamp[i]            = 0;
+
+                size_t time         = cache_size + 1;
+                size_t misses       = 0;
+                for (size_t i=0; i<triangles*3; ++i)
+                {
+                    size_t v            = indices[i];
+                    if (time - stamp[v] > cache_size)
+                    {
+                        stamp[v]            = time++;
+                        ++misses;
+                    }
+                }
+
+                free(stamp);
+                return float(misses) / float(triangles);
+            }
+
+            status_t optimize_triangles(uint32_t *indices, size_t count, size_t vertices)
+            {
+                size_t triangles    = count / 3;
+                if ((triangles <= 1) || (vertices <= 0))
+                    return STATUS_OK;
+
+                // Allocate memory
+                size_t szof_verts   = vertices * sizeof(fs_vertex_t);
+                size_t szof_adj     = triangles * 3 * sizeof(uint32_t);
+                size_t szof_score   = triangles * sizeof(float);
+                size_t szof_out     = triangles * 3 * sizeof(uint32_t);
+                size_t szof_flags   = triangles * sizeof(uint8_t);
+
+                uint8_t *data       = static_cast<uint8_t *>(malloc(szof_verts + szof_adj + szof_score + szof_out + szof_flags));
+                if (data == NULL)
+                    return STATUS_NO_MEM;
+
+                fs_vertex_t *vv     = reinterpret_cast<fs_vertex_t *>(data);
+                uint32_t *adj       = reinterpret_cast<uint32_t *>(&data[szof_verts]);
+                float *tscore       = reinterpret_cast<float *>(&data[szof_verts + szof_adj]);
+                uint32_t *out       = reinterpret_cast<uint32_t *>(&data[szof_verts + szof_adj + szof_score]);
+                uint8_t *emitted    = &data[szof_verts + szof_adj + szof_score + szof_out];
+
+                fs_tables_t tables;
+                init_tables(&tables);
+
+                // Build the vertex-triangle adjacency
+                for (size_t i=0; i<vertices; ++i)
+                {
+                    vv[i].offset        = 0;
+                    vv[i].active        = 0;
+                    vv[i].cache         = -1;
+                }
+                for (size_t i=0; i<triangles*3; ++i)
+                    ++vv[indices[i]].active;
+                for (size_t i=0, offset=0; i<vertices; ++i)
+                {
+                    vv[i].offset        = uint32_t(offset);
+                    offset             += vv[i].active;
+                    vv[i].active        = 0;
+                }
+                for (size_t i=0; i<triangles*3; ++i)
+                {
+                    fs_vertex_t *v      = &vv[indices[i]];
+                    adj[v->offset + v->active++] = uint32_t(i / 3);
+                }
+
+                // Compute initial scores
+                for (size_t i=0; i<vertices; ++i)
+                    vv[i].score         = vertex_score(&tables, &vv[i]);
+
+                ssize_t best        = -1;
+                float best_score    = -1.0f;
+                for (size_t i=0; i<triangles; ++i)
+                {
+                    const uint32_t *t   = &indices[i*3];
+                    tscore[i]           = vv[t[0]].score + vv[t[1]].score + vv[t[2]].score;
+                    emitted[i]          = 0;
+                    if (tscore[i] > best_score)
+                    {
+                        best_score          = tscore[i];
+                        best                = i;
+                    }
+                }
+
+                // Emit triangles
+                uint32_t cache[VCACHE_SIZE + 3];
+                size_t cache_size   = 0;
+                size_t cursor       = 0;
+
+                for (size_t n=0; n<triangles; ++n)
+                {
+                    // Pick up the next non-emitted triangle if there is no candidate in cache
+                    if (best < 0)
+                    {
+                        while (emitted[cursor])
+                            ++cursor;
+                        best                = cursor;
+                    }
+
+                    // Emit the triangle and remove it from the adjacency of its vertices
+                    const uint32_t *t   = &indices[best*3];
+                    out[n*3]            = t[0];
+                    out[n*3 + 1]        = t[1];
+                    out[n*3 + 2]        = t[2];
+                    emitted[best]       = 1;
+
+                    for (size_t j=0; j<3; ++j)
+                    {
+                        fs_vertex_t *v      = &vv[t[j]];
+                        uint32_t *list      = &adj[v->offset];
+                        for (size_t k=0; k<v->active; ++k)
+                        {
+                            if (list[k] == uint32_t(best))
+                            {
+                                list[k]             = list[--v->active];
+                                break;
+                            }
+                        }
+                    }
+
+                    // Update the cache: put vertices of the triangle to the front
+                    uint32_t next[VCACHE_SIZE + 3];
+                    size_t next_size    = 0;
+                    for (size_t j=0; j<3; ++j)
+                        next[next_size++]   = t[j];
+                    for (size_t j=0; j<cache_size; ++j)
+                    {
+                        uint32_t v          = cache[j];
+                        if ((v != t[0]) && (v != t[1]) && (v != t[2]))
+                            next[next_size++]   = v;
+                    }
+
+                    // Update scores of vertices and the cache contents
+                    for (size_t j=0; j<next_size; ++j)
+                    {
+                        fs_vertex_t *v      = &vv[next[j]];
+                        v->cache            = (j < VCACHE_SIZE) ? int32_t(j) : -1;
+                        v->score            = vertex_score(&tables, v);
+                    }
+                    cache_size          = lsp_min(next_size, VCACHE_SIZE);
+                    ::memcpy(cache, next, cache_size * sizeof(uint32_t));
+
+                    // Update scores of affected triangles and find the best one
+                    best                = -1;
+                    best_score          = -1.0f;
+                    for (size_t j=0; j<next_size; ++j)
+                    {
+                        const fs_vertex_t *v = &vv[next[j]];
+                        const uint32_t *list = &adj[v->offset];
+                        for (size_t k=0; k<v->active; ++k)
+                        {
+                            uint32_t ti         = list[k];
+                            const uint32_t *tt  = &indices[ti*3];
+                            float score         = vv[tt[0]].score + vv[tt[1]].score + vv[tt[2]].score;
+                            tscore[ti]          = score;
+                            if (score > best_score)
+                            {
+                                best_score          = score;
+                                best                = ti;
+                            }
+                        }
+                    }
+                }
+
+                ::memcpy(indices, out, triangles * 3 * sizeof(uint32_t));
+                free(data);
+
+                return STATUS_OK;
+            }
+
+            status_t optimize_vertices(uint32_t *order, uint32_t *indices, size_t count, size_t vertices)
+            {
+                uint32_t *remap     = static_cast<uint32_t *>(malloc(vertices * sizeof(uint32_t)));
+                if (remap == NULL)
+                    return STATUS_NO_MEM;
+
+                for (size_t i=0; i<vertices; ++i)
+                    remap[i]            = uint32_t(-1);
+
+                // Assign new indices in order of first use
+                uint32_t next       = 0;
+                for (size_t i=0; i<count; ++i)
+                {
+                    uint32_t v          = indices[i];
+                    if (remap[v] == uint32_t(-1))
+                    {
+                        order[next]         = v;
+                        remap[v]            = next++;
+                    }
+                    indices[i]          = remap[v];
+                }
+
+                // Move unreferenced vertices to the end
+                for (size_t i=0; i<vertices; ++i)
+                {
+                    if (remap[i] == uint32_t(-1))
+                        order[next++]       = uint32_t(i);
+                }
+
+                free(remap);
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/pixels.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            typedef void (* convert_row_t)(uint8_t *dst, const uint8_t *src, size_t count);
+
+            static inline uint32_t load_pixel(const uint8_t *src)
+            {
+                uint32_t x;
+                ::memcpy(&x, src, sizeof(x));
+                return x;
+            }
+
+            static inline void store_pixel(uint8_t *dst, uint32_t x)
+            {
+                ::memcpy(dst, &x, sizeof(x));
+            }
+
+            static inline uint32_t swap_rb(uint32_t x)
+            {
+                // Pixels are loaded as little-endian words: 0xAABBGGRR <-> 0xAARRGGBB
+                return (x & 0xff00ff00) | ((x >> 16) & 0xff) | ((x & 0xff) << 16);
+            }
+
+            static inline uint32_t premultiply(uint32_t x)
+            {
+                // Two channels per multiplication, division by 255 with rounding
+                uint32_t a      = x >> 24;
+                uint32_t rb     = (x & 0x00ff00ff) * a + 0x00800080;
+                uint32_t g      = ((x >> 8) & 0xff) * a + 0x80;
+                rb              = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+                g               = ((g + (g >> 8)) >> 8) & 0xff;
+                return (x & 0xff000000) | rb | (g << 8);
+            }
+
+            static inline uint16_t pack_565(uint32_t x)
+            {
+                return uint16_t((((x >> 3) & 0x1f) << 11) | (((x >> 10) & 0x3f) << 5) | ((x >> 19) & 0x1f));
+            }
+
+        #ifdef __SSE2__
+            static inline __m128i swap_rb_x4(__m128i x)
+            {
+                const __m128i mag   = _mm_set1_epi32(int32_t(0xff00ff00));
+                const __m128i mb    = _mm_set1_epi32(0xff);
+                return _mm_or_si128(
+                    _mm_and_si128(x, mag),
+                    _mm_or_si128(
+                        _mm_and_si128(_mm_srli_epi32(x, 16), mb),
+                        _mm_slli_epi32(_mm_and_si128(x, mb), 16)));
+            }
+
+            static inline __m128i premultiply_x2(__m128i c)
+            {
+                // c contains two pixels as 16-bit channels
+                const __m128i rnd   = _mm_set1_epi16(0x80);
+                __m128i a           = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, 0xff), 0xff);
+                __m128i t           = _mm_add_epi16(_mm_mullo_epi16(c, a), rnd);
+                return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+            }
+
+            static inline __m128i premultiply_x4(__m128i x)
+            {
+                const __m128i zero  = _mm_setzero_si128();
+                const __m128i ma    = _mm_set1_epi32(int32_t(0xff000000));
+                __m128i lo          = premultiply_x2(_mm_unpacklo_epi8(x, zero));
+                __m128i hi          = premultiply_x2(_mm_unpackhi_epi8(x, zero));
+                __m128i c           = _mm_packus_epi16(lo, hi);
+                return _mm_or_si128(_mm_andnot_si128(ma, c), _mm_and_si128(x, ma));
+            }
+
+            static inline __m128i pack_565_x4(__m128i x)
+            {
+                const __m128i m5    = _mm_set1_epi32(0x1f);
+                const __m128i m6    = _mm_set1_epi32(0x3f);
+                const __m128i bias  = _mm_set1_epi32(0x8000);
+                __m128i r           = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(x, 3), m5), 11);
+                __m128i g           = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(x, 10), m6), 5);
+                __m128i b           = _mm_and_si128(_mm_srli_epi32(x, 19), m5);
+                // Values are biased to fit the signed saturation of the pack
+                return _mm_sub_epi32(_mm_or_si128(r, _mm_or_si128(g, b)), bias);
+            }
+        #endif /* __SSE2__ */
+
+            static void convert_rgba(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                ::memcpy(dst, src, count * 4);
+            }
+
+            static void convert_bgra(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                size_t i        = 0;
+            #ifdef __SSE2__
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    __m128i x       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i * 4]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i * 4]), swap_rb_x4(x));
+                }
+            #endif /* __SSE2__ */
+                for ( ; i < count; ++i)
+                    store_pixel(&dst[i * 4], swap_rb(load_pixel(&src[i * 4])));
+            }
+
+            static void convert_rgba_premul(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                size_t i        = 0;
+            #ifdef __SSE2__
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    __m128i x       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i * 4]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i * 4]), premultiply_x4(x));
+                }
+            #endif /* __SSE2__ */
+                for ( ; i < count; ++i)
+                    store_pixel(&dst[i * 4], premultiply(load_pixel(&src[i * 4])));
+            }
+
+            static void convert_bgra_premul(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                size_t i        = 0;
+            #ifdef __SSE2__
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    __m128i x       = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i * 4]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i * 4]), swap_rb_x4(premultiply_x4(x)));
+                }
+            #endif /* __SSE2__ */
+                for ( ; i < count; ++i)
+                    store_pixel(&dst[i * 4], swap_rb(premultiply(load_pixel(&src[i * 4]))));
+            }
+
+            static void convert_rgb(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                for (size_t i=0; i<count; ++i, dst += 3, src += 4)
+                {
+                    dst[0]          = src[0];
+                    dst[1]          = src[1];
+                    dst[2]          = src[2];
+                }
+            }
+
+            static void convert_bgr(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                for (size_t i=0; i<count; ++i, dst += 3, src += 4)
+                {
+                    dst[0]          = src[2];
+                    dst[1]          = src[1];
+                    dst[2]          = src[0];
+                }
+            }
+
+            static void convert_rgb565(uint8_t *dst, const uint8_t *src, size_t count)
+            {
+                size_t i        = 0;
+            #ifdef __SSE2__
+                const __m128i bias  = _mm_set1_epi16(int16_t(0x8000));
+                for ( ; i + 8 <= count; i += 8)
+                {
+                    __m128i x0      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i * 4]));
+                    __m128i x1      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i * 4 + 16]));
+                    __m128i v       = _mm_packs_epi32(pack_565_x4(x0), pack_565_x4(x1));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i * 2]), _mm_add_epi16(v, bias));
+                }
+            #endif /* __SSE2__ */
+                for ( ; i < count; ++i)
+                {
+                    uint16_t v      = pack_565(load_pixel(&src[i * 4]));
+                    ::memcpy(&dst[i * 2], &v, sizeof(v));
+                }
+            }
+
+            size_t read_format_size(read_format_t format)
+            {
+                switch (format)
+                {
+                    case READ_RGBA:
+                    case READ_BGRA:
+                    case READ_RGBA_PREMUL:
+                    case READ_BGRA_PREMUL:
+                        return 4;
+                    case READ_RGB:
+                    case READ_BGR:
+                        return 3;
+                    case READ_RGB565:
+                        return 2;
+                    default:
+                        break;
+                }
+                return 0;
+            }
+
+            status_t convert_pixels(
+                uint8_t *dst, size_t dst_stride,
+                const uint8_t *src, size_t src_stride,
+                size_t width, size_t height,
+                read_format_t format, bool flip)
+            {
+                convert_row_t convert;
+                switch (format)
+                {
+                    case READ_RGBA:         convert = convert_rgba;         break;
+                    case READ_BGRA:         convert = convert_bgra;         break;
+                    case READ_RGBA_PREMUL:  convert = convert_rgba_premul;  break;
+                    case READ_BGRA_PREMUL:  convert = convert_bgra_premul;  break;
+                    case READ_RGB:          convert = convert_rgb;          break;
+                    case READ_BGR:          convert = convert_bgr;          break;
+                    case READ_RGB565:       convert = convert_rgb565;       break;
+                    default:
+                        return STATUS_BAD_ARGUMENTS;
+                }
+
+                if (flip)
+                {
+                    src                += (height - 1) * src_stride;
+                    for (size_t y=0; y<height; ++y, dst += dst_stride, src -= src_stride)
+                        convert(dst, src, width);
+                }
+                else
+                {
+                    for (size_t y=0; y<height; ++y, dst += dst_stride, src += src_stride)
+                        convert(dst, src, width);
+                }
+
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
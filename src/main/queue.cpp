@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <private/wgl/queue.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            void cmd_queue_t::construct()
+            {
+                vData       = NULL;
+                pData       = NULL;
+                nCapacity   = 0;
+                nHead       = 0;
+                nTail       = 0;
+                nPending    = 0;
+            }
+
+            void cmd_queue_t::destroy()
+            {
+                free_aligned(pData);
+                vData       = NULL;
+                nCapacity   = 0;
+                nHead       = 0;
+                nTail       = 0;
+                nPending    = 0;
+            }
+
+            status_t cmd_queue_t::init(size_t capacity)
+            {
+                // Round capacity up to the power of 2
+                size_t cap  = CMD_QUEUE_ALIGN * 2;
+                while (cap < capacity)
+                    cap       <<= 1;
+                if (cap > 0x40000000)
+                    return STATUS_OVERFLOW;
+
+                void *data  = NULL;
+                uint8_t *ptr= alloc_aligned<uint8_t>(data, cap, 64);
+                if (ptr == NULL)
+                    return STATUS_NO_MEM;
+
+                destroy();
+                vData       = ptr;
+                pData       = data;
+                nCapacity   = uint32_t(cap);
+
+                return STATUS_OK;
+            }
+
+            cmd_header_t *cmd_queue_t::begin(uint32_t type, size_t size)
+            {
+                size_t total        = (size + CMD_QUEUE_ALIGN - 1) & (~(CMD_QUEUE_ALIGN - 1));
+                if (total > max_record())
+                    return NULL;
+
+                const uint32_t mask = nCapacity - 1;
+                uint32_t head       = nHead;        // Only producer modifies the head
+                uint32_t tail       = atomic_load(&nTail);
+                uint32_t off        = head & mask;
+                uint32_t tailroom   = nCapacity - off;
+                uint32_t need       = (tailroom < total) ? tailroom + total : total;
+
+                if ((nCapacity - (head - tail)) < need)
+                    return NULL;
+
+                // Emit padding record if the record does not fit at the end of the ring
+                if (tailroom < total)
+                {
+                    cmd_header_t *pad   = reinterpret_cast<cmd_header_t *>(&vData[off]);
+                    pad->type           = CMD_PADDING;
+                    pad->size           = tailroom;
+                    off                 = 0;
+                }
+
+                cmd_header_t *hdr   = reinterpret_cast<cmd_header_t *>(&vData[off]);
+                hdr->type           = type;
+                hdr->size           = uint32_t(total);
+                nPending            = need;
+
+                return hdr;
+            }
+
+            void cmd_queue_t::commit()
+            {
+                atomic_store(&nHead, uint32_t(nHead + nPending));
+                nPending            = 0;
+            }
+
+            cmd_header_t *cmd_queue_t::fetch()
+            {
+                const uint32_t mask = nCapacity - 1;
+                uint32_t tail       = nTail;        // Only consumer modifies the tail
+                uint32_t head       = atomic_load(&nHead);
+
+                while (tail != head)
+                {
+                    cmd_header_t *hdr   = reinterpret_cast<cmd_header_t *>(&vData[tail & mask]);
+                    if (hdr->type != CMD_PADDING)
+                        return hdr;
+
+                    // Skip the padding record
+                    tail               += hdr->size;
+                    atomic_store(&nTail, tail);
+                }
+
+                return NULL;
+            }
+
+            void cmd_queue_t::release(const cmd_header_t *hdr)
+            {
+                atomic_store(&nTail, uint32_t(nTail + hdr->size));
+            }
+
+            bool cmd_queue_t::empty()
+            {
+                return atomic_load(&nHead) == atomic_load(&nTail);
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/wgl/scale.h>
+
+#include <stdlib.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            typedef struct scale_tap_t
+            {
+                uint32_t            i0, i1;         // Offsets of the left and right source pixels
+                uint32_t            w;              // Weight of the right pixel, 0..255
+            } scale_tap_t;
+
+            static inline void compute_tap(scale_tap_t *tap, size_t i, size_t step, size_t size)
+            {
+                // Position of the destination pixel center in 16.16 fixed point
+                int64_t pos     = int64_t(i) * step + (step >> 1) - 0x8000;
+                if (pos < 0)
+                    pos             = 0;
+                size_t i0       = size_t(pos >> 16);
+                if (i0 >= (size - 1))
+                {
+                    tap->i0         = uint32_t(size - 1);
+                    tap->i1         = uint32_t(size - 1);
+                    tap->w          = 0;
+                    return;
+                }
+                tap->i0         = uint32_t(i0);
+                tap->i1         = uint32_t(i0 + 1);
+                tap->w          = uint32_t((pos >> 8) & 0xff);
+            }
+
+            static void lerp_rows(uint8_t *dst, const uint8_t *a, const uint8_t *b, uint32_t w, size_t count)
+            {
+                uint32_t wa     = 256 - w;
+                size_t i        = 0;
+
+            #ifdef __SSE2__
+                const __m128i vwa   = _mm_set1_epi16(int16_t(wa));
+                const __m128i vwb   = _mm_set1_epi16(int16_t(w));
+                const __m128i vrnd  = _mm_set1_epi16(0x80);
+                const __m128i zero  = _mm_setzero_si128();
+
+                for ( ; i + 16 <= count; i += 16)
+                {
+                    __m128i xa      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&a[i]));
+                    __m128i xb      = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&b[i]));
+
+                    // a*(256-w) + b*w fits unsigned 16 bits for 8-bit weights
+                    __m128i lo      = _mm_add_epi16(
+                        _mm_mullo_epi16(_mm_unpacklo_epi8(xa, zero), vwa),
+                        _mm_mullo_epi16(_mm_unpacklo_epi8(xb, zero), vwb));
+                    __m128i hi      = _mm_add_epi16(
+                        _mm_mullo_epi16(_mm_unpackhi_epi8(xa, zero), vwa),
+                        _mm_mullo_epi16(_mm_unpackhi_epi8(xb, zero), vwb));
+                    lo              = _mm_srli_epi16(_mm_add_epi16(lo, vrnd), 8);
+                    hi              = _mm_srli_epi16(_mm_add_epi16(hi, vrnd), 8);
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i]), _mm_packus_epi16(lo, hi));
+                }
+            #endif /* __SSE2__ */
+
+                for ( ; i < count; ++i)
+                    dst[i]          = uint8_t((a[i] * wa + b[i] * w + 0x80) >> 8);
+            }
+
+            status_t upscale_bilinear(
+                uint8_t *dst, size_t dw, size_t dh, size_t dst_stride,
+                const uint8_t *src, size_t sw, size_t sh, size_t src_stride,
+                size_t bpp, bool flip)
+            {
+                if ((dw <= 0) || (dh <= 0) || (sw <= 0) || (sh <= 0))
+                    return STATUS_OK;
+
+                // Allocate horizontal taps and the row after the vertical pass
+                size_t row_size     = sw * bpp;
+                uint8_t *ptr        = static_cast<uint8_t *>(malloc(dw * sizeof(scale_tap_t) + row_size));
+                if (ptr == NULL)
+                    return STATUS_NO_MEM;
+                scale_tap_t *taps   = reinterpret_cast<scale_tap_t *>(ptr);
+                uint8_t *row        = &ptr[dw * sizeof(scale_tap_t)];
+
+                size_t hstep        = (sw << 16) / dw;
+                size_t vstep        = (sh << 16) / dh;
+                for (size_t x=0; x<dw; ++x)
+                {
+                    compute_tap(&taps[x], x, hstep, sw);
+                    taps[x].i0         *= bpp;
+                    taps[x].i1         *= bpp;
+                }
+
+                for (size_t y=0; y<dh; ++y, dst += dst_stride)
+                {
+                    // Vertical pass
+                    scale_tap_t vt;
+                    compute_tap(&vt, y, vstep, sh);
+                    if (flip)
+                    {
+                        vt.i0               = uint32_t(sh - 1 - vt.i0);
+                        vt.i1               = uint32_t(sh - 1 - vt.i1);
+                    }
+                    const uint8_t *r0   = &src[vt.i0 * src_stride];
+                    const uint8_t *r1   = &src[vt.i1 * src_stride];
+                    const uint8_t *v    = r0;
+                    if (vt.w > 0)
+                    {
+                        lerp_rows(row, r0, r1, vt.w, row_size);
+                        v                   = row;
+                    }
+
+                    // Horizontal pass
+                    uint8_t *p          = dst;
+                    for (size_t x=0; x<dw; ++x)
+                    {
+                        const scale_tap_t *t= &taps[x];
+                        const uint8_t *a    = &v[t->i0];
+                        const uint8_t *b    = &v[t->i1];
+                        uint32_t wb         = t->w;
+                        uint32_t wa         = 256 - wb;
+                        for (size_t k=0; k<bpp; ++k)
+                            *(p++)              = uint8_t((a[k] * wa + b[k] * wb + 0x80) >> 8);
+                    }
+                }
+
+                free(ptr);
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/wgl/sort.h>
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t RADIX_BITS             = 11;
+            constexpr size_t RADIX_SIZE             = 1 << RADIX_BITS;
+            constexpr size_t RADIX_PASSES           = (32 + RADIX_BITS - 1) / RADIX_BITS;
+
+            void compute_depths(float *dst, const float *x, const float *y, const float *z, const float *row, size_t count)
+            {
+                size_t i = 0;
+
+            #ifdef __SSE2__
+                __m128 kx   = _mm_set1_ps(row[0]);
+                __m128 ky   = _mm_set1_ps(row[1]);
+                __m128 kz   = _mm_set1_ps(row[2]);
+                __m128 kw   = _mm_set1_ps(row[3]);
+
+                for ( ; i + 4 <= count; i += 4)
+                {
+                    __m128 d    = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(kx, _mm_loadu_ps(&x[i])), _mm_mul_ps(ky, _mm_loadu_ps(&y[i]))),
+                        _mm_add_ps(_mm_mul_ps(kz, _mm_loadu_ps(&z[i])), kw));
+                    _mm_storeu_ps(&dst[i], d);
+                }
+            #endif /* __SSE2__ */
+
+                for ( ; i < count; ++i)
+                    dst[i]      = row[0] * x[i] + row[1] * y[i] + row[2] * z[i] + row[3];
+            }
+
+            bool depth_row_changed(const float *a, const float *b, float epsilon)
+            {
+                for (size_t i=0; i<4; ++i)
+                {
+                    if (fabsf(a[i] - b[i]) > epsilon * (1.0f + fabsf(a[i])))
+                        return true;
+                }
+                return false;
+            }
+
+            static inline uint32_t float_key(float v)
+            {
+                // Map float to unsigned integer with the same order
+                union { float f; uint32_t u; } x;
+                x.f         = v;
+                return (x.u & 0x80000000) ? ~x.u : x.u | 0x80000000;
+            }
+
+            status_t sort_by_keys(uint32_t *order, const float *keys, size_t count, arena_t *arena)
+            {
+                if (count <= 1)
+                {
+                    if (count > 0)
+                        order[0]    = 0;
+                    return STATUS_OK;
+                }
+
+                arena_mark_t mark   = arena->mark();
+                uint32_t *buf   = arena->alloc<uint32_t>(count * 3 + RADIX_SIZE * RADIX_PASSES);
+                if (buf == NULL)
+                    return STATUS_NO_MEM;
+
+                uint32_t *ukeys = buf;
+                uint32_t *tmp   = &buf[count];
+                uint32_t *ukeys2= &buf[count * 2];
+                uint32_t *hist  = &buf[count * 3];
+
+                // Convert keys and compute histograms of all passes at once
+                for (size_t i=0; i<RADIX_SIZE * RADIX_PASSES; ++i)
+                    hist[i]         = 0;
+                for (size_t i=0; i<count; ++i)
+                {
+                    uint32_t k      = float_key(keys[i]);
+                    ukeys[i]        = k;
+                    order[i]        = uint32_t(i);
+                    for (size_t p=0; p<RADIX_PASSES; ++p)
+                        ++hist[p * RADIX_SIZE + ((k >> (p * RADIX_BITS)) & (RADIX_SIZE - 1))];
+                }
+
+                // Perform passes
+                uint32_t *src_o = order, *dst_o = tmp;
+                uint32_t *src_k = ukeys, *dst_k = ukeys2;
+                for (size_t p=0; p<RADIX_PASSES; ++p)
+                {
+                    uint32_t *h     = &hist[p * RADIX_SIZE];
+                    size_t shift    = p * RADIX_BITS;
+
+                    // Skip the pass if all keys fall into the same bucket
+                    if (h[(src_k[0] >> shift) & (RADIX_SIZE - 1)] == count)
+                        continue;
+
+                    // Compute offsets
+                    uint32_t sum    = 0;
+                    for (size_t i=0; i<RADIX_SIZE; ++i)
+                    {
+                        uint32_t n      = h[i];
+                        h[i]            = sum;
+                        sum            += n;
+                    }
+
+                    // Scatter elements
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        uint32_t k      = src_k[i];
+                        uint32_t pos    = h[(k >> shift) & (RADIX_SIZE - 1)]++;
+                        dst_o[pos]      = src_o[i];
+                        dst_k[pos]      = k;
+                    }
+
+                    uint32_t *t;
+                    t = src_o; src_o = dst_o; dst_o = t;
+                    t = src_k; src_k = dst_k; dst_k = t;
+                }
+
+                if (src_o != order)
+                {
+                    for (size_t i=0; i<count; ++i)
+                        order[i]        = src_o[i];
+                }
+
+                arena->release(mark);
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,509 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <private/sw/raster.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            namespace sw
+            {
+                static bool reserve(void **ptr, size_t *capacity, size_t required, size_t item_size)
+                {
+                    if (required <= *capacity)
+                        return true;
+
+                    size_t cap      = lsp_max(*capacity, size_t(64));
+                    while (cap < required)
+                        cap           <<= 1;
+
+                    void *data      = realloc(*ptr, cap * item_size);
+                    if (data == NULL)
+                        return false;
+
+                    *ptr            = data;
+                    *capacity       = cap;
+                    return true;
+                }
+
+                static inline uint32_t pack_color(float r, float g, float b, float a)
+                {
+                    r   = lsp_limit(r, 0.0f, 1.0f);
+                    g   = lsp_limit(g, 0.0f, 1.0f);
+                    b   = lsp_limit(b, 0.0f, 1.0f);
+                    a   = lsp_limit(a, 0.0f, 1.0f);
+
+                    return
+                        (uint32_t(r * 255.0f + 0.5f)) |
+                        (uint32_t(g * 255.0f + 0.5f) << 8) |
+                        (uint32_t(b * 255.0f + 0.5f) << 16) |
+                        (uint32_t(a * 255.0f + 0.5f) << 24);
+                }
+
+                static inline void set_plane(float *p, const svertex_t *v0, const svertex_t *v1, const svertex_t *v2,
+                    float a0, float a1, float a2, float inv_area)
+                {
+                    float dx1   = v1->x - v0->x, dy1 = v1->y - v0->y;
+                    float dx2   = v2->x - v0->x, dy2 = v2->y - v0->y;
+                    float da1   = a1 - a0, da2 = a2 - a0;
+
+                    p[0]        = (da1 * dy2 - da2 * dy1) * inv_area;
+                    p[1]        = (da2 * dx1 - da1 * dx2) * inv_area;
+                    p[2]        = a0 - p[0] * v0->x - p[1] * v0->y;
+                }
+
+                static inline void set_edge(float *e, const svertex_t *a, const svertex_t *b, float sign)
+                {
+                    e[0]        = (a->y - b->y) * sign;
+                    e[1]        = (b->x - a->x) * sign;
+                    e[2]        = (a->x * b->y - b->x * a->y) * sign;
+                }
+
+                void raster_t::construct()
+                {
+                    vColor          = NULL;
+                    vDepth          = NULL;
+                    nWidth          = 0;
+                    nHeight         = 0;
+                    nTilesX         = 0;
+                    nTilesY         = 0;
+                    vBins           = NULL;
+                    vTriangles      = NULL;
+                    nTriangles      = 0;
+                    nTriCapacity    = 0;
+                    bWorkers        = false;
+
+                    sWorkers.construct();
+                }
+
+                void raster_t::destroy()
+                {
+                    sWorkers.destroy();
+                    bWorkers        = false;
+
+                    if (vBins != NULL)
+                    {
+                        for (size_t i=0, n=nTilesX*nTilesY; i<n; ++i)
+                            free(vBins[i].vItems);
+                        free(vBins);
+                        vBins           = NULL;
+                    }
+                    if (vTriangles != NULL)
+                    {
+                        free(vTriangles);
+                        vTriangles      = NULL;
+                    }
+                    if (vColor != NULL)
+                    {
+                        free(vColor);
+                        vColor          = NULL;
+                    }
+                    if (vDepth != NULL)
+                    {
+                        free(vDepth);
+                        vDepth          = NULL;
+                    }
+
+                    nWidth          = 0;
+                    nHeight         = 0;
+                    nTilesX         = 0;
+                    nTilesY         = 0;
+                    nTriangles      = 0;
+                    nTriCapacity    = 0;
+                }
+
+                status_t raster_t::resize(size_t width, size_t height)
+                {
+                    if ((width == nWidth) && (height == nHeight))
+                        return STATUS_OK;
+
+                    size_t pixels   = width * height;
+                    size_t tx       = (width + TILE_SIZE - 1) >> TILE_SHIFT;
+                    size_t ty       = (height + TILE_SIZE - 1) >> TILE_SHIFT;
+
+                    uint32_t *color = static_cast<uint32_t *>(malloc(lsp_max(pixels, size_t(1)) * sizeof(uint32_t)));
+                    float *depth    = static_cast<float *>(malloc(lsp_max(pixels, size_t(1)) * sizeof(float)));
+                    bin_t *bins     = static_cast<bin_t *>(malloc(lsp_max(tx * ty, size_t(1)) * sizeof(bin_t)));
+                    if ((color == NULL) || (depth == NULL) || (bins == NULL))
+                    {
+                        free(color);
+                        free(depth);
+                        free(bins);
+                        return STATUS_NO_MEM;
+                    }
+
+                    for (size_t i=0, n=tx*ty; i<n; ++i)
+                    {
+                        bins[i].vItems      = NULL;
+                        bins[i].nItems      = 0;
+                        bins[i].nCapacity   = 0;
+                    }
+
+                    // Replace the buffers
+                    if (vBins != NULL)
+                    {
+                        for (size_t i=0, n=nTilesX*nTilesY; i<n; ++i)
+                            free(vBins[i].vItems);
+                        free(vBins);
+                    }
+                    free(vColor);
+                    free(vDepth);
+
+                    vColor          = color;
+                    vDepth          = depth;
+                    vBins           = bins;
+                    nWidth          = width;
+                    nHeight         = height;
+                    nTilesX         = tx;
+                    nTilesY         = ty;
+                    nTriangles      = 0;
+
+                    return STATUS_OK;
+                }
+
+                void raster_t::clear(const r3d::color_t *color)
+                {
+                    reset();
+
+                    uint32_t c      = pack_color(color->r, color->g, color->b, color->a);
+                    for (size_t i=0, n=nWidth*nHeight; i<n; ++i)
+                    {
+                        vColor[i]       = c;
+                        vDepth[i]       = 1.0f;
+                    }
+                }
+
+                void raster_t::reset()
+                {
+                    for (size_t i=0, n=nTilesX*nTilesY; i<n; ++i)
+                        vBins[i].nItems     = 0;
+                    nTriangles      = 0;
+                }
+
+                status_t raster_t::add_triangle(const svertex_t *v0, const svertex_t *v1, const svertex_t *v2, uint32_t flags)
+                {
+                    // Compute the signed area, front faces have negative area since Y axis looks down
+                    float area      = (v1->x - v0->x) * (v2->y - v0->y) - (v2->x - v0->x) * (v1->y - v0->y);
+                    if ((area == 0.0f) || (isnan(area)))
+                        return STATUS_OK;
+                    if ((flags & RF_CULL) && (area > 0.0f))
+                        return STATUS_OK;
+
+                    // Compute the bounding box
+                    float fl        = lsp_min(v0->x, lsp_min(v1->x, v2->x));
+                    float ft        = lsp_min(v0->y, lsp_min(v1->y, v2->y));
+                    float fr        = lsp_max(v0->x, lsp_max(v1->x, v2->x));
+                    float fb        = lsp_max(v0->y, lsp_max(v1->y, v2->y));
+                    fl              = lsp_max(fl, 0.0f);
+                    ft              = lsp_max(ft, 0.0f);
+                    fr              = lsp_min(fr, float(nWidth));
+                    fb              = lsp_min(fb, float(nHeight));
+                    if ((fl >= fr) || (ft >= fb))
+                        return STATUS_OK;
+
+                    if (!reserve(reinterpret_cast<void **>(&vTriangles), &nTriCapacity, nTriangles + 1, sizeof(triangle_t)))
+                        return STATUS_NO_MEM;
+
+                    // Setup the triangle
+                    triangle_t *t   = &vTriangles[nTriangles];
+                    float sign      = (area > 0.0f) ? 1.0f : -1.0f;
+                    float inv_area  = 1.0f / area;
+
+                    set_edge(t->e[0], v0, v1, sign);
+                    set_edge(t->e[1], v1, v2, sign);
+                    set_edge(t->e[2], v2, v0, sign);
+                    set_plane(t->z, v0, v1, v2, v0->z, v1->z, v2->z, inv_area);
+                    set_plane(t->iw, v0, v1, v2, v0->iw, v1->iw, v2->iw, inv_area);
+                    set_plane(t->c[0], v0, v1, v2, v0->c.r * v0->iw, v1->c.r * v1->iw, v2->c.r * v2->iw, inv_area);
+                    set_plane(t->c[1], v0, v1, v2, v0->c.g * v0->iw, v1->c.g * v1->iw, v2->c.g * v2->iw, inv_area);
+                    set_plane(t->c[2], v0, v1, v2, v0->c.b * v0->iw, v1->c.b * v1->iw, v2->c.b * v2->iw, inv_area);
+                    set_plane(t->c[3], v0, v1, v2, v0->c.a * v0->iw, v1->c.a * v1->iw, v2->c.a * v2->iw, inv_area);
+
+                    t->left         = int32_t(fl);
+                    t->top          = int32_t(ft);
+                    t->right        = int32_t(ceilf(fr));
+                    t->bottom       = int32_t(ceilf(fb));
+                    t->flags        = flags;
+
+                    // Distribute the triangle between tiles
+                    size_t tx0      = size_t(t->left) >> TILE_SHIFT;
+                    size_t ty0      = size_t(t->top) >> TILE_SHIFT;
+                    size_t tx1      = size_t(t->right - 1) >> TILE_SHIFT;
+                    size_t ty1      = size_t(t->bottom - 1) >> TILE_SHIFT;
+                    uint32_t index  = uint32_t(nTriangles);
+
+                    for (size_t ty=ty0; ty <= ty1; ++ty)
+                    {
+                        bin_t *bin      = &vBins[ty * nTilesX + tx0];
+                        for (size_t tx=tx0; tx <= tx1; ++tx, ++bin)
+                        {
+                            if (!reserve(reinterpret_cast<void **>(&bin->vItems), &bin->nCapacity, bin->nItems + 1, sizeof(uint32_t)))
+                                return STATUS_NO_MEM;
+                            bin->vItems[bin->nItems++]  = index;
+                        }
+                    }
+
+                    ++nTriangles;
+
+                    return STATUS_OK;
+                }
+
+                status_t raster_t::add_line(const svertex_t *v0, const svertex_t *v1, float width, uint32_t flags)
+                {
+                    float dx        = v1->x - v0->x;
+                    float dy        = v1->y - v0->y;
+                    float len       = sqrtf(dx*dx + dy*dy);
+                    if (len <= 1e-6f)
+                        return add_point(v0, width, flags);
+
+                    // Build the quad
+                    float k         = 0.5f * lsp_max(width, 1.0f) / len;
+                    float nx        = -dy * k;
+                    float ny        = dx * k;
+                    svertex_t q[4];
+
+                    q[0]            = *v0;
+                    q[1]            = *v1;
+                    q[2]            = *v1;
+                    q[3]            = *v0;
+                    q[0].x         += nx;
+                    q[0].y         += ny;
+                    q[1].x         += nx;
+                    q[1].y         += ny;
+                    q[2].x         -= nx;
+                    q[2].y         -= ny;
+                    q[3].x         -= nx;
+                    q[3].y         -= ny;
+
+                    flags          &= ~uint32_t(RF_CULL);
+                    status_t res    = add_triangle(&q[0], &q[1], &q[2], flags);
+                    if (res == STATUS_OK)
+                        res             = add_triangle(&q[0], &q[2], &q[3], flags);
+                    return res;
+                }
+
+                status_t raster_t::add_point(const svertex_t *v, float size, uint32_t flags)
+                {
+                    float h         = 0.5f * lsp_max(size, 1.0f);
+                    svertex_t q[4];
+
+                    q[0]            = *v;
+                    q[1]            = *v;
+                    q[2]            = *v;
+                    q[3]            = *v;
+                    q[0].x         -= h;
+                    q[0].y         -= h;
+                    q[1].x         += h;
+                    q[1].y         -= h;
+                    q[2].x         += h;
+                    q[2].y         += h;
+                    q[3].x         -= h;
+                    q[3].y         += h;
+
+                    flags          &= ~uint32_t(RF_CULL);
+                    status_t res    = add_triangle(&q[0], &q[1], &q[2], flags);
+                    if (res == STATUS_OK)
+                        res             = add_triangle(&q[0], &q[2], &q[3], flags);
+                    return res;
+                }
+
+                static void raster_span(
+                    const triangle_t *t, uint32_t *cp, float *dp,
+                    int32_t x0, int32_t x1, float yc)
+                {
+                    // Row constants of the planes
+                    const float z0  = t->z[1] * yc + t->z[2];
+                    const float w0  = t->iw[1] * yc + t->iw[2];
+                    const float r0  = t->c[0][1] * yc + t->c[0][2];
+                    const float g0  = t->c[1][1] * yc + t->c[1][2];
+                    const float b0  = t->c[2][1] * yc + t->c[2][2];
+                    const float a0  = t->c[3][1] * yc + t->c[3][2];
+                    const bool blend= t->flags & RF_BLEND;
+                    const bool std  = t->flags & RF_STD_BLEND;
+
+                    for (int32_t x=x0; x<x1; ++x)
+                    {
+                        float xc        = x + 0.5f;
+                        float z         = t->z[0] * xc + z0;
+                        if (z > dp[x])
+                            continue;
+
+                        float w         = 1.0f / (t->iw[0] * xc + w0);
+                        float r         = (t->c[0][0] * xc + r0) * w;
+                        float g         = (t->c[1][0] * xc + g0) * w;
+                        float b         = (t->c[2][0] * xc + b0) * w;
+                        float a         = (t->c[3][0] * xc + a0) * w;
+
+                        if (blend)
+                        {
+                            uint32_t dc     = cp[x];
+                            float k         = 1.0f / 255.0f;
+                            float ka        = lsp_limit(a, 0.0f, 1.0f);
+                            float ks        = (std) ? ka : 1.0f - ka;
+                            float kd        = 1.0f - ks;
+
+                            r               = r * ks + float(dc & 0xff) * k * kd;
+                            g               = g * ks + float((dc >> 8) & 0xff) * k * kd;
+                            b               = b * ks + float((dc >> 16) & 0xff) * k * kd;
+                            a               = a * ks + float(dc >> 24) * k * kd;
+                        }
+
+                        dp[x]           = z;
+                        cp[x]           = pack_color(r, g, b, a);
+                    }
+                }
+
+                static void raster_triangle(raster_t *r, const triangle_t *t, int32_t tl, int32_t tt, int32_t tr, int32_t tb)
+                {
+                    int32_t top     = lsp_max(t->top, tt);
+                    int32_t bottom  = lsp_min(t->bottom, tb);
+                    float left      = lsp_max(t->left, tl);
+                    float right     = lsp_min(t->right, tr);
+
+                    for (int32_t y=top; y<bottom; ++y)
+                    {
+                        // Compute the span covered by the triangle, pixel is covered
+                        // when all edge functions are non-negative at it's center. The top-left
+                        // fill rule: the center that lies exactly on the edge is covered only
+                        // when the edge is the left or the top one, so adjacent triangles
+                        // never draw the same pixel twice.
+                        float yc        = y + 0.5f;
+                        float xl        = left;
+                        float xr        = right;
+
+                        for (size_t i=0; i<3; ++i)
+                        {
+                            const float *e  = t->e[i];
+                            float d         = e[1] * yc + e[2];
+                            if (e[0] > 0.0f)            // Left edge, inclusive
+                                xl              = lsp_max(xl, ceilf(-d / e[0] - 0.5f));
+                            else if (e[0] < 0.0f)       // Right edge, exclusive
+                                xr              = lsp_min(xr, ceilf(-d / e[0] - 0.5f));
+                            else if ((d < 0.0f) || ((d == 0.0f) && (e[1] < 0.0f)))
+                                xr              = xl;   // Outside of horizontal edge or on the bottom one
+                        }
+
+                        if (xl >= xr)
+                            continue;
+
+                        size_t off      = size_t(y) * r->nWidth;
+                        raster_span(t, &r->vColor[off], &r->vDepth[off], int32_t(xl), int32_t(xr), yc);
+                    }
+                }
+
+                static void raster_tile(void *arg, size_t index)
+                {
+                    raster_t *r     = static_cast<raster_t *>(arg);
+                    const bin_t *bin= &r->vBins[index];
+                    if (bin->nItems <= 0)
+                        return;
+
+                    int32_t tl      = int32_t((index % r->nTilesX) << TILE_SHIFT);
+                    int32_t tt      = int32_t((index / r->nTilesX) << TILE_SHIFT);
+                    int32_t tr      = lsp_min(tl + int32_t(TILE_SIZE), int32_t(r->nWidth));
+                    int32_t tb      = lsp_min(tt + int32_t(TILE_SIZE), int32_t(r->nHeight));
+
+                    for (size_t i=0; i<bin->nItems; ++i)
+                        raster_triangle(r, &r->vTriangles[bin->vItems[i]], tl, tt, tr, tb);
+                }
+
+                void raster_t::flush()
+                {
+                    if (nTriangles <= 0)
+                        return;
+
+                    // Lazy start of worker threads
+                    if (!bWorkers)
+                    {
+                        bWorkers        = true;
+                        if (sWorkers.init(0) != STATUS_OK)
+                            lsp_warn("Could not start worker threads, rendering in single thread");
+                    }
+
+                    sWorkers.run(raster_tile, this, nTilesX * nTilesY);
+                    reset();
+                }
+
+                status_t raster_t::read(void *buf, r3d::pixel_format_t format)
+                {
+                    uint8_t *dst        = static_cast<uint8_t *>(buf);
+                    const uint32_t *src = vColor;
+                    size_t pixels       = nWidth * nHeight;
+
+                    switch (format)
+                    {
+                        case r3d::PIXEL_RGBA:
+                            for (size_t i=0; i<pixels; ++i, dst += 4)
+                            {
+                                uint32_t c  = src[i];
+                                dst[0]      = uint8_t(c);
+                                dst[1]      = uint8_t(c >> 8);
+                                dst[2]      = uint8_t(c >> 16);
+                                dst[3]      = uint8_t(c >> 24);
+                            }
+                            break;
+                        case r3d::PIXEL_BGRA:
+                            for (size_t i=0; i<pixels; ++i, dst += 4)
+                            {
+                                uint32_t c  = src[i];
+                                dst[0]      = uint8_t(c >> 16);
+                                dst[1]      = uint8_t(c >> 8);
+                                dst[2]      = uint8_t(c);
+                                dst[3]      = uint8_t(c >> 24);
+                            }
+                            break;
+                        case r3d::PIXEL_RGB:
+                            for (size_t i=0; i<pixels; ++i, dst += 3)
+                            {
+                                uint32_t c  = src[i];
+                                dst[0]      = uint8_t(c);
+                                dst[1]      = uint8_t(c >> 8);
+                                dst[2]      = uint8_t(c >> 16);
+                            }
+                            break;
+                        case r3d::PIXEL_BGR:
+                            for (size_t i=0; i<pixels; ++i, dst += 3)
+                            {
+                                uint32_t c  = src[i];
+                                dst[0]      = uint8_t(c >> 16);
+                                dst[1]      = uint8_t(c >> 8);
+                                dst[2]      = uint8_t(c);
+                            }
+                            break;
+                        default:
+                            return STATUS_BAD_ARGUMENTS;
+                    }
+
+                    return STATUS_OK;
+                }
+
+            } /* namespace sw */
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <private/sw/workers.h>
+
+#include <stdlib.h>
+
+#ifndef PLATFORM_WINDOWS
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            namespace sw
+            {
+            #ifdef PLATFORM_WINDOWS
+                static inline void mutex_init(mutex_t *m)       { ::InitializeSRWLock(m);                   }
+                static inline void mutex_destroy(mutex_t *m)    {                                           }
+                static inline void mutex_lock(mutex_t *m)       { ::AcquireSRWLockExclusive(m);             }
+                static inline void mutex_unlock(mutex_t *m)     { ::ReleaseSRWLockExclusive(m);             }
+                static inline void cond_init(cond_t *c)         { ::InitializeConditionVariable(c);         }
+                static inline void cond_destroy(cond_t *c)      {                                           }
+                static inline void cond_wait(cond_t *c, mutex_t *m) { ::SleepConditionVariableSRW(c, m, INFINITE, 0); }
+                static inline void cond_signal(cond_t *c)       { ::WakeConditionVariable(c);               }
+                static inline void cond_broadcast(cond_t *c)    { ::WakeAllConditionVariable(c);            }
+            #else
+                static inline void mutex_init(mutex_t *m)       { ::pthread_mutex_init(m, NULL);            }
+                static inline void mutex_destroy(mutex_t *m)    { ::pthread_mutex_destroy(m);               }
+                static inline void mutex_lock(mutex_t *m)       { ::pthread_mutex_lock(m);                  }
+                static inline void mutex_unlock(mutex_t *m)     { ::pthread_mutex_unlock(m);                }
+                static inline void cond_init(cond_t *c)         { ::pthread_cond_init(c, NULL);             }
+                static inline void cond_destroy(cond_t *c)      { ::pthread_cond_destroy(c);                }
+                static inline void cond_wait(cond_t *c, mutex_t *m) { ::pthread_cond_wait(c, m);            }
+                static inline void cond_signal(cond_t *c)       { ::pthread_cond_signal(c);                 }
+                static inline void cond_broadcast(cond_t *c)    { ::pthread_cond_broadcast(c);              }
+            #endif /* PLATFORM_WINDOWS */
+
+                static void process_items(workers_t *w, task_t task, void *arg, uint32_t items)
+                {
+                    while (true)
+                    {
+                        uint32_t index  = atomic_add(&w->nNext, uint32_t(1));
+                        if (index >= items)
+                            break;
+                        task(arg, index);
+                    }
+                }
+
+                static void worker_loop(workers_t *w)
+                {
+                    uint32_t generation = 0;
+
+                    mutex_lock(&w->sMutex);
+                    while (true)
+                    {
+                        while ((w->nGeneration == generation) && (!w->bExit))
+                            cond_wait(&w->sStart, &w->sMutex);
+                        if (w->bExit)
+                            break;
+
+                        // Fetch the task and process items
+                        generation      = w->nGeneration;
+                        task_t task     = w->pTask;
+                        void *arg       = w->pArg;
+                        uint32_t items  = w->nItems;
+                        mutex_unlock(&w->sMutex);
+
+                        process_items(w, task, arg, items);
+
+                        mutex_lock(&w->sMutex);
+                        if ((--w->nPending) == 0)
+                            cond_signal(&w->sDone);
+                    }
+                    mutex_unlock(&w->sMutex);
+                }
+
+            #ifdef PLATFORM_WINDOWS
+                static DWORD WINAPI worker_thread(LPVOID arg)
+                {
+                    worker_loop(static_cast<workers_t *>(arg));
+                    return 0;
+                }
+            #else
+                static void *worker_thread(void *arg)
+                {
+                    worker_loop(static_cast<workers_t *>(arg));
+                    return NULL;
+                }
+            #endif /* PLATFORM_WINDOWS */
+
+                void workers_t::construct()
+                {
+                    vThreads    = NULL;
+                    nThreads    = 0;
+                    pTask       = NULL;
+                    pArg        = NULL;
+                    nItems      = 0;
+                    nNext       = 0;
+                    nPending    = 0;
+                    nGeneration = 0;
+                    bExit       = false;
+
+                    mutex_init(&sMutex);
+                    cond_init(&sStart);
+                    cond_init(&sDone);
+                }
+
+                void workers_t::destroy()
+                {
+                    if (vThreads != NULL)
+                    {
+                        // Notify threads to leave
+                        mutex_lock(&sMutex);
+                        bExit       = true;
+                        cond_broadcast(&sStart);
+                        mutex_unlock(&sMutex);
+
+                        // Wait for threads
+                        for (size_t i=0; i<nThreads; ++i)
+                        {
+                        #ifdef PLATFORM_WINDOWS
+                            ::WaitForSingleObject(vThreads[i], INFINITE);
+                            ::CloseHandle(vThreads[i]);
+                        #else
+                            ::pthread_join(vThreads[i], NULL);
+                        #endif /* PLATFORM_WINDOWS */
+                        }
+
+                        free(vThreads);
+                        vThreads    = NULL;
+                    }
+
+                    nThreads    = 0;
+                    bExit       = false;
+
+                    cond_destroy(&sDone);
+                    cond_destroy(&sStart);
+                    mutex_destroy(&sMutex);
+                }
+
+                status_t workers_t::init(size_t threads)
+                {
+                    if (vThreads != NULL)
+                        return STATUS_BAD_STATE;
+                    if (threads == 0)
+                        threads     = processors() - 1;
+                    if (threads == 0)
+                        return STATUS_OK;
+
+                    vThreads    = static_cast<thread_t *>(malloc(sizeof(thread_t) * threads));
+                    if (vThreads == NULL)
+                        return STATUS_NO_MEM;
+
+                    for (nThreads = 0; nThreads < threads; ++nThreads)
+                    {
+                    #ifdef PLATFORM_WINDOWS
+                        vThreads[nThreads] = ::CreateThread(NULL, 0, worker_thread, this, 0, NULL);
+                        if (vThreads[nThreads] == NULL)
+                            break;
+                    #else
+                        if (::pthread_create(&vThreads[nThreads], NULL, worker_thread, this) != 0)
+                            break;
+                    #endif /* PLATFORM_WINDOWS */
+                    }
+
+                    // Work with the number of threads we managed to create
+                    if (nThreads < threads)
+                        lsp_warn("Created only %d worker threads of %d", int(nThreads), int(threads));
+
+                    return STATUS_OK;
+                }
+
+                void workers_t::run(task_t task, void *arg, size_t items)
+                {
+                    if (items <= 0)
+                        return;
+
+                    // Process small amount of items in the caller thread
+                    if ((nThreads <= 0) || (items <= 1))
+                    {
+                        for (size_t i=0; i<items; ++i)
+                            task(arg, i);
+                        return;
+                    }
+
+                    // Start the workers
+                    mutex_lock(&sMutex);
+                    pTask       = task;
+                    pArg        = arg;
+                    nItems      = uint32_t(items);
+                    atomic_store(&nNext, uint32_t(0));
+                    nPending    = uint32_t(nThreads);
+                    ++nGeneration;
+                    cond_broadcast(&sStart);
+                    mutex_unlock(&sMutex);
+
+                    // Participate in processing
+                    process_items(this, task, arg, uint32_t(items));
+
+                    // Wait for completion
+                    mutex_lock(&sMutex);
+                    while (nPending > 0)
+                        cond_wait(&sDone, &sMutex);
+                    mutex_unlock(&sMutex);
+                }
+
+                size_t workers_t::processors()
+                {
+                #ifdef PLATFORM_WINDOWS
+                    SYSTEM_INFO si;
+                    ::GetSystemInfo(&si);
+                    ssize_t count   = si.dwNumberOfProcessors;
+                #else
+                    ssize_t count   = ::sysconf(_SC_NPROCESSORS_ONLN);
+                #endif /* PLATFORM_WINDOWS */
+                    return (count > 0) ? count : 1;
+                }
+
+            } /* namespace sw */
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,574 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/r3d/wgl/sw_backend.h>
+#include <private/sw/raster.h>
+#include <private/wgl/arena.h>
+#include <private/wgl/fxaa.h>
+#include <private/wgl/matrix.h>
+
+#include <stdlib.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr float SW_GLOBAL_AMBIENT       = 0.2f;     // Default global ambient intensity of OpenGL
+            constexpr float SW_CLIP_EPSILON         = 1e-6f;
+
+            sw_backend_t::sw_backend_t()
+            {
+                construct();
+            }
+
+            void sw_backend_t::construct()
+            {
+                pRaster         = NULL;
+                vVertices       = NULL;
+                nVertices       = 0;
+                nLights         = 0;
+                bDrawing        = false;
+                bFxaa           = false;
+                vPixels         = NULL;
+                nPixelsCap      = 0;
+
+                base_backend_t::construct();
+
+                // Export virtual table
+                #define R3D_SW_BACKEND_EXP(func)   r3d::backend_t::func = sw_backend_t::func;
+                R3D_SW_BACKEND_EXP(init_window);
+                R3D_SW_BACKEND_EXP(init_offscreen);
+                R3D_SW_BACKEND_EXP(destroy);
+                R3D_SW_BACKEND_EXP(locate);
+
+                R3D_SW_BACKEND_EXP(start);
+                R3D_SW_BACKEND_EXP(sync);
+                R3D_SW_BACKEND_EXP(read_pixels);
+                R3D_SW_BACKEND_EXP(finish);
+
+                R3D_SW_BACKEND_EXP(set_lights);
+                R3D_SW_BACKEND_EXP(draw_primitives);
+
+                #undef R3D_SW_BACKEND_EXP
+            }
+
+            void sw_backend_t::destroy(r3d::backend_t *handle)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+
+                if (_this->pRaster != NULL)
+                {
+                    _this->pRaster->destroy();
+                    free(_this->pRaster);
+                    _this->pRaster      = NULL;
+                }
+                if (_this->vVertices != NULL)
+                {
+                    free(_this->vVertices);
+                    _this->vVertices    = NULL;
+                }
+                _this->nVertices    = 0;
+                if (_this->vPixels != NULL)
+                {
+                    free(_this->vPixels);
+                    _this->vPixels      = NULL;
+                }
+                _this->nPixelsCap   = 0;
+
+                // Call parent structure for destroy
+                r3d::base_backend_t::destroy(handle);
+            }
+
+            status_t sw_backend_t::init_window(r3d::backend_t *handle, void **out_window)
+            {
+                return STATUS_NOT_SUPPORTED;
+            }
+
+            status_t sw_backend_t::init_offscreen(r3d::backend_t *handle)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if (_this->pRaster != NULL)
+                    return STATUS_BAD_STATE;
+
+                sw::raster_t *r     = static_cast<sw::raster_t *>(malloc(sizeof(sw::raster_t)));
+                if (r == NULL)
+                    return STATUS_NO_MEM;
+                r->construct();
+                _this->pRaster      = r;
+
+                return STATUS_OK;
+            }
+
+            status_t sw_backend_t::locate(r3d::backend_t *handle, ssize_t left, ssize_t top, ssize_t width, ssize_t height)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+                if ((width < 0) || (height < 0))
+                    return STATUS_BAD_ARGUMENTS;
+
+                status_t res = _this->pRaster->resize(width, height);
+                if (res != STATUS_OK)
+                    return res;
+
+                // Update parameters
+                _this->viewLeft    = left;
+                _this->viewTop     = top;
+                _this->viewWidth   = width;
+                _this->viewHeight  = height;
+
+                return STATUS_OK;
+            }
+
+            status_t sw_backend_t::start(r3d::backend_t *handle)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                _this->pRaster->clear(&_this->colBackground);
+                _this->nLights      = 0;
+                _this->bDrawing     = true;
+
+                return STATUS_OK;
+            }
+
+            status_t sw_backend_t::set_lights(r3d::backend_t *handle, const r3d::light_t *lights, size_t count)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                size_t n = 0;
+                for (size_t i=0; (i<count) && (n < SW_MAX_LIGHTS); ++i)
+                {
+                    switch (lights[i].type)
+                    {
+                        case r3d::LIGHT_NONE:
+                            continue;
+                        case r3d::LIGHT_POINT:
+                        case r3d::LIGHT_DIRECTIONAL:
+                        case r3d::LIGHT_SPOT:
+                            _this->vLights[n++] = lights[i];
+                            break;
+                        default:
+                            _this->nLights      = n;
+                            return STATUS_INVALID_VALUE;
+                    }
+                }
+                _this->nLights      = n;
+
+                return STATUS_OK;
+            }
+
+            static inline void normalize(float &x, float &y, float &z)
+            {
+                float len = sqrtf(x*x + y*y + z*z);
+                if (len > 0.0f)
+                {
+                    len     = 1.0f / len;
+                    x      *= len;
+                    y      *= len;
+                    z      *= len;
+                }
+            }
+
+            /**
+             * Compute the vertex color using the fixed-function OpenGL lighting model
+             * with color material enabled for ambient and diffuse components
+             */
+            static void shade(r3d::color_t *dst, const r3d::color_t *c, const r3d::dot4_t *p, const r3d::vec4_t *n,
+                const r3d::light_t *lights, size_t count)
+            {
+                float r = SW_GLOBAL_AMBIENT * c->r;
+                float g = SW_GLOBAL_AMBIENT * c->g;
+                float b = SW_GLOBAL_AMBIENT * c->b;
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    const r3d::light_t *l = &lights[i];
+                    float lx, ly, lz, att = 1.0f;
+
+                    if (l->type == r3d::LIGHT_DIRECTIONAL)
+                    {
+                        lx      = l->direction.dx;
+                        ly      = l->direction.dy;
+                        lz      = l->direction.dz;
+                        normalize(lx, ly, lz);
+                    }
+                    else
+                    {
+                        lx      = l->position.x - p->x;
+                        ly      = l->position.y - p->y;
+                        lz      = l->position.z - p->z;
+                        float d = sqrtf(lx*lx + ly*ly + lz*lz);
+                        normalize(lx, ly, lz);
+
+                        if (l->type == r3d::LIGHT_SPOT)
+                        {
+                            float k = l->constant + (l->linear + l->quadratic * d) * d;
+                            att     = (k > 0.0f) ? 1.0f / k : 1.0f;
+
+                            // Check spot cone
+                            float sx = l->direction.dx, sy = l->direction.dy, sz = l->direction.dz;
+                            normalize(sx, sy, sz);
+                            float cosa = -(lx*sx + ly*sy + lz*sz);
+                            if ((l->cutoff < 180.0f) && (cosa < cosf(l->cutoff * M_PI / 180.0f)))
+                                att     = 0.0f;
+                        }
+                    }
+
+                    float ndl   = lsp_max(n->dx * lx + n->dy * ly + n->dz * lz, 0.0f);
+                    r          += att * (l->ambient.r + ndl * l->diffuse.r) * c->r;
+                    g          += att * (l->ambient.g + ndl * l->diffuse.g) * c->g;
+                    b          += att * (l->ambient.b + ndl * l->diffuse.b) * c->b;
+                }
+
+                dst->r  = r;
+                dst->g  = g;
+                dst->b  = b;
+                dst->a  = c->a;
+            }
+
+            static inline void to_screen(sw::svertex_t *s, const sw::cvertex_t *c, float width, float height)
+            {
+                float iw    = 1.0f / c->p.w;
+                s->x        = (c->p.x * iw * 0.5f + 0.5f) * width;
+                s->y        = (0.5f - c->p.y * iw * 0.5f) * height;
+                s->z        = c->p.z * iw * 0.5f + 0.5f;
+                s->iw       = iw;
+                s->c        = c->c;
+            }
+
+            static inline void lerp(sw::cvertex_t *r, const sw::cvertex_t *a, const sw::cvertex_t *b, float k)
+            {
+                r->p.x      = a->p.x + (b->p.x - a->p.x) * k;
+                r->p.y      = a->p.y + (b->p.y - a->p.y) * k;
+                r->p.z      = a->p.z + (b->p.z - a->p.z) * k;
+                r->p.w      = a->p.w + (b->p.w - a->p.w) * k;
+                r->c.r      = a->c.r + (b->c.r - a->c.r) * k;
+                r->c.g      = a->c.g + (b->c.g - a->c.g) * k;
+                r->c.b      = a->c.b + (b->c.b - a->c.b) * k;
+                r->c.a      = a->c.a + (b->c.a - a->c.a) * k;
+            }
+
+            static inline float near_distance(const sw::cvertex_t *v)
+            {
+                // Distance to the near clipping plane z = -w
+                return v->p.z + v->p.w - SW_CLIP_EPSILON;
+            }
+
+            static status_t emit_triangle(sw_backend_t *_this, const sw::cvertex_t *v0, const sw::cvertex_t *v1, const sw::cvertex_t *v2, uint32_t flags)
+            {
+                const sw::cvertex_t *in[3] = { v0, v1, v2 };
+                sw::cvertex_t poly[4];
+                size_t n = 0;
+
+                // Clip the triangle by the near plane
+                for (size_t i=0; i<3; ++i)
+                {
+                    const sw::cvertex_t *a = in[i];
+                    const sw::cvertex_t *b = in[(i + 1) % 3];
+                    float da = near_distance(a), db = near_distance(b);
+
+                    if (da >= 0.0f)
+                        poly[n++]   = *a;
+                    if ((da >= 0.0f) != (db >= 0.0f))
+                        lerp(&poly[n++], a, b, da / (da - db));
+                }
+                if (n < 3)
+                    return STATUS_OK;
+
+                // Emit the triangle fan
+                float w = _this->viewWidth, h = _this->viewHeight;
+                sw::svertex_t s[4];
+                for (size_t i=0; i<n; ++i)
+                    to_screen(&s[i], &poly[i], w, h);
+
+                for (size_t i=2; i<n; ++i)
+                {
+                    status_t res = _this->pRaster->add_triangle(&s[0], &s[i-1], &s[i], flags);
+                    if (res != STATUS_OK)
+                        return res;
+                }
+
+                return STATUS_OK;
+            }
+
+            static status_t emit_line(sw_backend_t *_this, const sw::cvertex_t *v0, const sw::cvertex_t *v1, float width, uint32_t flags)
+            {
+                sw::cvertex_t a = *v0, b = *v1;
+                float da = near_distance(&a), db = near_distance(&b);
+                if ((da < 0.0f) && (db < 0.0f))
+                    return STATUS_OK;
+                if (da < 0.0f)
+                    lerp(&a, v0, v1, da / (da - db));
+                else if (db < 0.0f)
+                    lerp(&b, v0, v1, da / (da - db));
+
+                float w = _this->viewWidth, h = _this->viewHeight;
+                sw::svertex_t s[2];
+                to_screen(&s[0], &a, w, h);
+                to_screen(&s[1], &b, w, h);
+
+                return _this->pRaster->add_line(&s[0], &s[1], width, flags);
+            }
+
+            static status_t emit_point(sw_backend_t *_this, const sw::cvertex_t *v, float size, uint32_t flags)
+            {
+                if (near_distance(v) < 0.0f)
+                    return STATUS_OK;
+
+                sw::svertex_t s;
+                to_screen(&s, v, _this->viewWidth, _this->viewHeight);
+                return _this->pRaster->add_point(&s, size, flags);
+            }
+
+            status_t sw_backend_t::draw_primitives(r3d::backend_t *handle, const r3d::buffer_t *buffer)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+
+                if (buffer == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((_this->pRaster == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                // Is there any data to draw?
+                if (buffer->count <= 0)
+                    return STATUS_OK;
+
+                // Check primitive type to draw
+                size_t count = buffer->count;
+                switch (buffer->type)
+                {
+                    case r3d::PRIMITIVE_TRIANGLES:
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        count   = (count << 1) + count; // count *= 3
+                        break;
+                    case r3d::PRIMITIVE_LINES:
+                        count <<= 1;                    // count *= 2
+                        break;
+                    case r3d::PRIMITIVE_POINTS:
+                        break;
+                    default:
+                        return STATUS_BAD_ARGUMENTS;
+                }
+
+                if (buffer->vertex.data == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((buffer->normal.data == NULL) && (buffer->normal.index != NULL))
+                    return STATUS_BAD_ARGUMENTS;
+                if ((buffer->color.data == NULL) && (buffer->color.index != NULL))
+                    return STATUS_BAD_ARGUMENTS;
+
+                // Allocate the vertex buffer
+                if (_this->nVertices < count)
+                {
+                    sw::cvertex_t *v    = static_cast<sw::cvertex_t *>(realloc(_this->vVertices, count * sizeof(sw::cvertex_t)));
+                    if (v == NULL)
+                        return STATUS_NO_MEM;
+                    _this->vVertices    = v;
+                    _this->nVertices    = count;
+                }
+
+                // Compute matrices
+                r3d::mat4_t vw, mv, mvp;
+                matrix_mul(&vw, &_this->matView, &_this->matWorld);
+                matrix_mul(&mv, &vw, &buffer->model);
+                matrix_mul(&mvp, &_this->matProjection, &mv);
+
+                // Transform vertices
+                const uint32_t *vindex  = buffer->vertex.index;
+                const uint32_t *nindex  = buffer->normal.index;
+                const uint32_t *cindex  = buffer->color.index;
+                const uint8_t  *vbuf    = reinterpret_cast<const uint8_t *>(buffer->vertex.data);
+                const uint8_t  *nbuf    = reinterpret_cast<const uint8_t *>(buffer->normal.data);
+                const uint8_t  *cbuf    = reinterpret_cast<const uint8_t *>(buffer->color.data);
+                size_t vstride          = (buffer->vertex.stride == 0) ? sizeof(r3d::dot4_t)  : buffer->vertex.stride;
+                size_t nstride          = (buffer->normal.stride == 0) ? sizeof(r3d::vec4_t)  : buffer->normal.stride;
+                size_t cstride          = (buffer->color.stride == 0)  ? sizeof(r3d::color_t) : buffer->color.stride;
+                bool lighting           = buffer->flags & r3d::BUFFER_LIGHTING;
+                r3d::vec4_t dfl_normal  = { 0.0f, 0.0f, 1.0f, 0.0f };
+                // Unindexed normals and colors are per element when there are normal or color
+                // indices, the same as for the OpenGL backend
+                bool separate           = (nindex != NULL) || (cindex != NULL);
+
+                sw::cvertex_t *cv       = _this->vVertices;
+                for (size_t i=0; i<count; ++i, ++cv)
+                {
+                    size_t vi   = (vindex != NULL) ? vindex[i] : i;
+                    size_t ui   = (separate) ? i : vi;
+                    size_t ni   = (nindex != NULL) ? nindex[i] : ui;
+                    size_t ci   = (cindex != NULL) ? cindex[i] : ui;
+
+                    const r3d::dot4_t *p    = reinterpret_cast<const r3d::dot4_t *>(&vbuf[vi * vstride]);
+                    const r3d::color_t *c   = (cbuf != NULL) ? reinterpret_cast<const r3d::color_t *>(&cbuf[ci * cstride]) : &buffer->color.dfl;
+
+                    matrix_apply(&cv->p, &mvp, p);
+                    if (!lighting)
+                    {
+                        cv->c       = *c;
+                        continue;
+                    }
+
+                    // Compute lighting in the eye space
+                    const r3d::vec4_t *n    = (nbuf != NULL) ? reinterpret_cast<const r3d::vec4_t *>(&nbuf[ni * nstride]) : &dfl_normal;
+                    r3d::dot4_t pe;
+                    r3d::vec4_t ne;
+                    matrix_apply(&pe, &mv, p);
+                    matrix_apply3(&ne, &mv, n);
+                    if ((pe.w != 0.0f) && (pe.w != 1.0f))
+                    {
+                        float k     = 1.0f / pe.w;
+                        pe.x       *= k;
+                        pe.y       *= k;
+                        pe.z       *= k;
+                    }
+                    normalize(ne.dx, ne.dy, ne.dz);
+
+                    shade(&cv->c, c, &pe, &ne, _this->vLights, _this->nLights);
+                }
+
+                // Assemble primitives
+                uint32_t flags          = 0;
+                if (buffer->flags & r3d::BUFFER_BLENDING)
+                {
+                    flags                  |= sw::RF_BLEND;
+                    if (buffer->flags & r3d::BUFFER_STD_BLENDING)
+                        flags                  |= sw::RF_STD_BLEND;
+                }
+                if (!(buffer->flags & r3d::BUFFER_NO_CULLING))
+                    flags                  |= sw::RF_CULL;
+
+                status_t res            = STATUS_OK;
+                cv                      = _this->vVertices;
+
+                switch (buffer->type)
+                {
+                    case r3d::PRIMITIVE_TRIANGLES:
+                        for (size_t i=0; (i<count) && (res == STATUS_OK); i += 3)
+                            res = emit_triangle(_this, &cv[i], &cv[i+1], &cv[i+2], flags);
+                        break;
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        for (size_t i=0; (i<count) && (res == STATUS_OK); i += 3)
+                        {
+                            res = emit_line(_this, &cv[i], &cv[i+1], buffer->width, flags);
+                            if (res == STATUS_OK)
+                                res = emit_line(_this, &cv[i+1], &cv[i+2], buffer->width, flags);
+                            if (res == STATUS_OK)
+                                res = emit_line(_this, &cv[i+2], &cv[i], buffer->width, flags);
+                        }
+                        break;
+                    case r3d::PRIMITIVE_LINES:
+                        for (size_t i=0; (i<count) && (res == STATUS_OK); i += 2)
+                            res = emit_line(_this, &cv[i], &cv[i+1], buffer->width, flags);
+                        break;
+                    case r3d::PRIMITIVE_POINTS:
+                        for (size_t i=0; (i<count) && (res == STATUS_OK); ++i)
+                            res = emit_point(_this, &cv[i], buffer->width, flags);
+                        break;
+                    default:
+                        break;
+                }
+
+                return res;
+            }
+
+            status_t sw_backend_t::sync(r3d::backend_t *handle)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                _this->pRaster->flush();
+                return STATUS_OK;
+            }
+
+            status_t sw_backend_t::read_pixels(r3d::backend_t *handle, void *buf, r3d::pixel_format_t format)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                _this->pRaster->flush();
+                if (!_this->bFxaa)
+                    return _this->pRaster->read(buf, format);
+
+                // Read pixels into the temporary buffer and filter them into the caller's buffer
+                size_t bpp          = ((format == r3d::PIXEL_RGB) || (format == r3d::PIXEL_BGR)) ? 3 : 4;
+                size_t row_size     = _this->viewWidth * bpp;
+                size_t size         = row_size * _this->viewHeight;
+                if (size > _this->nPixelsCap)
+                {
+                    uint8_t *ptr        = static_cast<uint8_t *>(realloc(_this->vPixels, size));
+                    if (ptr == NULL)
+                        return STATUS_NO_MEM;
+                    _this->vPixels      = ptr;
+                    _this->nPixelsCap   = size;
+                }
+
+                status_t res        = _this->pRaster->read(_this->vPixels, format);
+                if (res != STATUS_OK)
+                    return res;
+
+                arena_t arena;
+                arena.construct();
+                res                 = fxaa(
+                    static_cast<uint8_t *>(buf), row_size,
+                    _this->vPixels, row_size,
+                    _this->viewWidth, _this->viewHeight, bpp,
+                    &arena);
+                arena.destroy();
+
+                return res;
+            }
+
+            status_t sw_backend_t::finish(r3d::backend_t *handle)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (!_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                // Drop primitives that have not been read
+                _this->pRaster->reset();
+                _this->bDrawing     = false;
+
+                return STATUS_OK;
+            }
+
+            status_t sw_backend_t::set_fxaa(r3d::backend_t *handle, bool enable)
+            {
+                sw_backend_t *_this = static_cast<sw_backend_t *>(handle);
+                if ((_this->pRaster == NULL) || (_this->bDrawing))
+                    return STATUS_BAD_STATE;
+
+                _this->bFxaa        = enable;
+                return STATUS_OK;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
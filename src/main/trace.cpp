@@ -0,0 +1,904 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/r3d/wgl/trace.h>
+#include <private/wgl/mapping.h>
+#include <private/wgl/matrix.h>
+#include <private/wgl/trace.h>
+
+#include <stdlib.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+    #include <lsp-plug.in/r3d/wgl/backend.h>
+#else
+    #include <time.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            constexpr size_t TRACE_HASH_INITIAL     = 0x100;
+
+            static inline size_t trace_align(size_t size)
+            {
+                return (size + TRACE_ALIGN - 1) & ~(TRACE_ALIGN - 1);
+            }
+
+            static uint64_t content_hash(const void *data, size_t size)
+            {
+                // FNV-1a over 64-bit words with final avalanche
+                const uint8_t *p    = static_cast<const uint8_t *>(data);
+                uint64_t h          = 0xcbf29ce484222325ULL;
+                for ( ; size >= sizeof(uint64_t); size -= sizeof(uint64_t), p += sizeof(uint64_t))
+                {
+                    uint64_t w;
+                    memcpy(&w, p, sizeof(w));
+                    h                   = (h ^ w) * 0x100000001b3ULL;
+                }
+                for ( ; size > 0; --size, ++p)
+                    h                   = (h ^ *p) * 0x100000001b3ULL;
+
+                h  ^= h >> 33;
+                h  *= 0xff51afd7ed558ccdULL;
+                h  ^= h >> 33;
+
+                return (h != 0) ? h : 1;
+            }
+
+            static size_t index_extent(const uint32_t *index, size_t count)
+            {
+                uint32_t max = 0;
+                for (size_t i=0; i<count; ++i)
+                    max         = lsp_max(max, index[i]);
+                return size_t(max) + 1;
+            }
+
+            static inline size_t array_size(size_t items, size_t stride, size_t item_size)
+            {
+                return (items > 0) ? (items - 1) * stride + item_size : 0;
+            }
+
+            //-----------------------------------------------------------------
+            // Trace writer
+            void trace_writer_t::construct()
+            {
+                pFD         = NULL;
+                vHash       = NULL;
+                nHashCap    = 0;
+                nBlobs      = 0;
+                nError      = STATUS_OK;
+            }
+
+            void trace_writer_t::destroy()
+            {
+                close();
+            }
+
+            status_t trace_writer_t::open(const char *path)
+            {
+                if (path == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if (pFD != NULL)
+                    return STATUS_OPENED;
+
+                vHash       = static_cast<trace_hash_t *>(calloc(TRACE_HASH_INITIAL, sizeof(trace_hash_t)));
+                if (vHash == NULL)
+                    return STATUS_NO_MEM;
+                nHashCap    = TRACE_HASH_INITIAL;
+                nBlobs      = 0;
+                nError      = STATUS_OK;
+
+                pFD             = open_file(path, "wb");
+                if (pFD == NULL)
+                {
+                    close();
+                    return STATUS_IO_ERROR;
+                }
+
+                trace_file_t hdr;
+                memset(&hdr, 0, sizeof(hdr));
+                hdr.magic       = TRACE_MAGIC;
+                hdr.version     = TRACE_VERSION;
+                if (fwrite(&hdr, sizeof(hdr), 1, pFD) != 1)
+                {
+                    close();
+                    return STATUS_IO_ERROR;
+                }
+
+                return STATUS_OK;
+            }
+
+            status_t trace_writer_t::close()
+            {
+                status_t res    = nError;
+                if (pFD != NULL)
+                {
+                    if ((fclose(pFD) != 0) && (res == STATUS_OK))
+                        res             = STATUS_IO_ERROR;
+                    pFD             = NULL;
+                }
+                if (vHash != NULL)
+                {
+                    free(vHash);
+                    vHash           = NULL;
+                }
+                nHashCap        = 0;
+                nBlobs          = 0;
+                nError          = STATUS_OK;
+
+                return res;
+            }
+
+            static void write_record(trace_writer_t *w, uint32_t type, const void *a, size_t na, const void *b, size_t nb)
+            {
+                static const uint8_t padding[TRACE_ALIGN] = { 0 };
+
+                if ((w->pFD == NULL) || (w->nError != STATUS_OK))
+                    return;
+
+                trace_record_t rec;
+                rec.type        = type;
+                rec.size        = uint32_t(na + nb);
+                size_t pad      = trace_align(sizeof(rec) + na + nb) - (sizeof(rec) + na + nb);
+
+                bool ok         = fwrite(&rec, sizeof(rec), 1, w->pFD) == 1;
+                if ((ok) && (na > 0))
+                    ok              = fwrite(a, na, 1, w->pFD) == 1;
+                if ((ok) && (nb > 0))
+                    ok              = fwrite(b, nb, 1, w->pFD) == 1;
+                if ((ok) && (pad > 0))
+                    ok              = fwrite(padding, pad, 1, w->pFD) == 1;
+
+                if (!ok)
+                {
+                    lsp_warn("Failed to write trace record, tracing is stopped");
+                    w->nError       = STATUS_IO_ERROR;
+                }
+            }
+
+            static bool grow_hash(trace_writer_t *w)
+            {
+                size_t cap          = w->nHashCap << 1;
+                trace_hash_t *h     = static_cast<trace_hash_t *>(calloc(cap, sizeof(trace_hash_t)));
+                if (h == NULL)
+                    return false;
+
+                for (size_t i=0; i<w->nHashCap; ++i)
+                {
+                    const trace_hash_t *e = &w->vHash[i];
+                    if (e->hash == 0)
+                        continue;
+                    size_t j            = e->hash & (cap - 1);
+                    while (h[j].hash != 0)
+                        j                   = (j + 1) & (cap - 1);
+                    h[j]                = *e;
+                }
+
+                free(w->vHash);
+                w->vHash            = h;
+                w->nHashCap         = cap;
+                return true;
+            }
+
+            /**
+             * Emit the blob record if the blob with the same content has not been written yet
+             * @return identifier of the blob, 0 if there is no data
+             */
+            static uint32_t write_blob(trace_writer_t *w, const void *data, size_t size)
+            {
+                if ((data == NULL) || (size <= 0) || (w->nError != STATUS_OK))
+                    return 0;
+                if (size > 0xffffffff)
+                {
+                    w->nError           = STATUS_OVERFLOW;
+                    return 0;
+                }
+
+                // Lookup for the blob with the same content
+                uint64_t hash       = content_hash(data, size);
+                size_t mask         = w->nHashCap - 1;
+                size_t j            = hash & mask;
+                for ( ; w->vHash[j].hash != 0; j = (j + 1) & mask)
+                {
+                    const trace_hash_t *e = &w->vHash[j];
+                    if ((e->hash == hash) && (e->size == size))
+                        return e->id;
+                }
+
+                // Emit new blob
+                trace_blob_t blob;
+                blob.id             = uint32_t(++w->nBlobs);
+                blob.size           = uint32_t(size);
+                write_record(w, TRACE_BLOB, &blob, sizeof(blob), data, size);
+
+                trace_hash_t *e     = &w->vHash[j];
+                e->hash             = hash;
+                e->size             = uint32_t(size);
+                e->id               = blob.id;
+
+                // Keep the load factor below 1/2
+                if ((w->nBlobs << 1) >= w->nHashCap)
+                {
+                    if (!grow_hash(w))
+                        w->nError           = STATUS_NO_MEM;
+                }
+
+                return blob.id;
+            }
+
+            void trace_writer_t::locate(ssize_t left, ssize_t top, ssize_t width, ssize_t height)
+            {
+                trace_locate_t rec;
+                rec.left        = int32_t(left);
+                rec.top         = int32_t(top);
+                rec.width       = int32_t(width);
+                rec.height      = int32_t(height);
+                write_record(this, TRACE_LOCATE, &rec, sizeof(rec), NULL, 0);
+            }
+
+            void trace_writer_t::start(const r3d::color_t *bg)
+            {
+                trace_start_t rec;
+                rec.bg          = *bg;
+                write_record(this, TRACE_START, &rec, sizeof(rec), NULL, 0);
+            }
+
+            void trace_writer_t::set_matrix(r3d::matrix_type_t type, const r3d::mat4_t *m)
+            {
+                if (m == NULL)
+                    return;
+
+                trace_matrix_t rec;
+                memset(&rec, 0, sizeof(rec));
+                rec.type        = type;
+                rec.m           = *m;
+                write_record(this, TRACE_MATRIX, &rec, sizeof(rec), NULL, 0);
+            }
+
+            void trace_writer_t::set_lights(const r3d::light_t *lights, size_t count)
+            {
+                if ((lights == NULL) && (count > 0))
+                    return;
+
+                trace_light_t *rec  = static_cast<trace_light_t *>(malloc(lsp_max(count, size_t(1)) * sizeof(trace_light_t)));
+                if (rec == NULL)
+                {
+                    nError              = STATUS_NO_MEM;
+                    return;
+                }
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    const r3d::light_t *l   = &lights[i];
+                    trace_light_t *t        = &rec[i];
+                    t->type                 = l->type;
+                    t->constant             = l->constant;
+                    t->linear               = l->linear;
+                    t->quadratic            = l->quadratic;
+                    t->cutoff               = l->cutoff;
+                    t->position             = l->position;
+                    t->direction            = l->direction;
+                    t->ambient              = l->ambient;
+                    t->diffuse              = l->diffuse;
+                    t->specular             = l->specular;
+                }
+
+                write_record(this, TRACE_LIGHTS, rec, count * sizeof(trace_light_t), NULL, 0);
+                free(rec);
+            }
+
+            /**
+             * Fill the draw record and emit blobs for all data referenced by the buffer
+             */
+            static void write_draw(trace_writer_t *w, trace_draw_t *rec, const r3d::buffer_t *buffer)
+            {
+                memset(rec, 0, sizeof(*rec));
+                rec->model          = buffer->model;
+                rec->type           = buffer->type;
+                rec->flags          = uint32_t(buffer->flags);
+                rec->width          = buffer->width;
+                rec->count          = uint32_t(buffer->count);
+                rec->vertex.stride  = uint32_t(buffer->vertex.stride);
+                rec->normal.stride  = uint32_t(buffer->normal.stride);
+                rec->color.stride   = uint32_t(buffer->color.stride);
+                rec->dfl            = buffer->color.dfl;
+
+                // Estimate number of vertices
+                size_t count        = buffer->count;
+                switch (buffer->type)
+                {
+                    case r3d::PRIMITIVE_TRIANGLES:
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        count           = (count << 1) + count;
+                        break;
+                    case r3d::PRIMITIVE_LINES:
+                        count         <<= 1;
+                        break;
+                    case r3d::PRIMITIVE_POINTS:
+                        break;
+                    default:
+                        count           = 0;
+                        break;
+                }
+
+                // Emit blobs for all referenced data. The invalid buffer is still recorded
+                // to reproduce the error returned by the backend.
+                if ((count > 0) && (buffer->vertex.data != NULL))
+                {
+                    const uint32_t *vindex  = buffer->vertex.index;
+                    const uint32_t *nindex  = buffer->normal.index;
+                    const uint32_t *cindex  = buffer->color.index;
+                    size_t vstride          = (buffer->vertex.stride == 0) ? sizeof(r3d::dot4_t)  : buffer->vertex.stride;
+                    size_t nstride          = (buffer->normal.stride == 0) ? sizeof(r3d::vec4_t)  : buffer->normal.stride;
+                    size_t cstride          = (buffer->color.stride == 0)  ? sizeof(r3d::color_t) : buffer->color.stride;
+                    size_t vitems           = (vindex != NULL) ? index_extent(vindex, count) : count;
+                    size_t uitems           = ((nindex != NULL) || (cindex != NULL)) ? count : vitems;
+                    size_t nitems           = (nindex != NULL) ? index_extent(nindex, count) : uitems;
+                    size_t citems           = (cindex != NULL) ? index_extent(cindex, count) : uitems;
+
+                    rec->vertex.data        = write_blob(w, buffer->vertex.data, array_size(vitems, vstride, sizeof(r3d::dot4_t)));
+                    rec->vertex.index       = write_blob(w, vindex, count * sizeof(uint32_t));
+                    rec->normal.data        = write_blob(w, buffer->normal.data, array_size(nitems, nstride, sizeof(r3d::vec4_t)));
+                    rec->normal.index       = write_blob(w, nindex, count * sizeof(uint32_t));
+                    rec->color.data         = write_blob(w, buffer->color.data, array_size(citems, cstride, sizeof(r3d::color_t)));
+                    rec->color.index        = write_blob(w, cindex, count * sizeof(uint32_t));
+                }
+            }
+
+            void trace_writer_t::draw_primitives(const r3d::buffer_t *buffer)
+            {
+                if (buffer == NULL)
+                    return;
+
+                trace_draw_t rec;
+                write_draw(this, &rec, buffer);
+                write_record(this, TRACE_DRAW, &rec, sizeof(rec), NULL, 0);
+            }
+
+            void trace_writer_t::draw_ring(const r3d::buffer_t *buffer, size_t first, const r3d::mat4_t *wrap)
+            {
+                if (buffer == NULL)
+                    return;
+
+                trace_ring_t rec;
+                memset(&rec, 0, sizeof(rec));
+                rec.first           = uint32_t(first);
+                if (wrap != NULL)
+                    rec.wrap            = *wrap;
+                else
+                    matrix_identity(&rec.wrap);
+                write_draw(this, &rec.draw, buffer);
+                write_record(this, TRACE_RING, &rec, sizeof(rec), NULL, 0);
+            }
+
+            void trace_writer_t::sync()
+            {
+                write_record(this, TRACE_SYNC, NULL, 0, NULL, 0);
+            }
+
+            void trace_writer_t::read_pixels(r3d::pixel_format_t format)
+            {
+                trace_read_pixels_t rec;
+                rec.format      = format;
+                write_record(this, TRACE_READ_PIXELS, &rec, sizeof(rec), NULL, 0);
+            }
+
+            void trace_writer_t::finish()
+            {
+                write_record(this, TRACE_FINISH, NULL, 0, NULL, 0);
+                if ((pFD != NULL) && (nError == STATUS_OK))
+                    fflush(pFD);
+            }
+
+            //-----------------------------------------------------------------
+            // Trace replay
+            static uint64_t time_ns()
+            {
+            #ifdef PLATFORM_WINDOWS
+                LARGE_INTEGER freq, t;
+                ::QueryPerformanceFrequency(&freq);
+                ::QueryPerformanceCounter(&t);
+                return (uint64_t(t.QuadPart / freq.QuadPart) * 1000000000ULL) +
+                       (uint64_t(t.QuadPart % freq.QuadPart) * 1000000000ULL) / uint64_t(freq.QuadPart);
+            #else
+                struct timespec ts;
+                ::clock_gettime(CLOCK_MONOTONIC, &ts);
+                return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+            #endif /* PLATFORM_WINDOWS */
+            }
+
+            typedef struct replay_blob_t
+            {
+                const uint8_t      *pData;          // Blob data
+                size_t              nSize;          // Size of the blob data
+            } replay_blob_t;
+
+            typedef struct replay_t
+            {
+                r3d::backend_t     *pBackend;
+                replay_blob_t      *vBlobs;         // Blobs
+                size_t              nBlobs;
+                size_t              nBlobCap;
+                uint8_t            *pPixels;        // Buffer for read_pixels()
+                r3d::light_t       *vLights;        // Buffer for set_lights()
+                size_t              nLightCap;
+                uint64_t            nFrameStart;
+                trace_stats_t       sStats;
+            } replay_t;
+
+            static status_t add_blob(replay_t *r, const uint8_t *data, size_t size)
+            {
+                const trace_blob_t *blob    = reinterpret_cast<const trace_blob_t *>(data);
+                if ((size < sizeof(trace_blob_t)) || (blob->size != size - sizeof(trace_blob_t)))
+                    return STATUS_CORRUPTED;
+                if (blob->id != r->nBlobs + 1)
+                    return STATUS_CORRUPTED;
+
+                if (r->nBlobs >= r->nBlobCap)
+                {
+                    size_t cap          = lsp_max(r->nBlobCap << 1, size_t(0x100));
+                    replay_blob_t *b    = static_cast<replay_blob_t *>(realloc(r->vBlobs, cap * sizeof(replay_blob_t)));
+                    if (b == NULL)
+                        return STATUS_NO_MEM;
+                    r->vBlobs           = b;
+                    r->nBlobCap         = cap;
+                }
+
+                replay_blob_t *b        = &r->vBlobs[r->nBlobs++];
+                b->pData                = &data[sizeof(trace_blob_t)];
+                b->nSize                = blob->size;
+
+                return STATUS_OK;
+            }
+
+            static status_t get_blob(replay_t *r, replay_blob_t *blob, uint32_t id)
+            {
+                if (id == 0)
+                {
+                    blob->pData     = NULL;
+                    blob->nSize     = 0;
+                    return STATUS_OK;
+                }
+                if (id > r->nBlobs)
+                    return STATUS_CORRUPTED;
+
+                *blob   = r->vBlobs[id - 1];
+                return STATUS_OK;
+            }
+
+            /**
+             * Fetch the array and check that all elements referenced by the draw call
+             * lie within the blobs, so the corrupted trace can not make the backend
+             * read beyond the end of the mapped file
+             *
+             * @param r replay state
+             * @param data pointer to store the array data
+             * @param index pointer to store the array indices
+             * @param a array record
+             * @param count number of elements to draw
+             * @param items number of array elements referenced when there are no indices
+             * @param item_size size of the array element
+             * @return status of operation
+             */
+            static status_t get_array(replay_t *r, const void **data, const uint32_t **index, const trace_array_t *a,
+                size_t count, size_t items, size_t item_size)
+            {
+                replay_blob_t d, i;
+                status_t res    = get_blob(r, &d, a->data);
+                if (res == STATUS_OK)
+                    res             = get_blob(r, &i, a->index);
+                if (res != STATUS_OK)
+                    return res;
+
+                const uint32_t *idx = reinterpret_cast<const uint32_t *>(i.pData);
+                if ((d.pData != NULL) && (count > 0))
+                {
+                    if (idx != NULL)
+                    {
+                        if (i.nSize < count * sizeof(uint32_t))
+                            return STATUS_CORRUPTED;
+                        items           = index_extent(idx, count);
+                    }
+                    size_t stride   = (a->stride == 0) ? item_size : a->stride;
+                    if (d.nSize < array_size(items, stride, item_size))
+                        return STATUS_CORRUPTED;
+                }
+
+                *data           = d.pData;
+                *index          = idx;
+                return STATUS_OK;
+            }
+
+            /**
+             * Restore the buffer of the draw record
+             *
+             * @param r replay state
+             * @param buf buffer to restore
+             * @param rec draw record
+             * @return status of operation
+             */
+            static status_t fetch_draw(replay_t *r, r3d::buffer_t *buf, const trace_draw_t *rec)
+            {
+                memset(buf, 0, sizeof(*buf));
+                buf->model          = rec->model;
+                buf->type           = r3d::primitive_type_t(rec->type);
+                buf->flags          = rec->flags;
+                buf->width          = rec->width;
+                buf->count          = rec->count;
+                buf->vertex.stride  = rec->vertex.stride;
+                buf->normal.stride  = rec->normal.stride;
+                buf->color.stride   = rec->color.stride;
+                buf->color.dfl      = rec->dfl;
+
+                // Number of elements to draw, the backend reports the invalid primitive type itself
+                size_t count        = rec->count;
+                switch (rec->type)
+                {
+                    case r3d::PRIMITIVE_TRIANGLES:
+                    case r3d::PRIMITIVE_WIREFRAME_TRIANGLES:
+                        count           = (count << 1) + count;
+                        break;
+                    case r3d::PRIMITIVE_LINES:
+                        count         <<= 1;
+                        break;
+                    case r3d::PRIMITIVE_POINTS:
+                        break;
+                    default:
+                        count           = 0;
+                        break;
+                }
+
+                const void *data    = NULL;
+                status_t res        = get_array(r, &data, &buf->vertex.index, &rec->vertex, count, count, sizeof(r3d::dot4_t));
+                buf->vertex.data    = static_cast<const r3d::dot4_t *>(data);
+                if (res != STATUS_OK)
+                    return res;
+
+                // Unindexed normals and colors follow the vertex index unless there are
+                // normal or color indices
+                size_t items        = ((rec->normal.index != 0) || (rec->color.index != 0)) ? count :
+                                      (buf->vertex.index != NULL) ? index_extent(buf->vertex.index, count) : count;
+                res                 = get_array(r, &data, &buf->normal.index, &rec->normal, count, items, sizeof(r3d::vec4_t));
+                buf->normal.data    = static_cast<const r3d::vec4_t *>(data);
+                if (res == STATUS_OK)
+                {
+                    res                 = get_array(r, &data, &buf->color.index, &rec->color, count, items, sizeof(r3d::color_t));
+                    buf->color.data     = static_cast<const r3d::color_t *>(data);
+                }
+                return res;
+            }
+
+            static status_t replay_draw(replay_t *r, const trace_draw_t *rec, status_t *call_res)
+            {
+                r3d::buffer_t buf;
+                status_t res        = fetch_draw(r, &buf, rec);
+                if (res != STATUS_OK)
+                    return res;
+
+                *call_res           = r->pBackend->draw_primitives(r->pBackend, &buf);
+                return STATUS_OK;
+            }
+
+            /**
+             * Select the range of primitives of the ring buffer by shifting index pointers,
+             * or data pointers if there are no indices
+             *
+             * @param dst destination buffer
+             * @param src source buffer
+             * @param first first primitive of the range
+             * @param count number of primitives in the range
+             */
+            static void ring_range(r3d::buffer_t *dst, const r3d::buffer_t *src, size_t first, size_t count)
+            {
+                size_t n            = ((src->type == r3d::PRIMITIVE_TRIANGLES) || (src->type == r3d::PRIMITIVE_WIREFRAME_TRIANGLES)) ? 3 :
+                                      (src->type == r3d::PRIMITIVE_LINES) ? 2 : 1;
+                size_t off          = first * n;
+
+                *dst                = *src;
+                dst->count          = count;
+                if (src->vertex.index != NULL)
+                    dst->vertex.index   = &src->vertex.index[off];
+                else if (src->vertex.data != NULL)
+                {
+                    const uint8_t *v    = reinterpret_cast<const uint8_t *>(src->vertex.data);
+                    size_t vstride      = (src->vertex.stride == 0) ? sizeof(r3d::dot4_t) : src->vertex.stride;
+                    dst->vertex.data    = reinterpret_cast<const r3d::dot4_t *>(&v[off * vstride]);
+                }
+
+                // Unindexed normals and colors are shifted if they are read per element
+                bool separate       = (src->normal.index != NULL) || (src->color.index != NULL);
+                bool shift          = (separate) || (src->vertex.index == NULL);
+                if (src->normal.index != NULL)
+                    dst->normal.index   = &src->normal.index[off];
+                else if ((shift) && (src->normal.data != NULL))
+                {
+                    const uint8_t *p    = reinterpret_cast<const uint8_t *>(src->normal.data);
+                    size_t stride       = (src->normal.stride == 0) ? sizeof(r3d::vec4_t) : src->normal.stride;
+                    dst->normal.data    = reinterpret_cast<const r3d::vec4_t *>(&p[off * stride]);
+                }
+                if (src->color.index != NULL)
+                    dst->color.index    = &src->color.index[off];
+                else if ((shift) && (src->color.data != NULL))
+                {
+                    const uint8_t *p    = reinterpret_cast<const uint8_t *>(src->color.data);
+                    size_t stride       = (src->color.stride == 0) ? sizeof(r3d::color_t) : src->color.stride;
+                    dst->color.data     = reinterpret_cast<const r3d::color_t *>(&p[off * stride]);
+                }
+            }
+
+            static status_t replay_ring(replay_t *r, const trace_ring_t *rec, status_t *call_res)
+            {
+                r3d::buffer_t buf;
+                status_t res        = fetch_draw(r, &buf, &rec->draw);
+                if (res != STATUS_OK)
+                    return res;
+
+                r3d::backend_t *b   = r->pBackend;
+            #ifdef PLATFORM_WINDOWS
+                if (b->draw_primitives == wgl::backend_t::draw_primitives)
+                {
+                    *call_res           = wgl::backend_t::draw_ring(b, &buf, rec->first, &rec->wrap);
+                    return STATUS_OK;
+                }
+            #endif /* PLATFORM_WINDOWS */
+
+                // Other backends draw the tail of the ring, then the wrapped head with the additional transform
+                if ((buf.count > 0) && (rec->first >= buf.count))
+                {
+                    *call_res           = STATUS_BAD_ARGUMENTS;
+                    return STATUS_OK;
+                }
+                if ((buf.count <= 0) || (rec->first <= 0))
+                {
+                    *call_res           = b->draw_primitives(b, &buf);
+                    return STATUS_OK;
+                }
+
+                r3d::buffer_t range;
+                ring_range(&range, &buf, rec->first, buf.count - rec->first);
+                *call_res           = b->draw_primitives(b, &range);
+                if (*call_res != STATUS_OK)
+                    return STATUS_OK;
+
+                ring_range(&range, &buf, 0, rec->first);
+                matrix_mul(&range.model, &buf.model, &rec->wrap);
+                *call_res           = b->draw_primitives(b, &range);
+                return STATUS_OK;
+            }
+
+            static status_t replay_lights(replay_t *r, const uint8_t *data, size_t size, status_t *call_res)
+            {
+                if ((size % sizeof(trace_light_t)) != 0)
+                    return STATUS_CORRUPTED;
+
+                size_t count        = size / sizeof(trace_light_t);
+                if (count > r->nLightCap)
+                {
+                    r3d::light_t *l     = static_cast<r3d::light_t *>(realloc(r->vLights, count * sizeof(r3d::light_t)));
+                    if (l == NULL)
+                        return STATUS_NO_MEM;
+                    r->vLights          = l;
+                    r->nLightCap        = count;
+                }
+
+                const trace_light_t *src = reinterpret_cast<const trace_light_t *>(data);
+                for (size_t i=0; i<count; ++i)
+                {
+                    r3d::light_t *l     = &r->vLights[i];
+                    const trace_light_t *t = &src[i];
+                    l->type             = r3d::light_type_t(t->type);
+                    l->constant         = t->constant;
+                    l->linear           = t->linear;
+                    l->quadratic        = t->quadratic;
+                    l->cutoff           = t->cutoff;
+                    l->position         = t->position;
+                    l->direction        = t->direction;
+                    l->ambient          = t->ambient;
+                    l->diffuse          = t->diffuse;
+                    l->specular         = t->specular;
+                }
+
+                *call_res           = r->pBackend->set_lights(r->pBackend, r->vLights, count);
+                return STATUS_OK;
+            }
+
+            static status_t replay_record(replay_t *r, uint32_t type, const uint8_t *data, size_t size)
+            {
+                r3d::backend_t *b   = r->pBackend;
+                status_t call_res   = STATUS_OK;
+                status_t res        = STATUS_OK;
+
+                #define CHECK_SIZE(type) \
+                    if (size < sizeof(type)) \
+                        return STATUS_CORRUPTED;
+
+                switch (type)
+                {
+                    case TRACE_BLOB:
+                        return add_blob(r, data, size);
+
+                    case TRACE_LOCATE:
+                    {
+                        CHECK_SIZE(trace_locate_t);
+                        const trace_locate_t *rec = reinterpret_cast<const trace_locate_t *>(data);
+                        call_res            = b->locate(b, rec->left, rec->top, rec->width, rec->height);
+
+                        // Reallocate buffer for pixels
+                        size_t bytes        = size_t(lsp_max(rec->width, 0)) * size_t(lsp_max(rec->height, 0)) * sizeof(uint32_t);
+                        uint8_t *pixels     = static_cast<uint8_t *>(realloc(r->pPixels, lsp_max(bytes, size_t(sizeof(uint32_t)))));
+                        if (pixels == NULL)
+                            return STATUS_NO_MEM;
+                        r->pPixels          = pixels;
+                        break;
+                    }
+
+                    case TRACE_START:
+                    {
+                        CHECK_SIZE(trace_start_t);
+                        const trace_start_t *rec = reinterpret_cast<const trace_start_t *>(data);
+                        b->set_bg_color(b, &rec->bg);
+                        r->nFrameStart      = time_ns();
+                        call_res            = b->start(b);
+                        break;
+                    }
+
+                    case TRACE_MATRIX:
+                    {
+                        CHECK_SIZE(trace_matrix_t);
+                        const trace_matrix_t *rec = reinterpret_cast<const trace_matrix_t *>(data);
+                        call_res            = b->set_matrix(b, r3d::matrix_type_t(rec->type), &rec->m);
+                        break;
+                    }
+
+                    case TRACE_LIGHTS:
+                        res                 = replay_lights(r, data, size, &call_res);
+                        break;
+
+                    case TRACE_DRAW:
+                        CHECK_SIZE(trace_draw_t);
+                        res                 = replay_draw(r, reinterpret_cast<const trace_draw_t *>(data), &call_res);
+                        ++r->sStats.nDraws;
+                        break;
+
+                    case TRACE_RING:
+                        CHECK_SIZE(trace_ring_t);
+                        res                 = replay_ring(r, reinterpret_cast<const trace_ring_t *>(data), &call_res);
+                        ++r->sStats.nDraws;
+                        break;
+
+                    case TRACE_SYNC:
+                        call_res            = b->sync(b);
+                        break;
+
+                    case TRACE_READ_PIXELS:
+                    {
+                        CHECK_SIZE(trace_read_pixels_t);
+                        if (r->pPixels == NULL)
+                            return STATUS_CORRUPTED;
+                        const trace_read_pixels_t *rec = reinterpret_cast<const trace_read_pixels_t *>(data);
+                        call_res            = b->read_pixels(b, r->pPixels, r3d::pixel_format_t(rec->format));
+                        break;
+                    }
+
+                    case TRACE_FINISH:
+                    {
+                        call_res            = b->finish(b);
+                        uint64_t time       = time_ns() - r->nFrameStart;
+                        trace_stats_t *s    = &r->sStats;
+                        s->nFrameMin        = (s->nFrames > 0) ? lsp_min(s->nFrameMin, time) : time;
+                        s->nFrameMax        = (s->nFrames > 0) ? lsp_max(s->nFrameMax, time) : time;
+                        ++s->nFrames;
+                        break;
+                    }
+
+                    default:
+                        lsp_warn("Unknown trace record type %d, skipping", int(type));
+                        return STATUS_OK;
+                }
+
+                #undef CHECK_SIZE
+
+                ++r->sStats.nCalls;
+                if (call_res != STATUS_OK)
+                    ++r->sStats.nErrors;
+
+                return res;
+            }
+
+            status_t replay_trace(r3d::backend_t *backend, const char *path, trace_stats_t *stats)
+            {
+                if ((backend == NULL) || (path == NULL))
+                    return STATUS_BAD_ARGUMENTS;
+
+                mapping_t m;
+                status_t res        = map_file(&m, path);
+                if (res != STATUS_OK)
+                    return res;
+
+                // Validate header
+                const trace_file_t *hdr = reinterpret_cast<const trace_file_t *>(m.pData);
+                if ((m.nSize < sizeof(trace_file_t)) || (hdr->magic != TRACE_MAGIC))
+                {
+                    unmap_file(&m);
+                    return STATUS_BAD_FORMAT;
+                }
+                if (hdr->version != TRACE_VERSION)
+                {
+                    unmap_file(&m);
+                    return STATUS_UNSUPPORTED_FORMAT;
+                }
+
+                replay_t r;
+                memset(&r, 0, sizeof(r));
+                r.pBackend          = backend;
+
+                // Replay all records
+                uint64_t time       = time_ns();
+                size_t offset       = trace_align(sizeof(trace_file_t));
+                while ((res == STATUS_OK) && (offset < m.nSize))
+                {
+                    if (m.nSize - offset < sizeof(trace_record_t))
+                    {
+                        res                 = STATUS_CORRUPTED;
+                        break;
+                    }
+
+                    const trace_record_t *rec = reinterpret_cast<const trace_record_t *>(&m.pData[offset]);
+                    size_t size         = rec->size;
+                    if (m.nSize - offset - sizeof(trace_record_t) < size)
+                    {
+                        res                 = STATUS_CORRUPTED;
+                        break;
+                    }
+
+                    res                 = replay_record(&r, rec->type, &m.pData[offset + sizeof(trace_record_t)], size);
+                    offset             += trace_align(sizeof(trace_record_t) + size);
+                }
+                r.sStats.nTotalTime = time_ns() - time;
+
+                if (res != STATUS_OK)
+                    lsp_error("Trace replay failed at offset 0x%llx, code=%d", (unsigned long long)offset, int(res));
+
+                if (stats != NULL)
+                    *stats              = r.sStats;
+
+                // Release resources
+                if (r.vBlobs != NULL)
+                    free(r.vBlobs);
+                if (r.pPixels != NULL)
+                    free(r.pPixels);
+                if (r.vLights != NULL)
+                    free(r.vLights);
+                unmap_file(&m);
+
+                return res;
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/types.h>
+#include <private/wgl/weld.h>
+
+namespace lsp
+{
+    namespace r3d
+    {
+        namespace wgl
+        {
+            /**
+             * Weld the separate vertex, normal and color indices into single index
+             * @return number of unique vertices or negative value on error
+             */
+            ssize_t weld_indices(uint32_t *indices, remap_t *remap, const r3d::buffer_t *data, size_t count, arena_t *arena)
+            {
+                const uint32_t *vindex  = data->vertex.index;
+                const uint32_t *nindex  = data->normal.index;
+                const uint32_t *cindex  = data->color.index;
+                bool normal             = data->normal.data != NULL;
+                bool color              = data->color.data != NULL;
+                // Unindexed normals and colors are per element when there are normal or color indices
+                bool separate           = (nindex != NULL) || (cindex != NULL);
+
+                // Allocate hash table
+                size_t cap              = 0x10;
+                while (cap < (count << 1))
+                    cap                   <<= 1;
+                arena_mark_t mark       = arena->mark();
+                uint32_t *table         = arena->alloc<uint32_t>(cap);
+                if (table == NULL)
+                    return -STATUS_NO_MEM;
+                for (size_t i=0; i<cap; ++i)
+                    table[i]                = uint32_t(-1);
+
+                size_t vertices         = 0;
+                for (size_t i=0; i<count; ++i)
+                {
+                    remap_t r;
+                    r.v                     = (vindex != NULL) ? vindex[i] : uint32_t(i);
+                    uint32_t u              = (separate) ? uint32_t(i) : r.v;
+                    r.n                     = (normal) ? ((nindex != NULL) ? nindex[i] : u) : 0;
+                    r.c                     = (color)  ? ((cindex != NULL) ? cindex[i] : u) : 0;
+
+                    uint32_t h              = ((r.v * 0x9e3779b1) ^ (r.n * 0x85ebca6b) ^ (r.c * 0xc2b2ae35));
+                    size_t slot             = (h ^ (h >> 16)) & (cap - 1);
+                    while (true)
+                    {
+                        uint32_t id             = table[slot];
+                        if (id == uint32_t(-1))
+                        {
+                            table[slot]             = uint32_t(vertices);
+                            remap[vertices]         = r;
+                            indices[i]              = uint32_t(vertices++);
+                            break;
+                        }
+
+                        const remap_t *x        = &remap[id];
+                        if ((x->v == r.v) && (x->n == r.n) && (x->c == r.c))
+                        {
+                            indices[i]              = id;
+                            break;
+                        }
+                        slot                    = (slot + 1) & (cap - 1);
+                    }
+                }
+
+                arena->release(mark);
+                return vertices;
+            }
+
+            void gather_vertices(vertex_t *vx, const remap_t *remap, size_t count, const r3d::buffer_t *data)
+            {
+                const uint8_t  *vbuf    = reinterpret_cast<const uint8_t *>(data->vertex.data);
+                const uint8_t  *nbuf    = reinterpret_cast<const uint8_t *>(data->normal.data);
+                const uint8_t  *cbuf    = reinterpret_cast<const uint8_t *>(data->color.data);
+                size_t vstride          = (data->vertex.stride == 0) ? sizeof(r3d::dot4_t)  : data->vertex.stride;
+                size_t nstride          = (data->normal.stride == 0) ? sizeof(r3d::vec4_t)  : data->normal.stride;
+                size_t cstride          = (data->color.stride == 0)  ? sizeof(r3d::color_t) : data->color.stride;
+
+                for (size_t i=0; i<count; ++i, ++vx)
+                {
+                    const remap_t *r        = &remap[i];
+                    vx->v                   = *(reinterpret_cast<const r3d::dot4_t *>(&vbuf[r->v * vstride]));
+                    if (nbuf != NULL)
+                        vx->n                   = *(reinterpret_cast<const r3d::vec4_t *>(&nbuf[r->n * nstride]));
+                    if (cbuf != NULL)
+                        vx->c                   = *(reinterpret_cast<const r3d::color_t *>(&cbuf[r->c * cstride]));
+                }
+            }
+
+        } /* namespace wgl */
+    } /* namespace r3d */
+} /* namespace lsp */
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/r3d/wgl/sw_backend.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t NUM_SECTORS    = 64;
+    constexpr size_t MAX_SAMPLES    = 4;        // Maximum number of samples per pixel along each axis
+
+    /**
+     * Draw the pinwheel of thin sectors which has a lot of edges of different slopes
+     */
+    static status_t draw_frame(r3d::backend_t *b, void *pixels)
+    {
+        r3d::dot4_t v[NUM_SECTORS * 3];
+        r3d::color_t c[NUM_SECTORS * 3];
+
+        for (size_t i=0; i<NUM_SECTORS; ++i)
+        {
+            float a0            = (2.0f * M_PI * i) / NUM_SECTORS;
+            float a1            = (2.0f * M_PI * (i + 0.5f)) / NUM_SECTORS;
+            float r             = 0.95f - 0.3f * (i & 3) / 3.0f;
+            r3d::dot4_t *p      = &v[i*3];
+            p[0].x = 0.0f;              p[0].y = 0.0f;              p[0].z = 0.0f;  p[0].w = 1.0f;
+            p[1].x = r * cosf(a0);      p[1].y = r * sinf(a0);      p[1].z = 0.5f;  p[1].w = 1.0f;
+            p[2].x = r * cosf(a1);      p[2].y = r * sinf(a1);      p[2].z = 0.5f;  p[2].w = 1.0f;
+
+            for (size_t j=0; j<3; ++j)
+            {
+                r3d::color_t *col   = &c[i*3 + j];
+                col->r  = float(i & 1);
+                col->g  = float(i) / NUM_SECTORS;
+                col->b  = 1.0f - float(i) / NUM_SECTORS;
+                col->a  = 1.0f;
+            }
+        }
+
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        for (size_t i=0; i<4; ++i)
+            buf.model.m[i*5]    = 1.0f;
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.count           = NUM_SECTORS;
+        buf.flags           = r3d::BUFFER_NO_CULLING;
+        buf.vertex.data     = v;
+        buf.color.data      = c;
+
+        status_t res        = b->start(b);
+        if (res != STATUS_OK)
+            return res;
+        res                 = b->draw_primitives(b, &buf);
+        if (res == STATUS_OK)
+            res                 = b->read_pixels(b, pixels, r3d::PIXEL_RGBA);
+        status_t fres       = b->finish(b);
+
+        return (res != STATUS_OK) ? res : fres;
+    }
+
+    /**
+     * Average each block of samples x samples pixels of the supersampled image
+     */
+    static void downsample(uint8_t *dst, const uint8_t *src, size_t width, size_t height, size_t samples)
+    {
+        const size_t src_stride = width * samples * 4;
+        const size_t area       = samples * samples;
+
+        for (size_t y=0; y<height; ++y)
+        {
+            for (size_t x=0; x<width; ++x, dst += 4)
+            {
+                const uint8_t *s        = &src[y * samples * src_stride + x * samples * 4];
+                uint32_t acc[4]         = { 0, 0, 0, 0 };
+                for (size_t sy=0; sy<samples; ++sy, s += src_stride)
+                    for (size_t sx=0; sx<samples; ++sx)
+                        for (size_t i=0; i<4; ++i)
+                            acc[i]         += s[sx * 4 + i];
+
+                for (size_t i=0; i<4; ++i)
+                    dst[i]              = uint8_t((acc[i] + area / 2) / area);
+            }
+        }
+    }
+
+    static float mean_error(const uint8_t *a, const uint8_t *b, size_t width, size_t height)
+    {
+        uint64_t error      = 0;
+        for (size_t i=0, n=width*height*4; i<n; ++i)
+            error              += (a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i];
+        return float(error) / (width * height * 4);
+    }
+}
+
+PTEST_BEGIN("r3d.wgl", fxaa, 5, 100)
+
+    /**
+     * Render the frame of the specified size with the specified number of samples along
+     * each axis, with or without FXAA, and return the image of the specified size
+     */
+    bool render(sw_backend_t *s, uint8_t *dst, uint8_t *tmp, size_t width, size_t height, size_t samples, bool fxaa)
+    {
+        if (s->set_fxaa(s, fxaa) != STATUS_OK)
+            return false;
+        if (s->locate(s, 0, 0, width * samples, height * samples) != STATUS_OK)
+            return false;
+
+        if (samples <= 1)
+            return draw_frame(s, dst) == STATUS_OK;
+
+        if (draw_frame(s, tmp) != STATUS_OK)
+            return false;
+        downsample(dst, tmp, width, height, samples);
+        return true;
+    }
+
+    void call(sw_backend_t *s, uint8_t *dst, uint8_t *tmp, size_t width, size_t height, size_t samples, bool fxaa)
+    {
+        char buf[80];
+        if (fxaa)
+            snprintf(buf, sizeof(buf), "FXAA %dx%d", int(width), int(height));
+        else if (samples > 1)
+            snprintf(buf, sizeof(buf), "SSAA %dx%d, %dx%d samples", int(width), int(height), int(samples), int(samples));
+        else
+            snprintf(buf, sizeof(buf), "no AA %dx%d", int(width), int(height));
+        printf("Testing %s...\n", buf);
+
+        PTEST_LOOP(buf,
+            render(s, dst, tmp, width, height, samples, fxaa);
+        );
+    }
+
+    PTEST_MAIN
+    {
+        static const size_t sizes[] = { 256, 512, 1024 };
+        static const r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+        sw_backend_t *s     = static_cast<sw_backend_t *>(malloc(sizeof(sw_backend_t)));
+        if (s == NULL)
+            return;
+        s->construct();
+        if ((s->init_offscreen(s) != STATUS_OK) || (s->set_bg_color(s, &bg) != STATUS_OK))
+        {
+            s->destroy(s);
+            free(s);
+            return;
+        }
+
+        for (size_t i=0; i<sizeof(sizes)/sizeof(sizes[0]); ++i)
+        {
+            const size_t w      = sizes[i];
+            const size_t h      = sizes[i];
+            const size_t size   = w * h * 4;
+            uint8_t *ref        = static_cast<uint8_t *>(malloc(size * (MAX_SAMPLES * MAX_SAMPLES + 2)));
+            if (ref == NULL)
+                break;
+            uint8_t *dst        = &ref[size];
+            uint8_t *tmp        = &dst[size];
+
+            // Estimate the quality of each method against the image with the maximum supersampling
+            if (render(s, ref, tmp, w, h, MAX_SAMPLES, false))
+            {
+                render(s, dst, tmp, w, h, 1, false);
+                float plain         = mean_error(dst, ref, w, h);
+                render(s, dst, tmp, w, h, 1, true);
+                float filtered      = mean_error(dst, ref, w, h);
+                render(s, dst, tmp, w, h, 2, false);
+                float ssaa          = mean_error(dst, ref, w, h);
+                printf("Mean error against %dx%d supersampling at %dx%d: no AA=%.3f, FXAA=%.3f, SSAA 2x2=%.3f\n",
+                    int(MAX_SAMPLES), int(MAX_SAMPLES), int(w), int(h), plain, filtered, ssaa);
+            }
+
+            call(s, dst, tmp, w, h, 1, false);
+            call(s, dst, tmp, w, h, 1, true);
+            call(s, dst, tmp, w, h, 2, false);
+            call(s, dst, tmp, w, h, 4, false);
+            PTEST_SEPARATOR;
+
+            free(ref);
+        }
+
+        s->destroy(s);
+        free(s);
+    }
+
+PTEST_END
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/r3d/wgl/factory.h>
+#include <private/sw/workers.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t NUM_BACKENDS   = 8;
+    constexpr size_t FRAME_WIDTH    = 512;
+    constexpr size_t FRAME_HEIGHT   = 384;
+    constexpr size_t NUM_SECTORS    = 256;
+
+    typedef struct context_t
+    {
+        r3d::backend_t *vBackends[NUM_BACKENDS];
+        uint8_t        *vPixels[NUM_BACKENDS];
+        r3d::dot4_t     vVertices[NUM_SECTORS * 3];
+        r3d::color_t    vColors[NUM_SECTORS * 3];
+    } context_t;
+
+    static void build_scene(context_t *ctx)
+    {
+        for (size_t i=0; i<NUM_SECTORS; ++i)
+        {
+            float a0            = (2.0f * M_PI * i) / NUM_SECTORS;
+            float a1            = (2.0f * M_PI * (i + 1)) / NUM_SECTORS;
+            r3d::dot4_t *p      = &ctx->vVertices[i*3];
+            p[0].x = 0.0f;              p[0].y = 0.0f;              p[0].z = 0.0f;  p[0].w = 1.0f;
+            p[1].x = 0.9f * cosf(a0);   p[1].y = 0.9f * sinf(a0);   p[1].z = 0.5f;  p[1].w = 1.0f;
+            p[2].x = 0.9f * cosf(a1);   p[2].y = 0.9f * sinf(a1);   p[2].z = 0.5f;  p[2].w = 1.0f;
+
+            for (size_t j=0; j<3; ++j)
+            {
+                r3d::color_t *c     = &ctx->vColors[i*3 + j];
+                c->r    = float(i) / NUM_SECTORS;
+                c->g    = float(j) * 0.5f;
+                c->b    = 0.5f;
+                c->a    = 1.0f;
+            }
+        }
+    }
+
+    static void draw_task(void *arg, size_t index)
+    {
+        context_t *ctx      = static_cast<context_t *>(arg);
+        r3d::backend_t *b   = ctx->vBackends[index];
+
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        for (size_t i=0; i<4; ++i)
+            buf.model.m[i*5]    = 1.0f;
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.count           = NUM_SECTORS;
+        buf.flags           = r3d::BUFFER_NO_CULLING;
+        buf.vertex.data     = ctx->vVertices;
+        buf.color.data      = ctx->vColors;
+
+        if (b->start(b) != STATUS_OK)
+            return;
+        b->draw_primitives(b, &buf);
+        b->read_pixels(b, ctx->vPixels[index], r3d::PIXEL_RGBA);
+        b->finish(b);
+    }
+}
+
+PTEST_BEGIN("r3d.wgl", parallel, 5, 10)
+
+    void destroy_backends(context_t *ctx)
+    {
+        for (size_t i=0; i<NUM_BACKENDS; ++i)
+        {
+            r3d::backend_t *b   = ctx->vBackends[i];
+            if (b == NULL)
+                continue;
+            b->destroy(b);
+            free(b);
+            ctx->vBackends[i]   = NULL;
+        }
+    }
+
+    bool init_backends(context_t *ctx, r3d::factory_t *f, size_t id)
+    {
+        for (size_t i=0; i<NUM_BACKENDS; ++i)
+        {
+            r3d::backend_t *b   = f->create(f, id);
+            if (b == NULL)
+                return false;
+            ctx->vBackends[i]   = b;
+            if ((b->init_offscreen(b) != STATUS_OK) ||
+                (b->locate(b, 0, 0, FRAME_WIDTH, FRAME_HEIGHT) != STATUS_OK))
+                return false;
+        }
+
+        return true;
+    }
+
+    void call(context_t *ctx, const char *name, size_t threads)
+    {
+        sw::workers_t workers;
+        workers.construct();
+        if ((threads > 1) && (workers.init(threads - 1) != STATUS_OK))
+        {
+            workers.destroy();
+            return;
+        }
+
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x%d, %d threads", name, int(NUM_BACKENDS), int(threads));
+        printf("Testing %s...\n", buf);
+
+        PTEST_LOOP(buf,
+            workers.run(draw_task, ctx, NUM_BACKENDS);
+        );
+
+        workers.destroy();
+    }
+
+    PTEST_MAIN
+    {
+        wgl::factory_t factory;
+
+        context_t *ctx      = static_cast<context_t *>(malloc(sizeof(context_t)));
+        uint8_t *pixels     = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT * 4 * NUM_BACKENDS));
+        if ((ctx == NULL) || (pixels == NULL))
+        {
+            free(ctx);
+            free(pixels);
+            return;
+        }
+
+        memset(ctx, 0, sizeof(context_t));
+        build_scene(ctx);
+        for (size_t i=0; i<NUM_BACKENDS; ++i)
+            ctx->vPixels[i]     = &pixels[FRAME_WIDTH * FRAME_HEIGHT * 4 * i];
+
+        for (size_t id=0; ; ++id)
+        {
+            const r3d::backend_metadata_t *meta = factory.metadata(&factory, id);
+            if (meta == NULL)
+                break;
+
+            if (init_backends(ctx, &factory, id))
+            {
+                for (size_t threads=1; threads <= NUM_BACKENDS; threads <<= 1)
+                    call(ctx, meta->id, threads);
+                PTEST_SEPARATOR;
+            }
+            else
+                printf("Backend %s is not available, skipping\n", meta->id);
+
+            destroy_backends(ctx);
+        }
+
+        free(ctx);
+        free(pixels);
+    }
+
+PTEST_END
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <private/wgl/pixels.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t FRAME_WIDTH    = 1920;
+    constexpr size_t FRAME_HEIGHT   = 1080;
+
+    static const read_format_t formats[] =
+    {
+        READ_RGBA,
+        READ_BGRA,
+        READ_RGB,
+        READ_BGRA_PREMUL,
+        READ_RGB565
+    };
+
+    static const char *format_names[] =
+    {
+        "RGBA",
+        "BGRA",
+        "RGB",
+        "BGRA_PREMUL",
+        "RGB565"
+    };
+
+    /**
+     * The conversion as it was done before fused kernels: the image is read in the
+     * output format, then rows are flipped by the separate pass and the pixels are
+     * converted by the other pass over the whole image.
+     */
+    static void two_pass_convert(uint8_t *dst, const uint8_t *src, size_t width, size_t height, read_format_t format)
+    {
+        size_t bpp          = read_format_size(format);
+        size_t row_size     = width * 4;
+
+        // First pass: flip rows
+        for (size_t y=0; y<height; ++y)
+            memcpy(&dst[y * row_size], &src[(height - 1 - y) * row_size], row_size);
+
+        // Second pass: swizzle and pack pixels in place
+        uint8_t *d          = dst;
+        const uint8_t *s    = dst;
+        for (size_t i=0, n=width*height; i<n; ++i, s += 4, d += bpp)
+        {
+            uint8_t r = s[0], g = s[1], b = s[2], a = s[3];
+            switch (format)
+            {
+                case READ_RGBA:
+                    break;
+                case READ_BGRA:
+                    d[0] = b;   d[1] = g;   d[2] = r;   d[3] = a;
+                    break;
+                case READ_RGB:
+                    d[0] = r;   d[1] = g;   d[2] = b;
+                    break;
+                case READ_BGRA_PREMUL:
+                    d[0] = uint8_t((b * a * 2 + 255) / 510);
+                    d[1] = uint8_t((g * a * 2 + 255) / 510);
+                    d[2] = uint8_t((r * a * 2 + 255) / 510);
+                    d[3] = a;
+                    break;
+                case READ_RGB565:
+                {
+                    uint16_t v = uint16_t(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+                    memcpy(d, &v, sizeof(v));
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+PTEST_BEGIN("r3d.wgl", pixels, 5, 100)
+
+    void call(size_t fi, const uint8_t *src, uint8_t *dst)
+    {
+        read_format_t format    = formats[fi];
+        size_t bpp              = read_format_size(format);
+        char buf[80];
+
+        printf("Testing %s conversion of %dx%d image...\n", format_names[fi], int(FRAME_WIDTH), int(FRAME_HEIGHT));
+
+        snprintf(buf, sizeof(buf), "two-pass %s", format_names[fi]);
+        PTEST_LOOP(buf,
+            two_pass_convert(dst, src, FRAME_WIDTH, FRAME_HEIGHT, format);
+        );
+
+        snprintf(buf, sizeof(buf), "fused %s", format_names[fi]);
+        PTEST_LOOP(buf,
+            convert_pixels(dst, FRAME_WIDTH * bpp, src, FRAME_WIDTH * 4, FRAME_WIDTH, FRAME_HEIGHT, format, true);
+        );
+
+        PTEST_SEPARATOR;
+    }
+
+    PTEST_MAIN
+    {
+        size_t size     = FRAME_WIDTH * FRAME_HEIGHT * 4;
+        uint8_t *src    = static_cast<uint8_t *>(malloc(size));
+        uint8_t *dst    = static_cast<uint8_t *>(malloc(size));
+        if ((src != NULL) && (dst != NULL))
+        {
+            for (size_t i=0; i<size; ++i)
+                src[i]          = uint8_t(rand());
+
+            for (size_t fi=0; fi<sizeof(formats)/sizeof(formats[0]); ++fi)
+                call(fi, src, dst);
+        }
+
+        free(src);
+        free(dst);
+    }
+
+PTEST_END
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/common/types.h>
+#include <private/sw/raster.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t NUM_TRIANGLES      = 4096;
+    constexpr size_t MAX_THREADS        = 16;
+
+    static void random_triangles(sw::svertex_t *v, size_t count, size_t width, size_t height)
+    {
+        srand(0x5eed);
+        for (size_t i=0; i<count; ++i, v += 3)
+        {
+            // Triangles of size about 1/16 of the frame
+            float cx    = (rand() % 1000) * width * 1e-3f;
+            float cy    = (rand() % 1000) * height * 1e-3f;
+            float s     = width * 0.0625f;
+
+            for (size_t j=0; j<3; ++j)
+            {
+                v[j].x      = cx + ((rand() % 1000) * 1e-3f - 0.5f) * s;
+                v[j].y      = cy + ((rand() % 1000) * 1e-3f - 0.5f) * s;
+                v[j].z      = (rand() % 1000) * 1e-3f;
+                v[j].iw     = 1.0f;
+                v[j].c.r    = (rand() % 1000) * 1e-3f;
+                v[j].c.g    = (rand() % 1000) * 1e-3f;
+                v[j].c.b    = (rand() % 1000) * 1e-3f;
+                v[j].c.a    = 1.0f;
+            }
+        }
+    }
+}
+
+PTEST_BEGIN("r3d.wgl.sw", raster, 2, 10)
+
+    void draw_frame(sw::raster_t *r, const sw::svertex_t *v, size_t count)
+    {
+        r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+        r->clear(&bg);
+        for (size_t i=0; i<count; ++i, v += 3)
+            r->add_triangle(&v[0], &v[1], &v[2], 0);
+        r->flush();
+    }
+
+    void call(const char *label, size_t width, size_t height, size_t threads, const sw::svertex_t *v, size_t count)
+    {
+        sw::raster_t r;
+        r.construct();
+        if (r.resize(width, height) != STATUS_OK)
+        {
+            r.destroy();
+            return;
+        }
+
+        // The caller thread also participates in rasterization
+        r.bWorkers      = true;
+        if ((threads > 1) && (r.sWorkers.init(threads - 1) != STATUS_OK))
+        {
+            r.destroy();
+            return;
+        }
+
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s %dx%d, %d tiles, %d threads",
+            label, int(width), int(height), int(r.nTilesX * r.nTilesY), int(threads));
+        printf("Testing %s...\n", buf);
+
+        PTEST_LOOP(buf,
+            draw_frame(&r, v, count);
+        );
+
+        r.destroy();
+    }
+
+    PTEST_MAIN
+    {
+        static const size_t sizes[] = { 256, 512, 1024 };
+
+        sw::svertex_t *v    = static_cast<sw::svertex_t *>(malloc(NUM_TRIANGLES * 3 * sizeof(sw::svertex_t)));
+        if (v == NULL)
+            return;
+
+        // Also measure the overhead of threads on machines with few processors
+        size_t cpus         = lsp_min(lsp_max(sw::workers_t::processors(), size_t(8)), MAX_THREADS);
+        for (size_t i=0; i<sizeof(sizes)/sizeof(sizes[0]); ++i)
+        {
+            random_triangles(v, NUM_TRIANGLES, sizes[i], sizes[i]);
+            for (size_t threads=1; threads <= cpus; threads <<= 1)
+                call("raster", sizes[i], sizes[i], threads, v, NUM_TRIANGLES);
+            if ((cpus & (cpus - 1)) != 0)
+                call("raster", sizes[i], sizes[i], cpus, v, NUM_TRIANGLES);
+            PTEST_SEPARATOR;
+        }
+
+        free(v);
+    }
+
+PTEST_END
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/r3d/wgl/sw_backend.h>
+#include <lsp-plug.in/r3d/wgl/trace.h>
+#include <private/wgl/trace.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t GRID_SIZE      = 64;       // Grid of GRID_SIZE x GRID_SIZE quads
+    constexpr size_t NUM_FRAMES     = 16;
+
+    typedef struct scene_t
+    {
+        r3d::dot4_t    *vVertices;
+        r3d::vec4_t    *vNormals;
+        r3d::color_t   *vColors;
+        uint32_t       *vIndices;
+        size_t          nTriangles;
+    } scene_t;
+
+    static bool build_scene(scene_t *s)
+    {
+        const size_t n      = GRID_SIZE + 1;
+        s->vVertices        = static_cast<r3d::dot4_t *>(malloc(n * n * sizeof(r3d::dot4_t)));
+        s->vNormals         = static_cast<r3d::vec4_t *>(malloc(n * n * sizeof(r3d::vec4_t)));
+        s->vColors          = static_cast<r3d::color_t *>(malloc(n * n * sizeof(r3d::color_t)));
+        s->vIndices         = static_cast<uint32_t *>(malloc(GRID_SIZE * GRID_SIZE * 6 * sizeof(uint32_t)));
+        s->nTriangles       = GRID_SIZE * GRID_SIZE * 2;
+        if ((s->vVertices == NULL) || (s->vNormals == NULL) || (s->vColors == NULL) || (s->vIndices == NULL))
+            return false;
+
+        // Wavy surface
+        for (size_t y=0; y<n; ++y)
+            for (size_t x=0; x<n; ++x)
+            {
+                float fx            = float(x) / GRID_SIZE * 2.0f - 1.0f;
+                float fy            = float(y) / GRID_SIZE * 2.0f - 1.0f;
+                float fz            = 0.1f * sinf(fx * 6.0f) * cosf(fy * 6.0f);
+                size_t i            = y * n + x;
+
+                r3d::dot4_t *v      = &s->vVertices[i];
+                v->x = 0.8f * fx;   v->y = 0.8f * fy;   v->z = fz;  v->w = 1.0f;
+
+                r3d::vec4_t *nv     = &s->vNormals[i];
+                nv->dx  = -0.6f * cosf(fx * 6.0f) * cosf(fy * 6.0f);
+                nv->dy  = 0.6f * sinf(fx * 6.0f) * sinf(fy * 6.0f);
+                nv->dz  = 1.0f;
+                nv->dw  = 0.0f;
+
+                r3d::color_t *c     = &s->vColors[i];
+                c->r = 0.5f + 0.5f * fx;    c->g = 0.5f + 0.5f * fy;    c->b = 0.5f;    c->a = 1.0f;
+            }
+
+        uint32_t *idx       = s->vIndices;
+        for (size_t y=0; y<GRID_SIZE; ++y)
+            for (size_t x=0; x<GRID_SIZE; ++x, idx += 6)
+            {
+                uint32_t i          = uint32_t(y * n + x);
+                idx[0] = i;     idx[1] = i + 1;     idx[2] = i + n + 1;
+                idx[3] = i;     idx[4] = i + n + 1; idx[5] = i + n;
+            }
+
+        return true;
+    }
+
+    static void destroy_scene(scene_t *s)
+    {
+        free(s->vVertices);
+        free(s->vNormals);
+        free(s->vColors);
+        free(s->vIndices);
+    }
+
+    static status_t record_trace(const char *path, const scene_t *s, size_t width, size_t height)
+    {
+        trace_writer_t w;
+        w.construct();
+        status_t res        = w.open(path);
+        if (res != STATUS_OK)
+        {
+            w.destroy();
+            return res;
+        }
+
+        r3d::color_t bg     = { 0.0f, 0.0f, 0.0f, 1.0f };
+        r3d::light_t light;
+        memset(&light, 0, sizeof(light));
+        light.type          = r3d::LIGHT_DIRECTIONAL;
+        light.direction.dx  = -0.3f;
+        light.direction.dy  = -0.3f;
+        light.direction.dz  = -1.0f;
+        light.ambient.r     = 0.2f;     light.ambient.g     = 0.2f;     light.ambient.b     = 0.2f;     light.ambient.a     = 1.0f;
+        light.diffuse.r     = 0.8f;     light.diffuse.g     = 0.8f;     light.diffuse.b     = 0.8f;     light.diffuse.a     = 1.0f;
+        light.constant      = 1.0f;
+
+        r3d::buffer_t b;
+        memset(&b, 0, sizeof(b));
+        b.type              = r3d::PRIMITIVE_TRIANGLES;
+        b.count             = s->nTriangles;
+        b.flags             = r3d::BUFFER_LIGHTING | r3d::BUFFER_NO_CULLING;
+        b.vertex.data       = s->vVertices;
+        b.vertex.index      = s->vIndices;
+        b.normal.data       = s->vNormals;
+        b.normal.index      = s->vIndices;
+        b.color.data        = s->vColors;
+        b.color.index       = s->vIndices;
+
+        w.locate(0, 0, width, height);
+        for (size_t f=0; f<NUM_FRAMES; ++f)
+        {
+            // Rotate the surface around the Y axis
+            float a             = (f * 2.0f * M_PI) / NUM_FRAMES;
+            memset(&b.model, 0, sizeof(b.model));
+            b.model.m[0]        = cosf(a);
+            b.model.m[2]        = -sinf(a);
+            b.model.m[5]        = 1.0f;
+            b.model.m[8]        = sinf(a);
+            b.model.m[10]       = cosf(a);
+            b.model.m[15]       = 1.0f;
+
+            w.start(&bg);
+            w.set_lights(&light, 1);
+            w.draw_primitives(&b);
+            w.read_pixels(r3d::PIXEL_RGBA);
+            w.finish();
+        }
+
+        res                 = w.close();
+        w.destroy();
+        return res;
+    }
+}
+
+PTEST_BEGIN("r3d.wgl", trace, 5, 4)
+
+    void call(const char *path, size_t width, size_t height)
+    {
+        sw_backend_t *s     = static_cast<sw_backend_t *>(malloc(sizeof(sw_backend_t)));
+        if (s == NULL)
+            return;
+        s->construct();
+        if (s->init_offscreen(s) != STATUS_OK)
+        {
+            s->destroy(s);
+            free(s);
+            return;
+        }
+
+        char buf[80];
+        snprintf(buf, sizeof(buf), "replay sw %dx%d, %d frames", int(width), int(height), int(NUM_FRAMES));
+        printf("Testing %s...\n", buf);
+
+        trace_stats_t stats;
+        memset(&stats, 0, sizeof(stats));
+        PTEST_LOOP(buf,
+            replay_trace(s, path, &stats);
+        );
+
+        printf("  last replay: calls=%d, frames=%d, draws=%d, errors=%d, total=%.3f ms, frame min=%.3f ms, max=%.3f ms\n",
+            int(stats.nCalls), int(stats.nFrames), int(stats.nDraws), int(stats.nErrors),
+            stats.nTotalTime * 1e-6, stats.nFrameMin * 1e-6, stats.nFrameMax * 1e-6);
+
+        s->destroy(s);
+        free(s);
+    }
+
+    PTEST_MAIN
+    {
+        static const size_t sizes[] = { 256, 512, 1024 };
+
+        scene_t scene;
+        if (!build_scene(&scene))
+        {
+            destroy_scene(&scene);
+            return;
+        }
+
+        char path[1024];
+        for (size_t i=0; i<sizeof(sizes)/sizeof(sizes[0]); ++i)
+        {
+            snprintf(path, sizeof(path), "%s/r3d-wgl-ptest-trace-%d.bin", tempdir(), int(sizes[i]));
+            if (record_trace(path, &scene, sizes[i], sizes[i]) != STATUS_OK)
+            {
+                printf("Could not record trace %s\n", path);
+                continue;
+            }
+
+            call(path, sizes[i], sizes[i]);
+            remove(path);
+        }
+
+        destroy_scene(&scene);
+    }
+
+PTEST_END
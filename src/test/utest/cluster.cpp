@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/wgl/arena.h>
+#include <private/wgl/cluster.h>
+#include <private/wgl/matrix.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t SPHERE_SEGMENTS    = 96;
+    constexpr size_t SPHERE_RINGS       = 48;
+    constexpr size_t SPHERE_VERTICES    = (SPHERE_SEGMENTS + 1) * (SPHERE_RINGS + 1);
+    constexpr size_t SPHERE_INDICES     = SPHERE_SEGMENTS * SPHERE_RINGS * 6;
+    constexpr size_t NUM_CAMERAS        = 40;
+
+    /**
+     * Build the sphere of radius 3 with counter-clockwise triangles when looking from outside
+     */
+    static void build_sphere(r3d::dot4_t *v, uint32_t *idx)
+    {
+        for (size_t j=0; j<=SPHERE_RINGS; ++j)
+            for (size_t i=0; i<=SPHERE_SEGMENTS; ++i)
+            {
+                float th        = (M_PI * j) / SPHERE_RINGS;
+                float ph        = (2.0f * M_PI * i) / SPHERE_SEGMENTS;
+                r3d::dot4_t *p  = &v[j * (SPHERE_SEGMENTS + 1) + i];
+                p->x            = 3.0f * sinf(th) * cosf(ph);
+                p->y            = 3.0f * cosf(th);
+                p->z            = 3.0f * sinf(th) * sinf(ph);
+                p->w            = 1.0f;
+            }
+
+        for (size_t j=0; j<SPHERE_RINGS; ++j)
+            for (size_t i=0; i<SPHERE_SEGMENTS; ++i, idx += 6)
+            {
+                uint32_t a      = uint32_t(j * (SPHERE_SEGMENTS + 1) + i);
+                uint32_t b      = a + 1;
+                uint32_t c      = a + SPHERE_SEGMENTS + 1;
+                uint32_t d      = c + 1;
+                idx[0] = a;     idx[1] = c;     idx[2] = b;
+                idx[3] = b;     idx[4] = c;     idx[5] = d;
+            }
+    }
+
+    static void perspective(r3d::mat4_t *m, float fov, float znear, float zfar)
+    {
+        float t         = 1.0f / tanf(fov * 0.5f);
+        memset(m, 0, sizeof(r3d::mat4_t));
+        m->m[0]         = t;
+        m->m[5]         = t;
+        m->m[10]        = (zfar + znear) / (znear - zfar);
+        m->m[11]        = -1.0f;
+        m->m[14]        = 2.0f * zfar * znear / (znear - zfar);
+    }
+
+    static void orthogonal(r3d::mat4_t *m)
+    {
+        memset(m, 0, sizeof(r3d::mat4_t));
+        m->m[0]         = 0.2f;
+        m->m[5]         = 0.2f;
+        m->m[10]        = -0.01f;
+        m->m[15]        = 1.0f;
+    }
+
+    static void camera(r3d::mat4_t *proj, r3d::mat4_t *mv, size_t index)
+    {
+        if ((index % 5) == 4)
+            orthogonal(proj);
+        else
+            perspective(proj, 1.0f, 0.5f, 100.0f);
+
+        // Rotate, scale and move the sphere partially out of the view
+        float a         = index * 0.37f;
+        float s         = ((index % 3) == 0) ? 1.5f : 1.0f;
+        matrix_identity(mv);
+        mv->m[0]        = cosf(a) * s;
+        mv->m[2]        = -sinf(a) * s;
+        mv->m[5]        = s;
+        mv->m[8]        = sinf(a) * s;
+        mv->m[10]       = cosf(a) * s;
+        mv->m[12]       = ((index % 4) - 1.5f) * 2.5f;
+        mv->m[14]       = -4.0f - (index % 7);
+    }
+
+    /**
+     * Reference per-triangle test: the triangle is visible if it is not entirely outside
+     * one of the clip planes and is front-facing (or crosses the w = 0 plane)
+     */
+    static bool triangle_visible(const r3d::mat4_t *mvp, const r3d::dot4_t *v, const uint32_t *idx, bool cull)
+    {
+        r3d::dot4_t c[3];
+        for (size_t i=0; i<3; ++i)
+            matrix_apply(&c[i], mvp, &v[idx[i]]);
+
+        for (size_t axis=0; axis<3; ++axis)
+        {
+            bool below = true, above = true;
+            for (size_t i=0; i<3; ++i)
+            {
+                float x     = (&c[i].x)[axis];
+                if (x >= -c[i].w)
+                    below       = false;
+                if (x <= c[i].w)
+                    above       = false;
+            }
+            if ((below) || (above))
+                return false;
+        }
+
+        if (!cull)
+            return true;
+        for (size_t i=0; i<3; ++i)
+            if (c[i].w <= 0.0f)
+                return true;
+
+        float ax = c[0].x / c[0].w, ay = c[0].y / c[0].w;
+        float bx = c[1].x / c[1].w, by = c[1].y / c[1].w;
+        float cx = c[2].x / c[2].w, cy = c[2].y / c[2].w;
+        return ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax)) > 0.0f;
+    }
+}
+
+UTEST_BEGIN("r3d.wgl", cluster)
+
+    void test_cull(const r3d::dot4_t *v, const uint32_t *idx, const char *label)
+    {
+        cluster_set_t cs;
+        cs.construct();
+        UTEST_ASSERT(cs.build(v, 0, idx, SPHERE_INDICES) == STATUS_OK);
+        UTEST_ASSERT(cs.nClusters == (SPHERE_INDICES / 3 + CLUSTER_TRIANGLES - 1) / CLUSTER_TRIANGLES);
+
+        cluster_range_t *ranges = static_cast<cluster_range_t *>(malloc(sizeof(cluster_range_t) * ((cs.nClusters + 1) / 2)));
+        bool *drawn             = static_cast<bool *>(malloc(SPHERE_INDICES / 3));
+        UTEST_ASSERT((ranges != NULL) && (drawn != NULL));
+
+        size_t culled_total     = 0;
+        for (size_t cam=0; cam<NUM_CAMERAS; ++cam)
+        {
+            r3d::mat4_t proj, mv, mvp;
+            camera(&proj, &mv, cam);
+            matrix_mul(&mvp, &proj, &mv);
+
+            for (size_t cones=0; cones<2; ++cones)
+            {
+                cluster_view_t view;
+                cluster_view(&view, &proj, &mv, cones);
+
+                size_t visible      = 0;
+                size_t n            = cs.cull(ranges, &view, &visible);
+                UTEST_ASSERT(n <= (cs.nClusters + 1) / 2);
+                UTEST_ASSERT(visible <= cs.nClusters);
+
+                // Ranges should be ordered, disjoint, merged and aligned to triangles
+                memset(drawn, 0, SPHERE_INDICES / 3);
+                size_t indices      = 0;
+                for (size_t i=0; i<n; ++i)
+                {
+                    const cluster_range_t *r = &ranges[i];
+                    UTEST_ASSERT((r->count > 0) && ((r->first % 3) == 0) && ((r->count % 3) == 0));
+                    UTEST_ASSERT(r->first + r->count <= SPHERE_INDICES);
+                    if (i > 0)
+                        UTEST_ASSERT_MSG(ranges[i-1].first + ranges[i-1].count < r->first,
+                            "%s camera %d: ranges %d and %d are not ordered or not merged", label, int(cam), int(i-1), int(i));
+
+                    for (size_t k=0; k<r->count/3; ++k)
+                        drawn[r->first/3 + k]   = true;
+                    indices            += r->count;
+                }
+                UTEST_ASSERT(indices <= visible * CLUSTER_TRIANGLES * 3);
+                UTEST_ASSERT(indices + CLUSTER_TRIANGLES * 3 > visible * CLUSTER_TRIANGLES * 3);
+
+                // Culling is conservative: each visible triangle should be drawn
+                for (size_t t=0; t<SPHERE_INDICES/3; ++t)
+                {
+                    if (!triangle_visible(&mvp, v, &idx[t*3], cones))
+                        continue;
+                    UTEST_ASSERT_MSG(drawn[t], "%s camera %d cones=%d: visible triangle %d is culled",
+                        label, int(cam), int(cones), int(t));
+                }
+
+                culled_total       += cs.nClusters - visible;
+            }
+        }
+
+        // Clusters outside the frustum and back-facing clusters should be culled at all
+        printf("  %s: culled %d of %d cluster tests\n", label, int(culled_total), int(cs.nClusters * NUM_CAMERAS * 2));
+        UTEST_ASSERT(culled_total > 0);
+
+        free(ranges);
+        free(drawn);
+        cs.destroy();
+    }
+
+    UTEST_MAIN
+    {
+        r3d::dot4_t *v      = static_cast<r3d::dot4_t *>(malloc(SPHERE_VERTICES * sizeof(r3d::dot4_t)));
+        uint32_t *idx       = static_cast<uint32_t *>(malloc(SPHERE_INDICES * sizeof(uint32_t)));
+        uint32_t *sorted    = static_cast<uint32_t *>(malloc(SPHERE_INDICES * sizeof(uint32_t)));
+        UTEST_ASSERT((v != NULL) && (idx != NULL) && (sorted != NULL));
+        build_sphere(v, idx);
+
+        printf("Testing clusters of rings...\n");
+        test_cull(v, idx, "rings");
+
+        // Sorted triangles should be the permutation of source triangles
+        arena_t arena;
+        arena.construct();
+        memcpy(sorted, idx, SPHERE_INDICES * sizeof(uint32_t));
+        UTEST_ASSERT(cluster_sort(sorted, SPHERE_INDICES, v, 0, &arena) == STATUS_OK);
+        arena.destroy();
+
+        uint32_t *count     = static_cast<uint32_t *>(calloc(SPHERE_INDICES / 3, sizeof(uint32_t)));
+        UTEST_ASSERT(count != NULL);
+        for (size_t t=0; t<SPHERE_INDICES/3; ++t)
+        {
+            // The first vertex of the triangle identifies it in this mesh along with the second one
+            const uint32_t *s   = &sorted[t*3];
+            size_t found        = SPHERE_INDICES / 3;
+            for (size_t k=0; k<SPHERE_INDICES/3; ++k)
+            {
+                if ((idx[k*3] == s[0]) && (idx[k*3+1] == s[1]) && (idx[k*3+2] == s[2]))
+                {
+                    found           = k;
+                    break;
+                }
+            }
+            UTEST_ASSERT_MSG(found < SPHERE_INDICES / 3, "Sorted triangle %d does not exist in the source", int(t));
+            ++count[found];
+        }
+        for (size_t t=0; t<SPHERE_INDICES/3; ++t)
+            UTEST_ASSERT(count[t] == 1);
+        free(count);
+
+        printf("Testing clusters of sorted triangles...\n");
+        test_cull(v, sorted, "sorted");
+
+        free(v);
+        free(idx);
+        free(sorted);
+    }
+
+UTEST_END
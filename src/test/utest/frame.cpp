@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/common/types.h>
+#include <private/wgl/frame.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <lsp-plug.in/r3d/wgl/backend.h>
+#endif /* PLATFORM_WINDOWS */
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t FRAME_WIDTH    = 64;
+    constexpr size_t FRAME_HEIGHT   = 48;
+    constexpr size_t FRAME_SIZE     = FRAME_WIDTH * FRAME_HEIGHT * 4;
+
+#ifdef PLATFORM_WINDOWS
+    /**
+     * Draw the frame with the thin triangle which has long stair-stepped edges
+     */
+    static status_t draw_frame(r3d::backend_t *b, void *pixels, uint32_t id)
+    {
+        static const r3d::dot4_t v[] =
+        {
+            { -0.9f, -0.8f, 0.0f, 1.0f },
+            {  0.9f, -0.6f, 0.0f, 1.0f },
+            { -0.7f,  0.9f, 0.0f, 1.0f }
+        };
+
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        for (size_t i=0; i<4; ++i)
+            buf.model.m[i*5]    = 1.0f;
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.count           = 1;
+        buf.flags           = r3d::BUFFER_NO_CULLING;
+        buf.vertex.data     = v;
+        buf.color.dfl.r     = 1.0f;
+        buf.color.dfl.g     = 1.0f;
+        buf.color.dfl.b     = 1.0f;
+        buf.color.dfl.a     = 1.0f;
+
+        status_t res        = b->start(b);
+        if (res != STATUS_OK)
+            return res;
+        res                 = wgl::backend_t::set_object_id(b, id);
+        if (res == STATUS_OK)
+            res                 = b->draw_primitives(b, &buf);
+        if (res == STATUS_OK)
+            res                 = b->read_pixels(b, pixels, r3d::PIXEL_RGBA);
+        status_t fres       = b->finish(b);
+
+        return (res != STATUS_OK) ? res : fres;
+    }
+#endif /* PLATFORM_WINDOWS */
+}
+
+UTEST_BEGIN("r3d.wgl", frame)
+
+    void test_hash()
+    {
+        static const r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+        frame_t f;
+        f.construct();
+
+        // Values shorter than the word should change the hash too
+        uint64_t h[4];
+        for (size_t i=0; i<2; ++i)
+        {
+            bool flag           = (i > 0);
+            f.clear(&bg, FRAME_WIDTH, FRAME_HEIGHT, 0);
+            f.add_hash(&flag, sizeof(flag));
+            h[i]                = f.nHash;
+
+            uint32_t value      = uint32_t(i);
+            f.clear(&bg, FRAME_WIDTH, FRAME_HEIGHT, 0);
+            f.add_hash(&value, sizeof(value));
+            h[i + 2]            = f.nHash;
+        }
+        UTEST_ASSERT(h[0] != h[1]);
+        UTEST_ASSERT(h[2] != h[3]);
+
+        // Draws of the same buffer with different object identifiers should differ
+        r3d::mat4_t m;
+        r3d::buffer_t buf;
+        memset(&m, 0, sizeof(m));
+        memset(&buf, 0, sizeof(buf));
+        for (size_t i=0; i<2; ++i)
+        {
+            f.clear(&bg, FRAME_WIDTH, FRAME_HEIGHT, 0);
+            UTEST_ASSERT(f.add_draw(&buf, &m, &m, &m, NULL, uint32_t(i + 1)) == STATUS_OK);
+            h[i]                = f.nHash;
+        }
+        UTEST_ASSERT(h[0] != h[1]);
+
+        f.destroy();
+    }
+
+#ifdef PLATFORM_WINDOWS
+    /**
+     * Create the OpenGL backend with frame reuse and opaque black background
+     * @return backend or NULL if OpenGL is not available
+     */
+    wgl::backend_t *create_backend()
+    {
+        static const r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+        wgl::backend_t *b   = static_cast<wgl::backend_t *>(malloc(sizeof(wgl::backend_t)));
+        UTEST_ASSERT(b != NULL);
+        b->construct();
+        if (b->init_offscreen(b) != STATUS_OK)
+        {
+            printf("  OpenGL backend is not available, skipping\n");
+            b->destroy(b);
+            free(b);
+            return NULL;
+        }
+
+        UTEST_ASSERT(b->locate(b, 0, 0, FRAME_WIDTH, FRAME_HEIGHT) == STATUS_OK);
+        UTEST_ASSERT(b->set_bg_color(b, &bg) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::set_frame_reuse(b, true) == STATUS_OK);
+
+        return b;
+    }
+
+    void test_fxaa_reuse()
+    {
+        wgl::backend_t *b   = create_backend();
+        if (b == NULL)
+            return;
+
+        uint8_t *pixels     = static_cast<uint8_t *>(malloc(FRAME_SIZE * 4));
+        UTEST_ASSERT(pixels != NULL);
+
+        // Toggling FXAA between identical frames should draw the frame again
+        UTEST_ASSERT(draw_frame(b, &pixels[0], 0) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::set_fxaa(b, true) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &pixels[FRAME_SIZE], 0) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::set_fxaa(b, false) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &pixels[FRAME_SIZE * 2], 0) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &pixels[FRAME_SIZE * 3], 0) == STATUS_OK);
+
+        frame_stats_t stats;
+        UTEST_ASSERT(wgl::backend_t::get_frame_stats(b, &stats) == STATUS_OK);
+        printf("  frames=%d, drawn=%d, skipped=%d\n", int(stats.nFrames), int(stats.nDrawn), int(stats.nSkipped));
+        UTEST_ASSERT(stats.nDrawn == 3);
+        UTEST_ASSERT(stats.nSkipped == 1);
+
+        UTEST_ASSERT(memcmp(&pixels[0], &pixels[FRAME_SIZE], FRAME_SIZE) != 0);
+        UTEST_ASSERT(memcmp(&pixels[0], &pixels[FRAME_SIZE * 2], FRAME_SIZE) == 0);
+        UTEST_ASSERT(memcmp(&pixels[0], &pixels[FRAME_SIZE * 3], FRAME_SIZE) == 0);
+
+        free(pixels);
+        b->destroy(b);
+        free(b);
+    }
+
+    void test_picking_reuse()
+    {
+        wgl::backend_t *b   = create_backend();
+        if (b == NULL)
+            return;
+
+        uint8_t *pixels     = static_cast<uint8_t *>(malloc(FRAME_SIZE * 4));
+        UTEST_ASSERT(pixels != NULL);
+
+        // The background of the picking frame matches the opaque black background,
+        // so toggling of the picking mode should be detected by the flag itself
+        UTEST_ASSERT(draw_frame(b, &pixels[0], 1) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::set_picking(b, true) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &pixels[FRAME_SIZE], 1) == STATUS_OK);
+
+        // Changing of the object identifier over the same geometry should draw the frame again
+        UTEST_ASSERT(draw_frame(b, &pixels[FRAME_SIZE * 2], 2) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &pixels[FRAME_SIZE * 3], 2) == STATUS_OK);
+
+        frame_stats_t stats;
+        UTEST_ASSERT(wgl::backend_t::get_frame_stats(b, &stats) == STATUS_OK);
+        printf("  frames=%d, drawn=%d, skipped=%d\n", int(stats.nFrames), int(stats.nDrawn), int(stats.nSkipped));
+        UTEST_ASSERT(stats.nDrawn == 3);
+        UTEST_ASSERT(stats.nSkipped == 1);
+
+        UTEST_ASSERT(memcmp(&pixels[0], &pixels[FRAME_SIZE], FRAME_SIZE) != 0);
+        UTEST_ASSERT(memcmp(&pixels[FRAME_SIZE], &pixels[FRAME_SIZE * 2], FRAME_SIZE) != 0);
+        UTEST_ASSERT(memcmp(&pixels[FRAME_SIZE * 2], &pixels[FRAME_SIZE * 3], FRAME_SIZE) == 0);
+
+        free(pixels);
+        b->destroy(b);
+        free(b);
+    }
+#endif /* PLATFORM_WINDOWS */
+
+    UTEST_MAIN
+    {
+        printf("Testing hash of frame inputs...\n");
+        test_hash();
+    #ifdef PLATFORM_WINDOWS
+        printf("Testing FXAA with frame reuse...\n");
+        test_fxaa_reuse();
+        printf("Testing picking with frame reuse...\n");
+        test_picking_reuse();
+    #endif /* PLATFORM_WINDOWS */
+    }
+
+UTEST_END
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/wgl/arena.h>
+#include <private/wgl/fxaa.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t IMAGE_WIDTH    = 157;
+    constexpr size_t IMAGE_HEIGHT   = 61;
+    constexpr size_t SUPERSAMPLING  = 8;
+
+    static const uint8_t fg_color[] = { 230, 200, 40 };
+    static const uint8_t bg_color[] = { 20, 40, 220 };
+
+    /**
+     * The edge with the slope of 0.3 which produces long stairs when rasterized
+     */
+    static inline float edge_distance(float x, float y)
+    {
+        return y * 0.3f + 20.0f - x;
+    }
+
+    static void draw_edge(uint8_t *img, size_t stride, size_t bpp, bool exact)
+    {
+        for (size_t y=0; y<IMAGE_HEIGHT; ++y)
+            for (size_t x=0; x<IMAGE_WIDTH; ++x)
+            {
+                // Aliased image takes the sample at the pixel center, exact image is supersampled
+                float k         = 0.0f;
+                if (exact)
+                {
+                    for (size_t sy=0; sy<SUPERSAMPLING; ++sy)
+                        for (size_t sx=0; sx<SUPERSAMPLING; ++sx)
+                        {
+                            float px        = x + (sx + 0.5f) / SUPERSAMPLING;
+                            float py        = y + (sy + 0.5f) / SUPERSAMPLING;
+                            if (edge_distance(px, py) > 0.0f)
+                                k              += 1.0f;
+                        }
+                    k          /= SUPERSAMPLING * SUPERSAMPLING;
+                }
+                else
+                    k           = (edge_distance(x + 0.5f, y + 0.5f) > 0.0f) ? 1.0f : 0.0f;
+
+                uint8_t *p      = &img[y * stride + x * bpp];
+                for (size_t i=0; i<3; ++i)
+                    p[i]            = uint8_t(bg_color[i] + (fg_color[i] - bg_color[i]) * k + 0.5f);
+                if (bpp == 4)
+                    p[3]            = uint8_t(x * 7 + y);
+            }
+    }
+
+    /**
+     * Get the maximum difference of the first channel between vertically adjacent pixels,
+     * the edge is close to vertical, so each stair produces the full step
+     */
+    static int max_stair(const uint8_t *img, size_t stride, size_t bpp)
+    {
+        int result      = 0;
+        for (size_t y=1; y<IMAGE_HEIGHT; ++y)
+            for (size_t x=0; x<IMAGE_WIDTH; ++x)
+            {
+                int a           = img[(y - 1) * stride + x * bpp];
+                int b           = img[y * stride + x * bpp];
+                result          = lsp_max(result, abs(a - b));
+            }
+        return result;
+    }
+
+    static int row_sum(const uint8_t *img, size_t stride, size_t bpp, size_t y)
+    {
+        int result      = 0;
+        for (size_t x=0; x<IMAGE_WIDTH; ++x)
+            result         += img[y * stride + x * bpp];
+        return result;
+    }
+}
+
+UTEST_BEGIN("r3d.wgl", fxaa)
+
+    void test_edge(size_t bpp, arena_t *arena)
+    {
+        size_t stride   = IMAGE_WIDTH * bpp + 5;
+        size_t size     = stride * IMAGE_HEIGHT;
+        uint8_t *src    = static_cast<uint8_t *>(malloc(size));
+        uint8_t *dst    = static_cast<uint8_t *>(malloc(size));
+        uint8_t *exact  = static_cast<uint8_t *>(malloc(size));
+        uint8_t *packed = static_cast<uint8_t *>(malloc(IMAGE_WIDTH * bpp * IMAGE_HEIGHT * 2));
+        UTEST_ASSERT((src != NULL) && (dst != NULL) && (exact != NULL) && (packed != NULL));
+
+        memset(src, 0x55, size);
+        memset(dst, 0xaa, size);
+        memset(exact, 0x55, size);
+        draw_edge(src, stride, bpp, false);
+        draw_edge(exact, stride, bpp, true);
+
+        UTEST_ASSERT(fxaa(dst, stride, src, stride, IMAGE_WIDTH, IMAGE_HEIGHT, bpp, arena) == STATUS_OK);
+
+        size_t changed  = 0;
+        for (size_t y=0; y<IMAGE_HEIGHT; ++y)
+        {
+            // Padding of rows should stay untouched
+            for (size_t i=IMAGE_WIDTH * bpp; i<stride; ++i)
+                UTEST_ASSERT(dst[y * stride + i] == 0xaa);
+
+            for (size_t x=0; x<IMAGE_WIDTH; ++x)
+            {
+                const uint8_t *s    = &src[y * stride + x * bpp];
+                const uint8_t *d    = &dst[y * stride + x * bpp];
+                if (bpp == 4)
+                    UTEST_ASSERT_MSG(d[3] == s[3], "bpp=%d: alpha at (%d, %d) is modified", int(bpp), int(x), int(y));
+
+                // Pixels far from the edge should be copied as is
+                float dist          = fabsf(edge_distance(x + 0.5f, y + 0.5f));
+                if (dist >= 2.0f)
+                {
+                    UTEST_ASSERT_MSG(memcmp(s, d, 3) == 0,
+                        "bpp=%d: flat pixel (%d, %d) is modified", int(bpp), int(x), int(y));
+                    continue;
+                }
+
+                // Pixels on the edge should be the blend of the edge colors
+                for (size_t i=0; i<3; ++i)
+                {
+                    int lo = lsp_min(fg_color[i], bg_color[i]), hi = lsp_max(fg_color[i], bg_color[i]);
+                    UTEST_ASSERT_MSG((d[i] >= lo) && (d[i] <= hi),
+                        "bpp=%d: pixel (%d, %d) channel %d = %d is out of range", int(bpp), int(x), int(y), int(i), int(d[i]));
+                }
+                if (memcmp(s, d, 3) != 0)
+                    ++changed;
+            }
+        }
+
+        // The stairs of the edge should be smoothed
+        int before      = max_stair(src, stride, bpp);
+        int after       = max_stair(dst, stride, bpp);
+        printf("  bpp=%d: changed %d edge pixels, stair %d -> %d\n", int(bpp), int(changed), before, after);
+        UTEST_ASSERT(changed >= IMAGE_HEIGHT);
+        UTEST_ASSERT(after * 2 <= before);
+
+        // The coverage of each row should stay close to the exact one
+        int range       = abs(int(fg_color[0]) - int(bg_color[0]));
+        for (size_t y=0; y<IMAGE_HEIGHT; ++y)
+        {
+            int delta       = row_sum(dst, stride, bpp, y) - row_sum(exact, stride, bpp, y);
+            UTEST_ASSERT_MSG(abs(delta) <= range / 2,
+                "bpp=%d: coverage of row %d differs by %d from the exact one", int(bpp), int(y), delta);
+        }
+
+        // The result should not depend on the stride of rows
+        size_t pstride  = IMAGE_WIDTH * bpp;
+        for (size_t y=0; y<IMAGE_HEIGHT; ++y)
+            memcpy(&packed[y * pstride], &src[y * stride], pstride);
+        uint8_t *pdst   = &packed[pstride * IMAGE_HEIGHT];
+        UTEST_ASSERT(fxaa(pdst, pstride, packed, pstride, IMAGE_WIDTH, IMAGE_HEIGHT, bpp, arena) == STATUS_OK);
+        for (size_t y=0; y<IMAGE_HEIGHT; ++y)
+            UTEST_ASSERT(memcmp(&pdst[y * pstride], &dst[y * stride], pstride) == 0);
+
+        free(src);
+        free(dst);
+        free(exact);
+        free(packed);
+    }
+
+    void test_low_contrast(size_t bpp, arena_t *arena)
+    {
+        // The smooth gradient and the step below the minimum contrast are not edges
+        size_t stride   = IMAGE_WIDTH * bpp;
+        size_t size     = stride * IMAGE_HEIGHT;
+        uint8_t *src    = static_cast<uint8_t *>(malloc(size));
+        uint8_t *dst    = static_cast<uint8_t *>(malloc(size));
+        UTEST_ASSERT((src != NULL) && (dst != NULL));
+
+        for (size_t y=0; y<IMAGE_HEIGHT; ++y)
+            for (size_t x=0; x<IMAGE_WIDTH; ++x)
+            {
+                uint8_t *p      = &src[y * stride + x * bpp];
+                uint8_t v       = uint8_t(x + ((edge_distance(x + 0.5f, y + 0.5f) > 0.0f) ? 12 : 0));
+                p[0]            = v;
+                p[1]            = v;
+                p[2]            = v;
+                if (bpp == 4)
+                    p[3]            = 0xff;
+            }
+
+        UTEST_ASSERT(fxaa(dst, stride, src, stride, IMAGE_WIDTH, IMAGE_HEIGHT, bpp, arena) == STATUS_OK);
+        UTEST_ASSERT(memcmp(src, dst, size) == 0);
+
+        free(src);
+        free(dst);
+    }
+
+    UTEST_MAIN
+    {
+        arena_t arena;
+        arena.construct();
+
+        uint8_t pixel[4] = { 1, 2, 3, 4 };
+        UTEST_ASSERT(fxaa(pixel, 4, pixel, 4, 1, 1, 2, &arena) == STATUS_BAD_ARGUMENTS);
+        UTEST_ASSERT(fxaa(NULL, 0, NULL, 0, 0, 0, 4, &arena) == STATUS_OK);
+        UTEST_ASSERT(fxaa(NULL, 0, NULL, 0, 16, 0, 3, &arena) == STATUS_OK);
+
+        for (size_t bpp=3; bpp<=4; ++bpp)
+        {
+            printf("Testing edge for bpp=%d...\n", int(bpp));
+            test_edge(bpp, &arena);
+            printf("Testing low contrast image for bpp=%d...\n", int(bpp));
+            test_low_contrast(bpp, &arena);
+        }
+
+        arena.destroy();
+    }
+
+UTEST_END
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/wgl/optimize.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t GRID_SIZE      = 64;       // Grid of GRID_SIZE x GRID_SIZE quads
+    constexpr size_t NUM_VERTICES   = (GRID_SIZE + 1) * (GRID_SIZE + 1) + 1; // The last vertex is not referenced
+    constexpr size_t NUM_INDICES    = GRID_SIZE * GRID_SIZE * 6;
+
+    typedef struct triangle_t
+    {
+        uint32_t            v[3];
+    } triangle_t;
+
+    static void build_grid(uint32_t *idx, bool shuffle)
+    {
+        const uint32_t n    = GRID_SIZE + 1;
+        for (size_t y=0; y<GRID_SIZE; ++y)
+            for (size_t x=0; x<GRID_SIZE; ++x, idx += 6)
+            {
+                uint32_t i          = uint32_t(y * n + x);
+                idx[0] = i;     idx[1] = i + 1;     idx[2] = i + n + 1;
+                idx[3] = i;     idx[4] = i + n + 1; idx[5] = i + n;
+            }
+        if (!shuffle)
+            return;
+
+        // Fisher-Yates shuffle of triangles
+        triangle_t *t       = reinterpret_cast<triangle_t *>(idx - NUM_INDICES);
+        uint32_t seed       = 1;
+        for (size_t i=NUM_INDICES/3 - 1; i > 0; --i)
+        {
+            seed                = seed * 1664525 + 1013904223;
+            size_t j            = (seed >> 8) % (i + 1);
+            triangle_t tmp      = t[i];
+            t[i]                = t[j];
+            t[j]                = tmp;
+        }
+    }
+
+    static int cmp_triangles(const void *a, const void *b)
+    {
+        const uint32_t *ta  = static_cast<const triangle_t *>(a)->v;
+        const uint32_t *tb  = static_cast<const triangle_t *>(b)->v;
+        for (size_t i=0; i<3; ++i)
+        {
+            if (ta[i] != tb[i])
+                return (ta[i] < tb[i]) ? -1 : 1;
+        }
+        return 0;
+    }
+
+    /**
+     * Rotate each triangle to start with the smallest index, so the winding is kept,
+     * and sort the list of triangles
+     */
+    static void canonize(triangle_t *t, const uint32_t *idx, size_t count)
+    {
+        for (size_t i=0; i<count/3; ++i, idx += 3)
+        {
+            size_t k            = (idx[1] < idx[0]) ? 1 : 0;
+            if (idx[2] < idx[k])
+                k                   = 2;
+            for (size_t j=0; j<3; ++j)
+                t[i].v[j]           = idx[(k + j) % 3];
+        }
+        qsort(t, count/3, sizeof(triangle_t), cmp_triangles);
+    }
+}
+
+UTEST_BEGIN("r3d.wgl", optimize)
+
+    void test_grid(const char *label, bool shuffle)
+    {
+        printf("Testing %s grid...\n", label);
+
+        uint32_t *src       = static_cast<uint32_t *>(malloc(NUM_INDICES * sizeof(uint32_t)));
+        uint32_t *dst       = static_cast<uint32_t *>(malloc(NUM_INDICES * sizeof(uint32_t)));
+        uint32_t *remapped  = static_cast<uint32_t *>(malloc(NUM_INDICES * sizeof(uint32_t)));
+        uint32_t *order     = static_cast<uint32_t *>(malloc(NUM_VERTICES * sizeof(uint32_t)));
+        uint8_t *used       = static_cast<uint8_t *>(malloc(NUM_VERTICES));
+        triangle_t *ta      = static_cast<triangle_t *>(malloc(NUM_INDICES / 3 * sizeof(triangle_t)));
+        triangle_t *tb      = static_cast<triangle_t *>(malloc(NUM_INDICES / 3 * sizeof(triangle_t)));
+        UTEST_ASSERT((src != NULL) && (dst != NULL) && (remapped != NULL) && (order != NULL));
+        UTEST_ASSERT((used != NULL) && (ta != NULL) && (tb != NULL));
+
+        build_grid(src, shuffle);
+        memcpy(dst, src, NUM_INDICES * sizeof(uint32_t));
+
+        // Triangles are reordered, not changed
+        float before        = compute_acmr(src, NUM_INDICES, NUM_VERTICES, VCACHE_FIFO_SIZE);
+        UTEST_ASSERT(optimize_triangles(dst, NUM_INDICES, NUM_VERTICES) == STATUS_OK);
+        float after         = compute_acmr(dst, NUM_INDICES, NUM_VERTICES, VCACHE_FIFO_SIZE);
+        printf("  ACMR before=%.3f, after=%.3f\n", before, after);
+
+        canonize(ta, src, NUM_INDICES);
+        canonize(tb, dst, NUM_INDICES);
+        UTEST_ASSERT(memcmp(ta, tb, NUM_INDICES / 3 * sizeof(triangle_t)) == 0);
+        UTEST_ASSERT(after <= before);
+
+        // Renumbering of vertices is the permutation that keeps the triangles
+        // and does not change the cache behaviour
+        memcpy(remapped, dst, NUM_INDICES * sizeof(uint32_t));
+        UTEST_ASSERT(optimize_vertices(order, remapped, NUM_INDICES, NUM_VERTICES) == STATUS_OK);
+
+        memset(used, 0, NUM_VERTICES);
+        for (size_t i=0; i<NUM_VERTICES; ++i)
+        {
+            UTEST_ASSERT(order[i] < NUM_VERTICES);
+            UTEST_ASSERT(used[order[i]] == 0);
+            used[order[i]]      = 1;
+        }
+        UTEST_ASSERT(order[NUM_VERTICES - 1] == NUM_VERTICES - 1);
+
+        for (size_t i=0; i<NUM_INDICES; ++i)
+        {
+            UTEST_ASSERT(remapped[i] < NUM_VERTICES - 1);
+            UTEST_ASSERT(order[remapped[i]] == dst[i]);
+        }
+        UTEST_ASSERT(compute_acmr(remapped, NUM_INDICES, NUM_VERTICES, VCACHE_FIFO_SIZE) == after);
+
+        free(src);
+        free(dst);
+        free(remapped);
+        free(order);
+        free(used);
+        free(ta);
+        free(tb);
+    }
+
+    UTEST_MAIN
+    {
+        test_grid("regular", false);
+        test_grid("shuffled", true);
+    }
+
+UTEST_END
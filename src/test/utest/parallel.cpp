@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/r3d/wgl/factory.h>
+#include <private/sw/workers.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t NUM_BACKENDS   = 6;
+    constexpr size_t NUM_FRAMES     = 4;
+    constexpr size_t FRAME_WIDTH    = 160;
+    constexpr size_t FRAME_HEIGHT   = 120;
+    constexpr size_t NUM_SECTORS    = 24;
+
+    typedef struct context_t
+    {
+        r3d::backend_t *vBackends[NUM_BACKENDS];
+        uint8_t        *vPixels[NUM_BACKENDS];
+        status_t        vResult[NUM_BACKENDS];
+        size_t          nFrame;
+    } context_t;
+
+    /**
+     * Draw the frame that depends on the backend index and the frame number
+     */
+    static status_t draw_frame(r3d::backend_t *b, size_t index, size_t frame, void *pixels)
+    {
+        r3d::dot4_t v[NUM_SECTORS * 3];
+        r3d::color_t c[NUM_SECTORS * 3];
+        float phase         = (index * NUM_FRAMES + frame) * 0.1f;
+
+        for (size_t i=0; i<NUM_SECTORS; ++i)
+        {
+            float a0            = phase + (2.0f * M_PI * i) / NUM_SECTORS;
+            float a1            = phase + (2.0f * M_PI * (i + 1)) / NUM_SECTORS;
+            float r             = 0.5f + 0.4f * ((i + index) & 1);
+            r3d::dot4_t *p      = &v[i*3];
+            p[0].x = 0.0f;              p[0].y = 0.0f;              p[0].z = 0.0f;  p[0].w = 1.0f;
+            p[1].x = r * cosf(a0);      p[1].y = r * sinf(a0);      p[1].z = 0.5f;  p[1].w = 1.0f;
+            p[2].x = r * cosf(a1);      p[2].y = r * sinf(a1);      p[2].z = 0.5f;  p[2].w = 1.0f;
+
+            for (size_t j=0; j<3; ++j)
+            {
+                r3d::color_t *col   = &c[i*3 + j];
+                col->r  = float(i) / NUM_SECTORS;
+                col->g  = float(j) * 0.5f;
+                col->b  = float(index) / NUM_BACKENDS;
+                col->a  = 1.0f;
+            }
+        }
+
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        for (size_t i=0; i<4; ++i)
+            buf.model.m[i*5]    = 1.0f;
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.count           = NUM_SECTORS;
+        buf.flags           = r3d::BUFFER_NO_CULLING;
+        buf.vertex.data     = v;
+        buf.color.data      = c;
+
+        status_t res        = b->start(b);
+        if (res != STATUS_OK)
+            return res;
+        res                 = b->draw_primitives(b, &buf);
+        if (res == STATUS_OK)
+            res                 = b->read_pixels(b, pixels, r3d::PIXEL_RGBA);
+        status_t fres       = b->finish(b);
+
+        return (res != STATUS_OK) ? res : fres;
+    }
+
+    static void draw_task(void *arg, size_t index)
+    {
+        context_t *ctx          = static_cast<context_t *>(arg);
+        ctx->vResult[index]     = draw_frame(ctx->vBackends[index], index, ctx->nFrame, ctx->vPixels[index]);
+    }
+}
+
+UTEST_BEGIN("r3d.wgl", parallel)
+
+    bool init_backends(context_t *ctx, r3d::factory_t *f, size_t id)
+    {
+        static const r3d::color_t bg = { 0.1f, 0.2f, 0.3f, 1.0f };
+
+        for (size_t i=0; i<NUM_BACKENDS; ++i)
+        {
+            r3d::backend_t *b   = f->create(f, id);
+            UTEST_ASSERT(b != NULL);
+            ctx->vBackends[i]   = b;
+
+            if (b->init_offscreen(b) != STATUS_OK)
+                return false;
+            UTEST_ASSERT(b->locate(b, 0, 0, FRAME_WIDTH, FRAME_HEIGHT) == STATUS_OK);
+            UTEST_ASSERT(b->set_bg_color(b, &bg) == STATUS_OK);
+        }
+
+        return true;
+    }
+
+    void destroy_backends(context_t *ctx)
+    {
+        for (size_t i=0; i<NUM_BACKENDS; ++i)
+        {
+            r3d::backend_t *b   = ctx->vBackends[i];
+            if (b == NULL)
+                continue;
+            b->destroy(b);
+            free(b);
+            ctx->vBackends[i]   = NULL;
+        }
+    }
+
+    void test_backend(r3d::factory_t *f, size_t id, const char *name)
+    {
+        const size_t frame_size = FRAME_WIDTH * FRAME_HEIGHT * 4;
+        context_t ctx;
+        memset(&ctx, 0, sizeof(ctx));
+
+        uint8_t *serial     = static_cast<uint8_t *>(malloc(frame_size * NUM_BACKENDS * (NUM_FRAMES + 1)));
+        UTEST_ASSERT(serial != NULL);
+        uint8_t *parallel   = &serial[frame_size * NUM_BACKENDS * NUM_FRAMES];
+
+        if (!init_backends(&ctx, f, id))
+        {
+            printf("  backend %s is not available, skipping\n", name);
+            destroy_backends(&ctx);
+            free(serial);
+            return;
+        }
+
+        // Render frames in a single thread
+        for (size_t frame=0; frame<NUM_FRAMES; ++frame)
+            for (size_t i=0; i<NUM_BACKENDS; ++i)
+            {
+                uint8_t *dst        = &serial[(frame * NUM_BACKENDS + i) * frame_size];
+                UTEST_ASSERT(draw_frame(ctx.vBackends[i], i, frame, dst) == STATUS_OK);
+            }
+
+        // Render the same frames by all backends in parallel, each backend is used by
+        // any of the threads for each frame
+        sw::workers_t workers;
+        workers.construct();
+        UTEST_ASSERT(workers.init(NUM_BACKENDS - 1) == STATUS_OK);
+
+        for (size_t i=0; i<NUM_BACKENDS; ++i)
+            ctx.vPixels[i]      = &parallel[i * frame_size];
+
+        for (size_t frame=0; frame<NUM_FRAMES; ++frame)
+        {
+            ctx.nFrame          = frame;
+            workers.run(draw_task, &ctx, NUM_BACKENDS);
+
+            for (size_t i=0; i<NUM_BACKENDS; ++i)
+            {
+                UTEST_ASSERT_MSG(ctx.vResult[i] == STATUS_OK,
+                    "Backend %s #%d frame %d: error %d", name, int(i), int(frame), int(ctx.vResult[i]));
+                const uint8_t *ref  = &serial[(frame * NUM_BACKENDS + i) * frame_size];
+                UTEST_ASSERT_MSG(memcmp(ref, ctx.vPixels[i], frame_size) == 0,
+                    "Backend %s #%d frame %d: parallel output differs from serial", name, int(i), int(frame));
+            }
+        }
+
+        // Different backends should produce different images
+        UTEST_ASSERT(memcmp(&serial[0], &serial[frame_size], frame_size) != 0);
+
+        workers.destroy();
+        destroy_backends(&ctx);
+        free(serial);
+    }
+
+    UTEST_MAIN
+    {
+        wgl::factory_t factory;
+
+        for (size_t id=0; ; ++id)
+        {
+            const r3d::backend_metadata_t *meta = factory.metadata(&factory, id);
+            if (meta == NULL)
+                break;
+
+            printf("Testing backend %s...\n", meta->id);
+            test_backend(&factory, id, meta->id);
+        }
+    }
+
+UTEST_END
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/wgl/pixels.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    static const read_format_t formats[] =
+    {
+        READ_RGBA,
+        READ_BGRA,
+        READ_RGB,
+        READ_BGR,
+        READ_RGBA_PREMUL,
+        READ_BGRA_PREMUL,
+        READ_RGB565
+    };
+
+    static const char *format_names[] =
+    {
+        "RGBA",
+        "BGRA",
+        "RGB",
+        "BGR",
+        "RGBA_PREMUL",
+        "BGRA_PREMUL",
+        "RGB565"
+    };
+
+    // Exact rounded division by 255
+    static inline uint8_t premul(uint32_t c, uint32_t a)
+    {
+        return uint8_t((c * a * 2 + 255) / 510);
+    }
+
+    static size_t ref_convert(uint8_t *dst, const uint8_t *p, read_format_t format)
+    {
+        uint32_t a = p[3];
+
+        switch (format)
+        {
+            case READ_RGBA:
+                dst[0] = p[0];  dst[1] = p[1];  dst[2] = p[2];  dst[3] = p[3];
+                return 4;
+            case READ_BGRA:
+                dst[0] = p[2];  dst[1] = p[1];  dst[2] = p[0];  dst[3] = p[3];
+                return 4;
+            case READ_RGB:
+                dst[0] = p[0];  dst[1] = p[1];  dst[2] = p[2];
+                return 3;
+            case READ_BGR:
+                dst[0] = p[2];  dst[1] = p[1];  dst[2] = p[0];
+                return 3;
+            case READ_RGBA_PREMUL:
+                dst[0] = premul(p[0], a);   dst[1] = premul(p[1], a);   dst[2] = premul(p[2], a);   dst[3] = p[3];
+                return 4;
+            case READ_BGRA_PREMUL:
+                dst[0] = premul(p[2], a);   dst[1] = premul(p[1], a);   dst[2] = premul(p[0], a);   dst[3] = p[3];
+                return 4;
+            case READ_RGB565:
+            {
+                uint16_t v  = uint16_t(((p[0] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[2] >> 3));
+                memcpy(dst, &v, sizeof(v));
+                return 2;
+            }
+            default:
+                break;
+        }
+
+        return 0;
+    }
+}
+
+UTEST_BEGIN("r3d.wgl", pixels)
+
+    void test_premul()
+    {
+        // All combinations of color and alpha values
+        uint8_t src[256 * 4], dst[256 * 4];
+        for (size_t c=0; c<256; ++c)
+        {
+            for (size_t a=0; a<256; ++a)
+            {
+                uint8_t *p  = &src[a * 4];
+                p[0]        = uint8_t(c);
+                p[1]        = uint8_t(255 - c);
+                p[2]        = uint8_t(c ^ 0x5a);
+                p[3]        = uint8_t(a);
+            }
+
+            UTEST_ASSERT(convert_pixels(dst, sizeof(dst), src, sizeof(src), 256, 1, READ_RGBA_PREMUL, false) == STATUS_OK);
+            for (size_t a=0; a<256; ++a)
+            {
+                const uint8_t *p    = &src[a * 4];
+                const uint8_t *d    = &dst[a * 4];
+                UTEST_ASSERT_MSG(
+                    (d[0] == premul(p[0], a)) && (d[1] == premul(p[1], a)) && (d[2] == premul(p[2], a)) && (d[3] == a),
+                    "Premultiplication of color=%d alpha=%d gives %d %d %d %d",
+                    int(c), int(a), d[0], d[1], d[2], d[3]);
+            }
+        }
+    }
+
+    void test_format(size_t fi, size_t width, size_t height, bool flip)
+    {
+        read_format_t format    = formats[fi];
+        size_t bpp              = read_format_size(format);
+        UTEST_ASSERT(bpp > 0);
+
+        // Strides are not multiples of the pixel size to catch wrong addressing
+        size_t src_stride       = width * 4 + 12;
+        size_t dst_stride       = width * bpp + 7;
+        uint8_t *src            = static_cast<uint8_t *>(malloc(src_stride * height));
+        uint8_t *dst            = static_cast<uint8_t *>(malloc(dst_stride * height));
+        UTEST_ASSERT((src != NULL) && (dst != NULL));
+
+        for (size_t i=0; i<src_stride * height; ++i)
+            src[i]                  = uint8_t(rand());
+        memset(dst, 0xcc, dst_stride * height);
+
+        UTEST_ASSERT(convert_pixels(dst, dst_stride, src, src_stride, width, height, format, flip) == STATUS_OK);
+
+        for (size_t y=0; y<height; ++y)
+        {
+            const uint8_t *s        = &src[((flip) ? height - 1 - y : y) * src_stride];
+            const uint8_t *d        = &dst[y * dst_stride];
+
+            for (size_t x=0; x<width; ++x)
+            {
+                uint8_t e[4];
+                ref_convert(e, &s[x * 4], format);
+                UTEST_ASSERT_MSG(memcmp(e, &d[x * bpp], bpp) == 0,
+                    "Format %s, size %dx%d, flip=%d: pixel (%d, %d) differs",
+                    format_names[fi], int(width), int(height), int(flip), int(x), int(y));
+            }
+
+            // Padding of the destination row should not be touched
+            for (size_t x=width * bpp; x<dst_stride; ++x)
+                UTEST_ASSERT_MSG(d[x] == 0xcc,
+                    "Format %s, size %dx%d: padding of row %d is overwritten",
+                    format_names[fi], int(width), int(height), int(y));
+        }
+
+        free(src);
+        free(dst);
+    }
+
+    UTEST_MAIN
+    {
+        UTEST_ASSERT(read_format_size(read_format_t(-1)) == 0);
+
+        printf("Testing premultiplication...\n");
+        test_premul();
+
+        srand(0x900d);
+        for (size_t fi=0; fi<sizeof(formats)/sizeof(formats[0]); ++fi)
+        {
+            printf("Testing format %s...\n", format_names[fi]);
+
+            // Widths cover vector bodies and scalar tails of the kernels
+            for (size_t width=1; width<=67; ++width)
+                for (size_t height=1; height<=4; ++height)
+                {
+                    test_format(fi, width, height, false);
+                    test_format(fi, width, height, true);
+                }
+            test_format(fi, 640, 480, true);
+        }
+    }
+
+UTEST_END
@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/common/types.h>
+#include <private/wgl/queue.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <lsp-plug.in/r3d/wgl/backend.h>
+#endif /* PLATFORM_WINDOWS */
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t QUEUE_SIZE     = 256;
+    constexpr size_t NUM_RECORDS    = 4096;
+
+    typedef struct test_record_t
+    {
+        cmd_header_t        hdr;
+        uint32_t            seq;            // Sequence number of the record
+        uint32_t            bytes;          // Number of payload bytes filled with the sequence number
+    } test_record_t;
+
+    static uint32_t next_random(uint32_t *seed)
+    {
+        *seed       = *seed * 1664525 + 1013904223;
+        return *seed >> 8;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    constexpr size_t FRAME_WIDTH    = 64;
+    constexpr size_t FRAME_HEIGHT   = 64;
+    constexpr size_t FRAME_SIZE     = FRAME_WIDTH * FRAME_HEIGHT * 4;
+    constexpr size_t GRID_SIZE      = 256;      // Grid of the large buffer that does not fit into the queue
+    constexpr size_t NUM_STRIPS     = 512;      // Number of small buffers that wrap the queue around
+    constexpr size_t STRIP_SIZE     = 64;       // Number of triangles in the small buffer
+
+    typedef struct scene_t
+    {
+        r3d::dot4_t        *vGrid;
+        r3d::color_t       *vGridColors;
+        r3d::dot4_t        *vStrip;
+        r3d::color_t       *vStripColors;
+    } scene_t;
+
+    static void make_triangle(r3d::dot4_t *v, float x, float y, float w, float h)
+    {
+        v[0].x = x;         v[0].y = y;         v[0].z = 0.0f;  v[0].w = 1.0f;
+        v[1].x = x + w;     v[1].y = y;         v[1].z = 0.0f;  v[1].w = 1.0f;
+        v[2].x = x;         v[2].y = y + h;     v[2].z = 0.0f;  v[2].w = 1.0f;
+    }
+
+    static void make_color(r3d::color_t *c, float r, float g, float b)
+    {
+        c->r = r;   c->g = g;   c->b = b;   c->a = 1.0f;
+    }
+
+    static bool build_scene(scene_t *s)
+    {
+        s->vGrid            = static_cast<r3d::dot4_t *>(malloc(GRID_SIZE * GRID_SIZE * 3 * sizeof(r3d::dot4_t)));
+        s->vGridColors      = static_cast<r3d::color_t *>(malloc(GRID_SIZE * GRID_SIZE * 3 * sizeof(r3d::color_t)));
+        s->vStrip           = static_cast<r3d::dot4_t *>(malloc(STRIP_SIZE * 3 * sizeof(r3d::dot4_t)));
+        s->vStripColors     = static_cast<r3d::color_t *>(malloc(STRIP_SIZE * 3 * sizeof(r3d::color_t)));
+        if ((s->vGrid == NULL) || (s->vGridColors == NULL) || (s->vStrip == NULL) || (s->vStripColors == NULL))
+            return false;
+
+        // The grid covers the left half of the frame
+        float step          = 1.0f / GRID_SIZE;
+        for (size_t y=0; y<GRID_SIZE; ++y)
+            for (size_t x=0; x<GRID_SIZE; ++x)
+            {
+                size_t i            = (y * GRID_SIZE + x) * 3;
+                make_triangle(&s->vGrid[i], x * step - 1.0f, y * step * 2.0f - 1.0f, step, step * 2.0f);
+                for (size_t j=0; j<3; ++j)
+                    make_color(&s->vGridColors[i + j], float(x) / GRID_SIZE, float(y) / GRID_SIZE, 0.5f);
+            }
+
+        // The strip is drawn multiple times in the right half of the frame
+        step                = 1.0f / STRIP_SIZE;
+        for (size_t i=0; i<STRIP_SIZE; ++i)
+        {
+            make_triangle(&s->vStrip[i * 3], i * step, 0.0f, step, step);
+            for (size_t j=0; j<3; ++j)
+                make_color(&s->vStripColors[i * 3 + j], 0.5f, float(i) / STRIP_SIZE, 1.0f);
+        }
+
+        return true;
+    }
+
+    static void destroy_scene(scene_t *s)
+    {
+        free(s->vGrid);
+        free(s->vGridColors);
+        free(s->vStrip);
+        free(s->vStripColors);
+    }
+
+    static status_t draw_frame(r3d::backend_t *b, const scene_t *s, void *pixels)
+    {
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        for (size_t i=0; i<4; ++i)
+            buf.model.m[i*5]    = 1.0f;
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.flags           = r3d::BUFFER_NO_CULLING;
+
+        status_t res        = b->start(b);
+        if (res != STATUS_OK)
+            return res;
+
+        // Draw the large buffer
+        buf.count           = GRID_SIZE * GRID_SIZE;
+        buf.vertex.data     = s->vGrid;
+        buf.color.data      = s->vGridColors;
+        res                 = b->draw_primitives(b, &buf);
+
+        // Draw small buffers with different offsets
+        buf.count           = STRIP_SIZE;
+        buf.vertex.data     = s->vStrip;
+        buf.color.data      = s->vStripColors;
+        for (size_t i=0; (res == STATUS_OK) && (i<NUM_STRIPS); ++i)
+        {
+            buf.model.m[13]     = float(i) / NUM_STRIPS * 2.0f - 1.0f;
+            res                 = b->draw_primitives(b, &buf);
+        }
+
+        if (res == STATUS_OK)
+            res                 = b->read_pixels(b, pixels, r3d::PIXEL_RGBA);
+        status_t fres       = b->finish(b);
+
+        return (res != STATUS_OK) ? res : fres;
+    }
+#endif /* PLATFORM_WINDOWS */
+}
+
+UTEST_BEGIN("r3d.wgl", queue)
+
+    void check_record(cmd_queue_t *q, const cmd_header_t *hdr, uint32_t seq)
+    {
+        UTEST_ASSERT(hdr != NULL);
+
+        // Records are aligned and never cross the end of the ring
+        size_t off          = reinterpret_cast<const uint8_t *>(hdr) - q->vData;
+        UTEST_ASSERT((off % CMD_QUEUE_ALIGN) == 0);
+        UTEST_ASSERT(off + hdr->size <= q->nCapacity);
+        UTEST_ASSERT(hdr->type != CMD_PADDING);
+
+        const test_record_t *rec = reinterpret_cast<const test_record_t *>(hdr);
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(&rec[1]);
+        UTEST_ASSERT_MSG(rec->seq == seq, "Expected record %d, got %d", int(seq), int(rec->seq));
+        UTEST_ASSERT(sizeof(test_record_t) + rec->bytes <= hdr->size);
+        for (size_t i=0; i<rec->bytes; ++i)
+            UTEST_ASSERT(data[i] == uint8_t(seq));
+    }
+
+    void test_limits()
+    {
+        printf("Testing queue limits...\n");
+
+        cmd_queue_t q;
+        q.construct();
+        UTEST_ASSERT(q.init(QUEUE_SIZE) == STATUS_OK);
+        UTEST_ASSERT(q.nCapacity == QUEUE_SIZE);
+        UTEST_ASSERT(q.empty());
+        UTEST_ASSERT(q.fetch() == NULL);
+
+        // Records larger than the half of the ring are never accepted
+        UTEST_ASSERT(q.begin(1, q.max_record() + 1) == NULL);
+        UTEST_ASSERT(q.empty());
+
+        // The full ring does not accept more records until the consumer releases some space
+        size_t n            = 0;
+        for (cmd_header_t *hdr; (hdr = q.begin(1, sizeof(test_record_t))) != NULL; ++n)
+        {
+            reinterpret_cast<test_record_t *>(hdr)->seq     = uint32_t(n);
+            reinterpret_cast<test_record_t *>(hdr)->bytes   = 0;
+            q.commit();
+        }
+        UTEST_ASSERT(n == QUEUE_SIZE / CMD_QUEUE_ALIGN);
+
+        cmd_header_t *hdr   = q.fetch();
+        check_record(&q, hdr, 0);
+        q.release(hdr);
+        UTEST_ASSERT(q.begin(1, sizeof(test_record_t) + 1) == NULL);
+        hdr                 = q.begin(1, sizeof(test_record_t));
+        UTEST_ASSERT(hdr != NULL);
+        reinterpret_cast<test_record_t *>(hdr)->seq     = uint32_t(n);
+        reinterpret_cast<test_record_t *>(hdr)->bytes   = 0;
+        q.commit();
+
+        for (size_t i=1; i<=n; ++i)
+        {
+            hdr                 = q.fetch();
+            check_record(&q, hdr, uint32_t(i));
+            q.release(hdr);
+        }
+        UTEST_ASSERT(q.empty());
+        UTEST_ASSERT(q.fetch() == NULL);
+
+        q.destroy();
+    }
+
+    void test_wraparound()
+    {
+        printf("Testing queue wraparound...\n");
+
+        cmd_queue_t q;
+        q.construct();
+        UTEST_ASSERT(q.init(QUEUE_SIZE) == STATUS_OK);
+
+        // Records of random size are produced until the ring is full, then the consumer
+        // releases some of them. Records that do not fit at the end of the ring are
+        // preceded by the padding record which should be skipped by the consumer
+        uint32_t seed       = 1;
+        uint32_t produced   = 0, consumed = 0;
+        size_t paddings     = 0;
+        while (produced < NUM_RECORDS)
+        {
+            size_t bytes        = next_random(&seed) % (q.max_record() - sizeof(test_record_t) + 1);
+            size_t size         = sizeof(test_record_t) + bytes;
+            size_t pos          = q.nHead & (q.nCapacity - 1);
+            cmd_header_t *hdr   = q.begin(1, size);
+            if (hdr != NULL)
+            {
+                // The record that does not fit at the end starts the ring again
+                size_t off          = reinterpret_cast<uint8_t *>(hdr) - q.vData;
+                if (off != pos)
+                {
+                    const cmd_header_t *pad = reinterpret_cast<const cmd_header_t *>(&q.vData[pos]);
+                    UTEST_ASSERT(off == 0);
+                    UTEST_ASSERT(pad->type == CMD_PADDING);
+                    UTEST_ASSERT(pad->size == q.nCapacity - pos);
+                    ++paddings;
+                }
+
+                test_record_t *rec  = reinterpret_cast<test_record_t *>(hdr);
+                rec->seq            = produced;
+                rec->bytes          = uint32_t(bytes);
+                memset(&rec[1], uint8_t(produced), bytes);
+                q.commit();
+                ++produced;
+                continue;
+            }
+
+            // Release random number of records
+            size_t n            = 1 + next_random(&seed) % 4;
+            for (size_t i=0; (i<n) && (consumed < produced); ++i, ++consumed)
+            {
+                hdr                 = q.fetch();
+                check_record(&q, hdr, consumed);
+                q.release(hdr);
+            }
+        }
+
+        // Drain the queue
+        for ( ; consumed < produced; ++consumed)
+        {
+            cmd_header_t *hdr   = q.fetch();
+            check_record(&q, hdr, consumed);
+            q.release(hdr);
+        }
+        UTEST_ASSERT(q.empty());
+        UTEST_ASSERT(q.fetch() == NULL);
+
+        printf("  records=%d, paddings=%d\n", int(produced), int(paddings));
+        UTEST_ASSERT(paddings > 0);
+
+        q.destroy();
+    }
+
+#ifdef PLATFORM_WINDOWS
+    wgl::backend_t *create_backend()
+    {
+        wgl::backend_t *b   = static_cast<wgl::backend_t *>(malloc(sizeof(wgl::backend_t)));
+        UTEST_ASSERT(b != NULL);
+        b->construct();
+        if (b->init_offscreen(b) != STATUS_OK)
+        {
+            printf("  OpenGL backend is not available, skipping\n");
+            b->destroy(b);
+            free(b);
+            return NULL;
+        }
+
+        UTEST_ASSERT(b->locate(b, 0, 0, FRAME_WIDTH, FRAME_HEIGHT) == STATUS_OK);
+        return b;
+    }
+
+    void test_threaded()
+    {
+        printf("Testing threaded rendering...\n");
+
+        wgl::backend_t *b   = create_backend();
+        if (b == NULL)
+            return;
+
+        scene_t s;
+        bool ok             = build_scene(&s);
+        uint8_t *pixels     = static_cast<uint8_t *>(malloc(FRAME_SIZE * 3));
+        UTEST_ASSERT(ok);
+        UTEST_ASSERT(pixels != NULL);
+
+        // The large buffer is passed to the render thread without copying, small buffers
+        // wrap the queue around several times
+        UTEST_ASSERT(draw_frame(b, &s, &pixels[0]) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::set_threaded(b, true) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &s, &pixels[FRAME_SIZE]) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, &s, &pixels[FRAME_SIZE * 2]) == STATUS_OK);
+        UTEST_ASSERT(memcmp(&pixels[0], &pixels[FRAME_SIZE], FRAME_SIZE) == 0);
+        UTEST_ASSERT(memcmp(&pixels[0], &pixels[FRAME_SIZE * 2], FRAME_SIZE) == 0);
+
+        // The error of the asynchronous command is reported by the next synchronous
+        // call only once
+        UTEST_ASSERT(b->start(b) == STATUS_OK);
+        UTEST_ASSERT(b->sync(b) == STATUS_OK);
+        b->nAsyncError      = STATUS_NO_MEM;
+        UTEST_ASSERT(b->sync(b) == STATUS_NO_MEM);
+        UTEST_ASSERT(b->sync(b) == STATUS_OK);
+        b->nAsyncError      = STATUS_NO_MEM;
+        UTEST_ASSERT(b->read_pixels(b, pixels, r3d::PIXEL_RGBA) == STATUS_NO_MEM);
+        UTEST_ASSERT(b->read_pixels(b, pixels, r3d::PIXEL_RGBA) == STATUS_OK);
+        UTEST_ASSERT(b->finish(b) == STATUS_OK);
+
+        UTEST_ASSERT(wgl::backend_t::set_threaded(b, false) == STATUS_OK);
+
+        free(pixels);
+        destroy_scene(&s);
+        b->destroy(b);
+        free(b);
+    }
+#endif /* PLATFORM_WINDOWS */
+
+    UTEST_MAIN
+    {
+        test_limits();
+        test_wraparound();
+    #ifdef PLATFORM_WINDOWS
+        test_threaded();
+    #endif /* PLATFORM_WINDOWS */
+    }
+
+UTEST_END
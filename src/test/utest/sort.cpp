@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <private/wgl/arena.h>
+#include <private/wgl/sort.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <lsp-plug.in/r3d/wgl/backend.h>
+#endif /* PLATFORM_WINDOWS */
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t MAX_KEYS       = 100000;
+
+    static uint32_t next_random(uint32_t *seed)
+    {
+        *seed       = *seed * 1664525 + 1013904223;
+        return *seed >> 8;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    constexpr size_t FRAME_WIDTH    = 64;
+    constexpr size_t FRAME_HEIGHT   = 64;
+    constexpr size_t NUM_LAYERS     = 16;       // Number of stacked blended triangles
+
+    /**
+     * Draw the stack of blended triangles rotated around the Y axis
+     */
+    static status_t draw_frame(r3d::backend_t *b, float angle)
+    {
+        // The cached geometry is looked up by the data pointer
+        static r3d::dot4_t v[NUM_LAYERS * 3];
+        for (size_t i=0; i<NUM_LAYERS; ++i)
+        {
+            float z             = float(i) / NUM_LAYERS - 0.5f;
+            r3d::dot4_t *t      = &v[i * 3];
+            t[0].x = -0.5f;     t[0].y = -0.5f;     t[0].z = z;     t[0].w = 1.0f;
+            t[1].x =  0.5f;     t[1].y = -0.5f;     t[1].z = z;     t[1].w = 1.0f;
+            t[2].x =  0.0f;     t[2].y =  0.5f;     t[2].z = z;     t[2].w = 1.0f;
+        }
+
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        buf.model.m[0]      = cosf(angle);
+        buf.model.m[2]      = -sinf(angle);
+        buf.model.m[5]      = 1.0f;
+        buf.model.m[8]      = sinf(angle);
+        buf.model.m[10]     = cosf(angle);
+        buf.model.m[15]     = 1.0f;
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.count           = NUM_LAYERS;
+        buf.flags           = r3d::BUFFER_BLENDING | r3d::BUFFER_STD_BLENDING | r3d::BUFFER_NO_CULLING;
+        buf.vertex.data     = v;
+        buf.color.dfl.r     = 1.0f;
+        buf.color.dfl.a     = 0.5f;
+
+        status_t res        = b->start(b);
+        if (res != STATUS_OK)
+            return res;
+        res                 = b->draw_primitives(b, &buf);
+        status_t fres       = b->finish(b);
+
+        return (res != STATUS_OK) ? res : fres;
+    }
+#endif /* PLATFORM_WINDOWS */
+}
+
+UTEST_BEGIN("r3d.wgl", sort)
+
+    void check_sort(arena_t *arena, const char *label, const float *keys, size_t count)
+    {
+        printf("Testing sort of %d %s keys...\n", int(count), label);
+
+        uint32_t *order     = static_cast<uint32_t *>(malloc(lsp_max(count, size_t(1)) * sizeof(uint32_t)));
+        float *ref          = static_cast<float *>(malloc(lsp_max(count, size_t(1)) * sizeof(float)));
+        uint8_t *used       = static_cast<uint8_t *>(malloc(lsp_max(count, size_t(1))));
+        UTEST_ASSERT((order != NULL) && (ref != NULL) && (used != NULL));
+
+        UTEST_ASSERT(sort_by_keys(order, keys, count, arena) == STATUS_OK);
+
+        // The order is the permutation of elements
+        memset(used, 0, count);
+        for (size_t i=0; i<count; ++i)
+        {
+            UTEST_ASSERT(order[i] < count);
+            UTEST_ASSERT(used[order[i]] == 0);
+            used[order[i]]      = 1;
+        }
+
+        // Sorted keys match the reference, -0 and +0 are equal
+        memcpy(ref, keys, count * sizeof(float));
+        std::sort(ref, &ref[count]);
+        for (size_t i=0; i<count; ++i)
+            UTEST_ASSERT_MSG(keys[order[i]] == ref[i], "Key %d: %g != %g", int(i), keys[order[i]], ref[i]);
+
+        // Elements with identical keys keep the original order
+        for (size_t i=1; i<count; ++i)
+        {
+            if (memcmp(&keys[order[i-1]], &keys[order[i]], sizeof(float)) == 0)
+                UTEST_ASSERT(order[i-1] < order[i]);
+        }
+
+        free(order);
+        free(ref);
+        free(used);
+    }
+
+    void test_sort()
+    {
+        arena_t arena;
+        arena.construct();
+
+        float *keys         = static_cast<float *>(malloc(MAX_KEYS * sizeof(float)));
+        UTEST_ASSERT(keys != NULL);
+        uint32_t seed       = 1;
+
+        // Trivial sizes
+        keys[0]             = 1.0f;
+        check_sort(&arena, "empty", keys, 0);
+        check_sort(&arena, "single", keys, 1);
+
+        // Negative and positive keys of different magnitude
+        for (size_t i=0; i<MAX_KEYS; ++i)
+        {
+            float v             = float(next_random(&seed) & 0xffff) - 32768.0f;
+            keys[i]             = v * powf(10.0f, float(int(next_random(&seed) % 13) - 6));
+        }
+        check_sort(&arena, "random", keys, 2);
+        check_sort(&arena, "random", keys, 17);
+        check_sort(&arena, "random", keys, MAX_KEYS);
+
+        // Many equal keys including positive and negative zeros
+        for (size_t i=0; i<MAX_KEYS; ++i)
+        {
+            uint32_t r          = next_random(&seed) % 7;
+            keys[i]             = (r == 0) ? 0.0f : (r == 1) ? -0.0f : float(int(r) - 4) * 0.25f;
+        }
+        check_sort(&arena, "equal", keys, 1000);
+        check_sort(&arena, "equal", keys, MAX_KEYS);
+
+        // All keys are equal, every radix pass is skipped
+        for (size_t i=0; i<1000; ++i)
+            keys[i]             = -2.5f;
+        check_sort(&arena, "same", keys, 1000);
+
+        // The arena is rolled back after sorting
+        UTEST_ASSERT(arena.mark() == 0);
+
+        free(keys);
+        arena.destroy();
+    }
+
+    void test_row_changed()
+    {
+        printf("Testing changes of the depth row...\n");
+
+        static const float epsilon  = 1e-4f;
+        static const float row[4]   = { 0.3f, -0.5f, 0.0f, -12.0f };
+        float a[4];
+
+        UTEST_ASSERT(!depth_row_changed(row, row, epsilon));
+
+        // Small relative change of each element keeps the order
+        for (size_t i=0; i<4; ++i)
+            a[i]                = row[i] * (1.0f + 1e-6f) + 1e-6f;
+        UTEST_ASSERT(!depth_row_changed(a, row, epsilon));
+
+        // Large change of any element requires sorting
+        for (size_t i=0; i<4; ++i)
+        {
+            memcpy(a, row, sizeof(a));
+            a[i]               += 1e-2f * (1.0f + fabsf(row[i]));
+            UTEST_ASSERT_MSG(depth_row_changed(a, row, epsilon), "Change of element %d is not detected", int(i));
+        }
+    }
+
+#ifdef PLATFORM_WINDOWS
+    void test_cache_sort()
+    {
+        printf("Testing reuse of the depth order...\n");
+
+        wgl::backend_t *b   = static_cast<wgl::backend_t *>(malloc(sizeof(wgl::backend_t)));
+        UTEST_ASSERT(b != NULL);
+        b->construct();
+        if (b->init_offscreen(b) != STATUS_OK)
+        {
+            printf("  OpenGL backend is not available, skipping\n");
+            b->destroy(b);
+            free(b);
+            return;
+        }
+        UTEST_ASSERT(b->locate(b, 0, 0, FRAME_WIDTH, FRAME_HEIGHT) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::set_cache_flags(b, CACHE_GEOMETRY | CACHE_SORT) == STATUS_OK);
+
+        // The first draw sorts triangles, the same and the slightly rotated model
+        // reuse the order, the model rotated by the larger angle is sorted again
+        cache_stats_t stats;
+        UTEST_ASSERT(draw_frame(b, 0.5f) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, 0.5f) == STATUS_OK);
+        UTEST_ASSERT(draw_frame(b, 0.5f + 1e-6f) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::get_cache_stats(b, &stats) == STATUS_OK);
+        printf("  sorts=%d, hits=%d\n", int(stats.nSorts), int(stats.nSortHits));
+        UTEST_ASSERT(stats.nSorts == 1);
+        UTEST_ASSERT(stats.nSortHits == 2);
+
+        UTEST_ASSERT(draw_frame(b, 1.0f) == STATUS_OK);
+        UTEST_ASSERT(wgl::backend_t::get_cache_stats(b, &stats) == STATUS_OK);
+        printf("  sorts=%d, hits=%d\n", int(stats.nSorts), int(stats.nSortHits));
+        UTEST_ASSERT(stats.nSorts == 2);
+        UTEST_ASSERT(stats.nSortHits == 2);
+
+        b->destroy(b);
+        free(b);
+    }
+#endif /* PLATFORM_WINDOWS */
+
+    UTEST_MAIN
+    {
+        test_sort();
+        test_row_changed();
+    #ifdef PLATFORM_WINDOWS
+        test_cache_sort();
+    #endif /* PLATFORM_WINDOWS */
+    }
+
+UTEST_END
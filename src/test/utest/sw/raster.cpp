@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/r3d/wgl/sw_backend.h>
+#include <private/sw/raster.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t FRAME_WIDTH    = 80;
+    constexpr size_t FRAME_HEIGHT   = 72;
+    constexpr uint32_t BACKGROUND   = 0xff000000;
+
+    static void set_vertex(sw::svertex_t *v, float x, float y, float z)
+    {
+        v->x        = x;
+        v->y        = y;
+        v->z        = z;
+        v->iw       = 1.0f;
+        v->c.r      = 1.0f;
+        v->c.g      = 1.0f;
+        v->c.b      = 1.0f;
+        v->c.a      = 1.0f;
+    }
+
+    static void set_color(sw::svertex_t *v, float r, float g, float b)
+    {
+        v->c.r      = r;
+        v->c.g      = g;
+        v->c.b      = b;
+        v->c.a      = 1.0f;
+    }
+
+    // Reference edge function in double precision, >0 inside, 0 on the edge
+    static double edge(const sw::svertex_t *a, const sw::svertex_t *b, double x, double y, double sign)
+    {
+        return ((a->y - b->y) * x + (b->x - a->x) * y + (double(a->x) * b->y - double(b->x) * a->y)) * sign;
+    }
+
+    static bool top_left(const sw::svertex_t *a, const sw::svertex_t *b, double sign)
+    {
+        double ea   = (a->y - b->y) * sign;
+        double eb   = (b->x - a->x) * sign;
+        return (ea > 0.0) || ((ea == 0.0) && (eb > 0.0));
+    }
+
+    /**
+     * Compute the reference coverage of the triangle
+     * @param mask coverage mask: 0 - not covered, 1 - covered, 2 - too close to the edge to decide
+     */
+    static void ref_coverage(uint8_t *mask, const sw::svertex_t *v)
+    {
+        double area = double(v[1].x - v[0].x) * (v[2].y - v[0].y) - double(v[2].x - v[0].x) * (v[1].y - v[0].y);
+        double sign = (area > 0.0) ? 1.0 : -1.0;
+
+        for (size_t y=0; y<FRAME_HEIGHT; ++y)
+            for (size_t x=0; x<FRAME_WIDTH; ++x)
+            {
+                double xc = x + 0.5, yc = y + 0.5;
+                uint8_t m = 1;
+                for (size_t i=0; i<3; ++i)
+                {
+                    const sw::svertex_t *a = &v[i], *b = &v[(i+1) % 3];
+                    double e    = edge(a, b, xc, yc, sign);
+                    double len  = sqrt(double(a->x - b->x) * (a->x - b->x) + double(a->y - b->y) * (a->y - b->y));
+                    if (e < 0.0)
+                    {
+                        if (e > -1e-3 * len)
+                            m       = 2;
+                        else
+                        {
+                            m       = 0;
+                            break;
+                        }
+                    }
+                    else if (e == 0.0)
+                    {
+                        if (!top_left(a, b, sign))
+                        {
+                            m       = 0;
+                            break;
+                        }
+                    }
+                    else if (e < 1e-3 * len)
+                        m       = 2;
+                }
+                mask[y * FRAME_WIDTH + x] = m;
+            }
+    }
+}
+
+UTEST_BEGIN("r3d.wgl.sw", raster)
+
+    void draw(sw::raster_t *r, const sw::svertex_t *v, size_t count, uint32_t flags)
+    {
+        for (size_t i=0; i<count; i += 3)
+            UTEST_ASSERT(r->add_triangle(&v[i], &v[i+1], &v[i+2], flags) == STATUS_OK);
+        r->flush();
+    }
+
+    void coverage(uint8_t *mask, sw::raster_t *r, const sw::svertex_t *v, size_t count)
+    {
+        r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+        r->clear(&bg);
+        draw(r, v, count, 0);
+        for (size_t i=0; i<FRAME_WIDTH*FRAME_HEIGHT; ++i)
+            mask[i]     = (r->vColor[i] != BACKGROUND) ? 1 : 0;
+    }
+
+    void test_fill_rule(sw::raster_t *r)
+    {
+        // Shapes with edges that pass exactly through pixel centers, each one is split into two parts
+        static const float shapes[][6][2] =
+        {
+            // Square split by the diagonal
+            { { 8, 8 }, { 40, 8 }, { 40, 40 },          { 8, 8 }, { 40, 40 }, { 8, 40 } },
+            // Split by the vertical line
+            { { 4, 4 }, { 20.5f, 4 }, { 20.5f, 30 },    { 20.5f, 4 }, { 36, 30 }, { 20.5f, 30 } },
+            // Split by the horizontal line
+            { { 10, 2.5f }, { 60, 20.5f }, { 10, 20.5f }, { 10, 20.5f }, { 60, 20.5f }, { 30, 50 } },
+            // Fan of thin triangles with the shared vertex at the pixel center
+            { { 40.5f, 36.5f }, { 79, 2 }, { 79, 70.5f }, { 40.5f, 36.5f }, { 79, 70.5f }, { 3, 70 } },
+        };
+
+        uint8_t *m1 = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT));
+        uint8_t *m2 = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT));
+        uint8_t *mu = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT));
+        UTEST_ASSERT((m1 != NULL) && (m2 != NULL) && (mu != NULL));
+
+        for (size_t i=0; i<sizeof(shapes)/sizeof(shapes[0]); ++i)
+        {
+            sw::svertex_t v[6];
+            for (size_t j=0; j<6; ++j)
+                set_vertex(&v[j], shapes[i][j][0], shapes[i][j][1], 0.5f);
+
+            coverage(m1, r, &v[0], 3);
+            coverage(m2, r, &v[3], 3);
+            coverage(mu, r, v, 6);
+
+            for (size_t j=0; j<FRAME_WIDTH*FRAME_HEIGHT; ++j)
+            {
+                UTEST_ASSERT_MSG(!(m1[j] && m2[j]),
+                    "Shape %d: pixel (%d, %d) is covered by both triangles",
+                    int(i), int(j % FRAME_WIDTH), int(j / FRAME_WIDTH));
+                UTEST_ASSERT_MSG(mu[j] == (m1[j] | m2[j]),
+                    "Shape %d: coverage of pixel (%d, %d) differs", int(i), int(j % FRAME_WIDTH), int(j / FRAME_WIDTH));
+            }
+        }
+
+        free(m1);
+        free(m2);
+        free(mu);
+    }
+
+    void test_coverage(sw::raster_t *r)
+    {
+        uint8_t *mask   = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT));
+        uint8_t *ref    = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT));
+        UTEST_ASSERT((mask != NULL) && (ref != NULL));
+
+        // Random triangles, including ones that cross several tiles and the frame borders
+        srand(0x1234);
+        for (size_t i=0; i<200; ++i)
+        {
+            sw::svertex_t v[3];
+            for (size_t j=0; j<3; ++j)
+                set_vertex(&v[j],
+                    (rand() % 2000) * 0.05f - 10.0f,
+                    (rand() % 1800) * 0.05f - 9.0f,
+                    0.5f);
+
+            coverage(mask, r, v, 3);
+            ref_coverage(ref, v);
+
+            for (size_t j=0; j<FRAME_WIDTH*FRAME_HEIGHT; ++j)
+            {
+                if (ref[j] == 2)
+                    continue;
+                UTEST_ASSERT_MSG(mask[j] == ref[j],
+                    "Triangle %d: pixel (%d, %d) coverage is %d, expected %d",
+                    int(i), int(j % FRAME_WIDTH), int(j / FRAME_WIDTH), int(mask[j]), int(ref[j]));
+            }
+        }
+
+        free(mask);
+        free(ref);
+    }
+
+    void test_depth(sw::raster_t *r)
+    {
+        r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+        sw::svertex_t near[3], far[3];
+
+        // Red triangle is nearer than the green one
+        set_vertex(&near[0], 10, 10, 0.25f);
+        set_vertex(&near[1], 50, 10, 0.25f);
+        set_vertex(&near[2], 10, 50, 0.25f);
+        set_vertex(&far[0], 20, 20, 0.75f);
+        set_vertex(&far[1], 60, 20, 0.75f);
+        set_vertex(&far[2], 20, 60, 0.75f);
+        for (size_t i=0; i<3; ++i)
+        {
+            set_color(&near[i], 1.0f, 0.0f, 0.0f);
+            set_color(&far[i], 0.0f, 1.0f, 0.0f);
+        }
+
+        for (size_t order=0; order<2; ++order)
+        {
+            r->clear(&bg);
+            draw(r, (order) ? far : near, 3, 0);
+            draw(r, (order) ? near : far, 3, 0);
+
+            // Overlapped area
+            size_t off  = 25 * FRAME_WIDTH + 25;
+            UTEST_ASSERT_MSG(r->vColor[off] == 0xff0000ff, "order=%d color=%08x", int(order), unsigned(r->vColor[off]));
+            UTEST_ASSERT(r->vDepth[off] == 0.25f);
+
+            // Far triangle only
+            off         = 55 * FRAME_WIDTH + 22;
+            UTEST_ASSERT_MSG(r->vColor[off] == 0xff00ff00, "order=%d color=%08x", int(order), unsigned(r->vColor[off]));
+            UTEST_ASSERT(r->vDepth[off] == 0.75f);
+
+            // Background
+            off         = 5 * FRAME_WIDTH + 70;
+            UTEST_ASSERT(r->vColor[off] == BACKGROUND);
+            UTEST_ASSERT(r->vDepth[off] == 1.0f);
+        }
+
+        // Interpolation of depth and color along the triangle
+        sw::svertex_t v[3];
+        set_vertex(&v[0], 0, 0, 0.0f);
+        set_vertex(&v[1], 80, 0, 1.0f);
+        set_vertex(&v[2], 0, 80, 0.5f);
+        set_color(&v[0], 0.0f, 0.0f, 0.0f);
+        set_color(&v[1], 1.0f, 0.0f, 0.0f);
+        set_color(&v[2], 0.0f, 0.0f, 1.0f);
+
+        r->clear(&bg);
+        draw(r, v, 3, 0);
+        for (size_t y=0; y<FRAME_HEIGHT; y += 7)
+            for (size_t x=0; x + y + 1 < 80; x += 5)
+            {
+                float xc    = (x + 0.5f) / 80.0f, yc = (y + 0.5f) / 80.0f;
+                size_t off  = y * FRAME_WIDTH + x;
+                float z     = xc + 0.5f * yc;
+                uint32_t c  = r->vColor[off];
+                int rc      = int(xc * 255.0f + 0.5f);
+                int bc      = int(yc * 255.0f + 0.5f);
+
+                UTEST_ASSERT_MSG(fabsf(r->vDepth[off] - z) < 1e-5f,
+                    "Depth at (%d, %d) is %f, expected %f", int(x), int(y), r->vDepth[off], z);
+                UTEST_ASSERT_MSG((abs(int(c & 0xff) - rc) <= 1) && (abs(int((c >> 16) & 0xff) - bc) <= 1),
+                    "Color at (%d, %d) is %08x", int(x), int(y), unsigned(c));
+            }
+    }
+
+    void test_backend()
+    {
+        // Draw the triangle that covers the left-bottom half of the viewport
+        r3d::dot4_t v[3]    = { { -1.0f, -1.0f, 0.0f, 1.0f }, { 1.0f, -1.0f, 0.0f, 1.0f }, { -1.0f, 1.0f, 0.0f, 1.0f } };
+        r3d::color_t c[3]   = { { 1.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } };
+        r3d::color_t bg     = { 0.0f, 0.0f, 0.0f, 1.0f };
+        r3d::buffer_t b;
+        memset(&b, 0, sizeof(b));
+        for (size_t i=0; i<4; ++i)
+            b.model.m[i*5]      = 1.0f;
+        b.type              = r3d::PRIMITIVE_TRIANGLES;
+        b.count             = 1;
+        b.flags             = r3d::BUFFER_NO_CULLING;
+        b.vertex.data       = v;
+        b.color.data        = c;
+
+        sw_backend_t *s     = static_cast<sw_backend_t *>(malloc(sizeof(sw_backend_t)));
+        uint8_t *pix        = static_cast<uint8_t *>(malloc(FRAME_WIDTH * FRAME_HEIGHT * 4));
+        UTEST_ASSERT((s != NULL) && (pix != NULL));
+        s->construct();
+
+        UTEST_ASSERT(s->init_offscreen(s) == STATUS_OK);
+        UTEST_ASSERT(s->locate(s, 0, 0, FRAME_WIDTH, FRAME_HEIGHT) == STATUS_OK);
+        UTEST_ASSERT(s->set_bg_color(s, &bg) == STATUS_OK);
+        UTEST_ASSERT(s->start(s) == STATUS_OK);
+        UTEST_ASSERT(s->draw_primitives(s, &b) == STATUS_OK);
+        UTEST_ASSERT(s->read_pixels(s, pix, r3d::PIXEL_RGBA) == STATUS_OK);
+        UTEST_ASSERT(s->finish(s) == STATUS_OK);
+
+        // The OpenGL viewport has Y axis looking up, the first row of pixels is the top one
+        for (size_t y=0; y<FRAME_HEIGHT; ++y)
+            for (size_t x=0; x<FRAME_WIDTH; ++x)
+            {
+                const uint8_t *p    = &pix[(y * FRAME_WIDTH + x) * 4];
+                float fx            = (x + 0.5f) / FRAME_WIDTH;
+                float fy            = 1.0f - (y + 0.5f) / FRAME_HEIGHT;
+                float d             = fx + fy - 1.0f;
+                if (fabsf(d) < 0.05f)
+                    continue;
+                bool inside         = d < 0.0f;
+                UTEST_ASSERT_MSG((p[0] == ((inside) ? 0xff : 0x00)) && (p[1] == 0) && (p[2] == 0),
+                    "Pixel (%d, %d) is %02x%02x%02x, inside=%d", int(x), int(y), p[0], p[1], p[2], int(inside));
+            }
+
+        s->destroy(s);
+        free(s);
+        free(pix);
+    }
+
+    UTEST_MAIN
+    {
+        sw::raster_t r;
+        r.construct();
+        UTEST_ASSERT(r.resize(FRAME_WIDTH, FRAME_HEIGHT) == STATUS_OK);
+
+        printf("Testing fill rule...\n");
+        test_fill_rule(&r);
+        printf("Testing coverage...\n");
+        test_coverage(&r);
+        printf("Testing depth...\n");
+        test_depth(&r);
+        r.destroy();
+
+        printf("Testing backend...\n");
+        test_backend();
+    }
+
+UTEST_END
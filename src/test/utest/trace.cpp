@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-r3d-wgl-lib
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-r3d-wgl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-r3d-wgl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-r3d-wgl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/r3d/wgl/sw_backend.h>
+#include <lsp-plug.in/r3d/wgl/trace.h>
+#include <private/wgl/trace.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace lsp;
+using namespace lsp::r3d;
+using namespace lsp::r3d::wgl;
+
+namespace
+{
+    constexpr size_t RING_SIZE      = 4;        // Number of triangles in the ring
+    constexpr size_t RING_FIRST     = 1;        // First triangle of the ring
+    constexpr size_t MAX_CALLS      = 4;
+
+    typedef struct draw_call_t
+    {
+        r3d::mat4_t     model;
+        size_t          count;
+        r3d::dot4_t     vertex;                 // First vertex of the call
+        r3d::color_t    color;                  // First color of the call
+    } draw_call_t;
+
+    static draw_call_t  vCalls[MAX_CALLS];
+    static size_t       nCalls                  = 0;
+
+    /**
+     * Record the draw call passed to the software backend by the trace replay
+     */
+    static status_t draw_hook(r3d::backend_t *handle, const r3d::buffer_t *buffer)
+    {
+        if (nCalls < MAX_CALLS)
+        {
+            draw_call_t *c      = &vCalls[nCalls];
+            size_t vi           = (buffer->vertex.index != NULL) ? buffer->vertex.index[0] : 0;
+            c->model            = buffer->model;
+            c->count            = buffer->count;
+            c->vertex           = buffer->vertex.data[vi];
+            c->color            = (buffer->color.data != NULL) ? buffer->color.data[vi] : buffer->color.dfl;
+        }
+        ++nCalls;
+
+        return sw_backend_t::draw_primitives(handle, buffer);
+    }
+
+    static void identity(r3d::mat4_t *m)
+    {
+        memset(m, 0, sizeof(*m));
+        for (size_t i=0; i<4; ++i)
+            m->m[i*5]           = 1.0f;
+    }
+
+    static status_t record_trace(const char *path, const r3d::buffer_t *buf, size_t first, const r3d::mat4_t *wrap)
+    {
+        static const r3d::color_t bg = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+        trace_writer_t w;
+        w.construct();
+        status_t res        = w.open(path);
+        if (res != STATUS_OK)
+        {
+            w.destroy();
+            return res;
+        }
+
+        w.locate(0, 0, 32, 32);
+        w.start(&bg);
+        w.draw_ring(buf, first, wrap);
+        w.finish();
+
+        res                 = w.close();
+        w.destroy();
+        return res;
+    }
+}
+
+UTEST_BEGIN("r3d.wgl", trace)
+
+    void replay(const char *path, trace_stats_t *stats)
+    {
+        sw_backend_t *s     = static_cast<sw_backend_t *>(malloc(sizeof(sw_backend_t)));
+        UTEST_ASSERT(s != NULL);
+        s->construct();
+        UTEST_ASSERT(s->init_offscreen(s) == STATUS_OK);
+        r3d::backend_t *b   = s;
+        b->draw_primitives  = draw_hook;
+
+        nCalls              = 0;
+        UTEST_ASSERT(replay_trace(s, path, stats) == STATUS_OK);
+
+        s->destroy(s);
+        free(s);
+    }
+
+    void test_ring(const char *path, bool indexed)
+    {
+        printf("Testing ring replay, indexed=%s...\n", (indexed) ? "true" : "false");
+
+        // Each triangle of the ring has its own X coordinate and color
+        r3d::dot4_t v[RING_SIZE * 3];
+        r3d::color_t c[RING_SIZE * 3];
+        uint32_t idx[RING_SIZE * 3];
+        for (size_t i=0; i<RING_SIZE * 3; ++i)
+        {
+            size_t j            = (indexed) ? RING_SIZE * 3 - 1 - i : i;
+            float t             = float(i / 3) / RING_SIZE;
+            v[j].x              = t - 0.5f;
+            v[j].y              = float(i % 3) * 0.2f;
+            v[j].z              = 0.0f;
+            v[j].w              = 1.0f;
+            c[j].r              = t;
+            c[j].g              = 0.0f;
+            c[j].b              = 0.0f;
+            c[j].a              = 1.0f;
+            idx[i]              = uint32_t(j);
+        }
+
+        r3d::buffer_t buf;
+        memset(&buf, 0, sizeof(buf));
+        identity(&buf.model);
+        buf.type            = r3d::PRIMITIVE_TRIANGLES;
+        buf.count           = RING_SIZE;
+        buf.flags           = r3d::BUFFER_NO_CULLING;
+        buf.vertex.data     = v;
+        buf.vertex.index    = (indexed) ? idx : NULL;
+        buf.color.data      = c;
+
+        r3d::mat4_t wrap;
+        identity(&wrap);
+        wrap.m[12]          = 1.0f;
+
+        // The ring is replayed by two draws: the tail with the model transform
+        // and the wrapped head with the additional transform
+        trace_stats_t stats;
+        UTEST_ASSERT(record_trace(path, &buf, RING_FIRST, &wrap) == STATUS_OK);
+        replay(path, &stats);
+        UTEST_ASSERT(stats.nDraws == 1);
+        UTEST_ASSERT(stats.nErrors == 0);
+        UTEST_ASSERT(nCalls == 2);
+
+        const draw_call_t *tail = &vCalls[0];
+        UTEST_ASSERT(tail->count == RING_SIZE - RING_FIRST);
+        UTEST_ASSERT(memcmp(&tail->model, &buf.model, sizeof(r3d::mat4_t)) == 0);
+        UTEST_ASSERT(memcmp(&tail->vertex, &v[idx[RING_FIRST * 3]], sizeof(r3d::dot4_t)) == 0);
+        UTEST_ASSERT(memcmp(&tail->color, &c[idx[RING_FIRST * 3]], sizeof(r3d::color_t)) == 0);
+
+        const draw_call_t *head = &vCalls[1];
+        UTEST_ASSERT(head->count == RING_FIRST);
+        UTEST_ASSERT(memcmp(&head->model, &wrap, sizeof(r3d::mat4_t)) == 0);
+        UTEST_ASSERT(memcmp(&head->vertex, &v[idx[0]], sizeof(r3d::dot4_t)) == 0);
+        UTEST_ASSERT(memcmp(&head->color, &c[idx[0]], sizeof(r3d::color_t)) == 0);
+
+        // The ring without rotation is replayed as a single draw
+        UTEST_ASSERT(record_trace(path, &buf, 0, NULL) == STATUS_OK);
+        replay(path, &stats);
+        UTEST_ASSERT(stats.nErrors == 0);
+        UTEST_ASSERT(nCalls == 1);
+        UTEST_ASSERT(vCalls[0].count == RING_SIZE);
+
+        // The invalid first primitive is reported as the error of the call
+        UTEST_ASSERT(record_trace(path, &buf, RING_SIZE, NULL) == STATUS_OK);
+        replay(path, &stats);
+        UTEST_ASSERT(stats.nErrors == 1);
+        UTEST_ASSERT(nCalls == 0);
+
+        remove(path);
+    }
+
+    UTEST_MAIN
+    {
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/r3d-wgl-utest-trace.bin", tempdir());
+
+        test_ring(path, false);
+        test_ring(path, true);
+    }
+
+UTEST_END